@@ -0,0 +1,171 @@
+/**
+ * @file Aig.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "Aig.h"
+#include <utility>
+
+/**
+ * Constructor. Creates the constant and Unknown nodes.
+ */
+Aig::Aig()
+{
+    Node constant;
+    mNodes.push_back(constant);
+
+    Node unknown;
+    unknown.mKind = Kind::Unknown;
+    unknown.mKnown = false;
+    mNodes.push_back(unknown);
+}
+
+/**
+ * Add an input node
+ * @param known True if the input can never be Unknown
+ * @return Literal for the input
+ */
+int Aig::AddInput(bool known)
+{
+    Node node;
+    node.mKind = Kind::Input;
+    node.mInput = mNumInputs++;
+    node.mKnown = known;
+    mNodes.push_back(node);
+    return ((int)mNodes.size() - 1) * 2;
+}
+
+/**
+ * AND of two literals.
+ *
+ * Constants and repeated operands are folded, AND nodes one level
+ * down are checked for shared and opposite operands, and a node with
+ * the same operands as an existing one is reused.
+ *
+ * @param a First operand
+ * @param b Second operand
+ * @return Literal for a AND b
+ */
+int Aig::And(int a, int b)
+{
+    if (a == Unknown || b == Unknown)
+    {
+        return Unknown;
+    }
+
+    if (a > b)
+    {
+        std::swap(a, b);
+    }
+
+    // One AND x is x, even when x is Unknown
+    if (a == b || a == True)
+    {
+        return b;
+    }
+
+    bool known = mNodes[NodeOf(a)].mKnown && mNodes[NodeOf(b)].mKnown;
+    if (known && (a == False || a == Not(b)))
+    {
+        return False;
+    }
+
+    // Look one level into each operand that is an AND node
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int x = pass == 0 ? a : b;
+        int y = pass == 0 ? b : a;
+        const Node &node = mNodes[NodeOf(y)];
+        if (node.mKind != Kind::And)
+        {
+            continue;
+        }
+
+        if (!IsComplemented(y))
+        {
+            // x AND (x AND d) is x AND d
+            if (x == node.mA || x == node.mB)
+            {
+                return y;
+            }
+
+            // x AND (NOT x AND d) is Zero
+            if (known && (Not(x) == node.mA || Not(x) == node.mB))
+            {
+                return False;
+            }
+        }
+        else
+        {
+            // x AND NOT (x AND d) is x AND NOT d
+            if (x == node.mA || x == node.mB)
+            {
+                return And(x, Not(x == node.mA ? node.mB : node.mA));
+            }
+
+            // x AND NOT (NOT x AND d) is x
+            if (known && (Not(x) == node.mA || Not(x) == node.mB))
+            {
+                return x;
+            }
+        }
+    }
+
+    return Find(a, b);
+}
+
+/**
+ * Find the AND node for two operands, adding it if there is none
+ * @param a First operand, the smaller literal
+ * @param b Second operand
+ * @return Literal for the node
+ */
+int Aig::Find(int a, int b)
+{
+    uint64_t key = (uint64_t(a) << 32) | uint32_t(b);
+    auto found = mStrash.find(key);
+    if (found != mStrash.end())
+    {
+        return found->second;
+    }
+
+    Node node;
+    node.mKind = Kind::And;
+    node.mA = a;
+    node.mB = b;
+    node.mKnown = mNodes[NodeOf(a)].mKnown && mNodes[NodeOf(b)].mKnown;
+    mNodes.push_back(node);
+
+    int literal = ((int)mNodes.size() - 1) * 2;
+    mStrash[key] = literal;
+    return literal;
+}
+
+/**
+ * Count the AND nodes that some outputs depend on
+ * @param outputs Output literals
+ * @return Number of AND nodes reachable from the outputs
+ */
+int Aig::CountAnds(const std::vector<int> &outputs) const
+{
+    std::vector<bool> reached(mNodes.size(), false);
+    for (int literal : outputs)
+    {
+        reached[NodeOf(literal)] = true;
+    }
+
+    // Operands always precede the nodes that use them
+    int count = 0;
+    for (int n = (int)mNodes.size() - 1; n >= 0; n--)
+    {
+        if (reached[n] && mNodes[n].mKind == Kind::And)
+        {
+            count++;
+            reached[NodeOf(mNodes[n].mA)] = true;
+            reached[NodeOf(mNodes[n].mB)] = true;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file Aig.h
+ * @author matthew vazquez
+ *
+ * An AND-inverter graph with structural hashing.
+ */
+
+#ifndef AIG_H
+#define AIG_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * An AND-inverter graph with structural hashing.
+ *
+ * Every signal is a literal: a node number times two, plus one if
+ * the edge is complemented. Node 0 is constant Zero, so literal 0
+ * is Zero and literal 1 is One. Node 1 is a signal that is always
+ * Unknown, the value an unconnected pin has in the game.
+ *
+ * Gates in the game are strict: any Unknown input makes the output
+ * Unknown. Rules that drop an operand, such as a AND NOT a giving
+ * Zero, are only exact when that operand can never be Unknown, so
+ * they are only applied to nodes whose leaves are all known inputs.
+ */
+class Aig
+{
+public:
+    /// Literal that is always Zero
+    static constexpr int False = 0;
+
+    /// Literal that is always One
+    static constexpr int True = 1;
+
+    /// Literal that is always Unknown
+    static constexpr int Unknown = 2;
+
+    /// Kinds of node in the graph
+    enum class Kind {Constant, Unknown, Input, And};
+
+    /**
+     * A node in the graph
+     */
+    struct Node
+    {
+        /// What kind of node this is
+        Kind mKind = Kind::Constant;
+
+        /// First operand literal of an AND node
+        int mA = False;
+
+        /// Second operand literal of an AND node
+        int mB = False;
+
+        /// Position of an input among the inputs
+        int mInput = -1;
+
+        /// True if the node can never be Unknown
+        bool mKnown = true;
+    };
+
+private:
+    /// All nodes, operands always before the nodes using them
+    std::vector<Node> mNodes;
+
+    /// AND nodes by their operand pair
+    std::unordered_map<uint64_t, int> mStrash;
+
+    /// Number of input nodes
+    int mNumInputs = 0;
+
+    int Find(int a, int b);
+
+public:
+    Aig();
+
+    int AddInput(bool known);
+    int And(int a, int b);
+
+    /**
+     * OR of two literals
+     * @param a First operand
+     * @param b Second operand
+     * @return Literal for a OR b
+     */
+    int Or(int a, int b) { return Not(And(Not(a), Not(b))); }
+
+    /**
+     * XOR of two literals
+     * @param a First operand
+     * @param b Second operand
+     * @return Literal for a XOR b
+     */
+    int Xor(int a, int b) { return Or(And(a, Not(b)), And(Not(a), b)); }
+
+    int CountAnds(const std::vector<int> &outputs) const;
+
+    /**
+     * Complement a literal. Unknown stays Unknown.
+     * @param literal Literal to complement
+     * @return Complemented literal
+     */
+    static int Not(int literal) { return literal == Unknown ? Unknown : literal ^ 1; }
+
+    /**
+     * Get the node a literal refers to
+     * @param literal Literal
+     * @return Node number
+     */
+    static int NodeOf(int literal) { return literal >> 1; }
+
+    /**
+     * Is a literal complemented?
+     * @param literal Literal
+     * @return True if the edge inverts its node
+     */
+    static bool IsComplemented(int literal) { return (literal & 1) != 0; }
+
+    /**
+     * Get a node
+     * @param node Node number
+     * @return The node
+     */
+    const Node &GetNode(int node) const { return mNodes[node]; }
+
+    /**
+     * Get the total number of nodes, including constants and inputs
+     * @return Number of nodes
+     */
+    int GetNumNodes() const { return (int)mNodes.size(); }
+
+    /**
+     * Get the number of input nodes
+     * @return Number of inputs
+     */
+    int GetNumInputs() const { return mNumInputs; }
+};
+
+#endif //AIG_H
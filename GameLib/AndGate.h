@@ -18,16 +18,16 @@ class OutputPin;
 /**
  * Class for And gate
  */
-class AndGate : public Gates {
+class AndGate final : public Gates {
 private:
  /// wxGraphics path of gate
  wxGraphicsPath mPath;
  /// Pointer to Input Pin A
- std::shared_ptr<InputPin> mInputA;
+ ArenaHandle<InputPin> mInputA;
  /// Pointer to Input Pin B
- std::shared_ptr<InputPin> mInputB;
+ ArenaHandle<InputPin> mInputB;
  /// Pointer to Output Pin
- std::shared_ptr<OutputPin> mOutput;
+ ArenaHandle<OutputPin> mOutput;
 public:
  /**
   * Constructor for or gate
@@ -36,14 +36,54 @@ public:
  AndGate(Game *game);
 
  void ComputeOutput();
- void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+ void Draw(wxGraphicsContext *graphics) override;
  void OnClick(double x, double y) override; /// Questionable as to why it's here
  double getWidth() override;
  double getHeight() override;
- std::shared_ptr<IDraggable> HitDraggable(int x, int y) override;
+ IDraggable *HitDraggable(int x, int y) override;
  bool Connect(OutputPin *pin, wxPoint lineEnd) override;
  /// Updates Gate based on elapsed time
  void Update(double elapsed) override;
+ void SaveSnapshot(GameSnapshot &snapshot) const override;
+ void RestoreSnapshot(GameSnapshot &snapshot) override;
+
+ /**
+  * Accept a visitor
+  * @param visitor The visitor we accept
+  */
+ void Accept(ItemVisitor* visitor) override { visitor->VisitAndGate(this); }
+
+ /**
+  * Get input pin A
+  * @return The pin
+  */
+ InputPin *GetInputA() const { return Get(mInputA); }
+
+ /**
+  * Get input pin B
+  * @return The pin
+  */
+ InputPin *GetInputB() const { return Get(mInputB); }
+
+ /**
+  * Get the output pin
+  * @return The pin
+  */
+ OutputPin *GetOutput() const { return Get(mOutput); }
+
+ /**
+  * Get an input pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr
+  */
+ InputPin *GetInputPin(int index) const override { return index == 0 ? Get(mInputA) : index == 1 ? Get(mInputB) : nullptr; }
+
+ /**
+  * Get an output pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr
+  */
+ OutputPin *GetOutputPin(int index) const override { return index == 0 ? Get(mOutput) : nullptr; }
 
 };
 
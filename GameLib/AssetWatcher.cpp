@@ -0,0 +1,179 @@
+/**
+ * @file AssetWatcher.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "AssetWatcher.h"
+#include <wx/filename.h>
+#include "Game.h"
+#include "SpriteAtlas.h"
+#include "XmlPullParser.h"
+
+using namespace std;
+
+/// Directory the levels are loaded from
+const wxString LevelsDirectory = L"levels";
+
+/// Directory the sprite images are loaded from
+const wxString ImagesDirectory = L"images";
+
+/// Time the files must be quiet before reloading, in milliseconds
+const int SettleTime = 250;
+
+/**
+ * Constructor
+ * @param game The game whose assets are reloaded
+ * @param view Window the game is shown in
+ */
+AssetWatcher::AssetWatcher(Game *game, wxWindow *view) : mGame(game), mView(view)
+{
+    mSettleTimer.SetOwner(this);
+    Bind(wxEVT_TIMER, &AssetWatcher::OnSettled, this);
+    Bind(wxEVT_FSWATCHER, &AssetWatcher::OnChange, this);
+}
+
+/**
+ * Destructor
+ */
+AssetWatcher::~AssetWatcher()
+{
+    if (mWorker.joinable())
+    {
+        mWorker.join();
+    }
+}
+
+/**
+ * Start watching the asset directories. The event loop must be
+ * running, so call this once it is, as from CallAfter.
+ */
+void AssetWatcher::Start()
+{
+    mWatcher = make_unique<wxFileSystemWatcher>();
+    mWatcher->SetOwner(this);
+
+    for (const auto &name : {LevelsDirectory, ImagesDirectory})
+    {
+        auto directory = wxFileName::DirName(name);
+        directory.MakeAbsolute();
+        if (directory.DirExists())
+        {
+            mWatcher->Add(directory, wxFSW_EVENT_CREATE | wxFSW_EVENT_MODIFY | wxFSW_EVENT_RENAME | wxFSW_EVENT_DELETE);
+        }
+    }
+}
+
+/**
+ * Note a changed file and wait for the files to be quiet
+ * @param event File system watcher event
+ */
+void AssetWatcher::OnChange(wxFileSystemWatcherEvent &event)
+{
+    auto path = event.GetChangeType() == wxFSW_EVENT_RENAME ? event.GetNewPath() : event.GetPath();
+    auto extension = path.GetExt().Lower();
+    if (extension == L"xml")
+    {
+        mChangedLevels.insert(path.GetFullPath());
+    }
+    else if (extension == L"png")
+    {
+        mImagesChanged = true;
+    }
+    else
+    {
+        return;
+    }
+
+    mSettleTimer.StartOnce(SettleTime);
+}
+
+/**
+ * Read the changed files on a worker thread once they are quiet
+ * @param event Timer event
+ */
+void AssetWatcher::OnSettled(wxTimerEvent &event)
+{
+    if (mBusy)
+    {
+        // Try again once the last reload is in place
+        mSettleTimer.StartOnce(SettleTime);
+        return;
+    }
+
+    // Only the level being played is reloaded; others are read when picked
+    auto reload = make_shared<Reload>();
+    wxFileName current(mGame->GetLevelFile());
+    current.MakeAbsolute();
+    for (const auto &level : mChangedLevels)
+    {
+        if (!mGame->GetLevelFile().empty() && current.SameAs(wxFileName(level)))
+        {
+            reload->mLevelFile = mGame->GetLevelFile();
+        }
+    }
+    bool images = mImagesChanged;
+    mChangedLevels.clear();
+    mImagesChanged = false;
+
+    if (reload->mLevelFile.empty() && !images)
+    {
+        return;
+    }
+
+    if (mWorker.joinable())
+    {
+        mWorker.join();
+    }
+
+    // The atlas is only changed by Apply, which waits for the worker
+    SpriteAtlas *atlas = mGame->GetAtlas();
+    mBusy = true;
+    mWorker = thread([this, reload, images, atlas] {
+        if (!reload->mLevelFile.empty())
+        {
+            auto parser = make_unique<XmlPullParser>();
+            if (parser->Read(reload->mLevelFile) && parser->IsWellFormed())
+            {
+                reload->mParser = move(parser);
+            }
+        }
+
+        if (images)
+        {
+            reload->mAtlas = atlas->Rebuild(ImagesDirectory);
+        }
+
+        CallAfter([this, reload] { Apply(*reload); });
+    });
+}
+
+/**
+ * Put what a worker read in place, on the UI thread
+ * @param reload What the worker read
+ */
+void AssetWatcher::Apply(Reload &reload)
+{
+    mBusy = false;
+
+    if (reload.mAtlas != nullptr)
+    {
+        mGame->GetAtlas()->Swap(*reload.mAtlas);
+        wxLogStatus(L"Reloaded images");
+    }
+
+    if (!reload.mLevelFile.empty())
+    {
+        if (reload.mParser == nullptr)
+        {
+            wxLogStatus(L"Not reloading %ls: it is not well formed", reload.mLevelFile);
+        }
+        else if (reload.mLevelFile == mGame->GetLevelFile())
+        {
+            mGame->ReloadLevel(*reload.mParser);
+            wxLogStatus(L"Reloaded %ls", reload.mLevelFile);
+        }
+    }
+
+    mView->Refresh();
+}
@@ -0,0 +1,97 @@
+/**
+ * @file AssetWatcher.h
+ * @author matthew vazquez
+ *
+ * Reloads the current level and the sprite images when their files change.
+ */
+
+#ifndef ASSETWATCHER_H
+#define ASSETWATCHER_H
+
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <wx/fswatcher.h>
+#include <wx/timer.h>
+
+class Game;
+class SpriteAtlas;
+class XmlPullParser;
+
+/**
+ * Reloads the current level and the sprite images when their files change.
+ *
+ * Watches the levels and images directories. Editors write a file in
+ * several steps, so changes are gathered until the files have been
+ * quiet for a moment. Then a worker thread reads and checks the
+ * current level's file and decodes and packs the images, and the UI
+ * thread puts the results in place: the atlas's images are swapped so
+ * every item draws the new ones, and the level is loaded again the
+ * way picking it from the menu would, keeping the player's circuit.
+ * A level file that is not well formed is left alone until it is
+ * saved again.
+ *
+ * Reloads are not in the session log, so a session with them will
+ * not replay exactly.
+ */
+class AssetWatcher : public wxEvtHandler
+{
+private:
+    /**
+     * What a worker read, for the UI thread to put in place
+     */
+    struct Reload
+    {
+        /// Level file read, or empty if the current level did not change
+        std::wstring mLevelFile;
+
+        /// Parser over the level file's text, or null if it is not well formed
+        std::unique_ptr<XmlPullParser> mParser;
+
+        /// Images decoded and packed, or null if they did not change
+        std::unique_ptr<SpriteAtlas> mAtlas;
+    };
+
+    /// The game whose assets are reloaded
+    Game *mGame;
+
+    /// Window the game is shown in, redrawn after a reload
+    wxWindow *mView;
+
+    /// Watches the asset directories, null until started
+    std::unique_ptr<wxFileSystemWatcher> mWatcher;
+
+    /// Fires once the files have been quiet for a moment
+    wxTimer mSettleTimer;
+
+    /// Level files changed since the last reload
+    std::set<wxString> mChangedLevels;
+
+    /// True if any image changed since the last reload
+    bool mImagesChanged = false;
+
+    /// Thread reading the changed files
+    std::thread mWorker;
+
+    /// True while the worker's results have not been put in place
+    bool mBusy = false;
+
+    void OnChange(wxFileSystemWatcherEvent &event);
+    void OnSettled(wxTimerEvent &event);
+    void Apply(Reload &reload);
+
+public:
+    AssetWatcher(Game *game, wxWindow *view);
+    ~AssetWatcher() override;
+
+    /// Copy constructor (disabled)
+    AssetWatcher(const AssetWatcher &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AssetWatcher &) = delete;
+
+    void Start();
+};
+
+#endif //ASSETWATCHER_H
@@ -0,0 +1,232 @@
+/**
+ * @file BatchGrader.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "BatchGrader.h"
+#include <chrono>
+#include <iomanip>
+#include "CircuitSerializer.h"
+#include "Game.h"
+#include "ItemVisitor.h"
+#include "LevelLoader.h"
+#include "Product.h"
+#include "WorkStealingPool.h"
+#include "XmlPullParser.h"
+
+using namespace std;
+
+/**
+ * Visitor that counts how products were handled.
+ */
+class KickCounter : public ItemVisitor
+{
+private:
+    /// Number of products visited
+    int mProducts = 0;
+
+    /// Number of products kicked
+    int mKicked = 0;
+
+    /// Number of products kicked or passed as they should be
+    int mCorrect = 0;
+
+public:
+    /**
+     * Visit a product and count it
+     * @param product Product we are visiting
+     */
+    void VisitProduct(Product *product) override
+    {
+        mProducts++;
+        if (product->GetWasKicked())
+        {
+            mKicked++;
+        }
+        if (product->GetWasKicked() == product->GetKick())
+        {
+            mCorrect++;
+        }
+    }
+
+    /**
+     * Get the number of products visited
+     * @return Number of products
+     */
+    int GetProducts() const { return mProducts; }
+
+    /**
+     * Get the number of products kicked
+     * @return Number of kicked products
+     */
+    int GetKicked() const { return mKicked; }
+
+    /**
+     * Get the number of products handled correctly
+     * @return Number of correct products
+     */
+    int GetCorrect() const { return mCorrect; }
+};
+
+/**
+ * Make a CSV field from a string, quoting it if needed
+ * @param text Field text
+ * @return The field, UTF-8 encoded
+ */
+static string CsvField(const wstring &text)
+{
+    string field = wxString(text).utf8_string();
+    if (field.find_first_of(",\"\r\n") == string::npos)
+    {
+        return field;
+    }
+
+    string quoted = "\"";
+    for (auto c : field)
+    {
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/**
+ * Constructor
+ */
+BatchGrader::BatchGrader()
+{
+}
+
+/**
+ * Destructor
+ */
+BatchGrader::~BatchGrader()
+{
+}
+
+/**
+ * Add a job, loading its level and circuit into a new game.
+ * Call from the main thread, since loading creates bitmaps.
+ * @param level Level file to play
+ * @param circuit Circuit file to wire into the level, empty for none
+ * @return True if the level and circuit loaded. A job that does not
+ * load is still reported, but is not played.
+ */
+bool BatchGrader::AddJob(const std::wstring &level, const std::wstring &circuit)
+{
+    auto start = chrono::steady_clock::now();
+
+    Job job;
+    job.mResult.mLevel = level;
+    job.mResult.mCircuit = circuit;
+
+    // The level and circuit are read like a player's: the level by the
+    // level loader, then the circuit built in it by CircuitSerializer
+    XmlPullParser parser;
+    CircuitSerializer circuitFile;
+    if (parser.Open(level) && parser.IsWellFormed() && (circuit.empty() || circuitFile.Load(circuit)))
+    {
+        job.mGame = make_unique<Game>(mConfig);
+        LevelLoader loader;
+        loader.XmlLoad(parser, job.mGame.get());
+        if (!circuit.empty())
+        {
+            circuitFile.Apply(job.mGame.get());
+        }
+        job.mResult.mLoaded = true;
+    }
+
+    job.mResult.mLoadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    mJobs.push_back(move(job));
+    return mJobs.back().mResult.mLoaded;
+}
+
+/**
+ * Play every job that loaded, in parallel, and wait for them all.
+ * Games are released on the calling thread once played.
+ * @param pool Pool to play the jobs on
+ */
+void BatchGrader::Run(WorkStealingPool &pool)
+{
+    for (auto &job : mJobs)
+    {
+        if (job.mGame != nullptr)
+        {
+            Job *playing = &job;
+            pool.Submit([this, playing]() { Play(*playing); });
+        }
+    }
+    pool.Wait();
+
+    for (auto &job : mJobs)
+    {
+        job.mGame.reset();
+    }
+}
+
+/**
+ * Play one job until its level ends or the time limit is reached.
+ * The level starts like it does for a player: once the level notice
+ * is gone, the conveyor is started and the circuit does the rest.
+ * @param job Job to play
+ */
+void BatchGrader::Play(Job &job)
+{
+    auto start = chrono::steady_clock::now();
+
+    Game &game = *job.mGame;
+    auto &result = job.mResult;
+
+    while (game.GetState() == Game::State::Loading && result.mSimulatedTime < mTimeLimit)
+    {
+        game.Update(mTimeStep);
+        result.mSimulatedTime += mTimeStep;
+    }
+
+    game.StartConveyors();
+
+    while (game.GetState() != Game::State::Ended && result.mSimulatedTime < mTimeLimit)
+    {
+        game.Update(mTimeStep);
+        result.mSimulatedTime += mTimeStep;
+    }
+
+    KickCounter counter;
+    game.Accept(&counter);
+
+    // The level score moves to the game score, with the time bonus, when the level ends
+    result.mFinished = game.GetState() == Game::State::Ended;
+    result.mScore = game.GetScore()->GetGameScore() + game.GetScore()->GetLevelScore();
+    result.mProducts = counter.GetProducts();
+    result.mKicked = counter.GetKicked();
+    result.mCorrect = counter.GetCorrect();
+    result.mRunMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Write the outcome of every job as CSV, one row per job with a header row
+ * @param out Stream to write to
+ */
+void BatchGrader::WriteCsv(std::ostream &out) const
+{
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << fixed << setprecision(3);
+
+    out << "level,circuit,loaded,finished,score,products,kicked,correct,simulated_s,load_ms,run_ms\n";
+    for (const auto &job : mJobs)
+    {
+        const auto &result = job.mResult;
+        out << CsvField(result.mLevel) << ',' << CsvField(result.mCircuit) << ','
+            << (result.mLoaded ? 1 : 0) << ',' << (result.mFinished ? 1 : 0) << ','
+            << result.mScore << ',' << result.mProducts << ',' << result.mKicked << ',' << result.mCorrect << ','
+            << result.mSimulatedTime << ',' << result.mLoadMs << ',' << result.mRunMs << '\n';
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
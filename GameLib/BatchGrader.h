@@ -0,0 +1,155 @@
+/**
+ * @file BatchGrader.h
+ * @author matthew vazquez
+ *
+ * Plays many level and circuit pairs headless and collects their scores.
+ */
+
+#ifndef BATCHGRADER_H
+#define BATCHGRADER_H
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "GameConfig.h"
+
+class Game;
+class WorkStealingPool;
+
+/**
+ * Plays many level and circuit pairs headless and collects their scores.
+ *
+ * Each job is a level with a saved circuit wired into it, played by
+ * a Game of its own. Jobs are loaded on the calling thread, since
+ * loading creates bitmaps, then stepped with a fixed time step on a
+ * WorkStealingPool until the level ends. Games share no mutable
+ * state, so jobs run independently and throughput grows with the
+ * number of workers.
+ *
+ * A circuit file is one CircuitSerializer reads: an XML document whose
+ * root holds the gate and wire nodes a level's items node can hold.
+ * It is built in the level the way CircuitSerializer::Apply builds it.
+ */
+class BatchGrader
+{
+public:
+    /// Default simulation time step in seconds, one frame of the game view
+    static constexpr double DefaultTimeStep = 0.03;
+
+    /// Default limit on the simulated time of one job in seconds
+    static constexpr double DefaultTimeLimit = 300;
+
+    /**
+     * The outcome of playing one job
+     */
+    struct Result
+    {
+        /// Level file played
+        std::wstring mLevel;
+
+        /// Circuit file wired into the level, empty for none
+        std::wstring mCircuit;
+
+        /// True if the level and circuit loaded
+        bool mLoaded = false;
+
+        /// True if the level ended before the time limit
+        bool mFinished = false;
+
+        /// Score for the level, including the time bonus once it ends
+        int mScore = 0;
+
+        /// Number of products in the level
+        int mProducts = 0;
+
+        /// Number of products Sparty kicked
+        int mKicked = 0;
+
+        /// Number of products kicked or passed as they should be
+        int mCorrect = 0;
+
+        /// Simulated time in seconds
+        double mSimulatedTime = 0;
+
+        /// Wall time spent loading in milliseconds
+        double mLoadMs = 0;
+
+        /// Wall time spent playing in milliseconds
+        double mRunMs = 0;
+    };
+
+private:
+    /**
+     * A job waiting to be played
+     */
+    struct Job
+    {
+        /// The game playing the job, released once played
+        std::unique_ptr<Game> mGame;
+
+        /// Where the outcome goes
+        Result mResult;
+    };
+
+    /// Jobs in the order they were added
+    std::vector<Job> mJobs;
+
+    /// Settings every game is created with
+    GameConfig mConfig;
+
+    /// Simulation time step in seconds
+    double mTimeStep = DefaultTimeStep;
+
+    /// Limit on the simulated time of one job in seconds
+    double mTimeLimit = DefaultTimeLimit;
+
+    void Play(Job &job);
+
+public:
+    BatchGrader();
+    ~BatchGrader();
+
+    /// Copy constructor (disabled)
+    BatchGrader(const BatchGrader &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const BatchGrader &) = delete;
+
+    bool AddJob(const std::wstring &level, const std::wstring &circuit);
+    void Run(WorkStealingPool &pool);
+    void WriteCsv(std::ostream &out) const;
+
+    /**
+     * Set the settings games for later jobs are created with
+     * @param config Game settings
+     */
+    void SetConfig(const GameConfig &config) { mConfig = config; }
+
+    /**
+     * Set the simulation time step
+     * @param step Time step in seconds
+     */
+    void SetTimeStep(double step) { mTimeStep = step; }
+
+    /**
+     * Set the limit on the simulated time of one job
+     * @param limit Limit in seconds
+     */
+    void SetTimeLimit(double limit) { mTimeLimit = limit; }
+
+    /**
+     * Get the number of jobs added
+     * @return Number of jobs
+     */
+    int GetNumJobs() const { return (int)mJobs.size(); }
+
+    /**
+     * Get the outcome of a job
+     * @param job Job index, in the order added
+     * @return The outcome, filled in once Run returns
+     */
+    const Result &GetResult(int job) const { return mJobs[job].mResult; }
+};
+
+#endif //BATCHGRADER_H
@@ -10,9 +10,13 @@
 #include "Game.h"
 #include "ItemVisitor.h"
 #include "Product.h"
+#include "ProductionLine.h"
 #include "Sensor.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
 #include <unordered_map>
 #include "Gates.h"
+#include "XmlPullParser.h"
 
 /// Image for the beam sender and receiver when red
 const std::wstring BeamRedImage = L"beam-red.png";
@@ -41,33 +45,6 @@ private:
 	/// Pointer to the product that collides
 	Product* mCollidingProduct;
 
-	/**
-	 * Checks if a product collides with the beam
-	 *
-	 * @param product Pointer to the product
-	 * @return True if collision occurs, false if not
-	 */
-	bool CheckCollisionWithProduct(Product* product)
-	{
-		double beamXStart = mBeam->GetX() + mBeam->GetSenderOffset();
-		double beamXEnd = mBeam->GetX();
-		double beamY = mBeam->GetY();
-
-		double rectX = min(beamXStart, beamXEnd);
-		double rectWidth = abs(beamXEnd - beamXStart);
-		double rectY = beamY - 1;
-		double rectHeight = 2.0;
-
-		wxRect2DDouble beamRect(rectX, rectY, rectWidth, rectHeight);
-
-		double productSize = product->GetSize();
-		double productX = product->GetX() - productSize / 2;
-		double productY = product->GetY() - productSize / 2;
-		wxRect2DDouble productRect(productX, productY, productSize, productSize);
-
-		return beamRect.Intersects(productRect);
-	}
-
 public:
 	/**
 	 * Constructs a CollisionVisitor
@@ -81,7 +58,7 @@ public:
 	 */
 	void VisitProduct(Product* product) override
 	{
-		if (CheckCollisionWithProduct(product))
+		if (!product->IsParked() && mBeam->IsProductInBeam(product))
 		{
 			mBeamBroken = true;
 			mCollidingProduct = product;
@@ -166,34 +143,58 @@ wstring PropertyToString(Product::Properties property)
 	}
 }
 
+/**
+ * Checks if a product breaks the beam
+ * @param product Pointer to the product
+ * @return True if the product crosses the beam, false if not
+ */
+bool Beam::IsProductInBeam(Product* product) const
+{
+	double beamXStart = GetX() + mSenderOffset;
+	double beamXEnd = GetX();
+	double beamY = GetY();
+
+	double rectX = min(beamXStart, beamXEnd);
+	double rectWidth = abs(beamXEnd - beamXStart);
+	double rectY = beamY - 1;
+	double rectHeight = 2.0;
+
+	wxRect2DDouble beamRect(rectX, rectY, rectWidth, rectHeight);
+
+	double productSize = product->GetSize();
+	double productX = product->GetX() - productSize / 2;
+	double productY = product->GetY() - productSize / 2;
+	wxRect2DDouble productRect(productX, productY, productSize, productSize);
+
+	return beamRect.Intersects(productRect);
+}
+
 /**
  * Constructs a Beam object and loads images
  * @param game Pointer to the game instance
  */
 Beam::Beam(Game* game): Item(game)
 {
-    // Load images
-	mBeamImageGreen = make_shared<wxImage>(L"images/beam-green.png", wxBITMAP_TYPE_PNG);
-	mBeamBitmapGreen = make_shared<wxBitmap>(*mBeamImageGreen);
-
-	mBeamImageRed = make_shared<wxImage>(L"images/beam-red.png", wxBITMAP_TYPE_PNG);
-	mBeamBitmapRed = make_shared<wxBitmap>(*mBeamImageRed);
-
+    // Find images
+	mBeamSpriteGreen = game->GetAtlas()->Find(BeamGreenImage);
+	mBeamSpriteRed = game->GetAtlas()->Find(BeamRedImage);
 
 	wxPoint point(GetX(), GetY());
 
-	mBeamPin = make_shared<OutputPin>(this, point);
-	mBeamPin->ChangeDefaultLineLength(BeamPinOffset);
+	mBeamPin = CreatePart<OutputPin>(this, point);
+	Get(mBeamPin)->ChangeDefaultLineLength(BeamPinOffset);
 }
 
 /**
  * Draws the beam with appropriate color based on its state
  * @param graphics the graphics context to draw on
  */
-void Beam::Draw(shared_ptr<wxGraphicsContext> graphics)
+void Beam::Draw(wxGraphicsContext *graphics)
 {
 	// Choose image based on beam state
-	auto beamBitmap = mBeamBroken ? mBeamBitmapRed : mBeamBitmapGreen;
+	auto atlas = GetGame()->GetAtlas();
+	auto sprites = GetGame()->GetSprites();
+	auto beamSprite = mBeamBroken ? mBeamSpriteRed : mBeamSpriteGreen;
 
 	// Draw beam line between sender and receiver
 	wxPen laser1(wxColour(255, 200, 200, 100), 8);
@@ -207,27 +208,24 @@ void Beam::Draw(shared_ptr<wxGraphicsContext> graphics)
 	graphics->SetPen(laser2);
 	graphics->StrokeLine(GetX() + mSenderOffset, GetY(), GetX(), GetY());
 
-	double width = beamBitmap->GetWidth();
-	double height = beamBitmap->GetHeight();
-
-	double receiverX, receiverY;
-	double pinX, pinY;
+	double width = atlas->GetSize(beamSprite).GetWidth();
+	double height = atlas->GetSize(beamSprite).GetHeight();
 
 	// Determine if the sender is on the left or right
 	if (mSenderOffset < 0)
 	{
 		// Sender is on the left
 
-		mBeamPin->Draw(graphics);
+		Get(mBeamPin)->Draw(graphics);
 
 		// Draw sender image without flipping
-		graphics->DrawBitmap(*beamBitmap, GetX() + mSenderOffset - width / 2, GetY() - height / 2, width, height);
+		sprites->Draw(graphics, beamSprite, GetX() + mSenderOffset - width / 2, GetY() - height / 2, width, height);
 
 		// Draw receiver image flipped horizontally
 		graphics->PushState();
 		graphics->Translate(GetX(), GetY());
 		graphics->Scale(-1, 1);
-		graphics->DrawBitmap(*beamBitmap, -width / 2, -height / 2, width, height);
+		sprites->Draw(graphics, beamSprite, -width / 2, -height / 2, width, height);
 		graphics->PopState();
 	}
 	else
@@ -237,24 +235,22 @@ void Beam::Draw(shared_ptr<wxGraphicsContext> graphics)
 		graphics->PushState();
 		graphics->Translate(GetX() + mSenderOffset, GetY());
 		graphics->Scale(-1, 1);
-		graphics->DrawBitmap(*beamBitmap, -width / 2, -height / 2, width, height);
+		sprites->Draw(graphics, beamSprite, -width / 2, -height / 2, width, height);
 		graphics->PopState();
 
 		// Draw receiver image without flipping
-		graphics->DrawBitmap(*beamBitmap, GetX() - width / 2, GetY() - height / 2, width, height);
+		sprites->Draw(graphics, beamSprite, GetX() - width / 2, GetY() - height / 2, width, height);
 	}
 }
 
 /**
- * Loads beam data from an XML node
- * @param node The XML node containing beam data
+ * Load the beam from a level being read
+ * @param parser Parser on the beam's start element
  */
-void Beam::XmlLoad(wxXmlNode* node)
+void Beam::XmlLoad(XmlPullParser &parser)
 {
-	Item::XmlLoad(node);
-
-	wxString senderStr = node->GetAttribute(L"sender", L"0");
-	senderStr.ToDouble(&mSenderOffset);
+	Item::XmlLoad(parser);
+	mSenderOffset = parser.GetDouble("sender", 0);
 }
 
 /**
@@ -277,7 +273,7 @@ void Beam::Update(double elapsed)
 {
 	CollisionVisitor visitor(this);
 
-	GetGame()->Accept(&visitor);
+	AcceptLine(&visitor);
 
 	mBeamBroken = visitor.IsBeamBroken();
 
@@ -295,18 +291,26 @@ void Beam::Update(double elapsed)
 			// If product was supposed to be kicked, but passed through beam, give bad score.
 			if (mLastProduct->GetKick())
 			{
-				GetGame()->GetScore()->SetLevelScoreBad();
+				ScoreBad();
 			}
 			// If product passed through beam but shouldn't have been kicked, award good score.
 			else
 			{
-				GetGame()->GetScore()->SetLevelScoreGood();
+				ScoreGood();
 			}
 			mLastProduct->SetScoreUpdated(); // Set score as updated so it doesn't happen more than once.
 		}
 		mLastProduct = nullptr;
 
-		if (mNumBroken == GetGame()->GetNumProducts())
+		// The level ends once every line is finished
+		if (GetLine() != nullptr)
+		{
+			if (mNumBroken == GetLine()->GetNumProducts())
+			{
+				GetLine()->Finish();
+			}
+		}
+		else if (mNumBroken == GetGame()->GetNumProducts())
 		{
 			GetGame()->EndGame();
 		}
@@ -319,14 +323,14 @@ void Beam::Update(double elapsed)
 
 	if (mBeamBroken)
 	{
-		mBeamPin->SetState(States::One);
+		Get(mBeamPin)->SetState(States::One);
 	} else
 	{
-		mBeamPin->SetState(States::Zero);
+		Get(mBeamPin)->SetState(States::Zero);
 	}
 
 	mWasBroken = mBeamBroken;
-	mBeamPin->Update();
+	Get(mBeamPin)->Update();
 }
 
 /**
@@ -335,11 +339,11 @@ void Beam::Update(double elapsed)
  * @param y Y location clicked on
  * @return Whatever we clicked on or NULL if none
  */
-std::shared_ptr<IDraggable> Beam::HitDraggable(int x, int y)
+IDraggable *Beam::HitDraggable(int x, int y)
 {
-	if(mBeamPin->HitTest(x, y))
+	if(Get(mBeamPin)->HitTest(x, y))
 	{
-		return mBeamPin;
+		return Get(mBeamPin);
 	}
 
 	return nullptr;
@@ -352,4 +356,32 @@ void Beam::ResetCount()
 {
 	mNumBroken = 0;
 	mWasBroken = false;
-}
\ No newline at end of file
+}
+
+/**
+ * Save the beam's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void Beam::SaveSnapshot(GameSnapshot &snapshot) const
+{
+	Item::SaveSnapshot(snapshot);
+	snapshot.Write(mBeamBroken);
+	snapshot.Write(mWasBroken);
+	snapshot.Write(mNumBroken);
+	snapshot.Write(mLastProduct);
+	Get(mBeamPin)->SaveSnapshot(snapshot);
+}
+
+/**
+ * Restore the beam's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Beam::RestoreSnapshot(GameSnapshot &snapshot)
+{
+	Item::RestoreSnapshot(snapshot);
+	snapshot.Read(mBeamBroken);
+	snapshot.Read(mWasBroken);
+	snapshot.Read(mNumBroken);
+	snapshot.Read(mLastProduct);
+	Get(mBeamPin)->RestoreSnapshot(snapshot);
+}
@@ -12,26 +12,22 @@
 #include "OutputPin.h"
 #include <memory>
 
+class Product;
+
 /**
  * Class representing a beam in the game
  */
-class Beam : public Item
+class Beam final : public Item
 {
 private:
 	/// Offset for the sender relative to receiver
 	double mSenderOffset = 0.0;
 
-	/// Image for the green beam
-	std::shared_ptr<wxImage> mBeamImageGreen;
-
-	/// Bitmap for the green beam
-	std::shared_ptr<wxBitmap> mBeamBitmapGreen;
-
-	/// Image for the red beam
-	std::shared_ptr<wxImage> mBeamImageRed;
+	/// Sprite for the green beam
+	int mBeamSpriteGreen = -1;
 
-	/// Bitmap for the red beam
-	std::shared_ptr<wxBitmap> mBeamBitmapRed;
+	/// Sprite for the red beam
+	int mBeamSpriteRed = -1;
 
 	/// Indicates whether the beam is broken
 	bool mBeamBroken = false;
@@ -46,14 +42,14 @@ private:
 	Product* mLastProduct;
 
 	/// Pin representing the beam's state
-	std::shared_ptr<OutputPin> mBeamPin;
+	ArenaHandle<OutputPin> mBeamPin;
 
 public:
 	Beam(Game* game);
 
-	void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+	void Draw(wxGraphicsContext *graphics) override;
 
-	void XmlLoad(wxXmlNode* node) override;
+	void XmlLoad(XmlPullParser &parser) override;
 
 	void OnClick(double x, double y) override;
 
@@ -64,6 +60,8 @@ public:
     void Accept(ItemVisitor* visitor) override { visitor->VisitBeam(this); }
 
 	void Update(double elapsed) override;
+	void SaveSnapshot(GameSnapshot &snapshot) const override;
+	void RestoreSnapshot(GameSnapshot &snapshot) override;
 
 	/**
 	 * Gets the sender offset value
@@ -79,13 +77,14 @@ public:
 
 	/**
 	 * Getter for beam's output pin
-	 * @return Shared pointer to the OutputPin
+	 * @return The OutputPin
 	 */
-	std::shared_ptr<OutputPin> GetOutputPin() const { return mBeamPin; }
+	OutputPin *GetOutputPin() const { return Get(mBeamPin); }
 
-	std::shared_ptr<IDraggable> HitDraggable(int x, int y) override;
+	IDraggable *HitDraggable(int x, int y) override;
 
 	void ResetCount();
+	bool IsProductInBeam(Product* product) const;
 };
 
 
@@ -0,0 +1,114 @@
+/**
+ * @file BinaryCoding.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "BinaryCoding.h"
+
+using namespace std;
+
+/**
+ * Write an unsigned integer, seven bits per byte
+ * @param out Stream to write to
+ * @param value Value to write
+ */
+void WriteVarint(ostream &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.put(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.put(char(value));
+}
+
+/**
+ * Read an unsigned integer written by WriteVarint
+ * @param in Stream to read from
+ * @param value Receives the value
+ * @return True if a value was read
+ */
+bool ReadVarint(istream &in, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int c = in.get();
+        if (c == EOF)
+        {
+            return false;
+        }
+
+        value |= uint64_t(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Write a signed integer, small magnitudes in few bytes
+ * @param out Stream to write to
+ * @param value Value to write
+ */
+void WriteSigned(ostream &out, int value)
+{
+    WriteVarint(out, (uint32_t(value) << 1) ^ uint32_t(value >> 31));
+}
+
+/**
+ * Read a signed integer written by WriteSigned
+ * @param in Stream to read from
+ * @param value Receives the value
+ * @return True if a value was read
+ */
+bool ReadSigned(istream &in, int &value)
+{
+    uint64_t raw;
+    if (!ReadVarint(in, raw))
+    {
+        return false;
+    }
+
+    value = int(uint32_t(raw >> 1) ^ -uint32_t(raw & 1));
+    return true;
+}
+
+/**
+ * Write a string as its UTF-8 length and bytes
+ * @param out Stream to write to
+ * @param text String to write
+ */
+void WriteString(ostream &out, const wstring &text)
+{
+    auto utf8 = wxString(text).utf8_string();
+    WriteVarint(out, utf8.size());
+    out.write(utf8.data(), utf8.size());
+}
+
+/**
+ * Read a string written by WriteString
+ * @param in Stream to read from
+ * @param text Receives the string
+ * @return True if a string was read
+ */
+bool ReadString(istream &in, wstring &text)
+{
+    uint64_t length;
+    if (!ReadVarint(in, length) || length > 0xffff)
+    {
+        return false;
+    }
+
+    string utf8(length, '\0');
+    if (!in.read(&utf8[0], length))
+    {
+        return false;
+    }
+
+    text = wxString::FromUTF8(utf8.data(), utf8.size()).ToStdWstring();
+    return true;
+}
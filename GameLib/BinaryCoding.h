@@ -0,0 +1,23 @@
+/**
+ * @file BinaryCoding.h
+ * @author matthew vazquez
+ *
+ * Compact integer and string encodings shared by the binary file formats.
+ */
+
+#ifndef BINARYCODING_H
+#define BINARYCODING_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+void WriteVarint(std::ostream &out, uint64_t value);
+bool ReadVarint(std::istream &in, uint64_t &value);
+void WriteSigned(std::ostream &out, int value);
+bool ReadSigned(std::istream &in, int &value);
+void WriteString(std::ostream &out, const std::wstring &text);
+bool ReadString(std::istream &in, std::wstring &text);
+
+#endif //BINARYCODING_H
@@ -0,0 +1,219 @@
+/**
+ * @file BusConnector.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "BusConnector.h"
+#include <algorithm>
+#include "Game.h"
+#include "InputPin.h"
+#include "OutputPin.h"
+
+/// Width of the connector bar in pixels
+const int BusConnectorWidth = 16;
+
+/// Smallest height of the connector bar in pixels
+const int BusConnectorMinHeight = 50;
+
+/// Vertical distance between the single wire pins in pixels
+const int BusPinSpacing = 25;
+
+/**
+ * Constructor
+ * @param game The game this connector is in
+ * @param kind Join single wires into a bus, or split a bus
+ * @param width Number of bits in the bus, clamped to MinWidth to MaxWidth
+ */
+BusConnector::BusConnector(Game *game, Kind kind, int width) : Gates(game), mKind(kind)
+{
+    width = std::clamp(width, MinWidth, MaxWidth);
+
+    auto w = BusConnectorWidth;
+    auto h = std::max(BusConnectorMinHeight, width * BusPinSpacing);
+
+    // The single wires are spread down one side, the bus is at the middle of the other
+    int singles = kind == Kind::Join ? width : 1;
+    for (int i = 0; i < singles; i++)
+    {
+        int y = kind == Kind::Join ? -h / 2 + BusPinSpacing / 2 + i * BusPinSpacing : 0;
+        auto pin = CreatePart<InputPin>(this, wxPoint(-w / 2, y));
+        Get(pin)->SetState(States::Unknown);
+        Get(pin)->SetBusWidth(kind == Kind::Join ? 1 : width);
+        mInputs.push_back(pin);
+    }
+
+    int outputs = kind == Kind::Split ? width : 1;
+    for (int i = 0; i < outputs; i++)
+    {
+        int y = kind == Kind::Split ? -h / 2 + BusPinSpacing / 2 + i * BusPinSpacing : 0;
+        auto pin = CreatePart<OutputPin>(this, wxPoint(w / 2, y));
+        Get(pin)->SetState(States::Unknown);
+        Get(pin)->SetBusWidth(kind == Kind::Split ? 1 : width);
+        mOutputs.push_back(pin);
+    }
+}
+
+/**
+ * Compute the outputs from the input pins
+ */
+void BusConnector::ComputeOutput()
+{
+    if (mKind == Kind::Join)
+    {
+        LogicWord bus;
+        for (int i = 0; i < (int)mInputs.size(); i++)
+        {
+            bus.SetLane(i, Get(mInputs[i])->GetState());
+        }
+        Get(mOutputs[0])->SetBus(bus);
+    }
+    else
+    {
+        auto bus = Get(mInputs[0])->GetBus();
+        for (int i = 0; i < (int)mOutputs.size(); i++)
+        {
+            Get(mOutputs[i])->SetState(bus.Lane(i));
+        }
+    }
+}
+
+/**
+ * Draw the connector as a solid bar
+ * @param graphics Graphics context to draw on
+ */
+void BusConnector::Draw(wxGraphicsContext *graphics)
+{
+    for (auto &pin : mInputs)
+    {
+        Get(pin)->Draw(graphics);
+    }
+    for (auto &pin : mOutputs)
+    {
+        Get(pin)->Draw(graphics);
+    }
+
+    auto w = getWidth();
+    auto h = getHeight();
+
+    graphics->SetPen(*wxBLACK_PEN);
+    graphics->SetBrush(*wxBLACK_BRUSH);
+
+    auto path = graphics->CreatePath();
+    path.AddRectangle(GetX() - w / 2, GetY() - h / 2, w, h);
+    path.CloseSubpath();
+    graphics->DrawPath(path);
+}
+
+/**
+ * Handle updates for animation
+ * @param elapsed The time since the last update
+ */
+void BusConnector::Update(double elapsed)
+{
+    for (auto &pin : mOutputs)
+    {
+        Get(pin)->Update();
+    }
+    ComputeOutput();
+}
+
+/**
+ * Handle a click on the item
+ * @param x X location clicked on
+ * @param y Y location clicked on
+ */
+void BusConnector::OnClick(double x, double y)
+{
+    ComputeOutput();
+}
+
+/**
+ * Get the connector width
+ * @return Width in pixels
+ */
+double BusConnector::getWidth()
+{
+    return BusConnectorWidth;
+}
+
+/**
+ * Get the connector height, which grows with the bus width
+ * @return Height in pixels
+ */
+double BusConnector::getHeight()
+{
+    return std::max(BusConnectorMinHeight, GetBusWidth() * BusPinSpacing);
+}
+
+/**
+ * Test to see if we clicked on some draggable inside the item.
+ * @param x X location clicked on
+ * @param y Y location clicked on
+ * @return Whatever we clicked on or NULL if none
+ */
+IDraggable *BusConnector::HitDraggable(int x, int y)
+{
+    for (auto &pin : mOutputs)
+    {
+        if (Get(pin)->HitTest(x, y))
+        {
+            return Get(pin);
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Tests if an output pin has an input pin to connect to
+ * @param pin The pin that is connected
+ * @param lineEnd The spot of the mouse
+ * @return True if there is a pin to be connected to
+ */
+bool BusConnector::Connect(OutputPin *pin, wxPoint lineEnd)
+{
+    for (auto &input : mInputs)
+    {
+        if (Get(input)->Catch(pin, lineEnd))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Save the connector's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void BusConnector::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Gates::SaveSnapshot(snapshot);
+    for (const auto &input : mInputs)
+    {
+        Get(input)->SaveSnapshot(snapshot);
+    }
+    for (const auto &output : mOutputs)
+    {
+        Get(output)->SaveSnapshot(snapshot);
+    }
+}
+
+/**
+ * Restore the connector's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void BusConnector::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Gates::RestoreSnapshot(snapshot);
+    for (auto &input : mInputs)
+    {
+        Get(input)->RestoreSnapshot(snapshot);
+    }
+    for (auto &output : mOutputs)
+    {
+        Get(output)->RestoreSnapshot(snapshot);
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file BusConnector.h
+ * @author matthew vazquez
+ *
+ * Joins single wires into a bus, or splits a bus into single wires.
+ */
+
+#ifndef BUSCONNECTOR_H
+#define BUSCONNECTOR_H
+
+#include <vector>
+#include "Gates.h"
+
+class InputPin;
+class OutputPin;
+
+/**
+ * Joins single wires into a bus, or splits a bus into single wires.
+ *
+ * A join has one input pin per bit and a bus output pin; input i
+ * becomes bit i of the bus. A split has a bus input pin and one
+ * output pin per bit. Between a join and a split, the bits travel on
+ * one wire and through bus-width gates that compute every bit at
+ * once. Wires only connect pins that carry the same number of bits.
+ */
+class BusConnector final : public Gates {
+public:
+ /// Which way the connector converts
+ enum class Kind {Join, Split};
+
+ /// Fewest bits a bus carries
+ static const int MinWidth = 2;
+
+ /// Most bits a bus carries, one per lane of a LogicWord
+ static const int MaxWidth = 64;
+
+private:
+ /// Which way the connector converts
+ Kind mKind;
+
+ /// Input pins, from the top
+ std::vector<ArenaHandle<InputPin>> mInputs;
+
+ /// Output pins, from the top
+ std::vector<ArenaHandle<OutputPin>> mOutputs;
+
+public:
+ BusConnector(Game *game, Kind kind, int width);
+
+ void ComputeOutput();
+ void Draw(wxGraphicsContext *graphics) override;
+ void OnClick(double x, double y) override;
+ double getWidth() override;
+ double getHeight() override;
+ IDraggable *HitDraggable(int x, int y) override;
+ bool Connect(OutputPin *pin, wxPoint lineEnd) override;
+ void Update(double elapsed) override;
+ void SaveSnapshot(GameSnapshot &snapshot) const override;
+ void RestoreSnapshot(GameSnapshot &snapshot) override;
+
+ /**
+  * Accept a visitor
+  * @param visitor The visitor we accept
+  */
+ void Accept(ItemVisitor* visitor) override { visitor->VisitBusConnector(this); }
+
+ /**
+  * Get which way the connector converts
+  * @return Join or Split
+  */
+ Kind GetKind() const { return mKind; }
+
+ /**
+  * Get the number of bits in the bus
+  * @return Bus width
+  */
+ int GetBusWidth() const { return (int)(mKind == Kind::Join ? mInputs.size() : mOutputs.size()); }
+
+ /**
+  * Get an input pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr
+  */
+ InputPin *GetInputPin(int index) const override
+ {
+  return index >= 0 && index < (int)mInputs.size() ? Get(mInputs[index]) : nullptr;
+ }
+
+ /**
+  * Get an output pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr
+  */
+ OutputPin *GetOutputPin(int index) const override
+ {
+  return index >= 0 && index < (int)mOutputs.size() ? Get(mOutputs[index]) : nullptr;
+ }
+};
+
+#endif //BUSCONNECTOR_H
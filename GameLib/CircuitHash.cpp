@@ -0,0 +1,144 @@
+/**
+ * @file CircuitHash.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "CircuitHash.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Constructor. Hashes every net in the netlist.
+ * @param netlist Circuit to hash
+ */
+CircuitHash::CircuitHash(const Netlist &netlist)
+{
+    const auto &cells = netlist.GetCells();
+
+    mNetHashes.assign(netlist.GetNumNets(), 0);
+    for (int net = 0; net < netlist.GetNumInputs(); net++)
+    {
+        mNetHashes[net] = Combine(HashString(L"input"), HashString(netlist.GetInputName(net)));
+    }
+
+    for (const auto &cell : cells)
+    {
+        mNetHashes[cell.mOutput] = Combine((uint64_t)cell.mType, 0);
+        if (cell.mOutputNot != Netlist::Unconnected)
+        {
+            mNetHashes[cell.mOutputNot] = Combine((uint64_t)cell.mType, 1);
+        }
+    }
+
+    int maxRounds = max(MinRounds, (int)cells.size() + 1);
+    auto next = mNetHashes;
+    for (int round = 0; round < maxRounds; round++)
+    {
+        for (const auto &cell : cells)
+        {
+            vector<uint64_t> inputs;
+            for (int net : cell.mInputs)
+            {
+                inputs.push_back(GetNetHash(net));
+            }
+
+            if (cell.mType != Netlist::CellType::Not && !netlist.IsSequential(cell.mType))
+            {
+                sort(inputs.begin(), inputs.end());
+            }
+
+            uint64_t hash = Mix((uint64_t)cell.mType + 1);
+            for (auto input : inputs)
+            {
+                hash = Combine(hash, input);
+            }
+
+            next[cell.mOutput] = Combine(hash, 0);
+            if (cell.mOutputNot != Netlist::Unconnected)
+            {
+                next[cell.mOutputNot] = Combine(hash, 1);
+            }
+        }
+
+        bool changed = next != mNetHashes;
+        mNetHashes = next;
+        if (!changed)
+        {
+            break;
+        }
+    }
+
+    mKickHash = Combine(HashString(L"kick"), GetNetHash(netlist.GetKickNet()));
+}
+
+/**
+ * Scramble a 64-bit value (the splitmix64 finalizer)
+ * @param value Value to scramble
+ * @return Scrambled value
+ */
+uint64_t CircuitHash::Mix(uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+/**
+ * Combine a value into a running hash. Order matters.
+ * @param seed Hash so far
+ * @param value Value to add
+ * @return New hash
+ */
+uint64_t CircuitHash::Combine(uint64_t seed, uint64_t value)
+{
+    return Mix(seed ^ (Mix(value) + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * Hash a name
+ * @param text Name to hash
+ * @return Hash of the name
+ */
+uint64_t CircuitHash::HashString(const wstring &text)
+{
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (auto c : text)
+    {
+        hash = (hash ^ (uint64_t)c) * 0x100000001B3ull;
+    }
+
+    return Mix(hash);
+}
+
+/**
+ * Hash a product list the way the verifier sees it: the
+ * order of the products matters, the order of each product's
+ * properties does not.
+ * @param products Products in the order they reach the sensor
+ * @return Hash of the list
+ */
+uint64_t CircuitHash::HashProducts(const vector<CircuitVerifier::ProductSpec> &products)
+{
+    uint64_t hash = Mix(products.size());
+    for (const auto &product : products)
+    {
+        vector<uint64_t> properties;
+        for (const auto &property : product.mProperties)
+        {
+            properties.push_back(HashString(property));
+        }
+        sort(properties.begin(), properties.end());
+
+        hash = Combine(hash, product.mKick ? 1 : 2);
+        for (auto property : properties)
+        {
+            hash = Combine(hash, property);
+        }
+    }
+
+    return hash;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file CircuitHash.h
+ * @author matthew vazquez
+ *
+ * Canonical structural hashes of the nets in a Netlist.
+ */
+
+#ifndef CIRCUITHASH_H
+#define CIRCUITHASH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CircuitVerifier.h"
+#include "Netlist.h"
+
+/**
+ * Canonical structural hashes of the nets in a Netlist.
+ *
+ * A net's hash describes the whole sub-circuit that drives it: the
+ * input names at its leaves, the gate types and how they are wired.
+ * It does not depend on the order cells were added or, for AND and
+ * OR, on which pin each operand is wired to, so the same logic built
+ * by different players hashes the same.
+ *
+ * Hashes are refined one gate level per round until they stop
+ * changing. Circuits with feedback never settle, so refinement stops
+ * after a fixed number of rounds; identical feedback circuits still
+ * hash identically.
+ */
+class CircuitHash
+{
+public:
+    /// Refinement rounds used for circuits with feedback
+    static const int MinRounds = 64;
+
+private:
+    /// Hash of every net
+    std::vector<uint64_t> mNetHashes;
+
+    /// Hash used for the kick net
+    uint64_t mKickHash = 0;
+
+public:
+    CircuitHash(const Netlist &netlist);
+
+    /**
+     * Get the hash of the sub-circuit driving a net
+     * @param net Net number, may be Netlist::Unconnected
+     * @return Canonical hash
+     */
+    uint64_t GetNetHash(int net) const { return net == Netlist::Unconnected ? Unconnected() : mNetHashes[net]; }
+
+    /**
+     * Get the hash of the sub-circuit wired into Sparty
+     * @return Canonical hash
+     */
+    uint64_t GetKickHash() const { return mKickHash; }
+
+    static uint64_t Mix(uint64_t value);
+    static uint64_t Combine(uint64_t seed, uint64_t value);
+    static uint64_t HashString(const std::wstring &text);
+    static uint64_t HashProducts(const std::vector<CircuitVerifier::ProductSpec> &products);
+
+    /**
+     * Hash given to unconnected pins
+     * @return Fixed hash value
+     */
+    static uint64_t Unconnected() { return 0x5D5A1A7E0C0FFEE5ull; }
+};
+
+#endif //CIRCUITHASH_H
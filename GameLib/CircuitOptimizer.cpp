@@ -0,0 +1,279 @@
+/**
+ * @file CircuitOptimizer.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "CircuitOptimizer.h"
+#include <functional>
+
+/// Marks a net whose literal has not been found yet
+const int Unresolved = -1;
+
+/**
+ * Constructor. Optimizes the circuit.
+ * @param netlist Circuit to optimize. Must outlive the optimizer.
+ */
+CircuitOptimizer::CircuitOptimizer(const Netlist &netlist) : mNetlist(netlist)
+{
+    std::vector<int> latchInputs;
+    int kick = Aig::Unknown;
+    if (!BuildAig(latchInputs, kick))
+    {
+        mOptimized = mNetlist;
+        mNumAnds = GetOriginalGates() - mNetlist.GetNumLatches();
+        return;
+    }
+
+    std::vector<int> outputs = latchInputs;
+    outputs.push_back(kick);
+    mNumAnds = mAig.CountAnds(outputs);
+
+    for (int net = 0; net < mNetlist.GetNumInputs(); net++)
+    {
+        mLeafNets.push_back(mOptimized.AddInput(mNetlist.GetInputName(net)));
+    }
+
+    // Flip flops keep their order so Reset enumerates the same states
+    std::vector<int> latches;
+    for (const auto &cell : mNetlist.GetCells())
+    {
+        if (mNetlist.IsSequential(cell.mType))
+        {
+            int latch = mOptimized.AddCell(cell.mType);
+            latches.push_back(latch);
+            mLeafNets.push_back(mOptimized.GetCells()[latch].mOutput);
+            mLeafNets.push_back(mOptimized.GetCells()[latch].mOutputNot);
+        }
+    }
+
+    mPositive.assign(mAig.GetNumNodes(), int(Netlist::Unconnected));
+    mNegative.assign(mAig.GetNumNodes(), int(Netlist::Unconnected));
+
+    for (int j = 0; j < (int)latches.size(); j++)
+    {
+        for (int pin = 0; pin < 2; pin++)
+        {
+            mOptimized.ConnectInput(latches[j], pin, MapLiteral(latchInputs[j * 2 + pin]));
+        }
+    }
+
+    mOptimized.SetKickNet(MapLiteral(kick));
+
+    // XOR gates take several AND, OR and NOT gates to rebuild, so
+    // keep the original if the mapped circuit came out larger
+    if (GetOptimizedGates() > GetOriginalGates())
+    {
+        mOptimized = mNetlist;
+    }
+}
+
+/**
+ * Build the graph for everything the kick and flip flop inputs depend on.
+ *
+ * Circuit inputs and flip flop outputs are the leaves. Gates whose
+ * outputs nothing reads are never visited, so they are dropped.
+ *
+ * @param latchInputs Receives the literal wired to each flip flop input
+ * @param kick Receives the literal wired into Sparty
+ * @return False if the circuit has a combinational loop
+ */
+bool CircuitOptimizer::BuildAig(std::vector<int> &latchInputs, int &kick)
+{
+    const auto &cells = mNetlist.GetCells();
+
+    std::vector<int> literals(mNetlist.GetNumNets(), Unresolved);
+    std::vector<int> driver(mNetlist.GetNumNets(), -1);
+    for (int net = 0; net < mNetlist.GetNumInputs(); net++)
+    {
+        literals[net] = mAig.AddInput(true);
+    }
+
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        if (mNetlist.IsSequential(cells[c].mType))
+        {
+            literals[cells[c].mOutput] = mAig.AddInput(false);
+            literals[cells[c].mOutputNot] = mAig.AddInput(false);
+        }
+        else
+        {
+            driver[cells[c].mOutput] = c;
+        }
+    }
+
+    bool loop = false;
+    std::vector<bool> visiting(cells.size(), false);
+    std::function<int(int)> resolve = [&](int net) {
+        if (net == Netlist::Unconnected)
+        {
+            return Aig::Unknown;
+        }
+
+        if (literals[net] != Unresolved)
+        {
+            return literals[net];
+        }
+
+        int c = driver[net];
+        if (visiting[c])
+        {
+            loop = true;
+            return Aig::Unknown;
+        }
+
+        visiting[c] = true;
+        const auto &cell = cells[c];
+        int literal = resolve(cell.mInputs[0]);
+        for (size_t i = 1; i < cell.mInputs.size(); i++)
+        {
+            int b = resolve(cell.mInputs[i]);
+            switch (cell.mType)
+            {
+            case Netlist::CellType::And:
+            case Netlist::CellType::Nand:
+                literal = mAig.And(literal, b);
+                break;
+
+            case Netlist::CellType::Or:
+            case Netlist::CellType::Nor:
+                literal = mAig.Or(literal, b);
+                break;
+
+            default:
+                literal = mAig.Xor(literal, b);
+                break;
+            }
+        }
+
+        if (cell.mType == Netlist::CellType::Not || cell.mType == Netlist::CellType::Nand ||
+            cell.mType == Netlist::CellType::Nor)
+        {
+            literal = Aig::Not(literal);
+        }
+        visiting[c] = false;
+
+        literals[net] = literal;
+        return literal;
+    };
+
+    for (const auto &cell : cells)
+    {
+        if (mNetlist.IsSequential(cell.mType))
+        {
+            for (int net : cell.mInputs)
+            {
+                latchInputs.push_back(resolve(net));
+            }
+        }
+    }
+    kick = resolve(mNetlist.GetKickNet());
+
+    return !loop;
+}
+
+/**
+ * Get the net for a literal, adding gates as needed
+ * @param literal Literal in the graph
+ * @return Net in the optimized circuit
+ */
+int CircuitOptimizer::MapLiteral(int literal)
+{
+    if (literal == Aig::Unknown)
+    {
+        return Netlist::Unconnected;
+    }
+
+    int node = Aig::NodeOf(literal);
+    return Aig::IsComplemented(literal) ? MapNegative(node) : MapPositive(node);
+}
+
+/**
+ * Get the net for a node, adding gates as needed
+ * @param node Node in the graph
+ * @return Net in the optimized circuit
+ */
+int CircuitOptimizer::MapPositive(int node)
+{
+    if (mPositive[node] != Netlist::Unconnected)
+    {
+        return mPositive[node];
+    }
+
+    const auto &n = mAig.GetNode(node);
+    int net = Netlist::Unconnected;
+    switch (n.mKind)
+    {
+    case Aig::Kind::Input:
+        net = mLeafNets[n.mInput];
+        break;
+
+    case Aig::Kind::And:
+        net = AddGate(Netlist::CellType::And, MapLiteral(n.mA), MapLiteral(n.mB));
+        break;
+
+    case Aig::Kind::Constant:
+        // Constants only come from folding logic on the circuit
+        // inputs, so there is always an input to build Zero from
+        if (mNetlist.GetNumInputs() > 0)
+        {
+            net = AddGate(Netlist::CellType::And, 0, AddGate(Netlist::CellType::Not, 0));
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    mPositive[node] = net;
+    return net;
+}
+
+/**
+ * Get the net for the complement of a node, adding gates as needed.
+ *
+ * An AND of two complemented operands is mapped to an OR gate.
+ *
+ * @param node Node in the graph
+ * @return Net in the optimized circuit
+ */
+int CircuitOptimizer::MapNegative(int node)
+{
+    if (mNegative[node] != Netlist::Unconnected)
+    {
+        return mNegative[node];
+    }
+
+    const auto &n = mAig.GetNode(node);
+    int net;
+    if (n.mKind == Aig::Kind::And && Aig::IsComplemented(n.mA) && Aig::IsComplemented(n.mB))
+    {
+        net = AddGate(Netlist::CellType::Or, MapPositive(Aig::NodeOf(n.mA)), MapPositive(Aig::NodeOf(n.mB)));
+    }
+    else
+    {
+        net = AddGate(Netlist::CellType::Not, MapPositive(node));
+    }
+
+    mNegative[node] = net;
+    return net;
+}
+
+/**
+ * Add a combinational gate to the optimized circuit
+ * @param type Kind of gate
+ * @param a Net wired to the first input
+ * @param b Net wired to the second input, ignored for NOT
+ * @return Net the gate drives
+ */
+int CircuitOptimizer::AddGate(Netlist::CellType type, int a, int b)
+{
+    int cell = mOptimized.AddCell(type);
+    mOptimized.ConnectInput(cell, 0, a);
+    if (type != Netlist::CellType::Not)
+    {
+        mOptimized.ConnectInput(cell, 1, b);
+    }
+
+    return mOptimized.GetCells()[cell].mOutput;
+}
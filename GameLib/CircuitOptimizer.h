@@ -0,0 +1,91 @@
+/**
+ * @file CircuitOptimizer.h
+ * @author matthew vazquez
+ *
+ * Rebuilds a Netlist as an optimized equivalent circuit.
+ */
+
+#ifndef CIRCUITOPTIMIZER_H
+#define CIRCUITOPTIMIZER_H
+
+#include <vector>
+#include "Aig.h"
+#include "Netlist.h"
+
+/**
+ * Rebuilds a Netlist as an optimized equivalent circuit.
+ *
+ * The combinational gates are turned into an AND-inverter graph,
+ * which propagates constants and Unknowns, merges identical gates
+ * and drops gates whose outputs are never used. The graph is then
+ * mapped back to AND, OR and NOT cells. Flip flops and inputs keep
+ * their order, so the optimized circuit can be simulated in place
+ * of the original lane for lane.
+ *
+ * Circuits with combinational loops are left as they are.
+ */
+class CircuitOptimizer
+{
+private:
+    /// The circuit as given
+    const Netlist &mNetlist;
+
+    /// The optimized circuit
+    Netlist mOptimized;
+
+    /// The graph the optimized circuit was mapped from
+    Aig mAig;
+
+    /// AND nodes the outputs depend on
+    int mNumAnds = 0;
+
+    /// Net in mOptimized for each node, uncomplemented
+    std::vector<int> mPositive;
+
+    /// Net in mOptimized for each node, complemented
+    std::vector<int> mNegative;
+
+    /// Net in mOptimized for each leaf node
+    std::vector<int> mLeafNets;
+
+    bool BuildAig(std::vector<int> &latchInputs, int &kick);
+    int MapLiteral(int literal);
+    int MapPositive(int node);
+    int MapNegative(int node);
+    int AddGate(Netlist::CellType type, int a, int b = Netlist::Unconnected);
+
+public:
+    CircuitOptimizer(const Netlist &netlist);
+
+    /// Copy constructor (disabled)
+    CircuitOptimizer(const CircuitOptimizer &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const CircuitOptimizer &) = delete;
+
+    /**
+     * Get the optimized circuit
+     * @return Circuit equivalent to the original
+     */
+    const Netlist &GetOptimized() const { return mOptimized; }
+
+    /**
+     * Get the number of AND nodes in the optimized graph
+     * @return AND node count, a size measure independent of gate types
+     */
+    int GetNumAnds() const { return mNumAnds; }
+
+    /**
+     * Get the number of gates in the original circuit
+     * @return Gate count, flip flops included
+     */
+    int GetOriginalGates() const { return (int)mNetlist.GetCells().size(); }
+
+    /**
+     * Get the number of gates in the optimized circuit
+     * @return Gate count, flip flops included
+     */
+    int GetOptimizedGates() const { return (int)mOptimized.GetCells().size(); }
+};
+
+#endif //CIRCUITOPTIMIZER_H
@@ -0,0 +1,705 @@
+/**
+ * @file CircuitSerializer.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "CircuitSerializer.h"
+#include <wx/filename.h>
+#include <wx/mstream.h>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include "AndGate.h"
+#include "Beam.h"
+#include "BinaryCoding.h"
+#include "BusConnector.h"
+#include "DFlipFlopGate.h"
+#include "Game.h"
+#include "InputPin.h"
+#include "ItemVisitor.h"
+#include "LevelLoader.h"
+#include "MultiInputGate.h"
+#include "NotGate.h"
+#include "OrGate.h"
+#include "OutputPin.h"
+#include "ProductionLine.h"
+#include "Sensor.h"
+#include "SensorPanel.h"
+#include "Sparty.h"
+#include "SrFlipFlopGate.h"
+#include "XmlPullParser.h"
+
+using namespace std;
+
+/// Magic number at the start of a binary circuit file
+const uint32_t CircuitMagic = 0x43434253;   // "SBCC"
+
+/// Version of the binary circuit format
+const uint8_t CircuitVersion = 2;
+
+/// Oldest version of the binary format that can be read; it has no bus widths
+const uint8_t CircuitVersionNoBuses = 1;
+
+/// Element names of the gates a circuit can hold, in binary type order
+const wchar_t *const GateTypes[] = {L"andgate", L"orgate", L"notgate", L"srflipflop", L"dflipflop", L"multigate",
+                                    L"busjoin", L"bussplit"};
+
+/// Kinds of endpoint in the binary format
+enum class EndpointKind : uint8_t {Beam, Sparty, Sensor, Gate, Other};
+
+/**
+ * Visitor that finds the gates and pins of a game's circuit.
+ *
+ * Collect visits the gates, then each production line's sensor, beam
+ * and Sparty, naming their pins the way wire endpoints do. In a level
+ * with several lines the names carry the line, as line2.beam.
+ */
+class CircuitCollector : public ItemVisitor
+{
+private:
+    /// True while visiting a production line's items
+    bool mInLine = false;
+
+    /// Endpoint prefix of the line being visited, empty for a single line
+    wstring mPrefix;
+
+public:
+    /// Gates in the order visited
+    vector<Gates *> mGates;
+
+    /// Records for the gates, ids not yet assigned
+    vector<CircuitSerializer::Gate> mRecords;
+
+    /// Output pins of the sensor panels and beams, with their endpoints
+    vector<pair<wstring, OutputPin *>> mLineOutputs;
+
+    /// Input pins of the Spartys, with their endpoints
+    vector<pair<wstring, InputPin *>> mSpartyPins;
+
+    /**
+     * Visit a game's gates and the items of each of its lines
+     * @param game Game to visit
+     */
+    void Collect(Game *game)
+    {
+        // Items placed straight in a game with no lines are taken as one line
+        int lines = game->GetNumLines();
+        mInLine = lines == 0;
+        game->Accept(this);
+
+        mInLine = true;
+        for (int i = 0; i < lines; i++)
+        {
+            mPrefix = lines > 1 ? L"line" + to_wstring(i + 1) + L"." : L"";
+            game->GetLine(i)->AcceptAll(this);
+        }
+    }
+
+    /**
+     * Record a gate
+     * @param gate The gate
+     * @param type Element name of the gate
+     * @return Record for the gate
+     */
+    CircuitSerializer::Gate &Add(Gates *gate, const wstring &type)
+    {
+        CircuitSerializer::Gate record;
+        record.mType = type;
+        record.mId = gate->GetId();
+        record.mX = wxRound(gate->GetX());
+        record.mY = wxRound(gate->GetY());
+        mGates.push_back(gate);
+        mRecords.push_back(record);
+        return mRecords.back();
+    }
+
+    /**
+     * Visit a sensor to find its panels
+     * @param sensor Sensor we are visiting
+     */
+    void VisitSensor(Sensor *sensor) override
+    {
+        if (mInLine)
+        {
+            for (const auto &panel : sensor->GetSensorPanels())
+            {
+                mLineOutputs.emplace_back(mPrefix + L"sensor." + panel->GetProperty(), panel->GetOutputPin());
+            }
+        }
+    }
+
+    /**
+     * Visit the beam to find its output
+     * @param beam Beam we are visiting
+     */
+    void VisitBeam(Beam *beam) override
+    {
+        if (mInLine)
+        {
+            mLineOutputs.emplace_back(mPrefix + L"beam", beam->GetOutputPin());
+        }
+    }
+
+    /**
+     * Visit Sparty to find his input
+     * @param sparty Sparty we are visiting
+     */
+    void VisitSparty(Sparty *sparty) override
+    {
+        if (mInLine && sparty->GetInputPin() != nullptr)
+        {
+            mSpartyPins.emplace_back(mPrefix + L"sparty", sparty->GetInputPin());
+        }
+    }
+
+    /**
+     * Visit an AND gate
+     * @param gate Gate we are visiting
+     */
+    void VisitAndGate(AndGate *gate) override { Add(gate, L"andgate"); }
+
+    /**
+     * Visit an OR gate
+     * @param gate Gate we are visiting
+     */
+    void VisitOrGate(OrGate *gate) override { Add(gate, L"orgate"); }
+
+    /**
+     * Visit a NOT gate
+     * @param gate Gate we are visiting
+     */
+    void VisitNotGate(NotGate *gate) override { Add(gate, L"notgate"); }
+
+    /**
+     * Visit an SR flip flop
+     * @param gate Gate we are visiting
+     */
+    void VisitSrFlipFlopGate(SrFlipFlopGate *gate) override { Add(gate, L"srflipflop"); }
+
+    /**
+     * Visit a D flip flop
+     * @param gate Gate we are visiting
+     */
+    void VisitDFlipFlopGate(DFlipFlopGate *gate) override { Add(gate, L"dflipflop"); }
+
+    /**
+     * Visit a gate with any number of inputs
+     * @param gate Gate we are visiting
+     */
+    void VisitMultiInputGate(MultiInputGate *gate) override
+    {
+        auto &record = Add(gate, L"multigate");
+        record.mFunction = MultiInputGate::FunctionName(gate->GetFunction());
+        record.mInputs = gate->GetNumInputs();
+        record.mWidth = gate->GetBusWidth();
+    }
+
+    /**
+     * Visit a bus join or split
+     * @param connector Connector we are visiting
+     */
+    void VisitBusConnector(BusConnector *connector) override
+    {
+        auto &record = Add(connector, connector->GetKind() == BusConnector::Kind::Join ? L"busjoin" : L"bussplit");
+        record.mWidth = connector->GetBusWidth();
+    }
+};
+
+/**
+ * Name a gate pin the way wires in level files do
+ * @param id Gate id
+ * @param index Pin index, from the top
+ * @return Endpoint name
+ */
+static wstring GatePinName(const wstring &id, int index)
+{
+    return index == 0 ? id : id + L"." + to_wstring(index);
+}
+
+/**
+ * Does a gate have a bus width?
+ * @param type Element name of the gate
+ * @return True for multigates and bus connectors
+ */
+static bool HasBusWidth(const wstring &type)
+{
+    return type == L"multigate" || type == L"busjoin" || type == L"bussplit";
+}
+
+/**
+ * Make the level file node for a gate
+ * @param gate The gate
+ * @return New node, owned by the caller
+ */
+static wxXmlNode *MakeGateNode(const CircuitSerializer::Gate &gate)
+{
+    auto node = new wxXmlNode(wxXML_ELEMENT_NODE, gate.mType);
+    node->AddAttribute(L"id", gate.mId);
+    node->AddAttribute(L"x", wxString::Format(L"%d", gate.mX));
+    node->AddAttribute(L"y", wxString::Format(L"%d", gate.mY));
+    if (!gate.mFunction.empty())
+    {
+        node->AddAttribute(L"function", gate.mFunction);
+        node->AddAttribute(L"inputs", wxString::Format(L"%d", gate.mInputs));
+    }
+    if (gate.mWidth > 1)
+    {
+        node->AddAttribute(L"width", wxString::Format(L"%d", gate.mWidth));
+    }
+    return node;
+}
+
+/**
+ * Make the level file node for a wire
+ * @param wire The wire
+ * @return New node, owned by the caller
+ */
+static wxXmlNode *MakeWireNode(const CircuitSerializer::Wire &wire)
+{
+    auto node = new wxXmlNode(wxXML_ELEMENT_NODE, L"wire");
+    node->AddAttribute(L"from", wire.mFrom);
+    node->AddAttribute(L"to", wire.mTo);
+    return node;
+}
+
+/**
+ * Is an element name one of the gates a circuit can hold?
+ * @param type Element name
+ * @return True for a gate
+ */
+bool CircuitSerializer::IsGateType(const std::wstring &type)
+{
+    for (auto gateType : GateTypes)
+    {
+        if (type == gateType)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Record the circuit currently in a game.
+ * Gates without an id are given one, which they keep.
+ * @param game Game to record
+ */
+void CircuitSerializer::Capture(Game *game)
+{
+    CircuitCollector collector;
+    collector.Collect(game);
+
+    set<wstring> used;
+    for (const auto &record : collector.mRecords)
+    {
+        used.insert(record.mId);
+    }
+
+    int next = 1;
+    for (int g = 0; g < (int)collector.mGates.size(); g++)
+    {
+        auto &record = collector.mRecords[g];
+        if (record.mId.empty())
+        {
+            while (used.count(L"g" + to_wstring(next)) != 0)
+            {
+                next++;
+            }
+            record.mId = L"g" + to_wstring(next);
+            used.insert(record.mId);
+            collector.mGates[g]->SetId(record.mId);
+        }
+    }
+
+    // Name every output pin, then follow each input pin back to its driver
+    unordered_map<OutputPin *, wstring> outputs;
+    vector<pair<InputPin *, wstring>> inputs;
+    for (const auto &output : collector.mLineOutputs)
+    {
+        outputs[output.second] = output.first;
+    }
+    for (const auto &sparty : collector.mSpartyPins)
+    {
+        inputs.emplace_back(sparty.second, sparty.first);
+    }
+
+    for (int g = 0; g < (int)collector.mGates.size(); g++)
+    {
+        auto gate = collector.mGates[g];
+        const auto &id = collector.mRecords[g].mId;
+        for (int i = 0; gate->GetOutputPin(i) != nullptr; i++)
+        {
+            outputs[gate->GetOutputPin(i)] = GatePinName(id, i);
+        }
+        for (int i = 0; gate->GetInputPin(i) != nullptr; i++)
+        {
+            inputs.emplace_back(gate->GetInputPin(i), GatePinName(id, i));
+        }
+    }
+
+    mGates = collector.mRecords;
+    mWires.clear();
+    for (const auto &input : inputs)
+    {
+        auto from = outputs.find(input.first->GetLine());
+        if (from != outputs.end())
+        {
+            mWires.push_back({from->second, input.second});
+        }
+    }
+}
+
+/**
+ * Replace the circuit in a game with this one. The game's gates and
+ * the wires into them and into Sparty are removed first.
+ * @param game Game to build the circuit in
+ */
+void CircuitSerializer::Apply(Game *game) const
+{
+    CircuitCollector collector;
+    collector.Collect(game);
+
+    for (const auto &sparty : collector.mSpartyPins)
+    {
+        sparty.second->SetLine(nullptr);
+    }
+    for (auto gate : collector.mGates)
+    {
+        for (int i = 0; gate->GetInputPin(i) != nullptr; i++)
+        {
+            gate->GetInputPin(i)->SetLine(nullptr);
+        }
+        game->Remove(gate);
+    }
+
+    // The circuit is loaded like the items of a level file, so gates
+    // are made the way the level loader makes them
+    wxXmlDocument xmlDoc;
+    auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"circuit");
+    xmlDoc.SetRoot(root);
+    XmlSave(root);
+
+    wxMemoryOutputStream stream;
+    xmlDoc.Save(stream);
+    string text(stream.GetLength(), '\0');
+    stream.CopyTo(text.data(), text.size());
+
+    XmlPullParser parser;
+    parser.SetText(text);
+    if (parser.Next() == XmlPullParser::Event::StartElement)
+    {
+        LevelLoader loader;
+        loader.XmlItems(parser, game);
+    }
+}
+
+/**
+ * Save the circuit as gate and wire nodes
+ * @param root Node to add the gates and wires to
+ */
+void CircuitSerializer::XmlSave(wxXmlNode *root) const
+{
+    for (const auto &gate : mGates)
+    {
+        root->AddChild(MakeGateNode(gate));
+    }
+
+    for (const auto &wire : mWires)
+    {
+        root->AddChild(MakeWireNode(wire));
+    }
+}
+
+/**
+ * Load the circuit from gate and wire nodes. Other nodes are ignored.
+ * @param root Node holding the gates and wires
+ */
+void CircuitSerializer::XmlLoad(wxXmlNode *root)
+{
+    mGates.clear();
+    mWires.clear();
+
+    for (auto child = root->GetChildren(); child; child = child->GetNext())
+    {
+        auto name = child->GetName().ToStdWstring();
+        if (name == L"wire")
+        {
+            mWires.push_back({child->GetAttribute(L"from", L"").ToStdWstring(),
+                              child->GetAttribute(L"to", L"").ToStdWstring()});
+        }
+        else if (IsGateType(name))
+        {
+            Gate gate;
+            gate.mType = name;
+            gate.mId = child->GetAttribute(L"id", L"").ToStdWstring();
+
+            double x = 0, y = 0;
+            child->GetAttribute(L"x", L"0").ToDouble(&x);
+            child->GetAttribute(L"y", L"0").ToDouble(&y);
+            gate.mX = wxRound(x);
+            gate.mY = wxRound(y);
+
+            if (name == L"multigate")
+            {
+                long inputs = MultiInputGate::MinInputs;
+                child->GetAttribute(L"inputs", L"2").ToLong(&inputs);
+                gate.mFunction = child->GetAttribute(L"function", L"and").ToStdWstring();
+                gate.mInputs = (int)inputs;
+            }
+
+            if (HasBusWidth(name))
+            {
+                long width = name == L"multigate" ? 1 : BusConnector::MinWidth;
+                child->GetAttribute(L"width", wxString::Format(L"%ld", width)).ToLong(&width);
+                gate.mWidth = (int)width;
+            }
+            mGates.push_back(gate);
+        }
+    }
+}
+
+/**
+ * Write the circuit in the binary form
+ * @param out Stream to write to
+ */
+void CircuitSerializer::Write(std::ostream &out) const
+{
+    out.write((const char *)&CircuitMagic, sizeof(CircuitMagic));
+    out.put(char(CircuitVersion));
+
+    unordered_map<wstring, int> gateIndex;
+    WriteVarint(out, mGates.size());
+    for (int g = 0; g < (int)mGates.size(); g++)
+    {
+        const auto &gate = mGates[g];
+        gateIndex[gate.mId] = g;
+
+        int type = 0;
+        while (type < (int)size(GateTypes) - 1 && gate.mType != GateTypes[type])
+        {
+            type++;
+        }
+
+        out.put(char(type));
+        WriteString(out, gate.mId);
+        WriteSigned(out, gate.mX);
+        WriteSigned(out, gate.mY);
+        if (gate.mType == L"multigate")
+        {
+            auto function = MultiInputGate::Function::And;
+            MultiInputGate::FunctionFromName(gate.mFunction, function);
+            out.put(char(function));
+            WriteVarint(out, gate.mInputs);
+        }
+        if (HasBusWidth(gate.mType))
+        {
+            WriteVarint(out, gate.mWidth);
+        }
+    }
+
+    auto writeEndpoint = [&](const wstring &endpoint) {
+        auto dot = endpoint.find(L'.');
+        auto item = endpoint.substr(0, dot);
+        auto pin = dot == wstring::npos ? wstring() : endpoint.substr(dot + 1);
+
+        auto gate = gateIndex.find(item);
+        if (endpoint == L"beam")
+        {
+            out.put(char(EndpointKind::Beam));
+        }
+        else if (endpoint == L"sparty")
+        {
+            out.put(char(EndpointKind::Sparty));
+        }
+        else if (item == L"sensor" && !pin.empty())
+        {
+            out.put(char(EndpointKind::Sensor));
+            WriteString(out, pin);
+        }
+        else if (gate != gateIndex.end() && pin.size() < 10 &&
+                 pin.find_first_not_of(L"0123456789") == wstring::npos)
+        {
+            out.put(char(EndpointKind::Gate));
+            WriteVarint(out, gate->second);
+            WriteVarint(out, pin.empty() ? 0 : stoul(pin));
+        }
+        else
+        {
+            out.put(char(EndpointKind::Other));
+            WriteString(out, endpoint);
+        }
+    };
+
+    WriteVarint(out, mWires.size());
+    for (const auto &wire : mWires)
+    {
+        writeEndpoint(wire.mFrom);
+        writeEndpoint(wire.mTo);
+    }
+}
+
+/**
+ * Read a circuit in the binary form
+ * @param in Stream to read from
+ * @return True if a whole circuit was read; on failure the circuit is empty
+ */
+bool CircuitSerializer::Read(std::istream &in)
+{
+    mGates.clear();
+    mWires.clear();
+
+    uint32_t magic = 0;
+    in.read((char *)&magic, sizeof(magic));
+    int version = in.get();
+    if (!in || magic != CircuitMagic || version < CircuitVersionNoBuses || version > CircuitVersion)
+    {
+        return false;
+    }
+
+    uint64_t numGates;
+    if (!ReadVarint(in, numGates))
+    {
+        return false;
+    }
+
+    for (uint64_t g = 0; g < numGates; g++)
+    {
+        Gate gate;
+        int type = in.get();
+        if (type < 0 || type >= (int)size(GateTypes) || !ReadString(in, gate.mId) ||
+            !ReadSigned(in, gate.mX) || !ReadSigned(in, gate.mY))
+        {
+            mGates.clear();
+            return false;
+        }
+
+        gate.mType = GateTypes[type];
+        if (gate.mType == L"multigate")
+        {
+            int function = in.get();
+            uint64_t inputs;
+            if (function < 0 || function > (int)MultiInputGate::Function::Nor || !ReadVarint(in, inputs))
+            {
+                mGates.clear();
+                return false;
+            }
+
+            gate.mFunction = MultiInputGate::FunctionName((MultiInputGate::Function)function);
+            gate.mInputs = (int)inputs;
+        }
+
+        uint64_t width = 1;
+        if (version > CircuitVersionNoBuses && HasBusWidth(gate.mType) && !ReadVarint(in, width))
+        {
+            mGates.clear();
+            return false;
+        }
+        gate.mWidth = (int)width;
+        mGates.push_back(gate);
+    }
+
+    auto readEndpoint = [&](wstring &endpoint) {
+        wstring text;
+        uint64_t gate, pin;
+        switch ((EndpointKind)in.get())
+        {
+        case EndpointKind::Beam:
+            endpoint = L"beam";
+            return true;
+
+        case EndpointKind::Sparty:
+            endpoint = L"sparty";
+            return true;
+
+        case EndpointKind::Sensor:
+            if (!ReadString(in, text))
+            {
+                return false;
+            }
+            endpoint = L"sensor." + text;
+            return true;
+
+        case EndpointKind::Gate:
+            if (!ReadVarint(in, gate) || !ReadVarint(in, pin) || gate >= mGates.size())
+            {
+                return false;
+            }
+            endpoint = GatePinName(mGates[gate].mId, (int)pin);
+            return true;
+
+        case EndpointKind::Other:
+            return ReadString(in, endpoint);
+
+        default:
+            return false;
+        }
+    };
+
+    uint64_t numWires;
+    if (!ReadVarint(in, numWires))
+    {
+        mGates.clear();
+        return false;
+    }
+
+    for (uint64_t w = 0; w < numWires; w++)
+    {
+        Wire wire;
+        if (!readEndpoint(wire.mFrom) || !readEndpoint(wire.mTo))
+        {
+            mGates.clear();
+            mWires.clear();
+            return false;
+        }
+        mWires.push_back(wire);
+    }
+
+    return true;
+}
+
+/**
+ * Save the circuit to a file, as XML if the name ends in .xml and in
+ * the binary form otherwise
+ * @param filename File to write
+ * @return True if the file was written
+ */
+bool CircuitSerializer::Save(const wxString &filename) const
+{
+    if (wxFileName(filename).GetExt().Lower() == L"xml")
+    {
+        wxXmlDocument xmlDoc;
+        auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"circuit");
+        xmlDoc.SetRoot(root);
+        XmlSave(root);
+        return xmlDoc.Save(filename);
+    }
+
+    std::ofstream file(filename.fn_str(), std::ios::binary | std::ios::trunc);
+    Write(file);
+    return (bool)file;
+}
+
+/**
+ * Load the circuit from a file written by Save
+ * @param filename File to read
+ * @return True if the file was read
+ */
+bool CircuitSerializer::Load(const wxString &filename)
+{
+    if (wxFileName(filename).GetExt().Lower() == L"xml")
+    {
+        wxXmlDocument xmlDoc;
+        if (!xmlDoc.Load(filename))
+        {
+            return false;
+        }
+
+        XmlLoad(xmlDoc.GetRoot());
+        return true;
+    }
+
+    std::ifstream file(filename.fn_str(), std::ios::binary);
+    return file && Read(file);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file CircuitSerializer.h
+ * @author matthew vazquez
+ *
+ * The gates and wires a player built, saved apart from the level.
+ */
+
+#ifndef CIRCUITSERIALIZER_H
+#define CIRCUITSERIALIZER_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Game;
+
+/**
+ * The gates and wires a player built, saved apart from the level.
+ *
+ * A circuit is every gate in a game and every wire into an input
+ * pin. Gates are keyed by their id; gates without one are given an
+ * id the first time they are captured, so the same gate keeps its
+ * name from save to save. Wire endpoints are named the way level
+ * files name them (see PinFinder); in a level with several production
+ * lines the sensor, beam and Sparty endpoints name their line, as
+ * line2.beam, so each line keeps its own wiring.
+ *
+ * The XML form is a root element holding gate and wire nodes, the
+ * same nodes a level's items node holds. The binary form stores the
+ * same records with gates and endpoints reduced to small integers.
+ */
+class CircuitSerializer
+{
+public:
+    /**
+     * A gate in the circuit
+     */
+    struct Gate
+    {
+        /// Element name of the gate, such as andgate or multigate
+        std::wstring mType;
+
+        /// Gate id wires refer to
+        std::wstring mId;
+
+        /// Function of a multigate
+        std::wstring mFunction;
+
+        /// Number of inputs of a multigate
+        int mInputs = 0;
+
+        /// Bits each bus pin carries, 1 if the gate has no buses
+        int mWidth = 1;
+
+        /// X location in virtual pixels
+        int mX = 0;
+
+        /// Y location in virtual pixels
+        int mY = 0;
+    };
+
+    /**
+     * A wire from an output pin to an input pin
+     */
+    struct Wire
+    {
+        /// Output endpoint, such as beam or g1.1
+        std::wstring mFrom;
+
+        /// Input endpoint, such as sparty or g2
+        std::wstring mTo;
+    };
+
+private:
+    /// Gates in the order they appear in the game
+    std::vector<Gate> mGates;
+
+    /// Wires in the order of the input pins they feed
+    std::vector<Wire> mWires;
+
+public:
+    void Capture(Game *game);
+    void Apply(Game *game) const;
+
+    void XmlSave(wxXmlNode *root) const;
+    void XmlLoad(wxXmlNode *root);
+    void Write(std::ostream &out) const;
+    bool Read(std::istream &in);
+
+    bool Save(const wxString &filename) const;
+    bool Load(const wxString &filename);
+
+    static bool IsGateType(const std::wstring &type);
+
+    /**
+     * Get the gates in the circuit
+     * @return Gates in the order they appear in the game
+     */
+    const std::vector<Gate> &GetGates() const { return mGates; }
+
+    /**
+     * Get the wires in the circuit
+     * @return Wires in the order of the input pins they feed
+     */
+    const std::vector<Wire> &GetWires() const { return mWires; }
+};
+
+#endif //CIRCUITSERIALIZER_H
@@ -0,0 +1,504 @@
+/**
+ * @file CircuitSimulator.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "CircuitSimulator.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include "CircuitHash.h"
+#include "TruthTableCache.h"
+
+/// Distinguishes truth table entries from other cache entries
+const uint64_t TableSalt = 0x7AB1E5;
+
+/// Lanes in which table input j is One, for lane numbers 0 to 63
+const uint64_t TablePatterns[CircuitSimulator::MaxTableInputs] = {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull};
+
+/**
+ * Constructor
+ *
+ * Orders the combinational cells so that each one is evaluated
+ * after the cells that drive it. Cells in a combinational loop
+ * are appended in the order they were added.
+ *
+ * @param netlist Circuit to simulate. Must outlive the simulator.
+ * @param cache Cache of truth tables to reuse, or nullptr
+ */
+CircuitSimulator::CircuitSimulator(const Netlist &netlist, TruthTableCache *cache) : mNetlist(netlist)
+{
+    const auto &cells = mNetlist.GetCells();
+
+    // Which combinational cell drives each net
+    std::vector<int> driver(mNetlist.GetNumNets(), -1);
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        if (mNetlist.IsSequential(cells[c].mType))
+        {
+            mLatches.push_back(c);
+        }
+        else
+        {
+            driver[cells[c].mOutput] = c;
+        }
+    }
+
+    // Kahn's algorithm over the combinational cells
+    std::vector<int> pending(cells.size(), 0);
+    std::vector<std::vector<int>> fanout(cells.size());
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        if (mNetlist.IsSequential(cells[c].mType))
+        {
+            continue;
+        }
+
+        for (int net : cells[c].mInputs)
+        {
+            if (net != Netlist::Unconnected && driver[net] >= 0)
+            {
+                pending[c]++;
+                fanout[driver[net]].push_back(c);
+            }
+        }
+    }
+
+    std::vector<bool> placed(cells.size(), false);
+    std::vector<int> ready;
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        if (!mNetlist.IsSequential(cells[c].mType) && pending[c] == 0)
+        {
+            ready.push_back(c);
+        }
+    }
+
+    for (size_t i = 0; i < ready.size(); i++)
+    {
+        int c = ready[i];
+        placed[c] = true;
+        mCombinational.push_back(c);
+        for (int next : fanout[c])
+        {
+            if (--pending[next] == 0)
+            {
+                ready.push_back(next);
+            }
+        }
+    }
+
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        if (!mNetlist.IsSequential(cells[c].mType) && !placed[c])
+        {
+            mCombinational.push_back(c);
+        }
+    }
+
+    BuildTables(cache);
+    Reset();
+}
+
+/**
+ * Replace the sub-circuits that depend only on circuit inputs
+ * with truth tables where they have few enough inputs.
+ * @param cache Cache of truth tables to reuse, or nullptr
+ */
+void CircuitSimulator::BuildTables(TruthTableCache *cache)
+{
+    const auto &cells = mNetlist.GetCells();
+    int numInputs = mNetlist.GetNumInputs();
+
+    std::vector<int> driver(mNetlist.GetNumNets(), -1);
+    std::vector<int> position(cells.size(), -1);
+    for (int i = 0; i < (int)mCombinational.size(); i++)
+    {
+        driver[cells[mCombinational[i]].mOutput] = mCombinational[i];
+        position[mCombinational[i]] = i;
+    }
+
+    // mCombinational is in dependency order with loops last, so a cell
+    // in a loop always finds a driver that has not been decided yet
+    std::vector<bool> inputOnly(cells.size(), false);
+    std::vector<bool> decided(cells.size(), false);
+    for (int c : mCombinational)
+    {
+        bool only = true;
+        for (int net : cells[c].mInputs)
+        {
+            if (net != Netlist::Unconnected && net >= numInputs)
+            {
+                int d = driver[net];
+                only = only && d >= 0 && decided[d] && inputOnly[d];
+            }
+        }
+
+        inputOnly[c] = only;
+        decided[c] = true;
+    }
+
+    // Roots are the input-only cells whose outputs leave the input-only logic
+    std::vector<bool> root(cells.size(), false);
+    auto markRoot = [&](int net) {
+        if (net != Netlist::Unconnected && driver[net] >= 0 && inputOnly[driver[net]])
+        {
+            root[driver[net]] = true;
+        }
+    };
+
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        if (mNetlist.IsSequential(cells[c].mType) || !inputOnly[c])
+        {
+            for (int net : cells[c].mInputs)
+            {
+                markRoot(net);
+            }
+        }
+    }
+    markRoot(mNetlist.GetKickNet());
+
+    std::unique_ptr<CircuitHash> hash;
+    std::vector<bool> tabled(cells.size(), false);
+    std::vector<bool> needed(cells.size(), false);
+    for (int r : mCombinational)
+    {
+        if (!root[r])
+        {
+            continue;
+        }
+
+        std::vector<int> cone;
+        std::vector<int> support;
+        std::vector<bool> visited(cells.size(), false);
+        std::function<void(int)> collect = [&](int c) {
+            visited[c] = true;
+            cone.push_back(c);
+            for (int net : cells[c].mInputs)
+            {
+                if (net == Netlist::Unconnected)
+                {
+                    continue;
+                }
+
+                if (net < numInputs)
+                {
+                    if (std::find(support.begin(), support.end(), net) == support.end())
+                    {
+                        support.push_back(net);
+                    }
+                }
+                else if (!visited[driver[net]])
+                {
+                    collect(driver[net]);
+                }
+            }
+        };
+        collect(r);
+
+        if ((int)support.size() > MaxTableInputs)
+        {
+            for (int c : cone)
+            {
+                needed[c] = true;
+            }
+            continue;
+        }
+
+        // Inputs are ordered by name so equal sub-circuits share tables
+        std::sort(cone.begin(), cone.end(), [&](int a, int b) { return position[a] < position[b]; });
+        std::sort(support.begin(), support.end(), [this](int a, int b) {
+            return mNetlist.GetInputName(a) < mNetlist.GetInputName(b);
+        });
+
+        Table table;
+        table.mNet = cells[r].mOutput;
+        table.mSupport = support;
+
+        uint64_t key = 0;
+        bool found = false;
+        if (cache != nullptr)
+        {
+            if (hash == nullptr)
+            {
+                hash = std::make_unique<CircuitHash>(mNetlist);
+            }
+
+            key = CircuitHash::Combine(hash->GetNetHash(table.mNet), TableSalt);
+            found = cache->Find(key, table.mTable);
+        }
+
+        if (!found)
+        {
+            table.mTable = ComputeTable(cone, support, table.mNet);
+            if (cache != nullptr)
+            {
+                cache->Insert(key, table.mTable);
+            }
+        }
+
+        mTables.push_back(table);
+        for (int c : cone)
+        {
+            tabled[c] = true;
+        }
+    }
+
+    for (int c : mCombinational)
+    {
+        if (!tabled[c] || needed[c])
+        {
+            mUntabled.push_back(c);
+        }
+    }
+}
+
+/**
+ * Evaluate a sub-circuit for every combination of its inputs
+ * @param cone Cells of the sub-circuit in dependency order
+ * @param support Input nets of the sub-circuit
+ * @param net Net the sub-circuit drives
+ * @return Value of net, lane k for the inputs given by the bits of k
+ */
+LogicWord CircuitSimulator::ComputeTable(const std::vector<int> &cone, const std::vector<int> &support, int net) const
+{
+    const auto &cells = mNetlist.GetCells();
+
+    std::vector<LogicWord> nets(mNetlist.GetNumNets());
+    for (int j = 0; j < (int)support.size(); j++)
+    {
+        nets[support[j]].mOne = TablePatterns[j];
+        nets[support[j]].mZero = ~TablePatterns[j];
+    }
+
+    for (int c : cone)
+    {
+        nets[cells[c].mOutput] = Evaluate(cells[c], nets);
+    }
+
+    return nets[net];
+}
+
+/**
+ * Can the truth tables be used with the current inputs?
+ * @return True if every table input is the same known value in all lanes
+ */
+bool CircuitSimulator::TablesUsable() const
+{
+    for (const auto &table : mTables)
+    {
+        for (int net : table.mSupport)
+        {
+            if (mNets[net].mOne != ~uint64_t(0) && mNets[net].mZero != ~uint64_t(0))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Evaluate one combinational cell
+ * @param cell Cell to evaluate
+ * @param nets Current value of every net
+ * @return Value of the cell's output
+ */
+LogicWord CircuitSimulator::Evaluate(const Netlist::Cell &cell, const std::vector<LogicWord> &nets) const
+{
+    auto in = [&nets](int net) { return net == Netlist::Unconnected ? LogicWord() : nets[net]; };
+
+    // Wide gates fold their inputs pairwise, which keeps a single
+    // Unknown input making the whole output Unknown
+    LogicWord out = in(cell.mInputs[0]);
+    for (size_t i = 1; i < cell.mInputs.size(); i++)
+    {
+        switch (cell.mType)
+        {
+        case Netlist::CellType::And:
+        case Netlist::CellType::Nand:
+            out = GateLogic::And(out, in(cell.mInputs[i]));
+            break;
+
+        case Netlist::CellType::Or:
+        case Netlist::CellType::Nor:
+            out = GateLogic::Or(out, in(cell.mInputs[i]));
+            break;
+
+        case Netlist::CellType::Xor:
+            out = GateLogic::Xor(out, in(cell.mInputs[i]));
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    switch (cell.mType)
+    {
+    case Netlist::CellType::Not:
+    case Netlist::CellType::Nand:
+    case Netlist::CellType::Nor:
+        return GateLogic::Not(out);
+
+    default:
+        return out;
+    }
+}
+
+/**
+ * Put the circuit back in the state a freshly added set of gates has.
+ *
+ * Flip flops start with Q at Zero in the game. Lane k instead starts
+ * latch j with Q at One when bit j of (firstCombination + k) is set,
+ * so successive calls can enumerate every starting state. Lane 0 of
+ * a reset with firstCombination of 0 is exactly the game's start.
+ *
+ * @param firstCombination Starting state pattern for lane 0
+ */
+void CircuitSimulator::Reset(uint64_t firstCombination)
+{
+    const auto &cells = mNetlist.GetCells();
+
+    mNets.assign(mNetlist.GetNumNets(), LogicWord());
+    mPreviousClock.assign(cells.size(), LogicWord::Splat(States::Zero));
+
+    for (int j = 0; j < (int)mLatches.size(); j++)
+    {
+        uint64_t ones = 0;
+        if (j < 64)
+        {
+            for (int lane = 0; lane < 64; lane++)
+            {
+                if (((firstCombination + lane) >> j) & 1)
+                {
+                    ones |= uint64_t(1) << lane;
+                }
+            }
+        }
+
+        const auto &cell = cells[mLatches[j]];
+        mNets[cell.mOutput].mOne = ones;
+        mNets[cell.mOutput].mZero = ~ones;
+        mNets[cell.mOutputNot].mOne = ~ones;
+        mNets[cell.mOutputNot].mZero = ones;
+    }
+}
+
+/**
+ * Evaluate the combinational cells until their outputs stop changing
+ * @param order Cells to evaluate, in dependency order
+ * @return True if any net changed
+ */
+bool CircuitSimulator::EvaluateCombinational(const std::vector<int> &order)
+{
+    const auto &cells = mNetlist.GetCells();
+
+    bool any = false;
+    for (size_t pass = 0; pass <= order.size(); pass++)
+    {
+        bool changed = false;
+        for (int c : order)
+        {
+            const auto &cell = cells[c];
+            LogicWord out = Evaluate(cell, mNets);
+            if (out != mNets[cell.mOutput])
+            {
+                mNets[cell.mOutput] = out;
+                changed = true;
+            }
+        }
+
+        if (!changed)
+        {
+            break;
+        }
+        any = true;
+    }
+
+    return any;
+}
+
+/**
+ * Clock every flip flop once with the current net values
+ * @return True if any flip flop output changed
+ */
+bool CircuitSimulator::EvaluateLatches()
+{
+    const auto &cells = mNetlist.GetCells();
+
+    bool changed = false;
+    for (int c : mLatches)
+    {
+        const auto &cell = cells[c];
+        LogicWord q = mNets[cell.mOutput];
+        LogicWord notQ = mNets[cell.mOutputNot];
+
+        if (cell.mType == Netlist::CellType::SrFlipFlop)
+        {
+            GateLogic::SrFlipFlop(GetNet(cell.mInputs[0]), GetNet(cell.mInputs[1]), q, notQ);
+        }
+        else
+        {
+            GateLogic::DFlipFlop(GetNet(cell.mInputs[0]), GetNet(cell.mInputs[1]),
+                                 mPreviousClock[c], q, notQ);
+        }
+
+        if (q != mNets[cell.mOutput] || notQ != mNets[cell.mOutputNot])
+        {
+            mNets[cell.mOutput] = q;
+            mNets[cell.mOutputNot] = notQ;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * Let the circuit reach a steady state with the current inputs.
+ *
+ * Alternates settling the combinational logic and clocking the
+ * flip flops until nothing changes. Circuits that oscillate stop
+ * after a bounded number of passes.
+ */
+void CircuitSimulator::Settle()
+{
+    // Tabled outputs depend only on the inputs, so they are set once
+    bool useTables = !mTables.empty() && TablesUsable();
+    if (useTables)
+    {
+        for (const auto &table : mTables)
+        {
+            int lane = 0;
+            for (int j = 0; j < (int)table.mSupport.size(); j++)
+            {
+                if (mNets[table.mSupport[j]].mOne != 0)
+                {
+                    lane |= 1 << j;
+                }
+            }
+
+            mNets[table.mNet] = LogicWord::Splat(table.mTable.Lane(lane));
+        }
+    }
+
+    const auto &order = useTables ? mUntabled : mCombinational;
+
+    size_t maxPasses = mLatches.size() + 2;
+    for (size_t pass = 0; pass < maxPasses; pass++)
+    {
+        EvaluateCombinational(order);
+        if (!EvaluateLatches())
+        {
+            break;
+        }
+    }
+
+    EvaluateCombinational(order);
+}
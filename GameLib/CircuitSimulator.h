@@ -0,0 +1,123 @@
+/**
+ * @file CircuitSimulator.h
+ * @author matthew vazquez
+ *
+ * Evaluates a Netlist 64 simulations at a time.
+ */
+
+#ifndef CIRCUITSIMULATOR_H
+#define CIRCUITSIMULATOR_H
+
+#include <vector>
+#include "GateLogic.h"
+#include "Netlist.h"
+
+class TruthTableCache;
+
+/**
+ * Evaluates a Netlist 64 simulations at a time.
+ *
+ * Every net holds a LogicWord, so each bit lane is an independent
+ * copy of the circuit. Inputs are held constant while the circuit
+ * settles, which models the many frames the game spends in each
+ * stage of a product passing the sensor and beam.
+ *
+ * Sub-circuits of at most MaxTableInputs inputs that depend on
+ * nothing but circuit inputs are replaced by truth tables. While
+ * every input is the same in all lanes, as it is when the verifier
+ * drives the circuit, their outputs are looked up rather than
+ * evaluated, and the nets inside them are not updated.
+ */
+class CircuitSimulator
+{
+public:
+    /// Most inputs a sub-circuit can have and be replaced by a truth table
+    static const int MaxTableInputs = 6;
+
+private:
+    /**
+     * A sub-circuit replaced by its truth table
+     */
+    struct Table
+    {
+        /// Net the sub-circuit drives
+        int mNet;
+
+        /// Input nets, bit j of a lane number is the value of input j
+        std::vector<int> mSupport;
+
+        /// Output for each combination of inputs
+        LogicWord mTable;
+    };
+
+    /// The circuit being simulated
+    const Netlist &mNetlist;
+
+    /// Current value of every net
+    std::vector<LogicWord> mNets;
+
+    /// Last clock seen by each cell (only used by D flip flops)
+    std::vector<LogicWord> mPreviousClock;
+
+    /// Combinational cells in the order they are evaluated
+    std::vector<int> mCombinational;
+
+    /// Cells that hold state
+    std::vector<int> mLatches;
+
+    /// Sub-circuits replaced by truth tables
+    std::vector<Table> mTables;
+
+    /// Combinational cells still evaluated when the tables are used
+    std::vector<int> mUntabled;
+
+    void BuildTables(TruthTableCache *cache);
+    LogicWord ComputeTable(const std::vector<int> &cone, const std::vector<int> &support, int net) const;
+    bool TablesUsable() const;
+    LogicWord Evaluate(const Netlist::Cell &cell, const std::vector<LogicWord> &nets) const;
+    bool EvaluateCombinational(const std::vector<int> &order);
+    bool EvaluateLatches();
+
+public:
+    CircuitSimulator(const Netlist &netlist, TruthTableCache *cache = nullptr);
+
+    /// Copy constructor (disabled)
+    CircuitSimulator(const CircuitSimulator &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const CircuitSimulator &) = delete;
+
+    void Reset(uint64_t firstCombination = 0);
+    void Settle();
+
+    /**
+     * Drive an input net
+     * @param net Net driven by an input
+     * @param value New value for all lanes
+     */
+    void SetInput(int net, LogicWord value) { mNets[net] = value; }
+
+    /**
+     * Get the value of a net
+     * @param net Net number, may be Netlist::Unconnected
+     * @return Value of the net, Unknown in every lane if unconnected
+     */
+    LogicWord GetNet(int net) const
+    {
+        return net == Netlist::Unconnected ? LogicWord() : mNets[net];
+    }
+
+    /**
+     * Get the number of flip flops whose starting state is enumerated by Reset
+     * @return Number of latches
+     */
+    int GetNumLatches() const { return (int)mLatches.size(); }
+
+    /**
+     * Get the number of sub-circuits replaced by truth tables
+     * @return Number of tables
+     */
+    int GetNumTables() const { return (int)mTables.size(); }
+};
+
+#endif //CIRCUITSIMULATOR_H
@@ -0,0 +1,495 @@
+/**
+ * @file CircuitSynthesizer.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "CircuitSynthesizer.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <tuple>
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+/// Number of first operands each search task handles
+const size_t TaskChunk = 64;
+
+/// X location of the first column of gates in a solved level
+const int GateColumnX = 500;
+
+/// Horizontal spacing between columns of gates
+const int GateColumnSpacing = 140;
+
+/// Y location of the first row of gates in a solved level
+const int GateRowY = 200;
+
+/// Vertical spacing between rows of gates
+const int GateRowSpacing = 110;
+
+/**
+ * Constructor
+ * @param inputs Circuit input names, as the level's sensor and beam provide them
+ * @param products Products in the order they reach the sensor
+ */
+CircuitSynthesizer::CircuitSynthesizer(const vector<wstring> &inputs,
+                                       const vector<CircuitVerifier::ProductSpec> &products) :
+    mInputs(inputs), mProducts(products)
+{
+    // An idle stage, then four stages per product
+    int simulated = min((int)mProducts.size(), MaxProducts);
+    mStages = 1 + 4 * simulated;
+    mStageMask = mStages >= 64 ? ~uint64_t(0) : (uint64_t(1) << mStages) - 1;
+
+    for (int i = 0; i < simulated; i++)
+    {
+        uint64_t beamLane = uint64_t(1) << (2 + 4 * i);
+        if (mProducts[i].mKick)
+        {
+            mKickLanes |= beamLane;
+        }
+        else
+        {
+            mKeepLanes |= beamLane;
+        }
+    }
+}
+
+/**
+ * Compute the value an input has in each stage
+ * @param input Index of the input
+ * @return Trace of the input
+ */
+LogicWord CircuitSynthesizer::InputTrace(int input) const
+{
+    const auto &name = mInputs[input];
+    bool beam = name == CircuitVerifier::BeamInput;
+
+    LogicWord trace;
+    trace.SetLane(0, States::Zero);
+    for (int i = 0; 1 + 4 * i < mStages; i++)
+    {
+        const auto &properties = mProducts[i].mProperties;
+        bool sensed = find(properties.begin(), properties.end(), name) != properties.end();
+
+        for (int stage = 0; stage < 4; stage++)
+        {
+            bool active = beam ? stage == 1 : stage < 3 && sensed;
+            trace.SetLane(1 + 4 * i + stage, active ? States::One : States::Zero);
+        }
+    }
+
+    return trace;
+}
+
+/**
+ * Does a signal wired into Sparty solve the level?
+ *
+ * Sparty kicks on a beam stage when the signal is One there
+ * and was not One in the stage before.
+ *
+ * @param trace Trace of the signal
+ * @return True if every product gets the right treatment
+ */
+bool CircuitSynthesizer::Solves(const LogicWord &trace) const
+{
+    uint64_t rising = trace.mOne & ~(trace.mOne << 1);
+    return (rising & mKickLanes) == mKickLanes && (rising & mKeepLanes) == 0;
+}
+
+/**
+ * Run a flip flop through every stage, starting as the game starts it
+ * @param op SrQ or DQ for the kind of flip flop
+ * @param a Trace of the first input (S or D)
+ * @param b Trace of the second input (R or clock)
+ * @param q Trace of Q
+ * @param notQ Trace of Q'
+ */
+void CircuitSynthesizer::Sequential(Op op, const LogicWord &a, const LogicWord &b,
+                                    LogicWord &q, LogicWord &notQ) const
+{
+    LogicWord stateQ = {0, 1};
+    LogicWord stateNotQ = {1, 0};
+    LogicWord previousClock = {0, 1};
+
+    q = LogicWord();
+    notQ = LogicWord();
+    for (int stage = 0; stage < mStages; stage++)
+    {
+        LogicWord x = {(a.mOne >> stage) & 1, (a.mZero >> stage) & 1};
+        LogicWord y = {(b.mOne >> stage) & 1, (b.mZero >> stage) & 1};
+
+        if (op == Op::SrQ)
+        {
+            GateLogic::SrFlipFlop(x, y, stateQ, stateNotQ);
+        }
+        else
+        {
+            GateLogic::DFlipFlop(x, y, previousClock, stateQ, stateNotQ);
+        }
+
+        q.mOne |= (stateQ.mOne & 1) << stage;
+        q.mZero |= (stateQ.mZero & 1) << stage;
+        notQ.mOne |= (stateNotQ.mOne & 1) << stage;
+        notQ.mZero |= (stateNotQ.mZero & 1) << stage;
+    }
+}
+
+/**
+ * Find every new signal that takes exactly one more gate than
+ * the signals it is built from, where the total is size gates.
+ * @param size Number of gates in the new signals
+ * @param pool Pool to run the search on
+ * @param results Candidates found, one entry per task in a fixed order
+ */
+void CircuitSynthesizer::Expand(int size, WorkStealingPool &pool, vector<TaskResult> &results) const
+{
+    // Each task handles a range of first operands of one size
+    // against every second operand of the matching size
+    struct Task
+    {
+        int mSizeA;
+        size_t mBegin;
+        size_t mEnd;
+        bool mUnary;
+    };
+
+    vector<Task> tasks;
+    for (int sizeA = 0; sizeA < size; sizeA++)
+    {
+        for (size_t x = mSizeStart[sizeA]; x < mSizeStart[sizeA + 1]; x += TaskChunk)
+        {
+            tasks.push_back({sizeA, x, min(x + TaskChunk, mSizeStart[sizeA + 1]), sizeA == size - 1});
+        }
+    }
+
+    results.assign(tasks.size(), TaskResult());
+    for (size_t t = 0; t < tasks.size(); t++)
+    {
+        pool.Submit([this, size, &task = tasks[t], &result = results[t]] {
+            unordered_set<LogicWord, TraceHash> local;
+
+            auto add = [&](Op op, int a, int b, LogicWord trace) {
+                trace.mOne &= mStageMask;
+                trace.mZero &= mStageMask;
+                if (result.mNodes.size() >= MaxCandidates || mSeen.count(trace) || !local.insert(trace).second)
+                {
+                    return;
+                }
+
+                if (Solves(trace))
+                {
+                    result.mSolved.push_back((int)result.mNodes.size());
+                }
+                result.mNodes.push_back({op, a, b, trace});
+            };
+
+            int sizeB = size - 1 - task.mSizeA;
+            for (size_t x = task.mBegin; x < task.mEnd; x++)
+            {
+                const auto &nodeX = mNodes[x];
+                if (task.mUnary)
+                {
+                    add(Op::Not, (int)x, -1, GateLogic::Not(nodeX.mTrace));
+                }
+
+                for (size_t y = mSizeStart[sizeB]; y < mSizeStart[sizeB + 1]; y++)
+                {
+                    const auto &nodeY = mNodes[y];
+
+                    // AND and OR are symmetric, so only build each pair once
+                    if (task.mSizeA < sizeB || (task.mSizeA == sizeB && y >= x))
+                    {
+                        add(Op::And, (int)x, (int)y, GateLogic::And(nodeX.mTrace, nodeY.mTrace));
+                        add(Op::Or, (int)x, (int)y, GateLogic::Or(nodeX.mTrace, nodeY.mTrace));
+                    }
+
+                    LogicWord q, notQ;
+                    Sequential(Op::SrQ, nodeX.mTrace, nodeY.mTrace, q, notQ);
+                    add(Op::SrQ, (int)x, (int)y, q);
+                    add(Op::SrNotQ, (int)x, (int)y, notQ);
+
+                    Sequential(Op::DQ, nodeX.mTrace, nodeY.mTrace, q, notQ);
+                    add(Op::DQ, (int)x, (int)y, q);
+                    add(Op::DNotQ, (int)x, (int)y, notQ);
+                }
+            }
+        });
+    }
+
+    pool.Wait();
+}
+
+/**
+ * Search for the smallest circuit that solves the level
+ * @param pool Pool to run the search on
+ * @return True if a solution was found within the gate limit
+ */
+bool CircuitSynthesizer::Synthesize(WorkStealingPool &pool)
+{
+    mNodes.clear();
+    mSizeStart.clear();
+    mSeen.clear();
+    mSolution = Netlist();
+    mSolutionGates = -1;
+
+    if ((int)mProducts.size() > MaxProducts)
+    {
+        return false;
+    }
+
+    // Circuits of no gates wire an input straight to Sparty
+    mSizeStart.push_back(0);
+    vector<int> solved;
+    for (int i = 0; i < (int)mInputs.size(); i++)
+    {
+        auto trace = InputTrace(i);
+        trace.mOne &= mStageMask;
+        trace.mZero &= mStageMask;
+        if (mSeen.insert(trace).second)
+        {
+            if (Solves(trace))
+            {
+                solved.push_back((int)mNodes.size());
+            }
+            mNodes.push_back({Op::Input, i, -1, trace});
+        }
+    }
+    mSizeStart.push_back(mNodes.size());
+
+    for (int size = 1; ; size++)
+    {
+        for (int node : solved)
+        {
+            auto netlist = BuildNetlist(node);
+            if (Verify(netlist))
+            {
+                mSolution = netlist;
+                mSolutionGates = (int)mSolution.GetCells().size();
+                return true;
+            }
+        }
+
+        if (size > mMaxGates || mNodes.size() >= MaxCandidates)
+        {
+            return false;
+        }
+
+        vector<TaskResult> results;
+        Expand(size, pool, results);
+
+        // Merge in task order so the result does not depend on timing
+        solved.clear();
+        for (const auto &result : results)
+        {
+            auto nextSolved = result.mSolved.begin();
+            for (int i = 0; i < (int)result.mNodes.size(); i++)
+            {
+                bool isSolved = nextSolved != result.mSolved.end() && *nextSolved == i;
+                if (isSolved)
+                {
+                    ++nextSolved;
+                }
+
+                if (mSeen.insert(result.mNodes[i].mTrace).second)
+                {
+                    if (isSolved)
+                    {
+                        solved.push_back((int)mNodes.size());
+                    }
+                    mNodes.push_back(result.mNodes[i]);
+                }
+            }
+        }
+        mSizeStart.push_back(mNodes.size());
+    }
+}
+
+/**
+ * Build the circuit for a candidate, sharing repeated gates
+ * @param node Candidate wired into Sparty
+ * @return The circuit
+ */
+Netlist CircuitSynthesizer::BuildNetlist(int node) const
+{
+    Netlist netlist;
+    for (const auto &input : mInputs)
+    {
+        netlist.AddInput(input);
+    }
+
+    map<tuple<Netlist::CellType, int, int>, int> cells;
+    auto cellFor = [&](Netlist::CellType type, int a, int b) {
+        auto key = make_tuple(type, a, b);
+        auto found = cells.find(key);
+        if (found != cells.end())
+        {
+            return found->second;
+        }
+
+        int cell = netlist.AddCell(type);
+        netlist.ConnectInput(cell, 0, a);
+        if (b != Netlist::Unconnected)
+        {
+            netlist.ConnectInput(cell, 1, b);
+        }
+        cells[key] = cell;
+        return cell;
+    };
+
+    function<int(int)> netFor = [&](int index) {
+        const auto &n = mNodes[index];
+        if (n.mOp == Op::Input)
+        {
+            return n.mA;
+        }
+
+        int a = netFor(n.mA);
+        int b = n.mOp == Op::Not ? Netlist::Unconnected : netFor(n.mB);
+
+        switch (n.mOp)
+        {
+        case Op::And:
+            return netlist.GetCells()[cellFor(Netlist::CellType::And, a, b)].mOutput;
+
+        case Op::Or:
+            return netlist.GetCells()[cellFor(Netlist::CellType::Or, a, b)].mOutput;
+
+        case Op::Not:
+            return netlist.GetCells()[cellFor(Netlist::CellType::Not, a, b)].mOutput;
+
+        case Op::SrQ:
+            return netlist.GetCells()[cellFor(Netlist::CellType::SrFlipFlop, a, b)].mOutput;
+
+        case Op::SrNotQ:
+            return netlist.GetCells()[cellFor(Netlist::CellType::SrFlipFlop, a, b)].mOutputNot;
+
+        case Op::DQ:
+            return netlist.GetCells()[cellFor(Netlist::CellType::DFlipFlop, a, b)].mOutput;
+
+        default:
+            return netlist.GetCells()[cellFor(Netlist::CellType::DFlipFlop, a, b)].mOutputNot;
+        }
+    };
+
+    netlist.SetKickNet(netFor(node));
+    return netlist;
+}
+
+/**
+ * Confirm a candidate with the verifier, which settles
+ * flip flops the same way the game does.
+ * @param netlist Candidate circuit
+ * @return True if no product is mis-kicked
+ */
+bool CircuitSynthesizer::Verify(const Netlist &netlist) const
+{
+    CircuitVerifier verifier(netlist, mCache);
+    return CircuitVerifier::CountMisKicks(verifier.Verify(mProducts)) == 0;
+}
+
+/**
+ * Save the solution as gates and wires in a level's <items> node
+ * @param items Node to add the gates and wires to
+ */
+void CircuitSynthesizer::XmlSave(wxXmlNode *items) const
+{
+    const auto &cells = mSolution.GetCells();
+
+    // Which cell output drives each net
+    vector<pair<int, int>> driver(mSolution.GetNumNets(), {-1, 0});
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        driver[cells[c].mOutput] = {c, 0};
+        if (cells[c].mOutputNot != Netlist::Unconnected)
+        {
+            driver[cells[c].mOutputNot] = {c, 1};
+        }
+    }
+
+    auto source = [&](int net) {
+        if (net < mSolution.GetNumInputs())
+        {
+            const auto &name = mSolution.GetInputName(net);
+            return name == CircuitVerifier::BeamInput ? wxString(L"beam") : L"sensor." + wxString(name);
+        }
+
+        auto from = wxString::Format(L"g%d", driver[net].first + 1);
+        return driver[net].second == 0 ? from : from + L".1";
+    };
+
+    // Cells were added operands first, so one pass finds every depth
+    vector<int> depth(cells.size(), 1);
+    vector<int> rows;
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        for (int net : cells[c].mInputs)
+        {
+            if (net != Netlist::Unconnected && driver[net].first >= 0)
+            {
+                depth[c] = max(depth[c], depth[driver[net].first] + 1);
+            }
+        }
+
+        if ((int)rows.size() < depth[c])
+        {
+            rows.resize(depth[c], 0);
+        }
+        int row = rows[depth[c] - 1]++;
+
+        wxString name;
+        switch (cells[c].mType)
+        {
+        case Netlist::CellType::And:
+            name = L"andgate";
+            break;
+
+        case Netlist::CellType::Or:
+            name = L"orgate";
+            break;
+
+        case Netlist::CellType::Not:
+            name = L"notgate";
+            break;
+
+        case Netlist::CellType::SrFlipFlop:
+            name = L"srflipflop";
+            break;
+
+        default:
+            name = L"dflipflop";
+            break;
+        }
+
+        auto gate = new wxXmlNode(wxXML_ELEMENT_NODE, name);
+        gate->AddAttribute(L"id", wxString::Format(L"g%d", c + 1));
+        gate->AddAttribute(L"x", wxString::Format(L"%d", GateColumnX + (depth[c] - 1) * GateColumnSpacing));
+        gate->AddAttribute(L"y", wxString::Format(L"%d", GateRowY + row * GateRowSpacing));
+        items->AddChild(gate);
+    }
+
+    for (int c = 0; c < (int)cells.size(); c++)
+    {
+        for (int i = 0; i < (int)cells[c].mInputs.size(); i++)
+        {
+            if (cells[c].mInputs[i] == Netlist::Unconnected)
+            {
+                continue;
+            }
+
+            auto wire = new wxXmlNode(wxXML_ELEMENT_NODE, L"wire");
+            wire->AddAttribute(L"from", source(cells[c].mInputs[i]));
+            wire->AddAttribute(L"to", wxString::Format(L"g%d.%d", c + 1, i));
+            items->AddChild(wire);
+        }
+    }
+
+    if (mSolution.GetKickNet() != Netlist::Unconnected)
+    {
+        auto wire = new wxXmlNode(wxXML_ELEMENT_NODE, L"wire");
+        wire->AddAttribute(L"from", source(mSolution.GetKickNet()));
+        wire->AddAttribute(L"to", L"sparty");
+        items->AddChild(wire);
+    }
+}
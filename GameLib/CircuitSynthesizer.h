@@ -0,0 +1,181 @@
+/**
+ * @file CircuitSynthesizer.h
+ * @author matthew vazquez
+ *
+ * Searches for the smallest gate circuit that solves a level.
+ */
+
+#ifndef CIRCUITSYNTHESIZER_H
+#define CIRCUITSYNTHESIZER_H
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "CircuitVerifier.h"
+#include "GateLogic.h"
+#include "Netlist.h"
+
+class TruthTableCache;
+class WorkStealingPool;
+
+/**
+ * Searches for the smallest gate circuit that solves a level.
+ *
+ * Every signal in a candidate circuit is summarised by its trace:
+ * the value it has in each stage of the product sequence the
+ * verifier drives, one stage per lane of a LogicWord. Circuits are
+ * built bottom up, one gate at a time, from the traces of smaller
+ * circuits. Two circuits with the same trace behave identically
+ * wherever they are used, so only the first one found is kept.
+ *
+ * Size is counted as formula size, so a signal used twice counts
+ * twice. The netlist produced shares repeated signals, so it can
+ * be smaller than the size searched.
+ */
+class CircuitSynthesizer
+{
+public:
+    /// Default limit on the number of gates searched
+    static const int DefaultMaxGates = 6;
+
+    /// Most products whose stages fit in one trace
+    static const int MaxProducts = 15;
+
+    /// Limit on the number of distinct traces kept
+    static const size_t MaxCandidates = 4000000;
+
+private:
+    /// How a candidate signal is produced
+    enum class Op {Input, And, Or, Not, SrQ, SrNotQ, DQ, DNotQ};
+
+    /**
+     * A candidate signal
+     */
+    struct Node
+    {
+        /// Operation producing the signal
+        Op mOp = Op::Input;
+
+        /// First operand node, or input index for inputs
+        int mA = -1;
+
+        /// Second operand node
+        int mB = -1;
+
+        /// Value in each stage
+        LogicWord mTrace;
+    };
+
+    /**
+     * Hash of a trace for the set of traces already found
+     */
+    struct TraceHash
+    {
+        /**
+         * Hash a trace
+         * @param trace Trace to hash
+         * @return Hash value
+         */
+        size_t operator()(const LogicWord &trace) const
+        {
+            return std::hash<uint64_t>()(trace.mOne * 0x9E3779B97F4A7C15ull ^ trace.mZero);
+        }
+    };
+
+    /**
+     * Candidates one task produced
+     */
+    struct TaskResult
+    {
+        /// New candidates, in the order found
+        std::vector<Node> mNodes;
+
+        /// Positions in mNodes of candidates that solve the level
+        std::vector<int> mSolved;
+    };
+
+    /// Circuit input names
+    std::vector<std::wstring> mInputs;
+
+    /// Products in the order they reach the sensor
+    std::vector<CircuitVerifier::ProductSpec> mProducts;
+
+    /// Number of stages simulated
+    int mStages = 0;
+
+    /// Lanes that hold a stage
+    uint64_t mStageMask = 0;
+
+    /// Beam stages where Sparty must kick
+    uint64_t mKickLanes = 0;
+
+    /// Beam stages where Sparty must not kick
+    uint64_t mKeepLanes = 0;
+
+    /// Largest circuit searched
+    int mMaxGates = DefaultMaxGates;
+
+    /// Every distinct candidate found, smallest first
+    std::vector<Node> mNodes;
+
+    /// Index in mNodes where each size starts, plus the end
+    std::vector<size_t> mSizeStart;
+
+    /// Traces of every node in mNodes
+    std::unordered_set<LogicWord, TraceHash> mSeen;
+
+    /// The solution found, if any
+    Netlist mSolution;
+
+    /// Number of gates in the solution, or -1
+    int mSolutionGates = -1;
+
+    /// Cache of verification results, or nullptr
+    TruthTableCache *mCache = nullptr;
+
+    LogicWord InputTrace(int input) const;
+    bool Solves(const LogicWord &trace) const;
+    void Sequential(Op op, const LogicWord &a, const LogicWord &b, LogicWord &q, LogicWord &notQ) const;
+    void Expand(int size, WorkStealingPool &pool, std::vector<TaskResult> &results) const;
+    Netlist BuildNetlist(int node) const;
+    bool Verify(const Netlist &netlist) const;
+
+public:
+    CircuitSynthesizer(const std::vector<std::wstring> &inputs,
+                       const std::vector<CircuitVerifier::ProductSpec> &products);
+
+    bool Synthesize(WorkStealingPool &pool);
+    void XmlSave(wxXmlNode *items) const;
+
+    /**
+     * Set the largest circuit to search for
+     * @param gates Maximum number of gates
+     */
+    void SetMaxGates(int gates) { mMaxGates = gates; }
+
+    /**
+     * Set a cache of verification results to share across searches
+     * @param cache Cache to use, or nullptr for none
+     */
+    void SetCache(TruthTableCache *cache) { mCache = cache; }
+
+    /**
+     * Get the solution
+     * @return Solving netlist, empty if Synthesize failed
+     */
+    const Netlist &GetSolution() const { return mSolution; }
+
+    /**
+     * Get the number of gates in the solution
+     * @return Gate count, or -1 if there is no solution
+     */
+    int GetSolutionGates() const { return mSolutionGates; }
+
+    /**
+     * Get the number of distinct signals the search considered
+     * @return Number of candidates kept
+     */
+    size_t GetNumCandidates() const { return mNodes.size(); }
+};
+
+#endif //CIRCUITSYNTHESIZER_H
@@ -0,0 +1,177 @@
+/**
+ * @file CircuitVerifier.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "CircuitVerifier.h"
+#include "CircuitSimulator.h"
+#include <algorithm>
+#include "CircuitHash.h"
+#include "CircuitOptimizer.h"
+#include "TruthTableCache.h"
+
+using namespace std;
+
+const std::wstring CircuitVerifier::BeamInput = L"beam";
+
+/// Distinguishes verification results from other cache entries
+const uint64_t VerifySalt = 0x5E121F1;
+
+/**
+ * Drive the circuit inputs for one stage of a product passing
+ * @param simulator Simulator to drive
+ * @param netlist Circuit being simulated
+ * @param product Product the sensor sees, or nullptr if none
+ * @param beam True if the beam is broken
+ */
+static void DriveInputs(CircuitSimulator &simulator, const Netlist &netlist,
+                        const CircuitVerifier::ProductSpec *product, bool beam)
+{
+    auto one = LogicWord::Splat(States::One);
+    auto zero = LogicWord::Splat(States::Zero);
+
+    for (int net = 0; net < netlist.GetNumInputs(); net++)
+    {
+        const auto &name = netlist.GetInputName(net);
+        bool active;
+        if (name == CircuitVerifier::BeamInput)
+        {
+            active = beam;
+        }
+        else
+        {
+            active = product != nullptr &&
+                find(product->mProperties.begin(), product->mProperties.end(), name) != product->mProperties.end();
+        }
+
+        simulator.SetInput(net, active ? one : zero);
+    }
+}
+
+/**
+ * Run the products past the circuit and report what Sparty does to each.
+ * @param products Products in the order they reach the sensor
+ * @return One result per product, in the same order
+ */
+vector<CircuitVerifier::ProductResult> CircuitVerifier::Verify(const vector<ProductSpec> &products) const
+{
+    vector<ProductResult> results(products.size());
+    for (size_t i = 0; i < products.size(); i++)
+    {
+        results[i].mIndex = (int)i;
+        results[i].mExpectedKick = products[i].mKick;
+    }
+
+    // A cached result packs the kicked products into mOne and the
+    // state dependent ones into mZero, so it holds at most 64 products
+    if (mCache == nullptr || products.size() > 64)
+    {
+        Simulate(products, results);
+        return results;
+    }
+
+    CircuitHash hash(mNetlist);
+    uint64_t key = CircuitHash::Combine(hash.GetKickHash(), CircuitHash::HashProducts(products));
+    key = CircuitHash::Combine(key, VerifySalt);
+
+    LogicWord packed;
+    if (mCache->Find(key, packed))
+    {
+        for (size_t i = 0; i < products.size(); i++)
+        {
+            results[i].mKicked = (packed.mOne >> i) & 1;
+            results[i].mStateDependent = (packed.mZero >> i) & 1;
+        }
+        return results;
+    }
+
+    Simulate(products, results);
+
+    packed = LogicWord();
+    for (size_t i = 0; i < products.size(); i++)
+    {
+        packed.mOne |= uint64_t(results[i].mKicked) << i;
+        packed.mZero |= uint64_t(results[i].mStateDependent) << i;
+    }
+    mCache->Insert(key, packed);
+
+    return results;
+}
+
+/**
+ * Simulate the products passing the circuit
+ * @param products Products in the order they reach the sensor
+ * @param results Results to fill in, one per product
+ */
+void CircuitVerifier::Simulate(const vector<ProductSpec> &products, vector<ProductResult> &results) const
+{
+    // The optimized circuit behaves identically and is cheaper to settle
+    CircuitOptimizer optimizer(mNetlist);
+    const Netlist &netlist = optimizer.GetOptimized();
+    CircuitSimulator simulator(netlist, mCache);
+
+    int latchBits = min(simulator.GetNumLatches(), MaxLatchBits);
+    uint64_t combinations = uint64_t(1) << latchBits;
+
+    // Which lanes kicked each product, for the first batch
+    vector<uint64_t> firstKicked(products.size(), 0);
+
+    for (uint64_t first = 0; first < combinations; first += 64)
+    {
+        uint64_t lanes = combinations - first >= 64 ? ~uint64_t(0) : (uint64_t(1) << (combinations - first)) - 1;
+
+        simulator.Reset(first);
+        DriveInputs(simulator, netlist, nullptr, false);
+        simulator.Settle();
+        LogicWord last = simulator.GetNet(netlist.GetKickNet());
+
+        for (size_t i = 0; i < products.size(); i++)
+        {
+            const ProductSpec *product = &products[i];
+
+            // Sensor only, both, sensor only, then the gap before the next product
+            const ProductSpec *sensed[4] = {product, product, product, nullptr};
+            const bool beam[4] = {false, true, false, false};
+
+            uint64_t kicked = 0;
+            for (int stage = 0; stage < 4; stage++)
+            {
+                DriveInputs(simulator, netlist, sensed[stage], beam[stage]);
+                simulator.Settle();
+
+                LogicWord kick = simulator.GetNet(netlist.GetKickNet());
+                uint64_t rising = kick.mOne & ~last.mOne;
+                if (beam[stage])
+                {
+                    kicked = rising & lanes;
+                }
+                last = kick;
+            }
+
+            if (first == 0)
+            {
+                firstKicked[i] = kicked;
+                results[i].mKicked = (kicked & 1) != 0;
+            }
+
+            bool reference = (firstKicked[i] & 1) != 0;
+            if (kicked != (reference ? lanes : 0))
+            {
+                results[i].mStateDependent = true;
+            }
+        }
+    }
+
+}
+
+/**
+ * Count the products a circuit gets wrong
+ * @param results Results from Verify
+ * @return Number of mis-kicked products
+ */
+int CircuitVerifier::CountMisKicks(const vector<ProductResult> &results)
+{
+    return (int)count_if(results.begin(), results.end(),
+                         [](const ProductResult &result) { return result.IsMisKick(); });
+}
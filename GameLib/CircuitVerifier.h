@@ -0,0 +1,108 @@
+/**
+ * @file CircuitVerifier.h
+ * @author matthew vazquez
+ *
+ * Checks a wired circuit against a level's kick specification
+ * without running the animation.
+ */
+
+#ifndef CIRCUITVERIFIER_H
+#define CIRCUITVERIFIER_H
+
+#include <string>
+#include <vector>
+#include "Netlist.h"
+
+class TruthTableCache;
+
+/**
+ * Checks a wired circuit against a level's kick specification.
+ *
+ * Each product passing down the conveyor produces the same four
+ * stages of input: the sensor sees it, the beam breaks, the beam
+ * clears while the sensor still sees it, then neither sees anything
+ * until the next product. Sparty kicks a product when his input
+ * rises to One as the beam breaks.
+ *
+ * Every starting state of the flip flops is simulated, 64 at a time,
+ * so the verifier also reports products whose fate depends on how
+ * the latches happened to be left.
+ *
+ * The circuit is simulated as CircuitOptimizer rebuilds it, which
+ * behaves identically with fewer gates to settle.
+ *
+ * Given a TruthTableCache, results are remembered by the canonical
+ * hash of the circuit and products, so the same logic is only ever
+ * simulated once.
+ */
+class CircuitVerifier
+{
+public:
+    /// Most flip flops whose starting states are enumerated
+    static const int MaxLatchBits = 12;
+
+    /// Name of the circuit input driven by the beam
+    static const std::wstring BeamInput;
+
+    /**
+     * A product as the level describes it.
+     */
+    struct ProductSpec
+    {
+        /// Property names the sensor will see, e.g. L"red", L"square"
+        std::vector<std::wstring> mProperties;
+
+        /// Should Sparty kick this product?
+        bool mKick = false;
+    };
+
+    /**
+     * What happens to one product.
+     */
+    struct ProductResult
+    {
+        /// Position of the product in conveyor order
+        int mIndex = 0;
+
+        /// Production line the product is on, from 0
+        int mLine = 0;
+
+        /// Should Sparty kick this product?
+        bool mExpectedKick = false;
+
+        /// Does Sparty kick it when the circuit starts as the game starts it?
+        bool mKicked = false;
+
+        /// Does the outcome change with the starting state of the flip flops?
+        bool mStateDependent = false;
+
+        /**
+         * Was this product handled wrongly?
+         * @return True if kicked when it should not be or the reverse
+         */
+        bool IsMisKick() const { return mKicked != mExpectedKick; }
+    };
+
+private:
+    /// The circuit being checked
+    const Netlist &mNetlist;
+
+    /// Cache of earlier results, or nullptr
+    TruthTableCache *mCache = nullptr;
+
+    void Simulate(const std::vector<ProductSpec> &products, std::vector<ProductResult> &results) const;
+
+public:
+    /**
+     * Constructor
+     * @param netlist Circuit to check. Must outlive the verifier.
+     * @param cache Cache of earlier results, or nullptr
+     */
+    CircuitVerifier(const Netlist &netlist, TruthTableCache *cache = nullptr) : mNetlist(netlist), mCache(cache) {}
+
+    std::vector<ProductResult> Verify(const std::vector<ProductSpec> &products) const;
+
+    static int CountMisKicks(const std::vector<ProductResult> &results);
+};
+
+#endif //CIRCUITVERIFIER_H
@@ -12,7 +12,10 @@
 #include "Beam.h"
 #include "ItemVisitor.h"
 #include "ProductVisitors.h"
-#include <wx/tokenzr.h>
+#include "ProductionLine.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
+#include "XmlPullParser.h"
 
 
 /// Image for the background (base) of the conveyor
@@ -42,9 +45,6 @@ const wxRect StartButtonRect(35, 29, 95, 36);
  */
 const wxRect StopButtonRect(35, 87, 95, 36);
 
-/// Offset used to place products above the beam
-int beamOffset = 75;
-
 /**
  * Visitor to find and store reference to beam object.
  *
@@ -77,18 +77,11 @@ public:
  */
 Conveyor::Conveyor(Game* game) : Item(game, ConveyorBackgroundImage)
 {
-
-    mBackgroundImage = std::make_unique<wxImage>(ConveyorBackgroundImage, wxBITMAP_TYPE_ANY);
-    mBackgroundBitmap = std::make_unique<wxBitmap>(*mBackgroundImage);
-
-    mBeltImage = std::make_unique<wxImage>(ConveyorBeltImage, wxBITMAP_TYPE_ANY);
-    mBeltBitmap = std::make_unique<wxBitmap>(*mBeltImage);
-
-    mPanelStoppedImage = std::make_unique<wxImage>(ConveyorPanelStoppedImage, wxBITMAP_TYPE_ANY);
-    mPanelStoppedBitmap = std::make_unique<wxBitmap>(*mPanelStoppedImage);
-
-    mPanelStartedImage = std::make_unique<wxImage>(ConveyorPanelStartedImage, wxBITMAP_TYPE_ANY);
-    mPanelStartedBitmap = std::make_unique<wxBitmap>(*mPanelStartedImage);
+    auto atlas = game->GetAtlas();
+    mBackgroundSprite = atlas->Find(ConveyorBackgroundImage);
+    mBeltSprite = atlas->Find(ConveyorBeltImage);
+    mPanelStoppedSprite = atlas->Find(ConveyorPanelStoppedImage);
+    mPanelStartedSprite = atlas->Find(ConveyorPanelStartedImage);
 
     mBeltSpeed = ConveyorSpeed;
     mBeltPosition = 0;
@@ -99,34 +92,29 @@ Conveyor::Conveyor(Game* game) : Item(game, ConveyorBackgroundImage)
  * Renders the conveyor
  * @param graphics The graphics for rendering
  */
-void Conveyor::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Conveyor::Draw(wxGraphicsContext *graphics)
 {
     if (!graphics) return;
 
     graphics->PushState();
     graphics->Translate(GetX(), GetY());
 
+    auto atlas = GetGame()->GetAtlas();
+    auto sprites = GetGame()->GetSprites();
+    sprites->Draw(graphics, mBackgroundSprite, -mWidth/2, -mHeight/2, mWidth, mHeight);
 
-    if (mBackgroundBitmap->IsOk())
+    auto backgroundSize = atlas->GetSize(mBackgroundSprite);
+    if (backgroundSize.GetHeight() > 0)
     {
-        graphics->DrawBitmap(*mBackgroundBitmap, -mWidth/2, -mHeight/2, mWidth, mHeight);
+        double beltHeight = mHeight * ((double)atlas->GetSize(mBeltSprite).GetHeight() / backgroundSize.GetHeight());
+        sprites->Draw(graphics, mBeltSprite, -mWidth/2, -beltHeight/2 + mBeltPosition, mWidth, beltHeight);
+        sprites->Draw(graphics, mBeltSprite, -mWidth/2, -beltHeight/2 + mBeltPosition - beltHeight, mWidth, beltHeight);
     }
 
-
-    if (mBeltBitmap->IsOk())
-    {
-        double beltHeight = mHeight * ((double)mBeltImage->GetHeight() / (double)mBackgroundImage->GetHeight());
-        graphics->DrawBitmap(*mBeltBitmap, -mWidth/2, -beltHeight/2 + mBeltPosition, mWidth, beltHeight);
-        graphics->DrawBitmap(*mBeltBitmap, -mWidth/2, -beltHeight/2 + mBeltPosition - beltHeight, mWidth, beltHeight);
-    }
-
-
-    wxBitmap* panelBitmap = mIsRunning ? mPanelStartedBitmap.get() : mPanelStoppedBitmap.get();
-    if (panelBitmap->IsOk())
-    {
-        graphics->DrawBitmap(*panelBitmap, mPanelLocation.x, mPanelLocation.y,
-                             panelBitmap->GetWidth(), panelBitmap->GetHeight());
-    }
+    int panelSprite = mIsRunning ? mPanelStartedSprite : mPanelStoppedSprite;
+    auto panelSize = atlas->GetSize(panelSprite);
+    sprites->Draw(graphics, panelSprite, mPanelLocation.x, mPanelLocation.y,
+                  panelSize.GetWidth(), panelSize.GetHeight());
 
     graphics->PopState();
 
@@ -146,8 +134,9 @@ bool Conveyor::HitTest(double x, double y)
         return true;
     testX -= mPanelLocation.x;
     testY -= mPanelLocation.y;
-    if (testX >= 0 && testX <= mPanelStartedImage->GetWidth() &&
-        testY >= 0 && testY <= mPanelStartedImage->GetHeight())
+    auto panelSize = GetGame()->GetAtlas()->GetSize(mPanelStartedSprite);
+    if (testX >= 0 && testX <= panelSize.GetWidth() &&
+        testY >= 0 && testY <= panelSize.GetHeight())
         return true;
 
     return false;
@@ -160,9 +149,13 @@ void Conveyor::Start()
 {
     mIsRunning = true;
     ResetProducts();
+    if (mGenerator != nullptr)
+    {
+        mGenerator->Reset();
+    }
 
     BeamFinderVisitor beamFinder;
-    GetGame()->Accept(&beamFinder);
+    AcceptLine(&beamFinder);
     Beam* beam = beamFinder.GetBeam();
     if (beam)
     {
@@ -184,8 +177,21 @@ void Conveyor::Stop()
 void Conveyor::ResetProducts()
 {
     ResetProduct visitor = ResetProduct();
-    GetGame()->Accept(&visitor);
-    GetGame()->GetScore()->ResetLevelScore();
+
+    // Starting over only takes back the points this line scored
+    if (GetLine() != nullptr)
+    {
+        GetLine()->AcceptAll(&visitor);
+        GetLine()->ResetScore();
+    }
+    else
+    {
+        GetGame()->Accept(&visitor);
+        GetGame()->GetScore()->ResetLevelScore();
+    }
+
+    // Retired products are back in play
+    GetGame()->InvalidateActive();
 }
 
 /**
@@ -210,7 +216,12 @@ void Conveyor::Update(double elapsed)
     }
 
     MoveProduct visitor = MoveProduct(0, mBeltSpeed * elapsed);
-    GetGame()->Accept(&visitor);
+    AcceptLine(&visitor);
+
+    if (mGenerator != nullptr)
+    {
+        mGenerator->Update(elapsed);
+    }
 
 }
 
@@ -231,64 +242,116 @@ void Conveyor::OnClick(double x, double y)
 }
 
 /**
- * Initializes conveyor from xml
- * @param node The xml node that has conveyor in it
+ * Load the conveyor and its products from a level being read
+ * @param parser Parser on the conveyor's start element
  */
-void Conveyor::XmlLoad(wxXmlNode* node)
+void Conveyor::XmlLoad(XmlPullParser &parser)
 {
     // Load basic conveyor attributes
-    Item::XmlLoad(node);
-    node->GetAttribute(L"speed", L"100").ToDouble(&mBeltSpeed);
-    node->GetAttribute(L"height", L"800").ToDouble(&mHeight);
+    Item::XmlLoad(parser);
+    mBeltSpeed = parser.GetDouble("speed", 100);
+    mHeight = parser.GetDouble("height", 800);
 
     // Get panel location
-    wxStringTokenizer tokenizer(node->GetAttribute(L"panel"), L",");
-    double panelX = wxAtof(tokenizer.GetNextToken());
-    double panelY = wxAtof(tokenizer.GetNextToken());
+    double panelX = 0;
+    double panelY = 0;
+    XmlPullParser::ToPair(parser.GetAttribute("panel"), panelX, panelY);
     mPanelLocation = wxPoint(panelX, panelY);
 
     // Get width and height with aspect ratio
-    mWidth = mHeight * (double)mBackgroundImage->GetWidth() / (double)mBackgroundImage->GetHeight();
+    auto backgroundSize = GetGame()->GetAtlas()->GetSize(mBackgroundSprite);
+    mWidth = mHeight * (double)backgroundSize.GetWidth() / (double)backgroundSize.GetHeight();
 
-    // Inital placement of first product above the beam
-    double conveyorCenterX = GetX();
-    double conveyorCenterY = GetY();
+    double currentY = GetY();
+    int depth = parser.GetDepth();
+    while (parser.NextChild(depth))
+    {
+        if (!parser.IsStartElement())
+        {
+            continue;
+        }
 
-    // Initialize the y we are subtracting from as center of conveyor
-    double currentY = conveyorCenterY;
+        if (parser.GetName() == "product")
+        {
+            auto product = GetGame()->Create<Product>(GetGame());
+            product->XmlLoad(parser);
 
-    for (auto child = node->GetChildren(); child; child = child->GetNext())
-    {
-        if (child->GetName() == L"product")
+            currentY = PlacedY(parser.GetAttribute("placement", "0"), GetY(), currentY);
+            PlaceProduct(product, currentY);
+        }
+        else if (parser.GetName() == "generator")
         {
-            auto product = std::make_shared<Product>(GetGame());
-            product->XmlLoad(child);
-            GetGame()->Add(product);
-
-            // Process placement string for double without +
-            wxString placementString = child->GetAttribute(L"placement", L"0");
-            placementString.Replace("+", "");
-
-            double placement = 0;
-            placementString.ToDouble(&placement);
-
-            // Check if placement starts with a +, if so accumulate to y position
-            if (child->GetAttribute(L"placement").StartsWith("+"))
-            {
-                currentY -= placement;
-            }
-            else
-            {
-                currentY = conveyorCenterY - placement;
-            }
-
-            double productX = GetX();
-            product->SetInitalPosition(productX, currentY);
-            product->SetLocation(productX, currentY);
-            mNumberOfProductsOnConveyor++;
+            AddGenerator()->XmlLoad(parser);
         }
     }
-    GetGame()->SetNumProducts(mNumberOfProductsOnConveyor);
+    FinishLoad();
+}
+
+/**
+ * Get where a product placed in a level goes on the belt. A placement
+ * is a distance up the belt from the center, or from the product
+ * before if it has a leading +.
+ * @param placement Placement attribute of the product
+ * @param conveyorY Y of the conveyor's center
+ * @param previousY Y of the product before
+ * @return Y of the product
+ */
+double Conveyor::PlacedY(std::string_view placement, double conveyorY, double previousY)
+{
+    bool accumulate = !placement.empty() && placement[0] == '+';
+    if (accumulate)
+    {
+        placement.remove_prefix(1);
+    }
+
+    double distance = 0;
+    XmlPullParser::ToDouble(placement, distance);
+    return accumulate ? previousY - distance : conveyorY - distance;
+}
+
+/**
+ * Add a product loaded from a level to the game and place it on the belt
+ * @param product Product to place
+ * @param y Y of the product
+ */
+void Conveyor::PlaceProduct(const std::shared_ptr<Product> &product, double y)
+{
+    GetGame()->Add(product);
+    if (GetLine() != nullptr)
+    {
+        GetLine()->Add(product.get());
+    }
+
+    double productX = GetX();
+    product->SetInitalPosition(productX, y);
+    product->SetLocation(productX, y);
+    mNumberOfProductsOnConveyor++;
+}
+
+/**
+ * Create the generator that streams products onto the belt
+ * @return The generator, ready to load
+ */
+ProductGenerator *Conveyor::AddGenerator()
+{
+    // Generated products never run out, so they are not counted
+    mGenerator = std::make_unique<ProductGenerator>(this);
+    if (GetLine() != nullptr)
+    {
+        GetLine()->SetEndless();
+    }
+    return mGenerator.get();
+}
+
+/**
+ * Tell the conveyor's line how many products it has once they are loaded
+ */
+void Conveyor::FinishLoad()
+{
+    if (GetLine() != nullptr)
+    {
+        GetLine()->AddProducts(mNumberOfProductsOnConveyor);
+    }
 }
 
 /**
@@ -312,4 +375,40 @@ bool Conveyor::IsRunning() const
 void Conveyor::Accept(ItemVisitor* visitor)
 {
     visitor->VisitConveyor(this);
-}
\ No newline at end of file
+}
+
+/**
+ * Save the conveyor's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void Conveyor::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Item::SaveSnapshot(snapshot);
+    snapshot.Write(mSpeed);
+    snapshot.Write(mIsRunning);
+    snapshot.Write(mBeltPosition);
+    snapshot.Write(mNumberOfProductsOnConveyor);
+    snapshot.Write(mPreviousProduct);
+    if (mGenerator != nullptr)
+    {
+        mGenerator->SaveSnapshot(snapshot);
+    }
+}
+
+/**
+ * Restore the conveyor's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Conveyor::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Item::RestoreSnapshot(snapshot);
+    snapshot.Read(mSpeed);
+    snapshot.Read(mIsRunning);
+    snapshot.Read(mBeltPosition);
+    snapshot.Read(mNumberOfProductsOnConveyor);
+    snapshot.Read(mPreviousProduct);
+    if (mGenerator != nullptr)
+    {
+        mGenerator->RestoreSnapshot(snapshot);
+    }
+}
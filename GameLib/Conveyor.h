@@ -13,14 +13,16 @@
 #include "Item.h"
 #include <wx/graphics.h>
 #include <memory>
+#include <string_view>
 #include "Product.h"
+#include "ProductGenerator.h"
 
 /**
  * Underlying work for the conveyor belt
  *
  * This class manages the conveyor belt as well as moving the products around etc.
  */
-class Conveyor : public Item
+class Conveyor final : public Item
 {
 private:
     double mSpeed = 0;                    ///< Speed for the conveyor belt
@@ -37,27 +39,26 @@ private:
 
     double mBeltPosition = 0;             ///< The current position of the conveyor belt
 
-    std::unique_ptr<wxImage> mBackgroundImage;    ///< background for conveyor belt
+    int mBackgroundSprite = -1;           ///< sprite for the background of the conveyor belt
 
-    std::unique_ptr<wxBitmap> mBackgroundBitmap;  ///< background bitmap for conveyor belt
+    int mBeltSprite = -1;                 ///< sprite for the conveyor belt
 
-    std::unique_ptr<wxImage> mBeltImage;          ///< image fo the conveyor belt
+    int mPanelStoppedSprite = -1;         ///< sprite for the conveyor belt panel stopped
 
-    std::unique_ptr<wxBitmap> mBeltBitmap;        ///< image bitmap for conveyor belt
-
-    std::unique_ptr<wxImage> mPanelStoppedImage;  ///< image for the conveoyr belt panel stopped
-
-    std::unique_ptr<wxBitmap> mPanelStoppedBitmap;  ///< image bitmap fo convetyor belt panel stopped
-
-    std::unique_ptr<wxImage> mPanelStartedImage;  ///< image of the panel when it runs
-
-    std::unique_ptr<wxBitmap> mPanelStartedBitmap;  ///< image bitmap of the panek runnning
+    int mPanelStartedSprite = -1;         ///< sprite of the panel when it runs
 
     /// Track number of products added to conveyor
     int mNumberOfProductsOnConveyor = 0;
 
     bool mPreviousProduct = false; ///< The previous product on the conveyor
 
+    /// Streams products onto the belt in endless mode, null otherwise
+    std::unique_ptr<ProductGenerator> mGenerator;
+
+    void PlaceProduct(const std::shared_ptr<Product> &product, double y);
+    ProductGenerator *AddGenerator();
+    void FinishLoad();
+
 public:
     Conveyor(Game* game);
 
@@ -67,10 +68,14 @@ public:
 
     void operator=(const Conveyor&) = delete;
 
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Draw(wxGraphicsContext *graphics) override;
     bool HitTest(double x, double y) override;
     void Update(double elapsed) override;
-    void XmlLoad(wxXmlNode* node) override;
+    void SaveSnapshot(GameSnapshot &snapshot) const override;
+    void RestoreSnapshot(GameSnapshot &snapshot) override;
+
+    static double PlacedY(std::string_view placement, double conveyorY, double previousY);
+    void XmlLoad(XmlPullParser &parser) override;
     void OnClick(double x, double y) override;
 
     /**
@@ -88,6 +93,18 @@ public:
 
     double GetSpeed() const;
 
+    /**
+     * Get the height of the belt
+     * @return Height in virtual pixels
+     */
+    double GetHeight() const { return mHeight; }
+
+    /**
+     * Get the generator streaming products onto the belt
+     * @return Generator, or null if the conveyor only has the products the level lists
+     */
+    ProductGenerator *GetGenerator() const { return mGenerator.get(); }
+
     bool IsRunning() const;
 
    /**
@@ -37,15 +37,15 @@ DFlipFlopGate::DFlipFlopGate(Game *game) : Gates(game)
     wxPoint pointC(x + w/2,y - h/4);
     wxPoint pointD(x + w/2,y + h/4);
 
-    mInputA = std::make_shared<InputPin>(this, pointA);
-    mInputB = std::make_shared<InputPin>(this,pointB);
-    mOutputA = std::make_shared<OutputPin>(this, pointC);
-    mOutputB = std::make_shared<OutputPin>(this, pointD);
+    mInputA = CreatePart<InputPin>(this, pointA);
+    mInputB = CreatePart<InputPin>(this,pointB);
+    mOutputA = CreatePart<OutputPin>(this, pointC);
+    mOutputB = CreatePart<OutputPin>(this, pointD);
 
-    mInputA->SetState(States::Unknown);
-    mInputB->SetState(States::Unknown);
-    mOutputA->SetState(States::Zero);
-    mOutputB->SetState(States::One);
+    Get(mInputA)->SetState(States::Unknown);
+    Get(mInputB)->SetState(States::Unknown);
+    Get(mOutputA)->SetState(States::Zero);
+    Get(mOutputB)->SetState(States::One);
 
 }
 
@@ -55,20 +55,20 @@ DFlipFlopGate::DFlipFlopGate(Game *game) : Gates(game)
  */
 void DFlipFlopGate::ComputeOutput()
 {
-    States D = mInputA->GetState();
-    States clock = mInputB->GetState();
+    States D = Get(mInputA)->GetState();
+    States clock = Get(mInputB)->GetState();
 
     // Clock transitions from 0 to 1
     if (mPreviousClock == States::Zero && clock == States::One)
     {
-        mOutputA->SetState(D);
+        Get(mOutputA)->SetState(D);
         if (D == States::Zero)
         {
-            mOutputB->SetState(States::One);
+            Get(mOutputB)->SetState(States::One);
         }
         else
         {
-            mOutputB->SetState(States::Zero);
+            Get(mOutputB)->SetState(States::Zero);
         }
     }
     mPreviousClock = clock;
@@ -78,14 +78,14 @@ void DFlipFlopGate::ComputeOutput()
  * Draws or gate
  * @param graphics Graphics context to draw on
  */
-void DFlipFlopGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
+void DFlipFlopGate::Draw(wxGraphicsContext *graphics) {
     // Create a path to draw the gate shape
     auto path = graphics->CreatePath();
 
-    mInputA->Draw(graphics);
-    mInputB->Draw(graphics);
-    mOutputA->Draw(graphics);
-    mOutputB->Draw(graphics);
+    Get(mInputA)->Draw(graphics);
+    Get(mInputB)->Draw(graphics);
+    Get(mOutputA)->Draw(graphics);
+    Get(mOutputB)->Draw(graphics);
 
     // Get the location and size
     auto x = GetX();
@@ -128,8 +128,8 @@ void DFlipFlopGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
  */
 void DFlipFlopGate::Update(double elapsed)
 {
-    mOutputA->Update();
-    mOutputB->Update();
+    Get(mOutputA)->Update();
+    Get(mOutputB)->Update();
     ComputeOutput(); // Recompute the output on each update
 }
 
@@ -170,15 +170,15 @@ double DFlipFlopGate::getHeight()
  * @param y Y location clicked on
  * @return Whatever we clicked on or NULL if none
  */
-std::shared_ptr<IDraggable> DFlipFlopGate::HitDraggable(int x, int y)
+IDraggable *DFlipFlopGate::HitDraggable(int x, int y)
 {
-    if(mOutputA->HitTest(x, y))
+    if(Get(mOutputA)->HitTest(x, y))
     {
-        return mOutputA;
+        return Get(mOutputA);
     }
-    if (mOutputB->HitTest(x, y))
+    if (Get(mOutputB)->HitTest(x, y))
     {
-        return mOutputB;
+        return Get(mOutputB);
     }
 
     return nullptr;
@@ -192,5 +192,33 @@ std::shared_ptr<IDraggable> DFlipFlopGate::HitDraggable(int x, int y)
  */
 bool DFlipFlopGate::Connect(OutputPin *pin, wxPoint lineEnd)
 {
-    return mInputA->Catch(pin, lineEnd) || mInputB->Catch(pin, lineEnd);
-}
\ No newline at end of file
+    return Get(mInputA)->Catch(pin, lineEnd) || Get(mInputB)->Catch(pin, lineEnd);
+}
+
+/**
+ * Save the flip flop's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void DFlipFlopGate::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Gates::SaveSnapshot(snapshot);
+    snapshot.Write(mPreviousClock);
+    Get(mInputA)->SaveSnapshot(snapshot);
+    Get(mInputB)->SaveSnapshot(snapshot);
+    Get(mOutputA)->SaveSnapshot(snapshot);
+    Get(mOutputB)->SaveSnapshot(snapshot);
+}
+
+/**
+ * Restore the flip flop's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void DFlipFlopGate::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Gates::RestoreSnapshot(snapshot);
+    snapshot.Read(mPreviousClock);
+    Get(mInputA)->RestoreSnapshot(snapshot);
+    Get(mInputB)->RestoreSnapshot(snapshot);
+    Get(mOutputA)->RestoreSnapshot(snapshot);
+    Get(mOutputB)->RestoreSnapshot(snapshot);
+}
@@ -14,19 +14,19 @@ class OutputPin;
 /**
  * Class for or gate.
  */
-class DFlipFlopGate : public Gates {
+class DFlipFlopGate final : public Gates {
 private:
     /// Previous state of the clock, used to track transitions.
     States mPreviousClock = States::Zero;
 
     /// InputPin A
-    std::shared_ptr<InputPin> mInputA;
+    ArenaHandle<InputPin> mInputA;
     /// InputPin B
-    std::shared_ptr<InputPin> mInputB;
+    ArenaHandle<InputPin> mInputB;
     /// OutputPin A
-    std::shared_ptr<OutputPin> mOutputA;
+    ArenaHandle<OutputPin> mOutputA;
     /// OutputPin B
-    std::shared_ptr<OutputPin> mOutputB;
+    ArenaHandle<OutputPin> mOutputB;
 public:
     /**
      * Constructor for or gate
@@ -35,17 +35,63 @@ public:
     DFlipFlopGate(Game *game);
 
     void ComputeOutput();
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Draw(wxGraphicsContext *graphics) override;
     void OnClick(double x, double y) override;
     void Update(double elapsed) override;
+    void SaveSnapshot(GameSnapshot &snapshot) const override;
+    void RestoreSnapshot(GameSnapshot &snapshot) override;
 
 
     double getWidth() override;
     double getHeight() override;
 
-    std::shared_ptr<IDraggable> HitDraggable(int x, int y) override;
+    IDraggable *HitDraggable(int x, int y) override;
 
     bool Connect(OutputPin *pin, wxPoint lineEnd) override;
+
+    /**
+     * Accept a visitor
+     * @param visitor The visitor we accept
+     */
+    void Accept(ItemVisitor* visitor) override { visitor->VisitDFlipFlopGate(this); }
+
+    /**
+     * Get the D input pin
+     * @return The pin
+     */
+    InputPin *GetInputA() const { return Get(mInputA); }
+
+    /**
+     * Get the clock input pin
+     * @return The pin
+     */
+    InputPin *GetInputB() const { return Get(mInputB); }
+
+    /**
+     * Get the Q output pin
+     * @return The pin
+     */
+    OutputPin *GetOutputA() const { return Get(mOutputA); }
+
+    /**
+     * Get the Q' output pin
+     * @return The pin
+     */
+    OutputPin *GetOutputB() const { return Get(mOutputB); }
+
+    /**
+     * Get an input pin by position
+     * @param index Pin index, from the top
+     * @return The pin, or nullptr
+     */
+    InputPin *GetInputPin(int index) const override { return index == 0 ? Get(mInputA) : index == 1 ? Get(mInputB) : nullptr; }
+
+    /**
+     * Get an output pin by position
+     * @param index Pin index, from the top
+     * @return The pin, or nullptr
+     */
+    OutputPin *GetOutputPin(int index) const override { return index == 0 ? Get(mOutputA) : index == 1 ? Get(mOutputB) : nullptr; }
 };
 
 
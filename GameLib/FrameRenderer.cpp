@@ -0,0 +1,91 @@
+/**
+ * @file FrameRenderer.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "FrameRenderer.h"
+#include <cstdlib>
+#include <memory>
+#include "Game.h"
+#include "SpriteAtlas.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param width Width of the frames in pixels
+ * @param height Height of the frames in pixels
+ */
+FrameRenderer::FrameRenderer(int width, int height) : mWidth(width), mHeight(height)
+{
+}
+
+/**
+ * Draw a frame of a game as it is now
+ * @param game Game to draw
+ * @return The frame
+ */
+wxImage FrameRenderer::Render(Game *game)
+{
+    // The view draws sprites once they are decoded; a frame waits for them
+    game->GetAtlas()->Wait();
+
+    return Render([this, game](wxGraphicsContext *graphics) {
+        game->OnDraw(graphics, mWidth, mHeight);
+    });
+}
+
+/**
+ * Draw a frame with a function
+ * @param draw Function that draws on the frame's graphics context
+ * @return The frame, black where nothing was drawn
+ */
+wxImage FrameRenderer::Render(const std::function<void(wxGraphicsContext *graphics)> &draw)
+{
+    wxImage image(mWidth, mHeight);
+
+    // The image holds what was drawn once the context is gone
+    {
+        auto graphics = unique_ptr<wxGraphicsContext>(wxGraphicsContext::Create(image));
+        if (graphics != nullptr)
+        {
+            draw(graphics.get());
+        }
+    }
+
+    return image;
+}
+
+/**
+ * Compare two frames
+ * @param image1 One frame
+ * @param image2 The other frame
+ * @param tolerance How far a color channel may be off before its pixel differs
+ * @return Fraction of the pixels that differ, 1 if the frames are not the same size
+ */
+double FrameRenderer::Difference(const wxImage &image1, const wxImage &image2, int tolerance)
+{
+    if (!image1.IsOk() || !image2.IsOk() || image1.GetSize() != image2.GetSize())
+    {
+        return 1;
+    }
+
+    const unsigned char *data1 = image1.GetData();
+    const unsigned char *data2 = image2.GetData();
+    long pixels = (long)image1.GetWidth() * image1.GetHeight();
+    long different = 0;
+    for (long p = 0; p < pixels; p++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            if (abs(data1[p * 3 + c] - data2[p * 3 + c]) > tolerance)
+            {
+                different++;
+                break;
+            }
+        }
+    }
+
+    return double(different) / pixels;
+}
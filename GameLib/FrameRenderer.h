@@ -0,0 +1,56 @@
+/**
+ * @file FrameRenderer.h
+ * @author matthew vazquez
+ *
+ * Draws frames of a game into an image, without a window.
+ */
+
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <functional>
+#include <wx/graphics.h>
+
+class Game;
+
+/**
+ * Draws frames of a game into an image, without a window.
+ *
+ * Frames are drawn through a graphics context made on a wxImage, the
+ * way GameView draws them on its window: the image starts black and
+ * the game draws itself scaled to fit. Sprites are decoded before
+ * drawing, so a frame never misses one. Frames can be saved as PNG
+ * for screenshots and compared with a tolerance, since the platform's
+ * renderer and fonts change the edges of shapes and text a little.
+ */
+class FrameRenderer
+{
+private:
+    /// Width of the frames in pixels
+    int mWidth;
+
+    /// Height of the frames in pixels
+    int mHeight;
+
+public:
+    FrameRenderer(int width, int height);
+
+    wxImage Render(Game *game);
+    wxImage Render(const std::function<void(wxGraphicsContext *graphics)> &draw);
+
+    static double Difference(const wxImage &image1, const wxImage &image2, int tolerance);
+
+    /**
+     * Get the width of the frames
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Get the height of the frames
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mHeight; }
+};
+
+#endif //FRAMERENDERER_H
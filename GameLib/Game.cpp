@@ -5,18 +5,69 @@
 
 #include "pch.h"
 #include "Game.h"
+#include <algorithm>
+#include <cmath>
 #include "Conveyor.h"
 #include "Item.h"
 #include "OrGate.h"
+#include "AndGate.h"
+#include "NotGate.h"
+#include "SrFlipFlopGate.h"
+#include "DFlipFlopGate.h"
+#include "MultiInputGate.h"
+#include "BusConnector.h"
+#include "PinFinder.h"
 #include "Beam.h"
 #include "Product.h"
 #include "Sensor.h"
 #include "Scoreboard.h"
 #include "Sparty.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
 #include "LevelLoader.h"
+#include "NetlistBuilder.h"
+#include "CircuitOptimizer.h"
+#include "ids.h"
+#include "WorkStealingPool.h"
+#include "XmlPullParser.h"
 
 using namespace std;
 
+/**
+ * Visitor that collects products
+ */
+class ActiveProductVisitor : public ItemVisitor
+{
+public:
+    /// Products visited
+    vector<Product *> &mProducts;
+
+    /**
+     * Constructor
+     * @param products Vector to add the products visited to
+     */
+    explicit ActiveProductVisitor(vector<Product *> &products) : mProducts(products) {}
+
+    /**
+     * Collect a product
+     * @param product Product we are visiting
+     */
+    void VisitProduct(Product *product) override { mProducts.push_back(product); }
+};
+
+/**
+ * Visitor that starts every conveyor
+ */
+class ConveyorStarter : public ItemVisitor
+{
+public:
+    /**
+     * Start a conveyor
+     * @param conveyor Conveyor we are visiting
+     */
+    void VisitConveyor(Conveyor *conveyor) override { conveyor->Start(); }
+};
+
 /// Frame duration in milliseconds
 const int FrameDuration = 30;
 
@@ -29,10 +80,6 @@ const int NoticeSize = 100;
 /// Color to draw the level notices
 const auto LevelNoticeColor = wxColour(24, 69, 59);
 
-/// Color to draw a rectangle enclosing the level notice text
-/// @return LevelNoticeBackground colour.
-wxColour LevelNoticeBackground(255, 255, 255, 200);
-
 /// Padding to add to the left and right side of the level
 /// notice background rectangle in virtual pixels
 const double LevelNoticePadding = 20;
@@ -42,9 +89,51 @@ const int Overlap = 75;
 
 /**
  * Game Constructor
+ * @param config Tunable settings for this game
  */
-Game::Game()
+Game::Game(const GameConfig &config) : mConfig(config)
 {
+    mRewind.SetCapacity(mConfig.mRewindSnapshots);
+
+    if (mConfig.mUpdateThreads != 1)
+    {
+        mUpdatePool = std::make_unique<WorkStealingPool>(mConfig.mUpdateThreads);
+    }
+}
+
+/**
+ * Destructor
+ */
+Game::~Game()
+{
+}
+
+/**
+ * Get the sprite images items are drawn with
+ * @return Atlas of the images directory
+ */
+SpriteAtlas *Game::GetAtlas()
+{
+    if (mAtlas == nullptr)
+    {
+        mAtlas = SpriteAtlas::Shared(L"images");
+    }
+    return mAtlas.get();
+}
+
+/**
+ * Get what items draw their sprites with. Games share the atlas's
+ * images, but each draws them with bitmaps of its own.
+ * @return This game's view of the atlas
+ */
+SpriteView *Game::GetSprites()
+{
+    if (mSprites == nullptr)
+    {
+        GetAtlas();
+        mSprites = std::make_unique<SpriteView>(mAtlas);
+    }
+    return mSprites.get();
 }
 
 /**
@@ -53,29 +142,22 @@ Game::Game()
  * @param width width of the drawing area
  * @param height height of the drawing area
  */
-void Game::OnDraw(std::shared_ptr<wxGraphicsContext> graphics, int width, int height)
+void Game::OnDraw(wxGraphicsContext *graphics, int width, int height)
 {
     // Determine the size of the playing area in pixels
     int pixelWidth = mPlayfieldWidth; // Still need to load this
     int pixelHeight = mPlayfieldHeight; // Still need to load this
 
-    // Automatic Scaling
-    auto scaleX = double(width) / double(pixelWidth);
-    auto scaleY = double(height) / double(pixelHeight);
-    mScale = std::min(scaleX, scaleY);
-
-    mXOffset = (width - pixelWidth * mScale) / 2.0;
-    mYOffset = 0;
-    if (height > pixelHeight * mScale)
-    {
-        mYOffset = (double)((height - pixelHeight * mScale) / 2.0);
-    }
+    SetViewSize(width, height);
 
     graphics->PushState();
 
     graphics->Translate(mXOffset, mYOffset);
     graphics->Scale(mScale, mScale);
 
+    // Sprites are resampled for the scale once, not on every frame
+    GetSprites()->SetScale(mScale);
+
     wxColour color(235,254,232);
     wxBrush boundaryBrush(color);
     graphics->SetBrush(boundaryBrush);
@@ -86,10 +168,8 @@ void Game::OnDraw(std::shared_ptr<wxGraphicsContext> graphics, int width, int he
     graphics->Clip(0,0, mPlayfieldWidth, mPlayfieldHeight);
 
     // Draw all game items
-    for (const auto& item : mItems)
-    {
-        item->Draw(graphics);
-    }
+    UpdateRuns();
+    mRuns.Draw(graphics);
 
     graphics->PopState();
 
@@ -107,6 +187,27 @@ void Game::OnDraw(std::shared_ptr<wxGraphicsContext> graphics, int width, int he
     }
 }
 
+/**
+ * Set the size of the window the game is shown in, which decides
+ * how window coordinates map to the playing area
+ * @param width width of the drawing area
+ * @param height height of the drawing area
+ */
+void Game::SetViewSize(int width, int height)
+{
+    // Automatic Scaling
+    auto scaleX = double(width) / double(mPlayfieldWidth);
+    auto scaleY = double(height) / double(mPlayfieldHeight);
+    mScale = std::min(scaleX, scaleY);
+
+    mXOffset = (width - mPlayfieldWidth * mScale) / 2.0;
+    mYOffset = 0;
+    if (height > mPlayfieldHeight * mScale)
+    {
+        mYOffset = (double)((height - mPlayfieldHeight * mScale) / 2.0);
+    }
+}
+
 /**
  * Resets the game Timer
  */
@@ -116,89 +217,196 @@ void Game::ResetTimer()
 }
 
 /**
- * process level
- * @param node xml node
+ * Look up the function of a multigate in a level file. An unknown
+ * name is reported and the gate is made an AND gate, so the wires
+ * into it still load.
+ * @param name Function name from the level file
+ * @return The function, And if the name is unknown
  */
-void Game::XmlGame(wxXmlNode* node)
+static MultiInputGate::Function MultigateFunction(const std::wstring &name)
 {
-    wxString levelSize = node->GetAttribute("size", "0,0");
-    int delimiterPos = levelSize.find(',');
-
+    auto function = MultiInputGate::Function::And;
+    if (!MultiInputGate::FunctionFromName(name, function))
+    {
+        wxLogWarning(L"Unknown gate function \"%s\" in the level; using and", name.c_str());
+    }
+    return function;
+}
 
-    levelSize.substr(0, delimiterPos).ToInt(&mPlayfieldWidth);
-    levelSize.substr(delimiterPos + 1, levelSize.length()).ToInt(&mPlayfieldHeight);
+/**
+ * Read the level size from the level element being read
+ * @param parser Parser on the level's start element
+ */
+void Game::XmlGame(XmlPullParser &parser)
+{
+    double width = 0;
+    double height = 0;
+    XmlPullParser::ToPair(parser.GetAttribute("size", "0,0"), width, height);
+    mPlayfieldWidth = (int)width;
+    mPlayfieldHeight = (int)height;
 }
 
 /**
- * Process item node
- * @param node XML node
+ * Process an item element being read. Items that have children read
+ * them, and the children of those that do not are skipped.
+ * @param parser Parser on the item's start element
  */
-void Game::XmlItem(wxXmlNode *node)
+void Game::XmlItem(XmlPullParser &parser)
 {
-    auto name = node->GetName().ToStdWstring();
+    auto name = parser.GetName();
     shared_ptr<Item> item;
 
-    if (name == L"conveyor")
+    if (name == "line")
     {
-        auto conveyor = make_shared<Conveyor>(this);
+        XmlLine(parser);
+    }
+    else if (name == "conveyor")
+    {
+        auto conveyor = Create<Conveyor>(this);
         mItems.push_back(conveyor);
-        conveyor->XmlLoad(node);
-
+        mItemsVersion++;
+        LoadingLine()->Add(conveyor.get());
+        conveyor->XmlLoad(parser);
     }
-    else if (name == L"orgate")
+    else if (name == "orgate")
     {
-        item = make_shared<OrGate>(this);
-        if (item != nullptr)
-        {
-            item->XmlLoad(node);
-            Add(item);
-        }
+        XmlGate(parser, Create<OrGate>(this));
+    }
+    else if (name == "andgate")
+    {
+        XmlGate(parser, Create<AndGate>(this));
+    }
+    else if (name == "notgate")
+    {
+        XmlGate(parser, Create<NotGate>(this));
+    }
+    else if (name == "srflipflop")
+    {
+        XmlGate(parser, Create<SrFlipFlopGate>(this));
+    }
+    else if (name == "dflipflop")
+    {
+        XmlGate(parser, Create<DFlipFlopGate>(this));
     }
-    else if (name == L"beam")
+    else if (name == "multigate")
     {
-        item = make_shared<Beam>(this);
-        if (item != nullptr)
+        long inputs = parser.GetLong("inputs", 2);
+        long width = parser.GetLong("width", 1);
+        auto function = MultigateFunction(XmlPullParser::Decode(parser.GetAttribute("function", "and")));
+        XmlGate(parser, Create<MultiInputGate>(this, function, (int)inputs, (int)width));
+    }
+    else if (name == "busjoin" || name == "bussplit")
+    {
+        long width = parser.GetLong("width", BusConnector::MinWidth);
+        auto kind = name == "busjoin" ? BusConnector::Kind::Join : BusConnector::Kind::Split;
+        XmlGate(parser, Create<BusConnector>(this, kind, (int)width));
+    }
+    else if (name == "beam" || name == "sensor" || name == "sparty")
+    {
+        if (name == "beam")
+        {
+            item = Create<Beam>(this);
+        }
+        else if (name == "sensor")
         {
-            item->XmlLoad(node);
+            item = Create<Sensor>(this);
+        }
+        else
+        {
+            item = Create<Sparty>(this);
+        }
 
-            double x = item->GetX();
-            double y = item->GetY();
+        LoadingLine()->Add(item.get());
+        item->XmlLoad(parser);
 
-            Add(item, x, y);
-        }
+        double x = item->GetX();
+        double y = item->GetY();
+
+        Add(item, x, y);
     }
-    else if (name == L"sensor")
+    else if (name == "scoreboard")
     {
-        item = make_shared<Sensor>(this);
-        if (item != nullptr)
-        {
-            item->XmlLoad(node);
+        item = Create<Scoreboard>(this);
+        item->XmlLoad(parser);
+        Add(item);
+    }
+}
 
-            double x = item->GetX();
-            double y = item->GetY();
+/**
+ * Process a line element being read, loading the items of one production line
+ * @param parser Parser on the line's start element
+ */
+void Game::XmlLine(XmlPullParser &parser)
+{
+    mLines.push_back(std::make_unique<ProductionLine>((int)mLines.size()));
+    mLoadingLine = mLines.back().get();
 
-            Add(item, x, y);
-        }
-    }
-    else if (name == L"scoreboard")
+    int depth = parser.GetDepth();
+    while (parser.NextChild(depth))
     {
-        item = make_shared<Scoreboard>(this);
-        if (item != nullptr)
+        if (parser.IsStartElement())
         {
-            item->XmlLoad(node);
-            Add(item);
+            XmlItem(parser);
         }
     }
-    else if (name == L"sparty")
+
+    mLoadingLine = nullptr;
+}
+
+/**
+ * Load a gate from a level being read. Gates with a location are
+ * placed there, others are placed like gates added from the menu.
+ * @param parser Parser on the gate's start element
+ * @param gate The new gate
+ */
+void Game::XmlGate(XmlPullParser &parser, std::shared_ptr<Gates> gate)
+{
+    gate->XmlLoad(parser);
+    if (parser.HasAttribute("x"))
     {
-        item = make_shared<Sparty>(this);
-        if (item != nullptr)
-        {
-            item->XmlLoad(node);
-            double x = item->GetX();
-            double y = item->GetY();
-            Add(item, x, y);
-        }
+        Add(gate, gate->GetX(), gate->GetY());
+    }
+    else
+    {
+        Add(gate);
+    }
+}
+
+/**
+ * Get the line items being loaded belong to. Items outside any line
+ * node share a line, created when the first of them is loaded.
+ * @return Line to add the item being loaded to
+ */
+ProductionLine *Game::LoadingLine()
+{
+    if (mLoadingLine != nullptr)
+    {
+        return mLoadingLine;
+    }
+
+    if (mDefaultLine == nullptr)
+    {
+        mLines.push_back(std::make_unique<ProductionLine>((int)mLines.size()));
+        mDefaultLine = mLines.back().get();
+    }
+    return mDefaultLine;
+}
+
+/**
+ * Connect an output pin to an input pin named the way wire nodes name them
+ * @param fromEndpoint Output endpoint, such as beam
+ * @param toEndpoint Input endpoint, such as sparty
+ */
+void Game::XmlWire(const std::wstring &fromEndpoint, const std::wstring &toEndpoint)
+{
+    PinFinder from(fromEndpoint);
+    PinFinder to(toEndpoint);
+    from.Find(this);
+    to.Find(this);
+
+    if (from.GetOutputPin() != nullptr && to.GetInputPin() != nullptr)
+    {
+        from.GetOutputPin()->SetConnection(to.GetInputPin());
     }
 }
 
@@ -215,6 +423,7 @@ void Game::Add(std::shared_ptr<Item> item)
     AdjustPosition(item, InitialX, InitialY);
 
     mItems.push_back(item);
+    mItemsVersion++;
 }
 
 /**
@@ -254,6 +463,7 @@ void Game::Add(std::shared_ptr<Item> item, int customX, int customY)
 {
     item->SetLocation(customX, customY);
     mItems.push_back(item);
+    mItemsVersion++;
 }
 
 /**
@@ -261,21 +471,87 @@ void Game::Add(std::shared_ptr<Item> item, int customX, int customY)
  */
 void Game::Clear()
 {
+    mGrabbedItem = nullptr;
     mItems.clear();
+    mItemsVersion++;
+    mLines.clear();
+    mDefaultLine = nullptr;
+    mActiveItems.clear();
+    mActiveProducts.clear();
+    mThroughput.Clear();
+
+    // Snapshots of the old items cannot be restored into the new ones
+    mRewind.Clear();
+    mRewindTime = 0;
+
+    // The old arena goes once nothing placed in it is left
+    mArena = make_shared<ItemArena>();
 }
 
 /**
- * Handles updates for animation
- * @param elapsed time since last update
+ * Remove an item from the game
+ * @param item Item to remove
  */
-void Game::Update(double elapsed)
+void Game::Remove(Item *item)
+{
+    mGrabbedItem = nullptr;
+    mItems.erase(std::remove_if(mItems.begin(), mItems.end(),
+                                [item](const shared_ptr<Item> &other) { return other.get() == item; }),
+                 mItems.end());
+    mItemsVersion++;
+}
+
+/**
+ * Keep the circuit built on the current level, so it comes back
+ * when the level is loaded again
+ */
+void Game::StashCircuit()
+{
+    if (!mLevelFile.empty())
+    {
+        mLevelCircuits[mLevelFile].Capture(this);
+    }
+}
+
+/**
+ * Note the level file just loaded and bring back the circuit built
+ * on it before, if there is one
+ * @param levelFile Level file the items were loaded from
+ */
+void Game::RestoreCircuit(const std::wstring &levelFile)
 {
+    mLevelFile = levelFile;
 
+    auto circuit = mLevelCircuits.find(levelFile);
+    if (circuit != mLevelCircuits.end())
+    {
+        circuit->second.Apply(this);
+    }
+}
 
-    for (auto item : mItems)
+/**
+ * Load the current level again from its file's new text, keeping the
+ * circuit built on it, the score and the time
+ * @param parser Parser over the level file's text, checked to be well formed
+ */
+void Game::ReloadLevel(XmlPullParser &parser)
+{
+    if (!mLevelFile.empty())
     {
-        item->Update(elapsed);
+        mLevelLoader.LoadLevel(parser, mLevelFile, this);
     }
+}
+
+/**
+ * Handles updates for animation
+ * @param elapsed time since last update
+ */
+void Game::Update(double elapsed)
+{
+    UpdateRuns();
+    mUpdateGraph.Update(elapsed, mUpdatePool.get());
+    UpdateLines(elapsed);
+    RetireProducts();
 
     mTimer.Update(elapsed);
     UpdateTimeBonus();
@@ -300,7 +576,7 @@ void Game::Update(double elapsed)
         {
             mCurrentState = State::LoadingNextlLevel;
             mEndDelay = 0;
-            if (mCurrentLevel < 8)
+            if (mCurrentLevel < mMaxLevel)
             {
                 mCurrentLevel++;
             }
@@ -317,13 +593,40 @@ void Game::Update(double elapsed)
         break;
 
     default:
-        if (mTimer.GetRemainingTime() <= 0 && !mGameEnded)
+        // An endless level runs until another level is picked
+        if (mTimer.GetRemainingTime() <= 0 && !mGameEnded && !IsEndless())
         {
             mCurrentState = State::Ending;
             mEndDelay = 2.0;
         }
         break;
     }
+
+    mRewindTime += elapsed;
+    if (mRewindTime >= mConfig.mRewindInterval)
+    {
+        mRewindTime = 0;
+        mRewind.Push(this);
+    }
+}
+
+/**
+ * Advance the game by a simulated time, in equal steps no longer than
+ * the configured longest step, so items moving fast stay stable
+ * @param elapsed Simulated time in seconds
+ * @return Number of steps taken
+ */
+int Game::Advance(double elapsed)
+{
+    // A time that is a whole number of steps is not rounded up to one more
+    int steps = std::max(1, (int)ceil(elapsed / mConfig.mMaxTimeStep - 1e-9));
+    double step = elapsed / steps;
+    for (int i = 0; i < steps; i++)
+    {
+        Update(step);
+    }
+
+    return steps;
 }
 
 /**
@@ -332,7 +635,7 @@ void Game::Update(double elapsed)
  * @param y location in pixels
  * @returns Pointer to item clicked on, or nullptr if none.
  */
-std::shared_ptr<IDraggable> Game::HitTest(int x, int y)
+IDraggable *Game::HitTest(int x, int y)
 {
     for (auto i = mItems.rbegin(); i != mItems.rend();  i++)
     {
@@ -345,30 +648,13 @@ std::shared_ptr<IDraggable> Game::HitTest(int x, int y)
 
         if ((*i)->HitTest(x, y))
         {
-            return *i;
+            return i->get();
         }
     }
 
     return  nullptr;
 }
 
-/**
- * Adds product onto conveyor
- * @param node The node that is to be added
- * @param conveyor The conveyor that will be added on
- */
-void Game::AddProduct(wxXmlNode *node, std::shared_ptr<Conveyor> conveyor)
-{
-    auto product = make_shared<Product>(this);
-    product->XmlLoad(node);
-    double placement = 0;
-    node->GetAttribute("placement", "0").ToDouble(&placement);
-    double conveyorX = conveyor->GetX();
-    double conveyorY = conveyor->GetY();
-    product->SetLocation(conveyorX, conveyorY - placement);
-    mItems.push_back(product);
-}
-
 /**
  * Handle a mouse click
  * @param x X location clicked on
@@ -397,6 +683,322 @@ void Game::OnLeftDown(int x, int y)
     mX = oX;
     mY = oY;
     OnMouseDown(x, y);
+    mGrabbedItem = HitTest(mX, mY);
+}
+
+/**
+ * Handle the mouse move event, dragging any item grabbed
+ * @param x X coordinate of mouse
+ * @param y Y coordinate of mouse
+ * @param leftDown True if the left button is down
+ */
+void Game::OnMouseMove(int x, int y, bool leftDown)
+{
+    if (mGrabbedItem != nullptr)
+    {
+        if (leftDown && mGrabbedItem->IsGrabbable())
+        {
+            OnLeftDown(x, y);
+            mGrabbedItem->SetLocation(mX, mY);
+        }
+        else
+        {
+            mGrabbedItem->Release();
+            mGrabbedItem = nullptr;
+        }
+    }
+}
+
+/**
+ * Handle the left mouse button up event, dropping any item grabbed
+ * @param x X coordinate of mouse
+ * @param y Y coordinate of mouse
+ */
+void Game::OnLeftUp(int x, int y)
+{
+    OnMouseMove(x, y, false);
+}
+
+/**
+ * Carry out a Level or Gates menu command
+ * @param id Menu id of the command
+ * @return True if the id names a command the game carries out
+ */
+bool Game::OnCommand(int id)
+{
+    if (id >= IDM_LEVEL0 && id <= IDM_LEVEL10)
+    {
+        SelectLevel(id - IDM_LEVEL0);
+        return true;
+    }
+
+    if (id == IDM_REWIND)
+    {
+        Rewind();
+        return true;
+    }
+
+    if ((id >= IDM_ANDGATE && id <= IDM_NORGATE) || (id >= IDM_AND4BUS && id <= IDM_BUSSPLIT))
+    {
+        AddGate(id);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Start a level over, as when it is picked from the Level menu
+ * @param level Level number
+ */
+void Game::SelectLevel(int level)
+{
+    ResetTimer();
+    mLevelLoader.LoadLevel(LevelFile(level), this);
+    BeginLevel(level);
+}
+
+/**
+ * Start a level over from a level file already read, as on another thread
+ * @param level Level number
+ * @param parser Parser over the level file's text, checked to be well formed
+ */
+void Game::SelectLevel(int level, XmlPullParser &parser)
+{
+    ResetTimer();
+    mLevelLoader.LoadLevel(parser, LevelFile(level), this);
+    BeginLevel(level);
+}
+
+/**
+ * Get the file a level is loaded from
+ * @param level Level number
+ * @return Level file, such as levels/level1.xml
+ */
+wxString Game::LevelFile(int level)
+{
+    return "levels/level" + wxString::Format("%d", level) + ".xml";
+}
+
+/**
+ * Show the start of a level just selected, with the score reset
+ * @param level Level number
+ */
+void Game::BeginLevel(int level)
+{
+    SetCurrentLevel(level);
+    SetStateLoading();
+    GetScore()->ResetLevelScore();
+    GetScore()->ResetGameScore();
+}
+
+/**
+ * Add a new gate, as when it is picked from the Gates menu
+ * @param id Gates menu id of the gate
+ */
+void Game::AddGate(int id)
+{
+    auto function = MultiInputGate::Function::And;
+    int inputs = MultiInputGate::MinInputs;
+    int width = 1;
+    shared_ptr<Item> gate;
+    switch (id)
+    {
+    case IDM_ANDGATE:
+        gate = Create<AndGate>(this);
+        break;
+
+    case IDM_ORGATE:
+        gate = Create<OrGate>(this);
+        break;
+
+    case IDM_NOTGATE:
+        gate = Create<NotGate>(this);
+        break;
+
+    case IDM_SRFLIPFLOP:
+        gate = Create<SrFlipFlopGate>(this);
+        break;
+
+    case IDM_DFLIPFLOP:
+        gate = Create<DFlipFlopGate>(this);
+        break;
+
+    case IDM_AND4GATE:
+        inputs = 4;
+        break;
+
+    case IDM_OR4GATE:
+        function = MultiInputGate::Function::Or;
+        inputs = 4;
+        break;
+
+    case IDM_XORGATE:
+        function = MultiInputGate::Function::Xor;
+        break;
+
+    case IDM_NANDGATE:
+        function = MultiInputGate::Function::Nand;
+        break;
+
+    case IDM_AND4BUS:
+        width = 4;
+        break;
+
+    case IDM_BUSJOIN:
+        gate = Create<BusConnector>(this, BusConnector::Kind::Join, 4);
+        break;
+
+    case IDM_BUSSPLIT:
+        gate = Create<BusConnector>(this, BusConnector::Kind::Split, 4);
+        break;
+
+    default:
+        function = MultiInputGate::Function::Nor;
+        break;
+    }
+
+    if (gate == nullptr)
+    {
+        gate = Create<MultiInputGate>(this, function, inputs, width);
+    }
+    Add(gate);
+}
+
+/**
+ * Start every conveyor, as the player's click on the start button
+ * does. Headless players, tools and tests start levels this way.
+ */
+void Game::StartConveyors()
+{
+    ConveyorStarter starter;
+    Accept(&starter);
+}
+
+/**
+ * Replace the gates and wires with a saved circuit
+ * @param circuit Circuit to build
+ */
+void Game::ApplyCircuit(const CircuitSerializer &circuit)
+{
+    mGrabbedItem = nullptr;
+    circuit.Apply(this);
+}
+
+/**
+ * Save the simulation state of the game and every item in it
+ * @param snapshot Snapshot to fill, replacing what it held
+ */
+void Game::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    snapshot.Clear();
+    snapshot.Write(this);
+    snapshot.Write(mItemsVersion);
+
+    snapshot.Write(mX);
+    snapshot.Write(mY);
+    snapshot.Write(mTimer);
+    snapshot.Write(*mScore);
+    snapshot.Write(mCurrentState);
+    snapshot.Write(mEndDelay);
+    snapshot.Write(mStartDelay);
+    snapshot.Write(mCurrentLevel);
+    snapshot.Write(mTimeBonus);
+    snapshot.Write(mGameEnded);
+    snapshot.Write(mThroughput);
+
+    for (const auto &line : mLines)
+    {
+        line->SaveSnapshot(snapshot);
+    }
+
+    for (const auto &item : mItems)
+    {
+        item->SaveSnapshot(snapshot);
+    }
+}
+
+/**
+ * Put the game back the way it was when a snapshot was taken
+ * @param snapshot Snapshot taken of this game
+ * @return True if restored; false if the snapshot is of another game
+ * or items were added or removed since it was taken
+ */
+bool Game::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    const Game *game = nullptr;
+    uint64_t version = 0;
+    snapshot.StartReading();
+    if (!snapshot.Read(game) || !snapshot.Read(version) || game != this || version != mItemsVersion)
+    {
+        return false;
+    }
+
+    mGrabbedItem = nullptr;
+    mActiveChanged = true;
+    snapshot.Read(mX);
+    snapshot.Read(mY);
+    snapshot.Read(mTimer);
+    snapshot.Read(*mScore);
+    snapshot.Read(mCurrentState);
+    snapshot.Read(mEndDelay);
+    snapshot.Read(mStartDelay);
+    snapshot.Read(mCurrentLevel);
+    snapshot.Read(mTimeBonus);
+    snapshot.Read(mGameEnded);
+    snapshot.Read(mThroughput);
+
+    for (const auto &line : mLines)
+    {
+        line->RestoreSnapshot(snapshot);
+    }
+
+    for (const auto &item : mItems)
+    {
+        item->RestoreSnapshot(snapshot);
+    }
+    return true;
+}
+
+/**
+ * Go back to the most recent rewind snapshot. Rewinding again goes
+ * further back, a snapshot at a time.
+ * @return True if there was a snapshot to go back to
+ */
+bool Game::Rewind()
+{
+    mRewindTime = 0;
+    return mRewind.Rewind(this);
+}
+
+/**
+ * Compute a hash of where everything in the game is, the score and
+ * the sequencing state. Two games that got the same input end with
+ * the same hash.
+ * @return 64-bit FNV-1a hash of the game state
+ */
+uint64_t Game::StateHash() const
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void *data, size_t size) {
+        auto bytes = (const unsigned char *)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    for (const auto &item : mItems)
+    {
+        double location[] = {item->GetX(), item->GetY()};
+        mix(location, sizeof(location));
+    }
+
+    int values[] = {(int)mCurrentState, mCurrentLevel, mScore->GetGameScore(), mScore->GetLevelScore()};
+    mix(values, sizeof(values));
+    double remaining = mTimer.GetRemainingTime();
+    mix(&remaining, sizeof(remaining));
+    return hash;
 }
 
 /**
@@ -411,6 +1013,79 @@ void Game::Accept(ItemVisitor* visitor)
     }
 }
 
+/**
+ * Check the circuit currently wired against the level's products
+ * without running the conveyor. A level with several production
+ * lines is checked a line at a time.
+ * @return What happens to each product, line by line in the order they reach the sensor
+ */
+std::vector<CircuitVerifier::ProductResult> Game::VerifyCircuit()
+{
+    if (mLines.size() <= 1)
+    {
+        NetlistBuilder builder;
+        Accept(&builder);
+
+        auto netlist = builder.BuildNetlist();
+        CircuitVerifier verifier(netlist, &mCircuitCache);
+        return verifier.Verify(builder.BuildProducts());
+    }
+
+    // Each line's Sparty answers to its own circuit and products
+    std::vector<CircuitVerifier::ProductResult> results;
+    for (const auto &line : mLines)
+    {
+        NetlistBuilder builder(line.get());
+        Accept(&builder);
+
+        auto netlist = builder.BuildNetlist();
+        CircuitVerifier verifier(netlist, &mCircuitCache);
+        for (auto result : verifier.Verify(builder.BuildProducts()))
+        {
+            result.mLine = line->GetIndex();
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+/**
+ * Measure the circuit the player has wired. With several production
+ * lines, each line's circuit is measured and the counts added up.
+ * @param gates Receives the number of gates in the circuit
+ * @param optimized Receives the number of gates an equivalent optimized circuit needs
+ */
+void Game::MeasureCircuit(int &gates, int &optimized)
+{
+    if (mLines.size() <= 1)
+    {
+        NetlistBuilder builder;
+        Accept(&builder);
+
+        auto netlist = builder.BuildNetlist();
+        CircuitOptimizer optimizer(netlist);
+        gates = optimizer.GetOriginalGates();
+        optimized = optimizer.GetOptimizedGates();
+        return;
+    }
+
+    // Each line's circuit is the gates its Sparty depends on. Both
+    // counts are added up over the lines, so a gate that more than one
+    // line's Sparty depends on is counted once for each
+    gates = 0;
+    optimized = 0;
+    for (const auto &line : mLines)
+    {
+        NetlistBuilder builder(line.get());
+        Accept(&builder);
+
+        auto netlist = builder.BuildNetlist();
+        CircuitOptimizer optimizer(netlist);
+        gates += netlist.GetNumCellsFeeding(netlist.GetKickNet());
+        optimized += optimizer.GetOptimizedGates();
+    }
+}
+
 void Game::TryToConnect(OutputPin* pin, wxPoint lineEnd)
 {
     for (auto i = mItems.rbegin(); i != mItems.rend();  i++)
@@ -455,7 +1130,7 @@ void Game::SetStateLoading()
  * @param rect Window width and height
  * @param message Message to display on screen
  */
-void Game::DisplayMessage(std::shared_ptr<wxGraphicsContext> gc, double scale, wxRect rect, wxString message)
+void Game::DisplayMessage(wxGraphicsContext *gc, double scale, wxRect rect, wxString message)
 {
     auto levelMessageFont = gc->CreateFont(NoticeSize * scale, "Arial", wxFONTFLAG_BOLD, LevelNoticeColor);
     gc->SetFont(levelMessageFont);
@@ -472,7 +1147,7 @@ void Game::DisplayMessage(std::shared_ptr<wxGraphicsContext> gc, double scale, w
     double rectangleHeight = messageHeight + (LevelNoticePadding * scale); //Add padding to top and bottom.
 
     // Draw level start box, centered on screen.
-    wxBrush brush(LevelNoticeBackground);
+    wxBrush brush(mConfig.mLevelNoticeBackground);
     gc->SetBrush(brush);
     gc->SetPen(*wxTRANSPARENT_PEN);
     gc->DrawRectangle(rectangleX, rectangleY, rectangleWidth, rectangleHeight);
@@ -485,9 +1160,8 @@ void Game::LoadNextLevel(int level)
 {
     mCurrentState = State::Loading;
     mStartDelay = 0;
-    wxString levelName = "levels/level" + wxString::Format("%d",level) + ".xml";
     ResetTimer();
-    mLevelLoader.LoadLevel(levelName, this);
+    mLevelLoader.LoadLevel(LevelFile(level), this);
 }
 
 void Game::UpdateScore()
@@ -496,6 +1170,67 @@ void Game::UpdateScore()
     levelScore += mTimeBonus;
     GetScore()->SetGameScore(GetScore()->GetGameScore() + levelScore);
     GetScore()->ResetLevelScore();
+
+    for (const auto &line : mLines)
+    {
+        line->ClearScore();
+    }
+}
+
+/**
+ * Rebuild the runs of items of one type and the stages items update
+ * in if items were added, removed, retired or brought back. Only
+ * items still in play are updated and drawn.
+ */
+void Game::UpdateRuns()
+{
+    if (mRunsVersion == mItemsVersion && !mActiveChanged && !mWiresChanged)
+    {
+        return;
+    }
+
+    mActiveItems.clear();
+    mActiveProducts.clear();
+    mRuns.Clear();
+    ActiveProductVisitor products(mActiveProducts);
+    for (const auto &item : mItems)
+    {
+        if (!item->IsRetired())
+        {
+            mActiveItems.push_back(item);
+            mRuns.Add(item.get());
+            item->Accept(&products);
+        }
+    }
+
+    for (const auto &line : mLines)
+    {
+        line->UpdateActive();
+    }
+
+    mUpdateGraph.Build(mActiveItems, (int)mLines.size());
+    mRunsVersion = mItemsVersion;
+    mActiveChanged = false;
+    mWiresChanged = false;
+}
+
+/**
+ * Retire products that can no longer affect play: those already
+ * scored that have left the playfield, kicked off it or carried off
+ * the end of the belt. Retired products are no longer moved, looked
+ * at or drawn, so a frame's work follows the products still in play.
+ */
+void Game::RetireProducts()
+{
+    for (auto product : mActiveProducts)
+    {
+        // Pooled products go back to their generator instead
+        if (product->GetScoreUpdated() && !product->IsPooled() && !product->IsOnPlayfield())
+        {
+            product->SetRetired(true);
+            mActiveChanged = true;
+        }
+    }
 }
 
 /**
@@ -531,4 +1266,62 @@ void Game::UpdateTimeBonus()
     {
         mTimeBonus = LargeDeducation;
     }
-}
\ No newline at end of file
+}
+/**
+ * Add the points the lines scored during an update to the level score,
+ * count the products they sorted, and end the level once every line
+ * with products has finished
+ * @param elapsed Time since the last update in seconds
+ */
+void Game::UpdateLines(double elapsed)
+{
+    bool justFinished = false;
+    bool allFinished = true;
+    for (const auto &line : mLines)
+    {
+        mScore->SetLevelScore(line->TakePendingScore());
+        mThroughput.Add(line->TakeSorted());
+        justFinished = line->TakeJustFinished() || justFinished;
+        if (line->GetNumProducts() > 0 && !line->IsFinished())
+        {
+            allFinished = false;
+        }
+    }
+
+    mThroughput.Update(elapsed);
+
+    if (justFinished && allFinished)
+    {
+        EndGame();
+    }
+}
+
+/**
+ * Does the level stream products without end?
+ * @return True if a line of the level never runs out of products
+ */
+bool Game::IsEndless() const
+{
+    for (const auto &line : mLines)
+    {
+        if (line->IsEndless())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Get the number of products on every line of the level
+ * @return Number of products in the game
+ */
+int Game::GetNumProducts() const
+{
+    int products = 0;
+    for (const auto &line : mLines)
+    {
+        products += line->GetNumProducts();
+    }
+    return products;
+}
@@ -6,18 +6,36 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 #include <wx/xml/xml.h>
 #include <wx/graphics.h>
 
 #include "OutputPin.h"
 #include "Product.h"
+#include "GameConfig.h"
+#include "GameSnapshot.h"
+#include "ItemArena.h"
+#include "ItemRuns.h"
+#include "ProductionLine.h"
+#include "UpdateGraph.h"
+#include "RewindBuffer.h"
 #include "Score.h"
+#include "Throughput.h"
 #include "Timer.h"
 #include "LevelLoader.h"
+#include "CircuitSerializer.h"
+#include "CircuitVerifier.h"
+#include "TruthTableCache.h"
 
 class Item;
+class Gates;
+class WorkStealingPool;
+class XmlPullParser;
+class SpriteAtlas;
+class SpriteView;
 
 /**
  *  Class representing the game environment.
@@ -26,26 +44,81 @@ class Item;
  */
 class Game
 {
+public:
+    /// Maintains the state of game for game sequencing
+    enum class State {Loading, Loaded, LoadingNextlLevel, Ending, Ended};
+
 private:
+    /// Tunable settings of this game
+    GameConfig mConfig;
+
+    /// Sprite images of every item, built when the first item needs it;
+    /// declared before the items so it outlives them
+    std::shared_ptr<SpriteAtlas> mAtlas;
+
+    /// This game's bitmaps of the atlas's sprites and the scale they are drawn at
+    std::unique_ptr<SpriteView> mSprites;
+
+    /// Memory the current level's items and pins are placed in; declared
+    /// before the items so it is still here when they destroy their pins
+    std::shared_ptr<ItemArena> mArena = std::make_shared<ItemArena>();
+
     /// Vector of all items in the game. Cannot be duplicated.
     std::vector<std::shared_ptr<Item>> mItems;
 
+    /// Changes whenever items are added or removed, so snapshots of
+    /// other items are not restored
+    uint64_t mItemsVersion = 0;
+
+    /// The items split by type, drawn without virtual calls
+    ItemRuns mRuns;
+
+    /// The items split into stages that can update in parallel
+    UpdateGraph mUpdateGraph;
+
+    /// Workers updating stages, null to update on the calling thread
+    std::unique_ptr<WorkStealingPool> mUpdatePool;
+
+    /// Items version mRuns and mUpdateGraph were built from
+    uint64_t mRunsVersion = 0;
+
+    /// Items that are not retired, the ones updated and drawn
+    std::vector<std::shared_ptr<Item>> mActiveItems;
+
+    /// Products among the active items, checked for retirement
+    std::vector<Product *> mActiveProducts;
+
+    /// True if items retired or came back since the active items were found
+    bool mActiveChanged = false;
+
+    /// True if wires were connected or removed since mUpdateGraph was built
+    bool mWiresChanged = false;
+
+    /// Recent snapshots to rewind to
+    RewindBuffer mRewind;
+
+    /// Simulated time since the last rewind snapshot
+    double mRewindTime = 0;
+
     /// Play Field Width
     int mPlayfieldWidth = 1200;
     /// Play Field Height
     int mPlayfieldHeight = 800;
 
     /// Scale based on Width and Height
-    double mScale;
+    double mScale = 1;
     /// Virtual offset of X
-    double mXOffset;
+    double mXOffset = 0;
     /// Virtual offset of Y
-    double mYOffset;
+    double mYOffset = 0;
 
     /// X coordinate of game.
-    double mX;
+    double mX = 0;
     /// Y coordinate of game.
-    double mY;
+    double mY = 0;
+
+    /// Any item we are currently dragging
+    IDraggable *mGrabbedItem = nullptr;
 
     /// Timer displayed on scoreboard, used to calculate score.
     Timer mTimer;
@@ -53,14 +126,29 @@ private:
     /// Shared pointer for the score, so that multiple classes can access
     std::shared_ptr<Score> mScore = std::make_shared<Score>();
 
-    /// Keeps track of number of products on conveyor
-    int mNumProducts = 0;
+    /// Production lines of the level, in the order declared
+    std::vector<std::unique_ptr<ProductionLine>> mLines;
+
+    /// Line whose items are being loaded, null outside a line node
+    ProductionLine *mLoadingLine = nullptr;
+
+    /// Line of the items a level places outside any line node
+    ProductionLine *mDefaultLine = nullptr;
+
+    /// Products the lines sorted, per minute
+    Throughput mThroughput;
 
     /// Helps load levels from xml files.
     LevelLoader mLevelLoader;
 
-    /// Maintains the state of game for game sequencing
-    enum class State {Loading, Loaded, LoadingNextlLevel, Ending, Ended};
+    /// Results of earlier circuit verifications
+    TruthTableCache mCircuitCache;
+
+    /// Circuits built on levels left earlier, by level file
+    std::map<std::wstring, CircuitSerializer> mLevelCircuits;
+
+    /// Level file the items were loaded from, empty if none
+    std::wstring mLevelFile;
 
     /// Maintains current state of game. Initial state of the game is loading.
     State mCurrentState = State::Loading;
@@ -75,7 +163,7 @@ private:
     int mCurrentLevel = 1;
 
     /// Maximum number of levels in the game
-    int mMaxLevel = 8;
+    int mMaxLevel = 9;
 
     /// Current time bonus of game
     int mTimeBonus = 30;
@@ -83,26 +171,101 @@ private:
     /// Flag to help prevent double endings
     bool mGameEnded = false;
 
+    void UpdateRuns();
+    void UpdateLines(double elapsed);
+    void RetireProducts();
+    ProductionLine *LoadingLine();
+    void BeginLevel(int level);
+
 public:
-    Game();
+    explicit Game(const GameConfig &config = GameConfig());
+    ~Game();
+
+    /// Copy constructor (disabled)
+    Game(const Game &) = delete;
 
-    void OnDraw(std::shared_ptr<wxGraphicsContext> graphics, int width, int height);
+    /// Assignment operator (disabled)
+    void operator=(const Game &) = delete;
+
+    void OnDraw(wxGraphicsContext *graphics, int width, int height);
+    void SetViewSize(int width, int height);
     void Add(std::shared_ptr<Item> item);
     void Add(std::shared_ptr<Item> item, int customX, int customY);
     void Update(double elapsed);
+    int Advance(double elapsed);
     void Clear();
-    std::shared_ptr<IDraggable> HitTest(int x, int y);
-    void XmlGame(wxXmlNode *node);
-    void XmlItem(wxXmlNode *node);
+    void Remove(Item *item);
+    void StashCircuit();
+    void RestoreCircuit(const std::wstring &levelFile);
+    void ReloadLevel(XmlPullParser &parser);
+
+    /**
+     * Get the file the current level was loaded from
+     * @return Level file, such as levels/level1.xml, or empty if none is loaded
+     */
+    const std::wstring &GetLevelFile() const { return mLevelFile; }
+
+    IDraggable *HitTest(int x, int y);
+    void XmlGame(XmlPullParser &parser);
+    void XmlItem(XmlPullParser &parser);
+    void XmlGate(XmlPullParser &parser, std::shared_ptr<Gates> gate);
+    void XmlLine(XmlPullParser &parser);
+    void XmlWire(const std::wstring &from, const std::wstring &to);
     void OnMouseDown(int x, int y);
-    void AddProduct(wxXmlNode *node, std::shared_ptr<Conveyor> conveyor);
+    void OnMouseMove(int x, int y, bool leftDown);
+    void OnLeftUp(int x, int y);
+    bool OnCommand(int id);
+    void SelectLevel(int level);
+    void SelectLevel(int level, XmlPullParser &parser);
+    static wxString LevelFile(int level);
+    void AddGate(int id);
+    void StartConveyors();
+    void ApplyCircuit(const CircuitSerializer &circuit);
+    uint64_t StateHash() const;
+    void SaveSnapshot(GameSnapshot &snapshot) const;
+    bool RestoreSnapshot(GameSnapshot &snapshot);
+    bool Rewind();
     void AdjustPosition(std::shared_ptr<Item> item, int &x, int &y);
 
+    /**
+     * Get the number of snapshots Rewind can go back to
+     * @return Number of snapshots held
+     */
+    int GetNumRewinds() const { return mRewind.GetCount(); }
+
+    /**
+     * Create an item in the current level's arena. Items create
+     * their pins and panels with Item::CreatePart.
+     * @tparam T Type to create
+     * @param args Constructor arguments
+     * @return The new object
+     */
+    template <class T, class... Args>
+    std::shared_ptr<T> Create(Args&&... args)
+    {
+        return std::allocate_shared<T>(ArenaAllocator<T>(mArena), std::forward<Args>(args)...);
+    }
+
+    /**
+     * Get the memory the current level's items and pins are placed in
+     * @return Arena for the level
+     */
+    const std::shared_ptr<ItemArena> &GetArena() const { return mArena; }
+
+    /**
+     * Get the tunable settings of this game
+     * @return Game settings
+     */
+    const GameConfig &GetConfig() const { return mConfig; }
+
     /**
      * Gets the pointer to the game score.
-     * @return shared pointer to game score.
+     * @return pointer to game score.
      */
-    std::shared_ptr<Score> GetScore() {return mScore;}
+    Score *GetScore() {return mScore.get();}
+
+    SpriteAtlas *GetAtlas();
+    SpriteView *GetSprites();
 
     /**
      * Gets the game timer.
@@ -123,6 +286,12 @@ public:
 
     void OnLeftDown(int x, int y);
 
+    /**
+     * Is an item being dragged?
+     * @return True if the mouse holds an item
+     */
+    bool IsDragging() const { return mGrabbedItem != nullptr; }
+
     /**
      * Get the height of the game area
      * @return Game area height in pixels
@@ -142,6 +311,8 @@ public:
     double GetY() const { return mY; }
 
     void Accept(ItemVisitor* visitor);
+    std::vector<CircuitVerifier::ProductResult> VerifyCircuit();
+    void MeasureCircuit(int &gates, int &optimized);
 
     /**
      * Get the scale of game window.
@@ -149,17 +320,53 @@ public:
      */
     double GetScale() const { return mScale; }
 
+    int GetNumProducts() const;
+
+    /**
+     * Get the number of production lines in the level
+     * @return Number of lines
+     */
+    int GetNumLines() const { return (int)mLines.size(); }
+
+    /**
+     * Get a production line of the level
+     * @param index Position of the line, from 0
+     * @return The line
+     */
+    ProductionLine *GetLine(int index) const { return mLines[index].get(); }
+
+    bool IsEndless() const;
+
+    /**
+     * Note that retired items may be back in play, so the active
+     * items are found again before the next update or draw
+     */
+    void InvalidateActive() { mActiveChanged = true; }
+
+    /**
+     * Note that a wire was connected or removed, so the items are
+     * grouped by the wires between them again before the next update
+     */
+    void InvalidateWires() { mWiresChanged = true; }
+
+    /**
+     * Get the number of items updated and drawn, as of the last
+     * update or draw
+     * @return Number of items that are not retired
+     */
+    int GetNumActiveItems() const { return (int)mActiveItems.size(); }
+
     /**
-     * Sets the number of products in the game.
-     * @param number new number of products
+     * Get the stages items update in, as of the last update or draw
+     * @return The update graph
      */
-    void SetNumProducts(int number) { mNumProducts = number; }
+    const UpdateGraph &GetUpdateGraph() const { return mUpdateGraph; }
 
     /**
-     * Returns the number of products in the game
-     * @return number of products in game
+     * Get the rate the level's products are being sorted at
+     * @return Products sorted per minute
      */
-    int GetNumProducts() const { return mNumProducts; }
+    const Throughput &GetThroughput() const { return mThroughput; }
 
     /**
      * Attempts to connect an output pin to a line.
@@ -184,7 +391,7 @@ public:
      */
     void SetStateLoading();
 
-    void DisplayMessage(std::shared_ptr<wxGraphicsContext> gc, double scale, wxRect rect, wxString message);
+    void DisplayMessage(wxGraphicsContext *gc, double scale, wxRect rect, wxString message);
 
     /**
      * Uses LevelLoader class to load levels from Xml to game.
@@ -0,0 +1,44 @@
+/**
+ * @file GameConfig.h
+ * @author matthew vazquez
+ *
+ * Tunable settings of one game.
+ */
+
+#ifndef GAMECONFIG_H
+#define GAMECONFIG_H
+
+/**
+ * Tunable settings of one game.
+ *
+ * Every Game owns a copy, and items read their settings through
+ * their game rather than from file-scope variables, so games with
+ * different settings can run side by side on different threads.
+ */
+struct GameConfig
+{
+    /// Width and height of a product in virtual pixels
+    double mProductSize = 80;
+
+    /// Size to draw a product's content relative to the product size
+    double mContentScale = 0.8;
+
+    /// Color of the rectangle enclosing the level notice text
+    wxColour mLevelNoticeBackground = wxColour(255, 255, 255, 200);
+
+    /// Number of snapshots kept for rewinding, 0 to not take any
+    int mRewindSnapshots = 30;
+
+    /// Simulated time between rewind snapshots in seconds
+    double mRewindInterval = 1.0;
+
+    /// Threads updating items, 1 to update on the thread calling
+    /// Game::Update, 0 for one per core
+    int mUpdateThreads = 1;
+
+    /// Longest simulated time one update covers in seconds; longer
+    /// times, as when the game runs fast, are split into equal steps
+    double mMaxTimeStep = 0.05;
+};
+
+#endif //GAMECONFIG_H
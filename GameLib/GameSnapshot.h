@@ -0,0 +1,94 @@
+/**
+ * @file GameSnapshot.h
+ * @author matthew vazquez
+ *
+ * The simulation state of a game, copied into a flat buffer.
+ */
+
+#ifndef GAMESNAPSHOT_H
+#define GAMESNAPSHOT_H
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+ * The simulation state of a game, copied into a flat buffer.
+ *
+ * Game::SaveSnapshot has each item append its state to the buffer,
+ * and Game::RestoreSnapshot reads it back in the same order. Only
+ * values are stored, with pins and items referred to by pointer, so
+ * a snapshot restores only the game it was taken from, and only
+ * while that game holds the same items. Taking a snapshot into a
+ * buffer used before reuses its memory.
+ */
+class GameSnapshot
+{
+private:
+    /// The saved state
+    std::vector<char> mData;
+
+    /// Where the next read comes from
+    size_t mReadPosition = 0;
+
+public:
+    /**
+     * Append a value to the snapshot
+     * @param value Value to append, copied bit for bit
+     */
+    template <class T>
+    void Write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshots hold plain values");
+        auto at = mData.size();
+        mData.resize(at + sizeof(T));
+        std::memcpy(&mData[at], &value, sizeof(T));
+    }
+
+    /**
+     * Read the next value from the snapshot
+     * @param value Receives the value, unchanged if the snapshot is used up
+     * @return True if a value was read
+     */
+    template <class T>
+    bool Read(T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshots hold plain values");
+        if (mReadPosition + sizeof(T) > mData.size())
+        {
+            return false;
+        }
+
+        std::memcpy(&value, &mData[mReadPosition], sizeof(T));
+        mReadPosition += sizeof(T);
+        return true;
+    }
+
+    /**
+     * Empty the snapshot, keeping its memory for the next one
+     */
+    void Clear()
+    {
+        mData.clear();
+        mReadPosition = 0;
+    }
+
+    /**
+     * Start reading from the beginning again
+     */
+    void StartReading() { mReadPosition = 0; }
+
+    /**
+     * Is the snapshot empty?
+     * @return True if nothing has been saved in it
+     */
+    bool IsEmpty() const { return mData.empty(); }
+
+    /**
+     * Get the size of the saved state
+     * @return Size in bytes
+     */
+    size_t GetSize() const { return mData.size(); }
+};
+
+#endif //GAMESNAPSHOT_H
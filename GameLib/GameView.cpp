@@ -8,15 +8,16 @@
 #include "pch.h"
 #include "GameView.h"
 #include <wx/dcbuffer.h>
+#include <wx/filedlg.h>
 #include <wx/graphics.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include "Game.h"
 #include "ids.h"
 #include "Item.h"
-#include "OrGate.h"
-#include "AndGate.h"
-#include "NotGate.h"
-#include "SrFlipFlopGate.h"
-#include "DFlipFlopGate.h"
+#include "CircuitSerializer.h"
+#include "XmlPullParser.h"
 
 /// Frame duration in milliseconds
 const int FrameDuration = 30;
@@ -24,8 +25,46 @@ const int FrameDuration = 30;
 /// one OneThousanth
 const double OneThousanth = 0.001;
 
+/// Level the game starts with
+const int StartLevel = 1;
+
+/// Real milliseconds of a frame spent updating at full speed
+const double FullSpeedBudget = FrameDuration * 0.6;
+
+/// Most update steps in a frame at full speed
+const int FullSpeedSteps = 2000;
+
 using namespace std;
 
+/**
+ * Settings for the game shown in the window
+ * @return Settings that update items on every core
+ */
+static GameConfig ViewConfig()
+{
+    GameConfig config;
+    config.mUpdateThreads = 0;
+    return config;
+}
+
+/**
+ * Constructor
+ */
+GameView::GameView() : mGame(ViewConfig()), mAssetWatcher(&mGame, this)
+{
+}
+
+/**
+ * Destructor
+ */
+GameView::~GameView()
+{
+    if (mStartLevelReader.joinable())
+    {
+        mStartLevelReader.join();
+    }
+}
+
 /**
  * Initialize the GameView class.
  * @param parent The parent window
@@ -42,24 +81,17 @@ void GameView::Initialize(wxFrame* parent)
     Bind(wxEVT_LEFT_UP, &GameView::OnLeftUp, this);
     Bind(wxEVT_MOTION, &GameView::OnMouseMove, this);
 
-    // Bind level menu events
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL0);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL1);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL2);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL3);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL4);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL5);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL6);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL7);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLevelSelect, this, IDM_LEVEL8);
-
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnAddOrGate, this, IDM_ORGATE);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnAddAndGate, this, IDM_ANDGATE);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnAddNotGate, this, IDM_NOTGATE);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnAddSRGate, this, IDM_SRFLIPFLOP);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnAddDGate, this, IDM_DFLIPFLOP);
+    // Bind level and gate menu events
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnCommand, this, IDM_LEVEL0, IDM_REWIND);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnCommand, this, IDM_ANDGATE, IDM_NORGATE);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnCommand, this, IDM_AND4BUS, IDM_BUSSPLIT);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnVerifyCircuit, this, IDM_VERIFYCIRCUIT);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnSaveCircuit, this, IDM_SAVECIRCUIT);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLoadCircuit, this, IDM_LOADCIRCUIT);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnSaveSession, this, IDM_SAVESESSION);
 
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnControlPoints, this, IDM_CONTROLPOINTS);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnSpeed, this, IDM_SPEED1, IDM_SPEEDMAX);
 
     mTimer.SetOwner(this);
     mTimer.Start(FrameDuration);
@@ -68,8 +100,10 @@ void GameView::Initialize(wxFrame* parent)
 
     mStopWatch.Start();
 
-    // Starts game with level 1 on load.
-    LoadStartLevel();
+    // The start level is loaded once the first frame is shown; see OnPaint
+
+    // Files can only be watched once the event loop runs
+    CallAfter([this] { mAssetWatcher.Start(); });
 }
 
 
@@ -91,17 +125,42 @@ void GameView::OnPaint(wxPaintEvent& event)
     auto gc =
         std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(dc));
 
-    // Compute the time that has elapsed since the last call to OnPaint
+    // Show a placeholder until the start level is loaded, and only
+    // start loading it once the window has been shown
+    if (!mStartLevelLoaded && mGame.GetLevelFile().empty())
+    {
+        wxRect rect = GetRect();
+        mGame.SetViewSize(rect.GetWidth(), rect.GetHeight());
+        mGame.DisplayMessage(gc.get(), mGame.GetScale(), rect, L"Loading...");
+        if (mFirstFrameTime < 0)
+        {
+            mFirstFrameTime = mStartupWatch.Time();
+            CallAfter(&GameView::LoadStartLevel);
+        }
+        return;
+    }
+
+    // Compute the time that has elapsed since the last call to OnPaint,
+    // and the game time that covers at the current speed. The log holds
+    // game time, so a session replays the same at any speed
     auto newTime = mStopWatch.Time();
-    auto elapsed = (double)(newTime - mTime) * OneThousanth;
+    auto simulated = SimulatedTime(newTime - mTime);
+    mRecorder.Tick(simulated);
     mTime = newTime;
 
     // Update the game with the elapsed time for animations
-    mGame.Update(elapsed);
+    auto start = chrono::steady_clock::now();
+    int steps = mGame.Advance((double)simulated * OneThousanth);
+    if (mSpeed == 0)
+    {
+        mStepCost = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / steps;
+    }
+    mRecorder.Checkpoint(&mGame);
 
     // Tell the game class to draw
     wxRect rect = GetRect();
-    mGame.OnDraw(gc, rect.GetWidth(), rect.GetHeight());
+    mRecorder.ViewSize(rect.GetWidth(), rect.GetHeight());
+    mGame.OnDraw(gc.get(), rect.GetWidth(), rect.GetHeight());
 }
 
 /**
@@ -110,8 +169,8 @@ void GameView::OnPaint(wxPaintEvent& event)
  */
 void GameView::OnLeftDown(wxMouseEvent& event)
 {
+    mRecorder.LeftDown(event.GetX(), event.GetY());
     mGame.OnLeftDown(event.GetX(), event.GetY());
-    mGrabbedItem = mGame.HitTest(mGame.GetX(), mGame.GetY());
 }
 
 /**
@@ -120,7 +179,9 @@ void GameView::OnLeftDown(wxMouseEvent& event)
  */
 void GameView::OnLeftUp(wxMouseEvent& event)
 {
-    OnMouseMove(event);
+    mRecorder.LeftUp(event.GetX(), event.GetY());
+    mGame.OnLeftUp(event.GetX(), event.GetY());
+    Refresh();
 }
 
 /**
@@ -129,50 +190,86 @@ void GameView::OnLeftUp(wxMouseEvent& event)
  */
 void GameView::OnMouseMove(wxMouseEvent &event)
 {
-    if (mGrabbedItem != nullptr)
+    // Moves only matter to the game while something is dragged
+    if (mGame.IsDragging())
     {
-        if (event.LeftIsDown() && mGrabbedItem->IsGrabbable())
-        {
-            mGame.OnLeftDown(event.GetX(), event.GetY());
-            mGrabbedItem->SetLocation(mGame.GetX(), mGame.GetY());
-        }
-        else
-        {
-            mGrabbedItem->Release();
-            mGrabbedItem = nullptr;
-        }
+        mRecorder.MouseMove(event.GetX(), event.GetY(), event.LeftIsDown());
+        mGame.OnMouseMove(event.GetX(), event.GetY(), event.LeftIsDown());
         Refresh();
     }
 }
 
 /**
- * Loads level 1 on game start.
+ * Loads level 1 on game start. The level file is read and checked on
+ * a worker thread while the images decode on another; the items are
+ * made on the UI thread by FinishStartLevel.
  */
 void GameView::LoadStartLevel()
 {
-    int level = 1;
-    wxString levelName = "levels/level" + wxString::Format("%d",level) + ".xml";
-    mGame.ResetTimer();
-    mLevelLoader.LoadLevel(levelName, &mGame);
-    GetGame().SetCurrentLevel(level);
+    auto filename = Game::LevelFile(StartLevel);
+    mStartLevelReader = thread([this, filename] {
+        auto parser = make_shared<XmlPullParser>();
+        bool wellFormed = parser->Read(filename) && parser->IsWellFormed();
+        CallAfter([this, parser, wellFormed] { FinishStartLevel(wellFormed ? parser.get() : nullptr); });
+    });
+
+    // Start decoding the images meanwhile
+    mGame.GetAtlas();
 }
+
 /**
- * Handle the level selection
- * @param event Menu event
+ * Put the start level in place once its file has been read
+ * @param parser Parser over the level file, or null if it could not be read
+ */
+void GameView::FinishStartLevel(XmlPullParser *parser)
+{
+    mStartLevelLoaded = true;
+
+    // A level picked from the menu meanwhile stays
+    if (!mGame.GetLevelFile().empty())
+    {
+        return;
+    }
+
+    if (parser == nullptr)
+    {
+        // Loading from the file reports what is wrong
+        RunCommand(IDM_LEVEL0 + StartLevel);
+    }
+    else
+    {
+        mRecorder.Command(IDM_LEVEL0 + StartLevel);
+        mGame.SelectLevel(StartLevel, *parser);
+        Refresh();
+    }
+
+    // Time spent loading is not played
+    mTime = mStopWatch.Time();
+
+    wxLogStatus(L"First frame in %ld ms, level ready in %ld ms", mFirstFrameTime, mStartupWatch.Time());
+}
+
+/**
+ * Have the game carry out a Level or Gates menu command, logging it
+ * so the session can be replayed
+ * @param id Menu id of the command
  */
-void GameView::OnLevelSelect(wxCommandEvent& event)
+void GameView::RunCommand(int id)
 {
-    int level = event.GetId() - IDM_LEVEL0;
-    wxString levelName = "levels/level" + wxString::Format("%d", level) + ".xml";
-    mGame.ResetTimer();
-    mLevelLoader.LoadLevel(levelName, &mGame);
-    GetGame().SetCurrentLevel(level);
-    GetGame().SetStateLoading();
-    GetGame().GetScore()->ResetLevelScore();
-    GetGame().GetScore()->ResetGameScore();
+    mRecorder.Command(id);
+    mGame.OnCommand(id);
     Refresh();
 }
 
+/**
+ * Handle the Level menu and the Gates menu's gates
+ * @param event Menu event, whose id says which command
+ */
+void GameView::OnCommand(wxCommandEvent& event)
+{
+    RunCommand(event.GetId());
+}
+
 /**
  * Handle toggling of control points
  * @param event Menu event
@@ -183,6 +280,51 @@ void GameView::OnControlPoints(wxCommandEvent& event)
     // mGame.ToggleControlPoints();
 }
 
+/**
+ * Get the game time a frame covers at the current speed. As fast as
+ * frames allow, that is as many of the longest update steps as the
+ * last frame's steps say fit in most of a frame.
+ * @param milliseconds Real time since the last frame
+ * @return Game time in milliseconds
+ */
+long GameView::SimulatedTime(long milliseconds) const
+{
+    if (mSpeed > 0)
+    {
+        return milliseconds * mSpeed;
+    }
+
+    int steps = mStepCost > 0 ? int(FullSpeedBudget / mStepCost) : 1;
+    return lround(mGame.GetConfig().mMaxTimeStep * 1000) * std::clamp(steps, 1, FullSpeedSteps);
+}
+
+/**
+ * Menu handler for View>Speed
+ * @param event Menu event
+ */
+void GameView::OnSpeed(wxCommandEvent& event)
+{
+    switch (event.GetId())
+    {
+    case IDM_SPEED2:
+        mSpeed = 2;
+        break;
+
+    case IDM_SPEED8:
+        mSpeed = 8;
+        break;
+
+    case IDM_SPEEDMAX:
+        mSpeed = 0;
+        mStepCost = 0;
+        break;
+
+    default:
+        mSpeed = 1;
+        break;
+    }
+}
+
 /**
  * Handle timer events
  * @param event Timer event
@@ -202,61 +344,106 @@ Game &GameView::GetGame()
 }
 
 /**
- * Menu hander for Add Gate>Or Gate
- * @param event Mouse event
+ * Menu handler for Gates>Verify Circuit
+ * @param event Menu event
  */
-void GameView::OnAddOrGate(wxCommandEvent& event)
+void GameView::OnVerifyCircuit(wxCommandEvent& event)
 {
-    auto gate = make_shared<OrGate>(&mGame);
-    mGame.Add(gate);
-    Refresh();
+    auto results = mGame.VerifyCircuit();
+
+    wxString message;
+    for (const auto& result : results)
+    {
+        // Products are numbered within their line when there are several
+        wxString product = wxString::Format(L"Product %d", result.mIndex + 1);
+        if (mGame.GetNumLines() > 1)
+        {
+            product = wxString::Format(L"Line %d product %d", result.mLine + 1, result.mIndex + 1);
+        }
+
+        if (result.IsMisKick())
+        {
+            message += product + (result.mExpectedKick ? L": should be kicked\n" : L": should not be kicked\n");
+        }
+        else if (result.mStateDependent)
+        {
+            message += product + L": depends on flip flop starting state\n";
+        }
+    }
+
+    int misKicks = CircuitVerifier::CountMisKicks(results);
+    message += wxString::Format(L"%d of %d products handled correctly",
+                                (int)results.size() - misKicks, (int)results.size());
+
+    int gates, optimized;
+    mGame.MeasureCircuit(gates, optimized);
+    message += wxString::Format(L"\n%d gates, %d after optimization", gates, optimized);
+
+    wxMessageBox(message, L"Verify Circuit", wxOK | wxICON_INFORMATION, this);
 }
 
+/// File types offered when saving and loading circuits
+const wxString CircuitFileTypes = L"Circuit files (*.circuit)|*.circuit|XML circuit files (*.xml)|*.xml";
+
 /**
- * Menu hander for Add Gate>And Gate
- * @param event Mouse event
+ * Menu handler for File>Save Circuit
+ * @param event Menu event
  */
-void GameView::OnAddAndGate(wxCommandEvent& event)
+void GameView::OnSaveCircuit(wxCommandEvent& event)
 {
-    auto gate = make_shared<AndGate>(&mGame);
-    mGame.Add(gate);
-    Refresh();
+    wxFileDialog saveDialog(this, L"Save Circuit", L"", L"", CircuitFileTypes, wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (saveDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    CircuitSerializer circuit;
+    circuit.Capture(&mGame);
+    if (!circuit.Save(saveDialog.GetPath()))
+    {
+        wxMessageBox(L"Unable to save circuit", L"Save Circuit", wxOK | wxICON_ERROR, this);
+    }
 }
 
 /**
- * Menu hander for Add Gate>Not Gate
- * @param event Mouse event
+ * Menu handler for File>Load Circuit
+ * @param event Menu event
  */
-void GameView::OnAddNotGate(wxCommandEvent& event)
+void GameView::OnLoadCircuit(wxCommandEvent& event)
 {
-    auto gate = make_shared<NotGate>(&mGame);
-    mGame.Add(gate);
-    Refresh();
-}
+    wxFileDialog loadDialog(this, L"Load Circuit", L"", L"", CircuitFileTypes, wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (loadDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
 
-/**
-* Menu hander for Add Gate>DFlipFlop Gate
-* @param event Mouse event
-*/
-void GameView::OnAddDGate(wxCommandEvent& event)
-{
-    auto gate = make_shared<DFlipFlopGate>(&mGame);
-    mGame.Add(gate);
+    CircuitSerializer circuit;
+    if (!circuit.Load(loadDialog.GetPath()))
+    {
+        wxMessageBox(L"Unable to load circuit", L"Load Circuit", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    mRecorder.Circuit(circuit);
+    mGame.ApplyCircuit(circuit);
     Refresh();
 }
 
 /**
-* Menu hander for Add Gate>SR Flip Flop Gate
-* @param event Mouse event
-*/
-void GameView::OnAddSRGate(wxCommandEvent& event)
+ * Menu handler for File>Save Session Log
+ * @param event Menu event
+ */
+void GameView::OnSaveSession(wxCommandEvent& event)
 {
-    auto gate = make_shared<SrFlipFlopGate>(&mGame);
-    mGame.Add(gate);
-    Refresh();
-}
-
-
-
-
+    wxFileDialog saveDialog(this, L"Save Session Log", L"", L"", L"Session logs (*.session)|*.session",
+                            wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (saveDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
 
+    if (!mRecorder.Save(saveDialog.GetPath(), &mGame))
+    {
+        wxMessageBox(L"Unable to save session log", L"Save Session Log", wxOK | wxICON_ERROR, this);
+    }
+}
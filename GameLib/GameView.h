@@ -10,8 +10,10 @@
 
 #include <wx/wx.h>
 #include <wx/timer.h>
+#include <thread>
+#include "AssetWatcher.h"
 #include "Game.h"
-#include "LevelLoader.h"
+#include "InputRecorder.h"
 
 /**
  * Class that implements our game view window.
@@ -21,9 +23,6 @@ private:
     /// An object that describes our game
     Game mGame;
 
-    /// Class to load on level selects from menu
-    LevelLoader mLevelLoader;
-
     /// Timer that allows for animation
     wxTimer mTimer;
 
@@ -33,13 +32,41 @@ private:
     /// The last stopwatch time
     long mTime = 0;
 
-    /// Any item we are currently dragging
-    std::shared_ptr<IDraggable> mGrabbedItem;
+    /// Log of everything done to the game, for replaying the session
+    InputRecorder mRecorder;
+
+    /// Reloads the level and images when their files are edited
+    AssetWatcher mAssetWatcher;
+
+    /// Time since the view was made, for measuring startup
+    wxStopWatch mStartupWatch;
+
+    /// Time the first frame was shown in milliseconds, -1 until it is
+    long mFirstFrameTime = -1;
+
+    /// True once the level the game starts with is in place
+    bool mStartLevelLoaded = false;
+
+    /// Thread reading the level the game starts with
+    std::thread mStartLevelReader;
+
+    /// Simulated seconds per real second, 0 for as fast as frames allow
+    int mSpeed = 1;
+
+    /// Real milliseconds one update step takes, measured at full speed
+    double mStepCost = 0;
+
+    void RunCommand(int id);
+    long SimulatedTime(long milliseconds) const;
+    void FinishStartLevel(XmlPullParser *parser);
 
 public:
+    GameView();
+    ~GameView() override;
+
     void Initialize(wxFrame* parent);
     void LoadStartLevel();
-    void OnLevelSelect(wxCommandEvent& event);
+    void OnCommand(wxCommandEvent& event);
     void OnTimer(wxTimerEvent& event);
     void OnPaint(wxPaintEvent& event);
 
@@ -47,13 +74,13 @@ public:
     void OnLeftUp(wxMouseEvent& event);
     void OnMouseMove(wxMouseEvent& event);
 
-    void OnAddOrGate(wxCommandEvent& event);
-    void OnAddAndGate(wxCommandEvent& event);
-    void OnAddNotGate(wxCommandEvent& event);
-    void OnAddSRGate(wxCommandEvent& event);
-    void OnAddDGate(wxCommandEvent& event);
+    void OnVerifyCircuit(wxCommandEvent& event);
+    void OnSaveCircuit(wxCommandEvent& event);
+    void OnLoadCircuit(wxCommandEvent& event);
+    void OnSaveSession(wxCommandEvent& event);
 
     void OnControlPoints(wxCommandEvent& event);
+    void OnSpeed(wxCommandEvent& event);
 
     Game &GetGame();
 };
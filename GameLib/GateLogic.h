@@ -0,0 +1,228 @@
+/**
+ * @file GateLogic.h
+ * @author matthew vazquez
+ *
+ * Bit-parallel form of the gate rules.
+ *
+ * Each LogicWord holds 64 independent pin states, so one call
+ * evaluates a gate for 64 simulations at once. The rules match
+ * the ComputeOutput functions of the gate classes exactly,
+ * including how Unknown inputs are handled.
+ */
+
+#ifndef GATELOGIC_H
+#define GATELOGIC_H
+
+#include <cstdint>
+
+/// The possible pin states
+enum class States {One, Zero, Unknown};
+
+/**
+ * 64 lanes of three-valued pin state.
+ *
+ * A lane is One when its bit is set in mOne, Zero when its bit
+ * is set in mZero and Unknown when it is set in neither.
+ */
+struct LogicWord
+{
+    /// Lanes that are One
+    uint64_t mOne = 0;
+
+    /// Lanes that are Zero
+    uint64_t mZero = 0;
+
+    /**
+     * Get the lanes that hold a known value
+     * @return Mask of lanes that are One or Zero
+     */
+    uint64_t Known() const { return mOne | mZero; }
+
+    /**
+     * Get a mask of the first lanes of a word
+     * @param count Number of lanes, 0 to 64
+     * @return Mask with the first count lanes set
+     */
+    static uint64_t Mask(int count) { return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1; }
+
+    /**
+     * Create a word with every lane set to the same state
+     * @param state State to copy into all lanes
+     * @return The new word
+     */
+    static LogicWord Splat(States state)
+    {
+        LogicWord word;
+        if (state == States::One)
+        {
+            word.mOne = ~uint64_t(0);
+        }
+        else if (state == States::Zero)
+        {
+            word.mZero = ~uint64_t(0);
+        }
+        return word;
+    }
+
+    /**
+     * Get the state of a single lane
+     * @param lane Lane index, 0 to 63
+     * @return State of that lane
+     */
+    States Lane(int lane) const
+    {
+        uint64_t bit = uint64_t(1) << lane;
+        if (mOne & bit)
+        {
+            return States::One;
+        }
+        return (mZero & bit) ? States::Zero : States::Unknown;
+    }
+
+    /**
+     * Set the state of a single lane
+     * @param lane Lane index, 0 to 63
+     * @param state New state for the lane
+     */
+    void SetLane(int lane, States state)
+    {
+        uint64_t bit = uint64_t(1) << lane;
+        mOne &= ~bit;
+        mZero &= ~bit;
+        if (state == States::One)
+        {
+            mOne |= bit;
+        }
+        else if (state == States::Zero)
+        {
+            mZero |= bit;
+        }
+    }
+
+    /**
+     * Compare two words lane for lane
+     * @param other Word to compare against
+     * @return True if every lane holds the same state
+     */
+    bool operator==(const LogicWord &other) const
+    {
+        return mOne == other.mOne && mZero == other.mZero;
+    }
+
+    /**
+     * Compare two words lane for lane
+     * @param other Word to compare against
+     * @return True if any lane differs
+     */
+    bool operator!=(const LogicWord &other) const { return !(*this == other); }
+};
+
+/**
+ * Gate rules applied to 64 lanes at a time.
+ */
+class GateLogic
+{
+public:
+    /**
+     * AND gate. Unknown if either input is Unknown.
+     * @param a Input A
+     * @param b Input B
+     * @return Output
+     */
+    static LogicWord And(LogicWord a, LogicWord b)
+    {
+        uint64_t known = a.Known() & b.Known();
+        LogicWord out;
+        out.mOne = known & a.mOne & b.mOne;
+        out.mZero = known & ~out.mOne;
+        return out;
+    }
+
+    /**
+     * OR gate. Unknown if either input is Unknown.
+     * @param a Input A
+     * @param b Input B
+     * @return Output
+     */
+    static LogicWord Or(LogicWord a, LogicWord b)
+    {
+        uint64_t known = a.Known() & b.Known();
+        LogicWord out;
+        out.mOne = known & (a.mOne | b.mOne);
+        out.mZero = known & ~out.mOne;
+        return out;
+    }
+
+    /**
+     * XOR gate. Unknown if either input is Unknown.
+     * @param a Input A
+     * @param b Input B
+     * @return Output
+     */
+    static LogicWord Xor(LogicWord a, LogicWord b)
+    {
+        uint64_t known = a.Known() & b.Known();
+        LogicWord out;
+        out.mOne = known & (a.mOne ^ b.mOne);
+        out.mZero = known & ~out.mOne;
+        return out;
+    }
+
+    /**
+     * NOT gate. Unknown stays Unknown.
+     * @param a Input
+     * @return Output
+     */
+    static LogicWord Not(LogicWord a)
+    {
+        LogicWord out;
+        out.mOne = a.mZero;
+        out.mZero = a.mOne;
+        return out;
+    }
+
+    /**
+     * SR flip flop. S sets, R resets, both make the outputs
+     * Unknown and anything else holds the current outputs.
+     * @param s Set input
+     * @param r Reset input
+     * @param q Q output, updated in place
+     * @param notQ Q' output, updated in place
+     */
+    static void SrFlipFlop(LogicWord s, LogicWord r, LogicWord &q, LogicWord &notQ)
+    {
+        uint64_t both = s.mOne & r.mOne;
+        uint64_t set = s.mOne & ~r.mOne;
+        uint64_t reset = r.mOne & ~s.mOne;
+        uint64_t changed = both | set | reset;
+
+        q.mOne = (q.mOne & ~changed) | set;
+        q.mZero = (q.mZero & ~changed) | reset;
+        notQ.mOne = (notQ.mOne & ~changed) | reset;
+        notQ.mZero = (notQ.mZero & ~changed) | set;
+    }
+
+    /**
+     * D flip flop. On a clock transition from Zero to One, Q takes
+     * the value of D and Q' is One only when D is Zero.
+     * @param d Data input
+     * @param clock Clock input
+     * @param previousClock Clock from the last evaluation, updated in place
+     * @param q Q output, updated in place
+     * @param notQ Q' output, updated in place
+     */
+    static void DFlipFlop(LogicWord d, LogicWord clock, LogicWord &previousClock,
+                          LogicWord &q, LogicWord &notQ)
+    {
+        uint64_t edge = previousClock.mZero & clock.mOne;
+
+        q.mOne = (q.mOne & ~edge) | (edge & d.mOne);
+        q.mZero = (q.mZero & ~edge) | (edge & d.mZero);
+        notQ.mOne = (notQ.mOne & ~edge) | (edge & d.mZero);
+        notQ.mZero = (notQ.mZero & ~edge) | (edge & ~d.mZero);
+
+        previousClock = clock;
+    }
+};
+
+#endif //GATELOGIC_H
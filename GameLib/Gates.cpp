@@ -7,6 +7,7 @@
 
 #include "pch.h"
 #include "Gates.h"
+#include "XmlPullParser.h"
 
 /**
  * Constructor
@@ -38,3 +39,13 @@ bool Gates::HitTest(double x, double y) {
     }
     return true;
 }
+
+/**
+ * Load the gate from a level being read
+ * @param parser Parser on the gate's start element
+ */
+void Gates::XmlLoad(XmlPullParser &parser)
+{
+    Item::XmlLoad(parser);
+    mId = XmlPullParser::Decode(parser.GetAttribute("id"));
+}
@@ -9,15 +9,17 @@
 #define GATES_H
 
 #include "Item.h"
-
-/// The possible pin states
-enum class States {One, Zero, Unknown};
+#include "GateLogic.h"
+#include "InputPin.h"
+#include "OutputPin.h"
 
 /**
  * Base class for all gates
  */
 class Gates : public Item {
 private:
+ /// Name that wires in a level file use to refer to this gate
+ std::wstring mId;
 
 public:
  /// Default constructor (disabled)
@@ -55,6 +57,34 @@ public:
  */
  virtual double getHeight() = 0;
 
+ /**
+  * Get an input pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr if there is none
+  */
+ virtual InputPin *GetInputPin(int index) const = 0;
+
+ /**
+  * Get an output pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr if there is none
+  */
+ virtual OutputPin *GetOutputPin(int index) const = 0;
+
+ void XmlLoad(XmlPullParser &parser) override;
+
+ /**
+  * Get the name wires in a level file use for this gate
+  * @return Gate id, empty if it has none
+  */
+ const std::wstring& GetId() const { return mId; }
+
+ /**
+  * Set the name wires use for this gate
+  * @param id Gate id
+  */
+ void SetId(const std::wstring& id) { mId = id; }
+
 protected:
  Gates(Game *game);
 
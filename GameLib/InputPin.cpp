@@ -36,7 +36,7 @@ InputPin::InputPin(Item *owner, wxPoint location) : mOwner(owner), mLocation(loc
  * Draws Input pin
  * @param graphics Graphics context to draw on
  */
-void InputPin::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void InputPin::Draw(wxGraphicsContext *graphics)
 {
  wxColour connectionColor; // Declare connectionColor here
 
@@ -61,7 +61,7 @@ void InputPin::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  wxGraphicsPath path2 = graphics->CreatePath();
  path2.MoveToPoint(loc.x + DefaultLineLength + PinSize/2,loc.y);
  path2.AddLineToPoint(loc.x + PinSize/2,loc.y);
- graphics->SetPen(wxPen(connectionColor, LineWidth));
+ graphics->SetPen(wxPen(connectionColor, mBusWidth > 1 ? BusLineWidth : LineWidth));
  graphics->DrawPath(path2);
 
 
@@ -97,9 +97,6 @@ wxPoint InputPin::GetAbsoluteLocation()
  */
 bool InputPin::Catch(OutputPin *pin, wxPoint lineEnd)
 {
- auto loc = GetAbsoluteLocation();
- auto relative = lineEnd - loc;
-
  if( this->HitTest(lineEnd.x, lineEnd.y))
  {
   if(mLine != nullptr)
@@ -148,3 +145,26 @@ void InputPin::SetLine(OutputPin *line)
  }
 }
 
+/**
+ * Save the pin's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void InputPin::SaveSnapshot(GameSnapshot &snapshot) const
+{
+ snapshot.Write(mLocation);
+ snapshot.Write(mState);
+ snapshot.Write(mBus);
+ snapshot.Write(mLine);
+}
+
+/**
+ * Restore the pin's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void InputPin::RestoreSnapshot(GameSnapshot &snapshot)
+{
+ snapshot.Read(mLocation);
+ snapshot.Read(mState);
+ snapshot.Read(mBus);
+ snapshot.Read(mLine);
+}
@@ -8,9 +8,11 @@
 #ifndef INPUTPIN_H
 #define INPUTPIN_H
 
+#include "GateLogic.h"
+
 class Item;
+class GameSnapshot;
 class OutputPin;
-enum class States;
 
 /**
  * Class for Input pin
@@ -26,6 +28,12 @@ private:
  /// State of pin
  States mState;
 
+ /// Number of bits the pin carries, 1 for a single wire
+ int mBusWidth = 1;
+
+ /// State of each bit of a bus pin, bit i in lane i
+ LogicWord mBus;
+
  /// Line we are connected to
  OutputPin* mLine = nullptr;
 
@@ -35,6 +43,9 @@ private:
  /// Line with for drawing lines between pins
  static const int LineWidth = 3;
 
+ /// Line width for drawing bus lines
+ static const int BusLineWidth = 7;
+
  /// Default length of line from the pin
  static const int DefaultLineLength = 20;
 
@@ -48,7 +59,7 @@ public:
   */
  void SetLocation(int x, int y) {mLocation = wxPoint(x, y);}
 
- void Draw(std::shared_ptr<wxGraphicsContext> graphics);
+ void Draw(wxGraphicsContext *graphics);
  wxPoint GetAbsoluteLocation();
 
  /**
@@ -63,10 +74,43 @@ public:
  */
  States GetState() {return mState;}
 
+ /**
+  * Make the pin carry a bus, or a single wire with width 1
+  * @param width Number of bits
+  */
+ void SetBusWidth(int width) {mBusWidth = width;}
+
+ /**
+  * Gets the number of bits the pin carries
+  * @return 1 for a single wire, more for a bus
+  */
+ int GetBusWidth() const {return mBusWidth;}
+
+ /**
+  * Sets the state of each bit of a bus pin
+  * @param bus Bit i in lane i
+  */
+ void SetBus(LogicWord bus) {mBus = bus;}
+
+ /**
+  * Gets the state of each bit of a bus pin
+  * @return Bit i in lane i
+  */
+ LogicWord GetBus() const {return mBus;}
+
  bool Catch(OutputPin *pin, wxPoint lineEnd);
  void SetLine(OutputPin* line);
+
+ /**
+  * Gets the output pin this pin is wired to
+  * @return Connected output pin, or nullptr if not wired
+  */
+ OutputPin* GetLine() const {return mLine;}
  bool HitTest(int x, int y);
 
+ void SaveSnapshot(GameSnapshot &snapshot) const;
+ void RestoreSnapshot(GameSnapshot &snapshot);
+
 };
 
 
@@ -0,0 +1,164 @@
+/**
+ * @file InputRecorder.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "InputRecorder.h"
+#include <fstream>
+#include "BinaryCoding.h"
+#include "CircuitSerializer.h"
+#include "Game.h"
+
+using namespace std;
+
+/**
+ * Log a frame
+ * @param milliseconds Time the frame advances the game by
+ */
+void InputRecorder::Tick(long milliseconds)
+{
+    mLog.put(char(Event::Tick));
+    WriteVarint(mLog, milliseconds < 0 ? 0 : milliseconds);
+    mTicks++;
+}
+
+/**
+ * Log the game state if a checksum is due, after a frame's update
+ * @param game Game being recorded
+ */
+void InputRecorder::Checkpoint(Game *game)
+{
+    if (mTicks % ChecksumInterval == 0)
+    {
+        Checksum(game);
+    }
+}
+
+/**
+ * Log the game state
+ * @param game Game being recorded
+ */
+void InputRecorder::Checksum(Game *game)
+{
+    mLog.put(char(Event::Checksum));
+    WriteVarint(mLog, game->StateHash());
+}
+
+/**
+ * Log the size of the window, if it changed
+ * @param width Window width in pixels
+ * @param height Window height in pixels
+ */
+void InputRecorder::ViewSize(int width, int height)
+{
+    if (width == mWidth && height == mHeight)
+    {
+        return;
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mLog.put(char(Event::ViewSize));
+    WriteSigned(mLog, width);
+    WriteSigned(mLog, height);
+}
+
+/**
+ * Log a mouse event
+ * @param event Kind of mouse event
+ * @param x X location in window coordinates
+ * @param y Y location in window coordinates
+ */
+void InputRecorder::Mouse(Event event, int x, int y)
+{
+    mLog.put(char(event));
+    WriteSigned(mLog, x);
+    WriteSigned(mLog, y);
+}
+
+/**
+ * Log the left mouse button going down
+ * @param x X location in window coordinates
+ * @param y Y location in window coordinates
+ */
+void InputRecorder::LeftDown(int x, int y)
+{
+    Mouse(Event::LeftDown, x, y);
+}
+
+/**
+ * Log the left mouse button going up
+ * @param x X location in window coordinates
+ * @param y Y location in window coordinates
+ */
+void InputRecorder::LeftUp(int x, int y)
+{
+    Mouse(Event::LeftUp, x, y);
+}
+
+/**
+ * Log the mouse moving
+ * @param x X location in window coordinates
+ * @param y Y location in window coordinates
+ * @param leftDown True if the left button is down
+ */
+void InputRecorder::MouseMove(int x, int y, bool leftDown)
+{
+    Mouse(leftDown ? Event::MouseDrag : Event::MouseMove, x, y);
+}
+
+/**
+ * Log a Level or Gates menu command
+ * @param id Menu id of the command
+ */
+void InputRecorder::Command(int id)
+{
+    // Logged relative to wxID_HIGHEST, which differs between wxWidgets versions
+    mLog.put(char(Event::Command));
+    WriteSigned(mLog, id - wxID_HIGHEST);
+}
+
+/**
+ * Log a circuit loaded into the game
+ * @param circuit Circuit that replaces the gates and wires
+ */
+void InputRecorder::Circuit(const CircuitSerializer &circuit)
+{
+    ostringstream encoded;
+    circuit.Write(encoded);
+
+    auto bytes = encoded.str();
+    mLog.put(char(Event::Circuit));
+    WriteVarint(mLog, bytes.size());
+    mLog.write(bytes.data(), bytes.size());
+}
+
+/**
+ * Write the session log
+ * @param out Stream to write to
+ */
+void InputRecorder::Write(std::ostream &out) const
+{
+    out.write((const char *)&Magic, sizeof(Magic));
+    out.put(char(Version));
+
+    auto log = mLog.str();
+    out.write(log.data(), log.size());
+}
+
+/**
+ * Save the session log to a file. The game state is logged first,
+ * so a replay can check where it ends up.
+ * @param filename File to write
+ * @param game Game being recorded
+ * @return True if the file was written
+ */
+bool InputRecorder::Save(const wxString &filename, Game *game)
+{
+    Checksum(game);
+
+    std::ofstream file(filename.fn_str(), std::ios::binary | std::ios::trunc);
+    Write(file);
+    return (bool)file;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file InputRecorder.h
+ * @author matthew vazquez
+ *
+ * Logs the input of a play session so it can be replayed.
+ */
+
+#ifndef INPUTRECORDER_H
+#define INPUTRECORDER_H
+
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+
+class Game;
+class CircuitSerializer;
+
+/**
+ * Logs the input of a play session so it can be replayed.
+ *
+ * Everything that changes a Game from outside is logged in the order
+ * it happens: the milliseconds each frame advances the game by, the
+ * window size, mouse events in window coordinates, Level and Gates
+ * menu commands and loaded circuits. Events between two ticks came
+ * between those frames, so an event's tick number is the number of
+ * ticks before it. Every ChecksumInterval ticks, and when the log is
+ * saved, the game's StateHash is logged too, so InputReplayer can
+ * tell where a replay stops matching.
+ *
+ * The log is kept encoded, a few bytes per event, so a whole session
+ * can be recorded and saved when something goes wrong.
+ */
+class InputRecorder
+{
+public:
+    /// Kinds of record in a session log
+    enum class Event : uint8_t {Tick, ViewSize, LeftDown, LeftUp, MouseMove, MouseDrag, Command, Circuit, Checksum};
+
+    /// Magic number at the start of a session log
+    static const uint32_t Magic = 0x4c494253;   // "SBIL"
+
+    /// Version of the session log format
+    static const uint8_t Version = 4;
+
+    /// Ticks between the checksums logged
+    static const int ChecksumInterval = 300;
+
+private:
+    /// Records logged so far
+    std::ostringstream mLog;
+
+    /// Number of ticks logged
+    int mTicks = 0;
+
+    /// Window width last logged
+    int mWidth = 0;
+
+    /// Window height last logged
+    int mHeight = 0;
+
+    void Mouse(Event event, int x, int y);
+
+public:
+    void Tick(long milliseconds);
+    void Checkpoint(Game *game);
+    void Checksum(Game *game);
+    void ViewSize(int width, int height);
+    void LeftDown(int x, int y);
+    void LeftUp(int x, int y);
+    void MouseMove(int x, int y, bool leftDown);
+    void Command(int id);
+    void Circuit(const CircuitSerializer &circuit);
+
+    void Write(std::ostream &out) const;
+    bool Save(const wxString &filename, Game *game);
+
+    /**
+     * Get the number of ticks logged
+     * @return Number of ticks
+     */
+    int GetNumTicks() const { return mTicks; }
+};
+
+#endif //INPUTRECORDER_H
@@ -0,0 +1,164 @@
+/**
+ * @file InputReplayer.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "InputReplayer.h"
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "BinaryCoding.h"
+#include "CircuitSerializer.h"
+#include "Game.h"
+#include "InputRecorder.h"
+
+using namespace std;
+
+/// Seconds in a millisecond, as the game view converts frame times
+const double OneThousanth = 0.001;
+
+/// Largest circuit record read from a log, in bytes
+const uint64_t MaxCircuitSize = 1 << 24;
+
+/**
+ * Read a session log
+ * @param in Stream to read from
+ * @return True if the stream holds a session log
+ */
+bool InputReplayer::Read(std::istream &in)
+{
+    mLog.clear();
+
+    uint32_t magic = 0;
+    in.read((char *)&magic, sizeof(magic));
+    if (!in || magic != InputRecorder::Magic || in.get() != InputRecorder::Version)
+    {
+        return false;
+    }
+
+    mLog.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    return true;
+}
+
+/**
+ * Load a session log from a file written by InputRecorder::Save
+ * @param filename File to read
+ * @return True if the file was read
+ */
+bool InputReplayer::Load(const wxString &filename)
+{
+    std::ifstream file(filename.fn_str(), std::ios::binary);
+    return file && Read(file);
+}
+
+/**
+ * Replay the session log into a game
+ * @param game Game to play, as it was before the session was recorded
+ * @return True if the whole log was replayed and every checksum matched
+ */
+bool InputReplayer::Replay(Game *game)
+{
+    mTicks = 0;
+    mSimulatedTime = 0;
+    mChecksums = 0;
+    mMismatchTick = -1;
+
+    istringstream in(mLog);
+    for (int c = in.get(); c != EOF; c = in.get())
+    {
+        uint64_t value, size;
+        int x, y;
+        CircuitSerializer circuit;
+        string bytes;
+        istringstream circuitIn;
+
+        switch ((InputRecorder::Event)c)
+        {
+        case InputRecorder::Event::Tick:
+            if (!ReadVarint(in, value))
+            {
+                return false;
+            }
+            mTicks++;
+            mSimulatedTime += (double)value * OneThousanth;
+            game->Advance((double)value * OneThousanth);
+            break;
+
+        case InputRecorder::Event::Checksum:
+            if (!ReadVarint(in, value))
+            {
+                return false;
+            }
+            mChecksums++;
+            if (value != game->StateHash() && mMismatchTick < 0)
+            {
+                mMismatchTick = mTicks;
+            }
+            break;
+
+        case InputRecorder::Event::ViewSize:
+        case InputRecorder::Event::LeftDown:
+        case InputRecorder::Event::LeftUp:
+        case InputRecorder::Event::MouseMove:
+        case InputRecorder::Event::MouseDrag:
+            if (!ReadSigned(in, x) || !ReadSigned(in, y))
+            {
+                return false;
+            }
+
+            switch ((InputRecorder::Event)c)
+            {
+            case InputRecorder::Event::ViewSize:
+                game->SetViewSize(x, y);
+                break;
+
+            case InputRecorder::Event::LeftDown:
+                game->OnLeftDown(x, y);
+                break;
+
+            case InputRecorder::Event::LeftUp:
+                game->OnLeftUp(x, y);
+                break;
+
+            default:
+                game->OnMouseMove(x, y, (InputRecorder::Event)c == InputRecorder::Event::MouseDrag);
+                break;
+            }
+            break;
+
+        case InputRecorder::Event::Command:
+            if (!ReadSigned(in, x))
+            {
+                return false;
+            }
+            game->OnCommand(x + wxID_HIGHEST);
+            break;
+
+        case InputRecorder::Event::Circuit:
+            if (!ReadVarint(in, size) || size > MaxCircuitSize)
+            {
+                return false;
+            }
+
+            bytes.resize(size);
+            if (!in.read(&bytes[0], size))
+            {
+                return false;
+            }
+
+            circuitIn.str(bytes);
+            if (!circuit.Read(circuitIn))
+            {
+                return false;
+            }
+            game->ApplyCircuit(circuit);
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    return mMismatchTick < 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file InputReplayer.h
+ * @author matthew vazquez
+ *
+ * Plays a session log back into a game.
+ */
+
+#ifndef INPUTREPLAYER_H
+#define INPUTREPLAYER_H
+
+#include <istream>
+#include <string>
+
+class Game;
+
+/**
+ * Plays a session log back into a game.
+ *
+ * The log written by an InputRecorder is fed to a Game in the order
+ * it was recorded, with no window: each tick updates the game by the
+ * time recorded for it, so the game goes through the same states the
+ * recorded one did, as fast as it can be updated. Each checksum in
+ * the log is compared with the replayed game's StateHash.
+ */
+class InputReplayer
+{
+private:
+    /// Records of the session log, after the header
+    std::string mLog;
+
+    /// Number of ticks replayed
+    int mTicks = 0;
+
+    /// Time the game was updated by in seconds
+    double mSimulatedTime = 0;
+
+    /// Number of checksums compared
+    int mChecksums = 0;
+
+    /// Tick of the first checksum that did not match, or -1 for none
+    int mMismatchTick = -1;
+
+public:
+    bool Read(std::istream &in);
+    bool Load(const wxString &filename);
+    bool Replay(Game *game);
+
+    /**
+     * Get the number of ticks replayed
+     * @return Number of ticks
+     */
+    int GetNumTicks() const { return mTicks; }
+
+    /**
+     * Get the time the game was updated by
+     * @return Simulated time in seconds
+     */
+    double GetSimulatedTime() const { return mSimulatedTime; }
+
+    /**
+     * Get the number of checksums compared
+     * @return Number of checksums
+     */
+    int GetNumChecksums() const { return mChecksums; }
+
+    /**
+     * Get the tick where the replay stopped matching the recording
+     * @return Tick of the first checksum that did not match, or -1 for none
+     */
+    int GetMismatchTick() const { return mMismatchTick; }
+};
+
+#endif //INPUTREPLAYER_H
@@ -5,26 +5,64 @@
 
 #include "pch.h"
 #include "Item.h"
+#include <algorithm>
 #include "Game.h"
+#include "ProductionLine.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
+#include "XmlPullParser.h"
 
 using namespace std;
 
+/**
+ * Constructor
+ * @param game The game this item is a member of
+ */
+Item::Item(Game* game) : mGame(game)
+{
+    if (game != nullptr)
+    {
+        mArena = game->GetArena();
+    }
+}
+
 /**
  * Constructor
  * @param game The game this item is a member of
  * @param filename The filename for the item image
  */
-Item::Item(Game* game, const std::wstring &filename) : mGame(game)
+Item::Item(Game* game, const std::wstring &filename) : Item(game)
 {
-    mItemImage = make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
-    mItemBitmap = make_unique<wxBitmap>(*mItemImage);
+    mSprite = game->GetAtlas()->Find(filename);
+}
 
+/**
+ * Destructor, which destroys the pins and panels the item created
+ */
+Item::~Item()
+{
+    for (const auto &part : mParts)
+    {
+        mArena->Destroy(part);
+    }
 }
 
 /**
- * Destructor
+ * Destroy a pin or panel this item created before the item is
+ * destroyed, so the item no longer owns it
+ * @param part Part from ItemArena::ToPart
  */
-Item::~Item() {}
+void Item::DestroyPart(const ItemArena::Part &part)
+{
+    auto found = std::find_if(mParts.begin(), mParts.end(), [&part](const ItemArena::Part &other) {
+        return other.mPool == part.mPool && other.mIndex == part.mIndex && other.mGeneration == part.mGeneration;
+    });
+    if (found != mParts.end())
+    {
+        mArena->Destroy(part);
+        mParts.erase(found);
+    }
+}
 
 /**
  * Test if this item has been clicked on
@@ -34,12 +72,10 @@ Item::~Item() {}
  */
 bool Item::HitTest(double x, double y)
 {
-    if (!mItemBitmap || !mItemBitmap->IsOk())
-    {
-        return false;
-    }
-    double wid = mItemBitmap->GetWidth();
-    double hit = mItemBitmap->GetHeight();
+    auto atlas = mGame->GetAtlas();
+    auto size = atlas->GetSize(mSprite);
+    double wid = size.GetWidth();
+    double hit = size.GetHeight();
     double testX = x - GetX() + wid / 2;
     double testY = y - GetY() + hit / 2;
 
@@ -47,23 +83,22 @@ bool Item::HitTest(double x, double y)
     {
         return false;
     }
-    if (mItemImage && mItemImage->IsOk())
-    {
-        return !mItemImage->IsTransparent((int)testX, (int)testY);
-    }
 
-    return true;
+    return !atlas->IsTransparent(mSprite, (int)testX, (int)testY);
 }
 
 /**
  * Draw this item
  * @param graphics Graphics context to draw on
  */
-void Item::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Item::Draw(wxGraphicsContext *graphics)
 {
-    double wid = mItemBitmap->GetWidth();
-    double hit = mItemBitmap->GetHeight();
-    graphics->DrawBitmap(*mItemBitmap,
+    auto atlas = mGame->GetAtlas();
+    auto sprites = mGame->GetSprites();
+    auto size = atlas->GetSize(mSprite);
+    double wid = size.GetWidth();
+    double hit = size.GetHeight();
+    sprites->Draw(graphics, mSprite,
         (int)(GetX() - wid / 2),
         (int)(GetY() - hit / 2),
         wid, hit);
@@ -72,11 +107,83 @@ void Item::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 
 
 /**
- * Load the attributes for an item node.
- * @param node The XML node we are loading the item from
+ * Load the attributes for an item from a level being read.
+ * @param parser Parser on the item's start element
+ */
+void Item::XmlLoad(XmlPullParser &parser)
+{
+    mX = parser.GetDouble("x", 0);
+    mY = parser.GetDouble("y", 0);
+}
+
+/**
+ * Save the item's state to a snapshot. Items that change as the
+ * game plays add their own state after this.
+ * @param snapshot Snapshot to append to
+ */
+void Item::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    snapshot.Write(mX);
+    snapshot.Write(mY);
+    snapshot.Write(mRetired);
+}
+
+/**
+ * Restore the item's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Item::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    snapshot.Read(mX);
+    snapshot.Read(mY);
+    snapshot.Read(mRetired);
+}
+
+/**
+ * Accept a visitor for every item of this item's production line, or
+ * for every item in the game if it is in no line
+ * @param visitor Visitor to accept
  */
-void Item::XmlLoad(wxXmlNode* node)
+void Item::AcceptLine(ItemVisitor *visitor)
 {
-    node->GetAttribute(L"x", L"0").ToDouble(&mX);
-    node->GetAttribute(L"y", L"0").ToDouble(&mY);
-}
\ No newline at end of file
+    if (mLine != nullptr)
+    {
+        mLine->Accept(visitor);
+    }
+    else
+    {
+        mGame->Accept(visitor);
+    }
+}
+
+/**
+ * Score a product sorted correctly on this item's production line, or
+ * on the level if it is in no line
+ */
+void Item::ScoreGood()
+{
+    if (mLine != nullptr)
+    {
+        mLine->ScoreGood(*mGame->GetScore());
+    }
+    else
+    {
+        mGame->GetScore()->SetLevelScoreGood();
+    }
+}
+
+/**
+ * Score a product sorted wrongly on this item's production line, or
+ * on the level if it is in no line
+ */
+void Item::ScoreBad()
+{
+    if (mLine != nullptr)
+    {
+        mLine->ScoreBad(*mGame->GetScore());
+    }
+    else
+    {
+        mGame->GetScore()->SetLevelScoreBad();
+    }
+}
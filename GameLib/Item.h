@@ -13,11 +13,15 @@
 #include <wx/graphics.h>
 #include <wx/xml/xml.h>
 
+#include "GameSnapshot.h"
 #include "IDraggable.h"
+#include "ItemArena.h"
 #include "ItemVisitor.h"
 #include "OutputPin.h"
 
 class Game;
+class ProductionLine;
+class XmlPullParser;
 
 /**
  * Base class for any item in our game.
@@ -27,26 +31,56 @@ private:
     /// The game this item is contained in
     Game *mGame;
 
+    /// The production line this item belongs to, if any
+    ProductionLine *mLine = nullptr;
+
     // Item location in the game
     double mX = 0;     ///< X location for the center of the item
     double mY = 0;     ///< Y location for the center of the item
 
-    /// The underlying item image
-    std::unique_ptr<wxImage> mItemImage;
+    /// True once the item can no longer affect play, so it is left
+    /// out of updates and drawing
+    bool mRetired = false;
+
+    /// The item's sprite in the game's atlas, -1 if it has none
+    int mSprite = -1;
+
+    /// Arena the item's pins and panels are in, the game's arena when
+    /// the item was created, kept as long as the item is
+    std::shared_ptr<ItemArena> mArena;
 
-    /// The bitmap we can display for this item
-    std::unique_ptr<wxBitmap> mItemBitmap;
+    /// Pins and panels the item created in its arena, destroyed with it
+    std::vector<ItemArena::Part> mParts;
 
 protected:
-    /**
-    * Constructor
-    * @param game The game this item is a member of
-    */
+    Item(Game *game);
+    Item(Game *game, const std::wstring &filename);
 
-    Item (Game *game) : mGame(game)
+    /**
+     * Create a pin or panel that belongs to this item. It is
+     * destroyed when the item is.
+     * @tparam T Part type
+     * @param args Constructor arguments
+     * @return Handle to the part in the item's arena
+     */
+    template <class T, class... Args>
+    ArenaHandle<T> CreatePart(Args&&... args)
     {
-    };
-    Item(Game *game, const std::wstring &filename);
+        auto handle = mArena->Create<T>(std::forward<Args>(args)...);
+        mParts.push_back(ItemArena::ToPart(handle));
+        return handle;
+    }
+
+    /**
+     * Destroy a pin or panel this item created before the item is
+     * destroyed
+     * @tparam T Part type
+     * @param handle Handle from CreatePart
+     */
+    template <class T>
+    void DestroyPart(ArenaHandle<T> handle) { DestroyPart(ItemArena::ToPart(handle)); }
+
+    void DestroyPart(const ItemArena::Part &part);
 
 public:
     virtual ~Item();
@@ -67,7 +101,7 @@ public:
      * @return A reference to this object
      */
     virtual Item& operator=(const Item &other) = delete;
-    virtual void Draw(std::shared_ptr<wxGraphicsContext> graphics);
+    virtual void Draw(wxGraphicsContext *graphics);
     virtual bool HitTest(double x, double y);
 
     /**
@@ -95,7 +129,7 @@ public:
       */
     virtual void Accept(ItemVisitor* visitor) = 0;
 
-    virtual void XmlLoad(wxXmlNode* node);
+    virtual void XmlLoad(XmlPullParser &parser);
 
     /**
      * Handle updates for animation
@@ -103,12 +137,59 @@ public:
      */
     virtual void Update(double elapsed) {}
 
+    virtual void SaveSnapshot(GameSnapshot &snapshot) const;
+    virtual void RestoreSnapshot(GameSnapshot &snapshot);
+
     /**
      * Get the pointer to the Game object
      * @return Pointer to Game object
      */
     Game* GetGame() const { return mGame; }
 
+    /**
+     * Get the arena the item's pins and panels are in
+     * @return The arena the game was placing items in when this one was created
+     */
+    ItemArena *GetArena() const { return mArena.get(); }
+
+    /**
+     * Get a part this item created. The item destroys its own parts
+     * and keeps their arena, so the part is where it was created.
+     * @tparam T Part type
+     * @param handle Handle from CreatePart
+     * @return The part
+     */
+    template <class T>
+    T *Get(ArenaHandle<T> handle) const { return handle.GetObject(); }
+
+    /**
+     * Get the production line this item belongs to
+     * @return The line, or null if the item is in none
+     */
+    ProductionLine *GetLine() const { return mLine; }
+
+    /**
+     * Set the production line this item belongs to
+     * @param line The line
+     */
+    void SetLine(ProductionLine *line) { mLine = line; }
+
+    /**
+     * Has the item been retired from play?
+     * @return True if it is no longer updated or drawn
+     */
+    bool IsRetired() const { return mRetired; }
+
+    /**
+     * Retire the item from play, or bring it back
+     * @param retired True to retire the item
+     */
+    void SetRetired(bool retired) { mRetired = retired; }
+
+    void AcceptLine(ItemVisitor *visitor);
+    void ScoreGood();
+    void ScoreBad();
+
     /**
      * Handle a mouse click on this item
      * @param x X location relative to the game
@@ -154,7 +235,7 @@ public:
     * @param y Y location clicked on
     * @return Whatever we clicked on or NULL if none
     */
-    virtual std::shared_ptr<IDraggable> HitDraggable(int x, int y) {return nullptr;}
+    virtual IDraggable *HitDraggable(int x, int y) {return nullptr;}
 
     /**
      * Releases state or held item.
@@ -0,0 +1,73 @@
+/**
+ * @file ItemArena.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "ItemArena.h"
+#include <algorithm>
+
+/**
+ * Hand out memory from the arena
+ * @param size Number of bytes
+ * @param alignment Alignment the memory needs, a power of two
+ * @return Memory that stays valid until it is returned or the arena is destroyed
+ */
+void *ItemArena::Allocate(size_t size, size_t alignment)
+{
+    // Memory returned by an object of the same size comes first
+    auto free = mFreeMemory.find(size);
+    if (free != mFreeMemory.end() && !free->second.empty() &&
+        reinterpret_cast<uintptr_t>(free->second.back()) % alignment == 0)
+    {
+        void *memory = free->second.back();
+        free->second.pop_back();
+        mBytesUsed += size;
+        mNumAllocations++;
+        return memory;
+    }
+
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(mNext) % alignment) % alignment;
+    if (mNext == nullptr || padding + size > mAvailable)
+    {
+        // Objects too large for a block get a block of their own
+        size_t blockSize = std::max(BlockSize, size + alignment);
+        mBlocks.emplace_back(new char[blockSize]);
+        mNext = mBlocks.back().get();
+        mAvailable = blockSize;
+        padding = (alignment - reinterpret_cast<uintptr_t>(mNext) % alignment) % alignment;
+    }
+
+    void *memory = mNext + padding;
+    mNext += padding + size;
+    mAvailable -= padding + size;
+    mBytesUsed += size;
+    mNumAllocations++;
+    return memory;
+}
+
+/**
+ * Return memory to the arena. It stays in the arena's blocks and is
+ * handed out again for the next allocation of the same size.
+ * @param memory Memory from Allocate
+ * @param size Number of bytes asked for
+ */
+void ItemArena::Deallocate(void *memory, size_t size)
+{
+    mFreeMemory[size].push_back(memory);
+    mBytesUsed -= size;
+    mNumAllocations--;
+}
+
+/**
+ * Destroy a part, so its slot is used for the next part of its type.
+ * A part that is already gone, or in another arena, is left alone.
+ * @param part Part from ToPart
+ */
+void ItemArena::Destroy(const Part &part)
+{
+    if (part.mPool < (int)mPools.size() && mPools[part.mPool] != nullptr)
+    {
+        mPools[part.mPool]->Destroy(part.mIndex, part.mGeneration);
+    }
+}
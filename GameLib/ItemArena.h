@@ -0,0 +1,483 @@
+/**
+ * @file ItemArena.h
+ * @author matthew vazquez
+ *
+ * Memory for the items and pins of one level, released all at once.
+ */
+
+#ifndef ITEMARENA_H
+#define ITEMARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Handle to an object in an ItemArena.
+ *
+ * A handle is the object's index in the arena's array for its type
+ * plus the generation the slot had when the object was created.
+ * Generations are never reused, in this arena or any other, so a
+ * handle to an object that has been destroyed, or to one in an arena
+ * from an earlier level, finds nothing instead of a different object.
+ *
+ * A handle also remembers where the object was created. Objects
+ * never move, so whoever decides when the object is destroyed can use
+ * that address directly instead of looking the handle up.
+ * @tparam T Type of the object
+ */
+template <class T>
+class ArenaHandle
+{
+private:
+    /// Index of the object in its type's array
+    uint32_t mIndex = 0;
+
+    /// Generation of the slot when the object was created, 0 for none
+    uint32_t mGeneration = 0;
+
+    /// The object as it was created
+    T *mObject = nullptr;
+
+public:
+    ArenaHandle() = default;
+
+    /**
+     * Constructor
+     * @param index Index of the object in its type's array
+     * @param generation Generation of the slot
+     * @param object The object created
+     */
+    ArenaHandle(uint32_t index, uint32_t generation, T *object = nullptr) :
+        mIndex(index), mGeneration(generation), mObject(object) {}
+
+    /**
+     * Get the index of the object in its type's array
+     * @return Index
+     */
+    uint32_t GetIndex() const { return mIndex; }
+
+    /**
+     * Get the generation of the slot when the object was created
+     * @return Generation, 0 for a handle that was never set
+     */
+    uint32_t GetGeneration() const { return mGeneration; }
+
+    /**
+     * Was the handle ever set?
+     * @return True if it was set, even if the object is gone
+     */
+    explicit operator bool() const { return mGeneration != 0; }
+
+    /**
+     * Get the object without checking it is still there. Only its
+     * owner, which knows it has not destroyed it, may use this.
+     * @return The object as it was created
+     */
+    T *GetObject() const { return mObject; }
+
+    /**
+     * Compare two handles
+     * @param other Handle to compare against
+     * @return True if both name the same object
+     */
+    bool operator==(const ArenaHandle &other) const
+    {
+        return mIndex == other.mIndex && mGeneration == other.mGeneration;
+    }
+
+    /**
+     * Compare two handles
+     * @param other Handle to compare against
+     * @return True if they name different objects
+     */
+    bool operator!=(const ArenaHandle &other) const { return !(*this == other); }
+};
+
+/**
+ * Memory for the items and pins of one level, released all at once.
+ *
+ * Items are placed one after another in large blocks, so loading a
+ * level takes a handful of allocations instead of several per item,
+ * and items loaded together sit together in memory when the game
+ * updates them. They are created through ArenaAllocator with
+ * std::allocate_shared, so the game's item list still holds them by
+ * shared_ptr. Each item's control block holds the arena, which lives
+ * until the last item placed in it is destroyed. The memory of an item
+ * destroyed while its level is still played, such as a gate the
+ * player removed, is kept on a free list and handed to the next
+ * object of the same size, so a level played for hours does not grow.
+ *
+ * The parts items own, their pins and sensor panels, are kept in one
+ * array per type and named by ArenaHandle rather than held by
+ * shared_ptr. Every pin of a level sits in a few chunks of its type's
+ * array, and a destroyed part's slot is used again for the next part
+ * of that type. The arrays grow a chunk at a time from the blocks, so
+ * a part never moves and pins can point at each other directly.
+ */
+class ItemArena
+{
+public:
+    /// A part of any type, so an item can destroy its parts without knowing their types
+    struct Part
+    {
+        /// Index of the part type's array
+        int mPool = 0;
+
+        /// Index of the part in its array
+        uint32_t mIndex = 0;
+
+        /// Generation of the slot when the part was created
+        uint32_t mGeneration = 0;
+    };
+
+    /// Number of parts in each chunk of a type's array
+    static constexpr uint32_t ChunkSize = 64;
+
+private:
+    /**
+     * The array for one part type, without the type
+     */
+    class PoolBase
+    {
+    public:
+        virtual ~PoolBase() = default;
+
+        /**
+         * Destroy a part, if the handle is still current
+         * @param index Index of the part
+         * @param generation Generation from the part's handle
+         */
+        virtual void Destroy(uint32_t index, uint32_t generation) = 0;
+    };
+
+    /**
+     * The array for one part type
+     * @tparam T Part type
+     */
+    template <class T>
+    class Pool : public PoolBase
+    {
+    public:
+        /// A place for one part
+        struct Slot
+        {
+            /// Memory the part is constructed in
+            alignas(T) unsigned char mObject[sizeof(T)];
+
+            /// Generation of the part in the slot, 0 while the slot is free
+            uint32_t mGeneration;
+        };
+
+        /// Chunks of ChunkSize slots, in the arena's blocks
+        std::vector<Slot *> mChunks;
+
+        /// Number of slots handed out, free or not
+        uint32_t mSize = 0;
+
+        /// Slots whose parts were destroyed, to use again
+        std::vector<uint32_t> mFree;
+
+        /**
+         * Get a slot by index
+         * @param index Slot index, less than mSize
+         * @return The slot
+         */
+        Slot &At(uint32_t index) { return mChunks[index / ChunkSize][index % ChunkSize]; }
+
+        /**
+         * Get the part a handle names
+         * @param index Index from the handle
+         * @param generation Generation from the handle
+         * @return The part, or nullptr if it is gone
+         */
+        T *Find(uint32_t index, uint32_t generation)
+        {
+            if (generation == 0 || index >= mSize)
+            {
+                return nullptr;
+            }
+            auto &slot = At(index);
+            return slot.mGeneration == generation ? std::launder(reinterpret_cast<T *>(slot.mObject)) : nullptr;
+        }
+
+        void Destroy(uint32_t index, uint32_t generation) override
+        {
+            if (auto part = Find(index, generation))
+            {
+                part->~T();
+                At(index).mGeneration = 0;
+                mFree.push_back(index);
+            }
+        }
+
+        ~Pool() override
+        {
+            for (uint32_t i = 0; i < mSize; i++)
+            {
+                auto &slot = At(i);
+                if (slot.mGeneration != 0)
+                {
+                    std::launder(reinterpret_cast<T *>(slot.mObject))->~T();
+                }
+            }
+        }
+    };
+
+    /// Blocks of memory objects are placed in
+    std::vector<std::unique_ptr<char[]>> mBlocks;
+
+    /// Array for each part type, by PoolIndex; destroyed before the blocks they live in
+    std::vector<std::unique_ptr<PoolBase>> mPools;
+
+    /// Next free byte in the newest block
+    char *mNext = nullptr;
+
+    /// Bytes left in the newest block
+    size_t mAvailable = 0;
+
+    /// Memory returned by Deallocate, by size, to hand out again
+    std::map<size_t, std::vector<void *>> mFreeMemory;
+
+    /// Bytes handed out and not returned
+    size_t mBytesUsed = 0;
+
+    /// Number of allocations handed out and not returned
+    int mNumAllocations = 0;
+
+    /// Number of part types that have an array index
+    static inline std::atomic<int> sNumPools{0};
+
+    /// Last generation handed out by any arena
+    static inline std::atomic<uint32_t> sGeneration{0};
+
+    /**
+     * Get the index of a part type's array, the same in every arena
+     * @tparam T Part type
+     * @return Array index
+     */
+    template <class T>
+    static int PoolIndex()
+    {
+        static const int index = sNumPools++;
+        return index;
+    }
+
+    /**
+     * Get the array for a part type, creating it the first time
+     * @tparam T Part type
+     * @return The array
+     */
+    template <class T>
+    Pool<T> &GetPool()
+    {
+        auto index = PoolIndex<T>();
+        if (index >= (int)mPools.size())
+        {
+            mPools.resize(index + 1);
+        }
+        if (mPools[index] == nullptr)
+        {
+            mPools[index] = std::make_unique<Pool<T>>();
+        }
+        return static_cast<Pool<T> &>(*mPools[index]);
+    }
+
+public:
+    /// Size of a block of memory in bytes
+    static constexpr size_t BlockSize = 16384;
+
+    ItemArena() = default;
+
+    /// Copy constructor (disabled)
+    ItemArena(const ItemArena &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ItemArena &) = delete;
+
+    void *Allocate(size_t size, size_t alignment);
+    void Deallocate(void *memory, size_t size);
+
+    /**
+     * Create a part in its type's array
+     * @tparam T Part type
+     * @param args Constructor arguments
+     * @return Handle to the new part
+     */
+    template <class T, class... Args>
+    ArenaHandle<T> Create(Args&&... args)
+    {
+        auto &pool = GetPool<T>();
+        uint32_t index;
+        if (!pool.mFree.empty())
+        {
+            index = pool.mFree.back();
+            pool.mFree.pop_back();
+        }
+        else
+        {
+            if (pool.mSize % ChunkSize == 0)
+            {
+                using Slot = typename Pool<T>::Slot;
+                pool.mChunks.push_back(static_cast<Slot *>(Allocate(ChunkSize * sizeof(Slot), alignof(Slot))));
+            }
+            index = pool.mSize++;
+            pool.At(index).mGeneration = 0;
+        }
+
+        auto &slot = pool.At(index);
+        auto object = new (slot.mObject) T(std::forward<Args>(args)...);
+
+        // Zero marks a free slot, so it is skipped when the count wraps
+        uint32_t generation;
+        do
+        {
+            generation = ++sGeneration;
+        } while (generation == 0);
+        slot.mGeneration = generation;
+
+        return ArenaHandle<T>(index, generation, object);
+    }
+
+    /**
+     * Get the part a handle names
+     * @tparam T Part type
+     * @param handle Handle from Create
+     * @return The part, or nullptr if it was destroyed or is in another arena
+     */
+    template <class T>
+    T *Get(ArenaHandle<T> handle)
+    {
+        auto index = PoolIndex<T>();
+        if (index >= (int)mPools.size() || mPools[index] == nullptr)
+        {
+            return nullptr;
+        }
+        return static_cast<Pool<T> &>(*mPools[index]).Find(handle.GetIndex(), handle.GetGeneration());
+    }
+
+    /**
+     * Get a part of any type that can be destroyed later
+     * @tparam T Part type
+     * @param handle Handle from Create
+     * @return The part without its type
+     */
+    template <class T>
+    static Part ToPart(ArenaHandle<T> handle)
+    {
+        return Part{PoolIndex<T>(), handle.GetIndex(), handle.GetGeneration()};
+    }
+
+    /**
+     * Destroy a part, so its slot is used for the next part of its type.
+     * A part that is already gone, or in another arena, is left alone.
+     * @tparam T Part type
+     * @param handle Handle from Create
+     */
+    template <class T>
+    void Destroy(ArenaHandle<T> handle) { Destroy(ToPart(handle)); }
+
+    void Destroy(const Part &part);
+
+    /**
+     * Get the number of parts of a type that have not been destroyed
+     * @tparam T Part type
+     * @return Number of parts
+     */
+    template <class T>
+    int GetNumParts()
+    {
+        auto &pool = GetPool<T>();
+        return (int)(pool.mSize - pool.mFree.size());
+    }
+
+    /**
+     * Get the number of blocks allocated from the heap
+     * @return Number of blocks
+     */
+    int GetNumBlocks() const { return (int)mBlocks.size(); }
+
+    /**
+     * Get the number of allocations handed out and not returned
+     * @return Number of allocations
+     */
+    int GetNumAllocations() const { return mNumAllocations; }
+
+    /**
+     * Get the bytes handed out and not returned
+     * @return Bytes used
+     */
+    size_t GetBytesUsed() const { return mBytesUsed; }
+};
+
+/**
+ * Standard allocator that places objects in an ItemArena
+ * @tparam T Type allocated
+ */
+template <class T>
+class ArenaAllocator
+{
+private:
+    /// Arena objects are placed in
+    std::shared_ptr<ItemArena> mArena;
+
+public:
+    /// Type allocated
+    using value_type = T;
+
+    /**
+     * Constructor
+     * @param arena Arena objects are placed in
+     */
+    explicit ArenaAllocator(std::shared_ptr<ItemArena> arena) : mArena(std::move(arena)) {}
+
+    /**
+     * Construct from an allocator for another type
+     * @param other Allocator for the same arena
+     */
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : mArena(other.GetArena()) {}
+
+    /**
+     * Allocate memory for objects
+     * @param n Number of objects
+     * @return Memory in the arena
+     */
+    T *allocate(size_t n) { return static_cast<T *>(mArena->Allocate(n * sizeof(T), alignof(T))); }
+
+    /**
+     * Return memory to the arena for the next object of its size
+     * @param p Memory from allocate
+     * @param n Number of objects
+     */
+    void deallocate(T *p, size_t n) { mArena->Deallocate(p, n * sizeof(T)); }
+
+    /**
+     * Get the arena objects are placed in
+     * @return Arena
+     */
+    const std::shared_ptr<ItemArena> &GetArena() const { return mArena; }
+
+    /**
+     * Do two allocators place objects in the same arena?
+     * @param other Other allocator
+     * @return True if they share an arena
+     */
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &other) const { return mArena == other.GetArena(); }
+
+    /**
+     * Do two allocators place objects in different arenas?
+     * @param other Other allocator
+     * @return True if they do not share an arena
+     */
+    template <class U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return mArena != other.GetArena(); }
+};
+
+#endif //ITEMARENA_H
@@ -0,0 +1,134 @@
+/**
+ * @file ItemRuns.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include "ItemRuns.h"
+#include "AndGate.h"
+#include "Beam.h"
+#include "BusConnector.h"
+#include "Conveyor.h"
+#include "DFlipFlopGate.h"
+#include "MultiInputGate.h"
+#include "NotGate.h"
+#include "OrGate.h"
+#include "Product.h"
+#include "Scoreboard.h"
+#include "Sensor.h"
+#include "SensorPanel.h"
+#include "Sparty.h"
+#include "SrFlipFlopGate.h"
+
+/// Number of arrays, including the one for other items
+static constexpr size_t NumArrays = std::tuple_size<ItemRuns::Arrays>::value;
+
+/// Index of the array for items of any other type
+static constexpr size_t OtherArray = NumArrays - 1;
+
+/// Item type held by an array
+template <size_t I>
+using ArrayType = std::remove_pointer_t<typename std::tuple_element_t<I, ItemRuns::Arrays>::value_type>;
+
+/**
+ * Find the array an item belongs in
+ * @param item Item to place
+ * @return Index of the array for exactly the item's type, or OtherArray
+ */
+template <size_t... I>
+static size_t ArrayFor(Item *item, std::index_sequence<I...>)
+{
+    const std::type_info &type = typeid(*item);
+    size_t array = OtherArray;
+    ((array == OtherArray && type == typeid(ArrayType<I>) ? (array = I, 0) : 0), ...);
+    return array;
+}
+
+/**
+ * Call a function with one of the arrays
+ *
+ * The function is instantiated for each array's type, so calls it
+ * makes on the array's items are bound at compile time.
+ *
+ * @param arrays Arrays of items
+ * @param array Index of the array to pass
+ * @param function Function taking a vector of item pointers
+ */
+template <class Function, size_t... I>
+static void WithArray(ItemRuns::Arrays &arrays, size_t array, Function &&function, std::index_sequence<I...>)
+{
+    ((array == I ? (function(std::get<I>(arrays)), 0) : 0), ...);
+}
+
+/**
+ * Remove every item
+ */
+void ItemRuns::Clear()
+{
+    std::apply([](auto &... arrays) { (arrays.clear(), ...); }, mArrays);
+    mRuns.clear();
+    mNumItems = 0;
+}
+
+/**
+ * Add an item after the ones already added
+ * @param item Item to add
+ */
+void ItemRuns::Add(Item *item)
+{
+    size_t type = ArrayFor(item, std::make_index_sequence<OtherArray>());
+
+    size_t index = 0;
+    WithArray(mArrays, type, [item, &index](auto &items) {
+        using Type = std::remove_pointer_t<typename std::remove_reference_t<decltype(items)>::value_type>;
+        index = items.size();
+        items.push_back(static_cast<Type *>(item));
+    }, std::make_index_sequence<NumArrays>());
+
+    if (!mRuns.empty() && mRuns.back().mType == type)
+    {
+        mRuns.back().mEnd = index + 1;
+    }
+    else
+    {
+        mRuns.push_back({type, index, index + 1});
+    }
+    mNumItems++;
+}
+
+/**
+ * Update every item, in the order added
+ * @param elapsed Time since the last update in seconds
+ */
+void ItemRuns::Update(double elapsed)
+{
+    for (const auto &run : mRuns)
+    {
+        WithArray(mArrays, run.mType, [&run, elapsed](auto &items) {
+            for (size_t i = run.mBegin; i < run.mEnd; i++)
+            {
+                items[i]->Update(elapsed);
+            }
+        }, std::make_index_sequence<NumArrays>());
+    }
+}
+
+/**
+ * Draw every item, in the order added
+ * @param graphics Graphics context to draw on
+ */
+void ItemRuns::Draw(wxGraphicsContext *graphics)
+{
+    for (const auto &run : mRuns)
+    {
+        WithArray(mArrays, run.mType, [&run, graphics](auto &items) {
+            for (size_t i = run.mBegin; i < run.mEnd; i++)
+            {
+                items[i]->Draw(graphics);
+            }
+        }, std::make_index_sequence<NumArrays>());
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * @file ItemRuns.h
+ * @author matthew vazquez
+ *
+ * The items of a game split into runs of one concrete type, so each
+ * run is updated and drawn without virtual calls.
+ */
+
+#ifndef ITEMRUNS_H
+#define ITEMRUNS_H
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+#include <wx/graphics.h>
+
+class Item;
+class Product;
+class Conveyor;
+class Beam;
+class Sensor;
+class SensorPanel;
+class Sparty;
+class Scoreboard;
+class AndGate;
+class OrGate;
+class NotGate;
+class SrFlipFlopGate;
+class DFlipFlopGate;
+class MultiInputGate;
+class BusConnector;
+
+/**
+ * The items of a game split into runs of one concrete type, so each
+ * run is updated and drawn without virtual calls.
+ *
+ * Items are added in the order the game holds them. Consecutive items
+ * of the same type form a run, and each type keeps its items in an
+ * array of its own, so a level's products, placed one after another
+ * by their conveyor, are updated by a single loop over Product
+ * pointers. Runs are visited in order, so items are updated and drawn
+ * in the same order as a loop over every item would.
+ *
+ * Items whose type is not listed here, including classes derived
+ * from a listed type, go in runs of Item pointers and are called
+ * virtually.
+ */
+class ItemRuns
+{
+public:
+    /// Item types with arrays of their own; the last array holds all others
+    using Arrays = std::tuple<
+            std::vector<Product *>,
+            std::vector<Conveyor *>,
+            std::vector<Beam *>,
+            std::vector<Sensor *>,
+            std::vector<SensorPanel *>,
+            std::vector<Sparty *>,
+            std::vector<Scoreboard *>,
+            std::vector<AndGate *>,
+            std::vector<OrGate *>,
+            std::vector<NotGate *>,
+            std::vector<SrFlipFlopGate *>,
+            std::vector<DFlipFlopGate *>,
+            std::vector<MultiInputGate *>,
+            std::vector<BusConnector *>,
+            std::vector<Item *>>;
+
+private:
+    /**
+     * Consecutive items of one type
+     */
+    struct Run
+    {
+        /// Index of the type's array in Arrays
+        size_t mType;
+
+        /// First item of the run in the type's array
+        size_t mBegin;
+
+        /// One past the last item of the run
+        size_t mEnd;
+    };
+
+    /// Items of each type, in the order added
+    Arrays mArrays;
+
+    /// Runs in the order added
+    std::vector<Run> mRuns;
+
+    /// Number of items added
+    size_t mNumItems = 0;
+
+public:
+    void Clear();
+    void Add(Item *item);
+    void Update(double elapsed);
+    void Draw(wxGraphicsContext *graphics);
+
+    /**
+     * Get the number of runs
+     * @return Number of runs of one type
+     */
+    size_t GetNumRuns() const { return mRuns.size(); }
+
+    /**
+     * Get the number of items added
+     * @return Number of items
+     */
+    size_t GetNumItems() const { return mNumItems; }
+};
+
+#endif //ITEMRUNS_H
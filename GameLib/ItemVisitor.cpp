@@ -5,6 +5,13 @@
 
 #include "pch.h"
 #include "ItemVisitor.h"
+#include "AndGate.h"
+#include "OrGate.h"
+#include "NotGate.h"
+#include "SrFlipFlopGate.h"
+#include "DFlipFlopGate.h"
+#include "MultiInputGate.h"
+#include "BusConnector.h"
 
 ItemVisitor::ItemVisitor()
 {
@@ -15,3 +22,66 @@ ItemVisitor::~ItemVisitor()
 {
 
 }
+
+/**
+ * Visit an AndGate object. Defaults to visiting it as a gate.
+ * @param gate Gate we are visiting
+ */
+void ItemVisitor::VisitAndGate(AndGate* gate)
+{
+    VisitGates(gate);
+}
+
+/**
+ * Visit an OrGate object. Defaults to visiting it as a gate.
+ * @param gate Gate we are visiting
+ */
+void ItemVisitor::VisitOrGate(OrGate* gate)
+{
+    VisitGates(gate);
+}
+
+/**
+ * Visit a NotGate object. Defaults to visiting it as a gate.
+ * @param gate Gate we are visiting
+ */
+void ItemVisitor::VisitNotGate(NotGate* gate)
+{
+    VisitGates(gate);
+}
+
+/**
+ * Visit an SrFlipFlopGate object. Defaults to visiting it as a gate.
+ * @param gate Gate we are visiting
+ */
+void ItemVisitor::VisitSrFlipFlopGate(SrFlipFlopGate* gate)
+{
+    VisitGates(gate);
+}
+
+/**
+ * Visit a DFlipFlopGate object. Defaults to visiting it as a gate.
+ * @param gate Gate we are visiting
+ */
+void ItemVisitor::VisitDFlipFlopGate(DFlipFlopGate* gate)
+{
+    VisitGates(gate);
+}
+
+/**
+ * Visit a MultiInputGate object. Defaults to visiting it as a gate.
+ * @param gate Gate we are visiting
+ */
+void ItemVisitor::VisitMultiInputGate(MultiInputGate* gate)
+{
+    VisitGates(gate);
+}
+
+/**
+ * Visit a BusConnector object. Defaults to visiting it as a gate.
+ * @param connector Connector we are visiting
+ */
+void ItemVisitor::VisitBusConnector(BusConnector* connector)
+{
+    VisitGates(connector);
+}
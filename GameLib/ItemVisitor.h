@@ -24,6 +24,8 @@ class DFlipFlopGate;
 class NotGate;
 class OrGate;
 class SrFlipFlopGate;
+class MultiInputGate;
+class BusConnector;
 
 /**
  * Base class for visiting items.
@@ -86,6 +88,14 @@ public:
      */
     virtual void VisitGates(Gates* gates) {}
 
+    virtual void VisitAndGate(AndGate* gate);
+    virtual void VisitOrGate(OrGate* gate);
+    virtual void VisitNotGate(NotGate* gate);
+    virtual void VisitSrFlipFlopGate(SrFlipFlopGate* gate);
+    virtual void VisitDFlipFlopGate(DFlipFlopGate* gate);
+    virtual void VisitMultiInputGate(MultiInputGate* gate);
+    virtual void VisitBusConnector(BusConnector* connector);
+
     /**
        * Visit a SensorPanel object
        * @param sensorPanel SensorPanel we are visiting
@@ -6,36 +6,114 @@
 #include "pch.h"
 #include "LevelLoader.h"
 #include "Game.h"
+#include "XmlPullParser.h"
 
 /**
  * Load the game from XML file
  *
- * Opens XML file and reads nodes, creating all items.
+ * Maps XML file and reads it element by element, creating all items.
+ * The file is checked first, so a broken file leaves the game as it was.
  *
  * @param filename The filename of the XML file the level is loaded from
  * @param game the pointer to game instance.
  */
 void LevelLoader::LoadLevel(const wxString &filename, Game *game)
 {
-    wxXmlDocument xmlDoc;
+    XmlPullParser parser;
 
-    if (!xmlDoc.Load(filename))
+    if (!parser.Open(filename) || !parser.IsWellFormed())
     {
         wxMessageBox(L"Unable to load level");
         return;
     }
 
+    LoadLevel(parser, filename, game);
+}
+
+/**
+ * Load a level from a parser already checked to be well formed
+ *
+ * Used to reload a level whose file was read on another thread.
+ *
+ * @param parser Parser over the level's text
+ * @param filename The filename the level was read from
+ * @param game the pointer to game instance.
+ */
+void LevelLoader::LoadLevel(XmlPullParser &parser, const wxString &filename, Game *game)
+{
+    // Keep the circuit built on the level being left, and bring
+    // back the one built on this level the last time it was played
+    parser.Rewind();
+    game->StashCircuit();
+    XmlLoad(parser, game);
+    game->RestoreCircuit(filename.ToStdWstring());
+}
+
+/**
+ * Load a level being read, without building a document
+ *
+ * Replaces the items in the game with the items of the level.
+ *
+ * @param parser Parser at the start of the level file
+ * @param game the pointer to game instance.
+ */
+void LevelLoader::XmlLoad(XmlPullParser &parser, Game *game)
+{
     game->Clear();
 
-    auto root = xmlDoc.GetRoot();
+    if (parser.Next() != XmlPullParser::Event::StartElement)
+    {
+        return;
+    }
+    game->XmlGame(parser);
+
+    // The first element in the level holds the items
+    int depth = parser.GetDepth();
+    bool items = false;
+    while (!items && parser.NextChild(depth))
+    {
+        items = parser.IsStartElement();
+    }
+    if (!items)
+    {
+        return;
+    }
 
-    game->XmlGame(root);
+    XmlItems(parser, game);
+}
 
-    auto itemsChild = root->GetChildren();
+/**
+ * Load the items and wires an element holds into the game, such as
+ * a level's items or a circuit. Wires are connected once every item
+ * exists, since they refer to items by name.
+ *
+ * @param parser Parser on the element holding the items
+ * @param game the pointer to game instance.
+ */
+void LevelLoader::XmlItems(XmlPullParser &parser, Game *game)
+{
+    std::vector<std::pair<std::wstring, std::wstring>> wires;
+    int depth = parser.GetDepth();
+    while (parser.NextChild(depth))
+    {
+        if (!parser.IsStartElement())
+        {
+            continue;
+        }
+
+        if (parser.GetName() == "wire")
+        {
+            wires.emplace_back(XmlPullParser::Decode(parser.GetAttribute("from")),
+                               XmlPullParser::Decode(parser.GetAttribute("to")));
+        }
+        else
+        {
+            game->XmlItem(parser);
+        }
+    }
 
-    auto child = itemsChild->GetChildren();
-    for ( ; child; child = child->GetNext())
+    for (const auto &wire : wires)
     {
-        game->XmlItem(child);
+        game->XmlWire(wire.first, wire.second);
     }
-}
\ No newline at end of file
+}
@@ -10,6 +10,7 @@
 
 // Forward declaration.
 class Game;
+class XmlPullParser;
 
 /**
  * Objects of this class are responsible for loading levels within the game
@@ -21,6 +22,9 @@ private:
 
 public:
     void LoadLevel(const wxString &filename, Game* game);
+    void LoadLevel(XmlPullParser &parser, const wxString &filename, Game* game);
+    void XmlLoad(XmlPullParser &parser, Game* game);
+    void XmlItems(XmlPullParser &parser, Game* game);
 };
 
 #endif //LEVELLOADER_H
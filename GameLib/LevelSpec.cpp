@@ -0,0 +1,132 @@
+/**
+ * @file LevelSpec.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "LevelSpec.h"
+#include <algorithm>
+#include "Conveyor.h"
+#include "Product.h"
+
+using namespace std;
+
+/**
+ * Load the specification from a level's root node
+ * @param root The <level> node
+ * @return True if the level could be described, false if not; see GetError
+ */
+bool LevelSpec::XmlLoad(wxXmlNode *root)
+{
+    mInputs.clear();
+    mProducts.clear();
+    mError.clear();
+
+    bool beam = false;
+    for (auto items = root->GetChildren(); items; items = items->GetNext())
+    {
+        for (auto child = items->GetChildren(); child; child = child->GetNext())
+        {
+            auto name = child->GetName();
+            if (name == L"sensor")
+            {
+                XmlSensor(child);
+            }
+            else if (name == L"conveyor")
+            {
+                if (!XmlConveyor(child))
+                {
+                    return false;
+                }
+            }
+            else if (name == L"beam")
+            {
+                beam = true;
+            }
+            else if (name == L"line")
+            {
+                mError = L"levels with more than one production line are not supported";
+                return false;
+            }
+        }
+    }
+
+    if (beam)
+    {
+        mInputs.push_back(CircuitVerifier::BeamInput);
+    }
+
+    return true;
+}
+
+/**
+ * Load the properties a sensor can report
+ * @param node The <sensor> node
+ */
+void LevelSpec::XmlSensor(wxXmlNode *node)
+{
+    for (auto child = node->GetChildren(); child; child = child->GetNext())
+    {
+        auto property = child->GetName().ToStdWstring();
+        auto found = Product::NamesToProperties.find(property);
+        if (found != Product::NamesToProperties.end() && found->second != Product::Properties::None &&
+            find(mInputs.begin(), mInputs.end(), property) == mInputs.end())
+        {
+            mInputs.push_back(property);
+        }
+    }
+}
+
+/**
+ * Load the products on a conveyor.
+ *
+ * Products are placed the way Conveyor::XmlLoad places them, and
+ * are ordered by when they reach the sensor.
+ *
+ * @param node The <conveyor> node
+ * @return False if the conveyor generates its products
+ */
+bool LevelSpec::XmlConveyor(wxXmlNode *node)
+{
+    vector<pair<double, CircuitVerifier::ProductSpec>> placed;
+    double currentY = 0;
+
+    for (auto child = node->GetChildren(); child; child = child->GetNext())
+    {
+        if (child->GetName() == L"generator")
+        {
+            mError = L"conveyors that generate their products are not supported";
+            return false;
+        }
+
+        if (child->GetName() != L"product")
+        {
+            continue;
+        }
+
+        currentY = Conveyor::PlacedY(child->GetAttribute(L"placement", L"0").utf8_string(), 0, currentY);
+
+        CircuitVerifier::ProductSpec spec;
+        spec.mKick = child->GetAttribute(L"kick", L"no") == L"yes";
+        for (auto attribute : {L"shape", L"color", L"content"})
+        {
+            auto value = child->GetAttribute(attribute, L"").ToStdWstring();
+            auto found = Product::NamesToProperties.find(value);
+            if (found != Product::NamesToProperties.end() && found->second != Product::Properties::None)
+            {
+                spec.mProperties.push_back(value);
+            }
+        }
+
+        placed.push_back({currentY, spec});
+    }
+
+    // The lowest product reaches the sensor first
+    stable_sort(placed.begin(), placed.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+    for (const auto &product : placed)
+    {
+        mProducts.push_back(product.second);
+    }
+
+    return true;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file LevelSpec.h
+ * @author matthew vazquez
+ *
+ * The circuit inputs and products a level file describes.
+ */
+
+#ifndef LEVELSPEC_H
+#define LEVELSPEC_H
+
+#include <string>
+#include <vector>
+#include "CircuitVerifier.h"
+
+/**
+ * The circuit inputs and products a level file describes.
+ *
+ * Reads a level's XML directly, without creating any items, so
+ * tools can reason about a level without a window or images. Only
+ * levels with one production line and a fixed list of products can
+ * be described: a level with <line> nodes or a product <generator>
+ * is refused.
+ */
+class LevelSpec
+{
+private:
+    /// Circuit inputs: sensor properties, then the beam
+    std::vector<std::wstring> mInputs;
+
+    /// Products in the order they reach the sensor
+    std::vector<CircuitVerifier::ProductSpec> mProducts;
+
+    /// Why the level could not be described, empty if it could
+    std::wstring mError;
+
+    void XmlSensor(wxXmlNode *node);
+    bool XmlConveyor(wxXmlNode *node);
+
+public:
+    bool XmlLoad(wxXmlNode *root);
+
+    /**
+     * Get why the level could not be described
+     * @return Reason XmlLoad failed, empty if it did not
+     */
+    const std::wstring &GetError() const { return mError; }
+
+    /**
+     * Get the circuit input names
+     * @return Sensor properties the sensor can report, then the beam
+     */
+    const std::vector<std::wstring> &GetInputs() const { return mInputs; }
+
+    /**
+     * Get the products
+     * @return Products in the order they reach the sensor
+     */
+    const std::vector<CircuitVerifier::ProductSpec> &GetProducts() const { return mProducts; }
+};
+
+#endif //LEVELSPEC_H
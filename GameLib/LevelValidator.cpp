@@ -0,0 +1,631 @@
+/**
+ * @file LevelValidator.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "LevelValidator.h"
+#include <wx/tokenzr.h>
+#include "Beam.h"
+#include "BusConnector.h"
+#include "Conveyor.h"
+#include "Game.h"
+#include "InputPin.h"
+#include "ItemVisitor.h"
+#include "MultiInputGate.h"
+#include "OutputPin.h"
+#include "PinFinder.h"
+#include "Product.h"
+#include "ProductionLine.h"
+#include "Sensor.h"
+#include "Sparty.h"
+
+using namespace std;
+
+/**
+ * Visitor that collects the items of a production line
+ */
+class LineItemsVisitor : public ItemVisitor
+{
+public:
+    /// Conveyors of the line
+    vector<Conveyor *> mConveyors;
+
+    /// Sensors of the line
+    vector<Sensor *> mSensors;
+
+    /// Beams of the line
+    vector<Beam *> mBeams;
+
+    /// Sparty, if the line has one
+    vector<Sparty *> mSparties;
+
+    /**
+     * Collect a conveyor
+     * @param conveyor Conveyor we are visiting
+     */
+    void VisitConveyor(Conveyor *conveyor) override { mConveyors.push_back(conveyor); }
+
+    /**
+     * Collect a sensor
+     * @param sensor Sensor we are visiting
+     */
+    void VisitSensor(Sensor *sensor) override { mSensors.push_back(sensor); }
+
+    /**
+     * Collect a beam
+     * @param beam Beam we are visiting
+     */
+    void VisitBeam(Beam *beam) override { mBeams.push_back(beam); }
+
+    /**
+     * Collect Sparty
+     * @param sparty Sparty we are visiting
+     */
+    void VisitSparty(Sparty *sparty) override { mSparties.push_back(sparty); }
+};
+
+/**
+ * Read a number the way the loader does
+ * @param text Text of an attribute
+ * @param value Receives the number
+ * @return True if the text is a number
+ */
+static bool ParseNumber(wxString text, double &value)
+{
+    text.Trim(true).Trim(false);
+    return !text.empty() && text.ToDouble(&value);
+}
+
+/**
+ * Describe a location in a message
+ * @param x X location
+ * @param y Y location
+ * @return The location as (x, y)
+ */
+static wstring Location(double x, double y)
+{
+    return wxString::Format(L"(%g, %g)", x, y).ToStdWstring();
+}
+
+/**
+ * Note a mistake at a node of the level
+ * @param node Node the mistake is in
+ * @param message What is wrong
+ */
+void LevelValidator::Error(wxXmlNode *node, const wstring &message)
+{
+    mProblems.push_back({node->GetLineNumber(), message});
+}
+
+/**
+ * Note a mistake with no one place in the level file
+ * @param message What is wrong
+ */
+void LevelValidator::Error(const wstring &message)
+{
+    mProblems.push_back({0, message});
+}
+
+/**
+ * Check that a node has an attribute holding a number
+ * @param node Node to check
+ * @param name Name of the attribute
+ * @param positive True if the number must be greater than zero
+ * @return True if it does
+ */
+bool LevelValidator::RequireNumber(wxXmlNode *node, const wxString &name, bool positive)
+{
+    auto element = L"<" + node->GetName().ToStdWstring() + L">";
+    if (!node->HasAttribute(name))
+    {
+        Error(node, element + L" has no " + name.ToStdWstring() + L" attribute");
+        return false;
+    }
+
+    double value = 0;
+    auto text = node->GetAttribute(name);
+    if (!ParseNumber(text, value) || (positive && value <= 0))
+    {
+        Error(node, element + L" " + name.ToStdWstring() + L" \"" + text.ToStdWstring() + L"\" is not a " +
+                    (positive ? L"number above zero" : L"number"));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Check that an attribute a node may leave out holds a number
+ * @param node Node to check
+ * @param name Name of the attribute
+ */
+void LevelValidator::OptionalNumber(wxXmlNode *node, const wxString &name)
+{
+    if (node->HasAttribute(name))
+    {
+        RequireNumber(node, name);
+    }
+}
+
+/**
+ * Check that a node has an attribute holding two numbers, such as "60,-390"
+ * @param node Node to check
+ * @param name Name of the attribute
+ * @return True if it does
+ */
+bool LevelValidator::RequirePair(wxXmlNode *node, const wxString &name)
+{
+    auto element = L"<" + node->GetName().ToStdWstring() + L">";
+    if (!node->HasAttribute(name))
+    {
+        Error(node, element + L" has no " + name.ToStdWstring() + L" attribute");
+        return false;
+    }
+
+    auto text = node->GetAttribute(name);
+    wxStringTokenizer tokenizer(text, L",");
+    double x = 0;
+    double y = 0;
+    if (tokenizer.CountTokens() != 2 || !ParseNumber(tokenizer.GetNextToken(), x) ||
+        !ParseNumber(tokenizer.GetNextToken(), y))
+    {
+        Error(node, element + L" " + name.ToStdWstring() + L" \"" + text.ToStdWstring() + L"\" is not \"x,y\"");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Check a level document. This creates nothing, so documents can be
+ * checked on any thread.
+ * @param root Root node of the level document
+ */
+void LevelValidator::CheckXml(wxXmlNode *root)
+{
+    if (root == nullptr || root->GetName() != L"level")
+    {
+        Error(L"the root element is not <level>");
+        return;
+    }
+
+    if (RequirePair(root, L"size"))
+    {
+        double width = 0;
+        double height = 0;
+        wxStringTokenizer tokenizer(root->GetAttribute(L"size"), L",");
+        ParseNumber(tokenizer.GetNextToken(), width);
+        ParseNumber(tokenizer.GetNextToken(), height);
+        if (width <= 0 || height <= 0)
+        {
+            Error(root, L"the level size is not above zero");
+        }
+    }
+
+    // The loader takes the first child as the items
+    auto items = root->GetChildren();
+    if (items == nullptr || items->GetName() != L"items")
+    {
+        Error(root, L"the first node of <level> is not <items>");
+        return;
+    }
+
+    for (auto child = items->GetChildren(); child; child = child->GetNext())
+    {
+        if (child->GetType() == wxXML_ELEMENT_NODE)
+        {
+            CheckItem(child, false);
+        }
+    }
+}
+
+/**
+ * Check a node of the items node, or of a line node
+ * @param node Node to check
+ * @param inLine True if the node is in a line node
+ */
+void LevelValidator::CheckItem(wxXmlNode *node, bool inLine)
+{
+    auto name = node->GetName().ToStdWstring();
+    if (name == L"line")
+    {
+        if (inLine)
+        {
+            Error(node, L"<line> nodes cannot be nested");
+            return;
+        }
+
+        for (auto child = node->GetChildren(); child; child = child->GetNext())
+        {
+            if (child->GetType() != wxXML_ELEMENT_NODE)
+            {
+                continue;
+            }
+
+            auto childName = child->GetName();
+            if (childName != L"conveyor" && childName != L"sensor" && childName != L"beam" && childName != L"sparty")
+            {
+                Error(child, L"<" + childName.ToStdWstring() + L"> does not belong in a <line>");
+            }
+            else
+            {
+                CheckItem(child, true);
+            }
+        }
+    }
+    else if (name == L"conveyor")
+    {
+        CheckConveyor(node);
+    }
+    else if (name == L"sensor")
+    {
+        CheckSensor(node);
+    }
+    else if (name == L"beam")
+    {
+        RequireNumber(node, L"x");
+        RequireNumber(node, L"y");
+        RequireNumber(node, L"sender");
+    }
+    else if (name == L"sparty")
+    {
+        RequireNumber(node, L"x");
+        RequireNumber(node, L"y");
+        RequireNumber(node, L"height", true);
+        RequirePair(node, L"pin");
+        RequireNumber(node, L"kick-duration", true);
+        RequireNumber(node, L"kick-speed", true);
+    }
+    else if (name == L"scoreboard")
+    {
+        OptionalNumber(node, L"x");
+        OptionalNumber(node, L"y");
+        OptionalNumber(node, L"good");
+        OptionalNumber(node, L"bad");
+    }
+    else if (name == L"wire")
+    {
+        if (!node->HasAttribute(L"from") || !node->HasAttribute(L"to"))
+        {
+            Error(node, L"<wire> needs both from and to");
+            return;
+        }
+        mWires.push_back({node->GetLineNumber(), node->GetAttribute(L"from").ToStdWstring(),
+                          node->GetAttribute(L"to").ToStdWstring()});
+    }
+    else if (name == L"andgate" || name == L"orgate" || name == L"notgate" || name == L"srflipflop" ||
+             name == L"dflipflop" || name == L"multigate" || name == L"busjoin" || name == L"bussplit")
+    {
+        CheckGate(node);
+    }
+    else
+    {
+        // The game skips nodes it does not know
+        Error(node, L"unknown item <" + name + L">");
+    }
+}
+
+/**
+ * Check a conveyor node and its products
+ * @param node Conveyor node
+ */
+void LevelValidator::CheckConveyor(wxXmlNode *node)
+{
+    RequireNumber(node, L"x");
+    RequireNumber(node, L"y");
+    RequireNumber(node, L"speed", true);
+    RequireNumber(node, L"height", true);
+    RequirePair(node, L"panel");
+
+    int products = 0;
+    for (auto child = node->GetChildren(); child; child = child->GetNext())
+    {
+        if (child->GetType() != wxXML_ELEMENT_NODE)
+        {
+            continue;
+        }
+
+        if (child->GetName() == L"product")
+        {
+            CheckProduct(child, true);
+            products++;
+        }
+        else if (child->GetName() == L"generator")
+        {
+            CheckGenerator(child);
+            products++;
+        }
+        else
+        {
+            Error(child, L"unknown conveyor node <" + child->GetName().ToStdWstring() + L">");
+        }
+    }
+
+    if (products == 0)
+    {
+        Error(node, L"the conveyor has no products");
+    }
+}
+
+/**
+ * Check a product node
+ * @param node Product node
+ * @param placed True if the product is placed on the belt by the level,
+ * false if it is a generator's template
+ */
+void LevelValidator::CheckProduct(wxXmlNode *node, bool placed)
+{
+    if (placed)
+    {
+        // The loader drops every + and reads what is left, so only a
+        // leading + is meaningful
+        auto placement = node->GetAttribute(L"placement", L"");
+        auto number = placement.StartsWith(L"+") ? placement.Mid(1) : placement;
+        double value = 0;
+        if (placement.empty())
+        {
+            Error(node, L"<product> has no placement attribute");
+        }
+        else if (number.find_first_of(L"+-") != wxString::npos || !ParseNumber(number, value))
+        {
+            Error(node, L"placement \"" + placement.ToStdWstring() +
+                        L"\" is not a distance, or a +distance from the product before");
+        }
+    }
+
+    // Each attribute must name a property of its own type
+    static const pair<const wchar_t *, Product::Types> attributes[] = {
+            {L"shape", Product::Types::Shape},
+            {L"color", Product::Types::Color},
+            {L"content", Product::Types::Content}};
+    for (const auto &attribute : attributes)
+    {
+        if (!node->HasAttribute(attribute.first))
+        {
+            continue;
+        }
+
+        auto value = node->GetAttribute(attribute.first).ToStdWstring();
+        auto property = Product::NamesToProperties.find(value);
+        if (property == Product::NamesToProperties.end() ||
+            Product::PropertiesToTypes.at(property->second) != attribute.second)
+        {
+            Error(node, L"unknown " + wstring(attribute.first) + L" \"" + value + L"\"");
+        }
+    }
+
+    if (!node->HasAttribute(L"shape"))
+    {
+        Error(node, L"<product> has no shape");
+    }
+
+    auto kick = node->GetAttribute(L"kick", L"no");
+    if (kick != L"yes" && kick != L"no")
+    {
+        Error(node, L"kick \"" + kick.ToStdWstring() + L"\" is not yes or no");
+    }
+}
+
+/**
+ * Check a generator node and its product templates
+ * @param node Generator node
+ */
+void LevelValidator::CheckGenerator(wxXmlNode *node)
+{
+    if (node->HasAttribute(L"rate"))
+    {
+        RequireNumber(node, L"rate", true);
+    }
+    if (node->HasAttribute(L"pool"))
+    {
+        RequireNumber(node, L"pool", true);
+    }
+    OptionalNumber(node, L"seed");
+
+    int templates = 0;
+    for (auto child = node->GetChildren(); child; child = child->GetNext())
+    {
+        if (child->GetType() != wxXML_ELEMENT_NODE)
+        {
+            continue;
+        }
+
+        if (child->GetName() != L"product")
+        {
+            Error(child, L"unknown generator node <" + child->GetName().ToStdWstring() + L">");
+            continue;
+        }
+
+        CheckProduct(child, false);
+        if (child->HasAttribute(L"weight"))
+        {
+            RequireNumber(child, L"weight", true);
+        }
+        templates++;
+    }
+
+    if (templates == 0)
+    {
+        Error(node, L"the generator has no products to make");
+    }
+}
+
+/**
+ * Check a sensor node. A property no panel knows makes its panel's
+ * output stay put whatever passes.
+ * @param node Sensor node
+ */
+void LevelValidator::CheckSensor(wxXmlNode *node)
+{
+    RequireNumber(node, L"x");
+    RequireNumber(node, L"y");
+
+    int panels = 0;
+    for (auto child = node->GetChildren(); child; child = child->GetNext())
+    {
+        if (child->GetType() != wxXML_ELEMENT_NODE)
+        {
+            continue;
+        }
+
+        auto property = child->GetName().ToStdWstring();
+        if (property == L"none" || Product::NamesToProperties.find(property) == Product::NamesToProperties.end())
+        {
+            Error(child, L"unknown sensor property <" + property + L">");
+        }
+        panels++;
+    }
+
+    if (panels == 0)
+    {
+        Error(node, L"the sensor has no properties");
+    }
+}
+
+/**
+ * Check a gate node
+ * @param node Gate node
+ */
+void LevelValidator::CheckGate(wxXmlNode *node)
+{
+    if (node->HasAttribute(L"x") || node->HasAttribute(L"y"))
+    {
+        RequireNumber(node, L"x");
+        RequireNumber(node, L"y");
+    }
+
+    if (node->GetName() == L"multigate")
+    {
+        MultiInputGate::Function function;
+        auto name = node->GetAttribute(L"function", L"and").ToStdWstring();
+        if (!MultiInputGate::FunctionFromName(name, function))
+        {
+            Error(node, L"unknown gate function \"" + name + L"\"");
+        }
+
+        long inputs = MultiInputGate::MinInputs;
+        if (!node->GetAttribute(L"inputs", L"2").ToLong(&inputs) || inputs < MultiInputGate::MinInputs ||
+            inputs > MultiInputGate::MaxInputs)
+        {
+            Error(node, wxString::Format(L"a multigate has %d to %d inputs", MultiInputGate::MinInputs,
+                                         MultiInputGate::MaxInputs).ToStdWstring());
+        }
+
+        long width = 1;
+        if (!node->GetAttribute(L"width", L"1").ToLong(&width) || width < 1 || width > MultiInputGate::MaxBusWidth)
+        {
+            Error(node, wxString::Format(L"a multigate is 1 to %d bits wide", MultiInputGate::MaxBusWidth).ToStdWstring());
+        }
+    }
+    else if (node->GetName() == L"busjoin" || node->GetName() == L"bussplit")
+    {
+        long width = BusConnector::MinWidth;
+        if (!node->GetAttribute(L"width", L"2").ToLong(&width) || width < BusConnector::MinWidth ||
+            width > BusConnector::MaxWidth)
+        {
+            Error(node, wxString::Format(L"a bus is %d to %d bits wide", BusConnector::MinWidth,
+                                         BusConnector::MaxWidth).ToStdWstring());
+        }
+    }
+}
+
+/**
+ * Check the items a level created once it was loaded into a game
+ * with LevelLoader. Games are not shared, so different games can be
+ * checked on different threads.
+ * @param game Game the level was loaded into
+ */
+void LevelValidator::CheckGame(Game *game)
+{
+    // A product at the center of the belt finds what the items see
+    Product probe(game);
+
+    for (int i = 0; i < game->GetNumLines(); i++)
+    {
+        LineItemsVisitor items;
+        game->GetLine(i)->AcceptAll(&items);
+        wstring line = game->GetNumLines() > 1 ? L"line " + to_wstring(i + 1) : L"the level";
+
+        if (items.mConveyors.empty())
+        {
+            Error(line + L" has no conveyor");
+            continue;
+        }
+        if (items.mConveyors.size() > 1)
+        {
+            Error(line + L" has more than one conveyor; put each in its own <line>");
+        }
+        if (items.mBeams.empty())
+        {
+            Error(line + L" has no beam, so it never finishes");
+        }
+        if (items.mSparties.empty())
+        {
+            Error(line + L" has no Sparty to kick its products");
+        }
+
+        auto conveyor = items.mConveyors[0];
+        double x = conveyor->GetX();
+        double top = conveyor->GetY() - conveyor->GetHeight() / 2;
+        double bottom = conveyor->GetY() + conveyor->GetHeight() / 2;
+        auto conveyorAt = Location(conveyor->GetX(), conveyor->GetY());
+
+        for (auto beam : items.mBeams)
+        {
+            probe.SetLocation(x, beam->GetY());
+            if (beam->GetY() < top || beam->GetY() > bottom || !beam->IsProductInBeam(&probe))
+            {
+                Error(L"the beam at " + Location(beam->GetX(), beam->GetY()) +
+                      L" does not cross the conveyor at " + conveyorAt);
+            }
+        }
+
+        // The sensor's range must sit on the belt and over the lane
+        // the products travel down
+        double half = probe.GetSize() / 2;
+        for (auto sensor : items.mSensors)
+        {
+            auto range = sensor->GetRange();
+            if (range.GetTop() < top || range.GetBottom() > bottom || range.GetRight() < x - half ||
+                range.GetLeft() > x + half)
+            {
+                Error(L"the sensor at " + Location(sensor->GetX(), sensor->GetY()) +
+                      L" cannot see products on the conveyor at " + conveyorAt);
+            }
+        }
+
+        for (auto sparty : items.mSparties)
+        {
+            auto kick = sparty->GetKickPoint();
+            probe.SetLocation(x, kick.m_y);
+            if (kick.m_y < top || kick.m_y > bottom || !probe.HitTest(kick.m_x, kick.m_y))
+            {
+                Error(L"Sparty's kick at " + Location(kick.m_x, kick.m_y) +
+                      L" does not reach the conveyor at " + conveyorAt);
+            }
+        }
+    }
+
+    for (const auto &wire : mWires)
+    {
+        PinFinder from(wire.mFrom);
+        PinFinder to(wire.mTo);
+        from.Find(game);
+        to.Find(game);
+        if (from.GetOutputPin() == nullptr)
+        {
+            mProblems.push_back({wire.mLine, L"wire from \"" + wire.mFrom + L"\" names no output pin"});
+        }
+        if (to.GetInputPin() == nullptr)
+        {
+            mProblems.push_back({wire.mLine, L"wire to \"" + wire.mTo + L"\" names no input pin"});
+        }
+        else if (from.GetOutputPin() != nullptr &&
+                 from.GetOutputPin()->GetBusWidth() != to.GetInputPin()->GetBusWidth())
+        {
+            // The game does not connect pins that carry different numbers of bits
+            mProblems.push_back({wire.mLine, wxString::Format(L"wire from \"%s\" carries %d bits but \"%s\" takes %d",
+                                                              wire.mFrom.c_str(), from.GetOutputPin()->GetBusWidth(), wire.mTo.c_str(),
+                                                              to.GetInputPin()->GetBusWidth()).ToStdWstring()});
+        }
+    }
+}
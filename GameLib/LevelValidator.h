@@ -0,0 +1,96 @@
+/**
+ * @file LevelValidator.h
+ * @author matthew vazquez
+ *
+ * Finds mistakes in a level file that the game would load silently.
+ */
+
+#ifndef LEVELVALIDATOR_H
+#define LEVELVALIDATOR_H
+
+#include <string>
+#include <vector>
+
+class Game;
+
+/**
+ * Finds mistakes in a level file that the game would load silently.
+ *
+ * Checking takes two steps. CheckXml looks at the document itself:
+ * unknown elements, missing or malformed attributes, sensor
+ * properties no panel knows and placements that are not a number or
+ * a +number. It creates nothing, so documents can be checked on any
+ * thread. A level that passes can then be loaded into a game with
+ * LevelLoader, the way the game loads it, and CheckGame looks at the
+ * items that were created: each line's beam must cross its conveyor's
+ * belt, its sensor must see products on the belt, Sparty's boot must
+ * reach them, and every wire must join pins that exist.
+ */
+class LevelValidator
+{
+public:
+    /**
+     * A mistake in the level
+     */
+    struct Problem
+    {
+        /// Line of the level file, or 0 if the mistake has no one place
+        int mLine = 0;
+
+        /// What is wrong
+        std::wstring mMessage;
+    };
+
+private:
+    /**
+     * A wire node, checked once the items exist
+     */
+    struct Wire
+    {
+        /// Line of the wire node
+        int mLine;
+
+        /// Output endpoint
+        std::wstring mFrom;
+
+        /// Input endpoint
+        std::wstring mTo;
+    };
+
+    /// Mistakes found, in the order found
+    std::vector<Problem> mProblems;
+
+    /// Wires of the level
+    std::vector<Wire> mWires;
+
+    void Error(wxXmlNode *node, const std::wstring &message);
+    void Error(const std::wstring &message);
+    bool RequireNumber(wxXmlNode *node, const wxString &name, bool positive = false);
+    void OptionalNumber(wxXmlNode *node, const wxString &name);
+    bool RequirePair(wxXmlNode *node, const wxString &name);
+
+    void CheckItem(wxXmlNode *node, bool inLine);
+    void CheckConveyor(wxXmlNode *node);
+    void CheckProduct(wxXmlNode *node, bool placed);
+    void CheckGenerator(wxXmlNode *node);
+    void CheckSensor(wxXmlNode *node);
+    void CheckGate(wxXmlNode *node);
+
+public:
+    void CheckXml(wxXmlNode *root);
+    void CheckGame(Game *game);
+
+    /**
+     * Get the mistakes found
+     * @return Mistakes in the order found
+     */
+    const std::vector<Problem> &GetProblems() const { return mProblems; }
+
+    /**
+     * Did the level pass every check so far?
+     * @return True if no mistakes were found
+     */
+    bool IsValid() const { return mProblems.empty(); }
+};
+
+#endif //LEVELVALIDATOR_H
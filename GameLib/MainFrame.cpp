@@ -48,10 +48,20 @@ void MainFrame::Initialize()
     auto levelMenu = new wxMenu();
 
     // Append items to the file menu
+    fileMenu->Append(IDM_SAVECIRCUIT, L"&Save Circuit...\tCtrl-S", L"Save the gates and wires you built");
+    fileMenu->Append(IDM_LOADCIRCUIT, L"&Load Circuit...\tCtrl-O", L"Replace the gates and wires with a saved circuit");
+    fileMenu->AppendSeparator();
+    fileMenu->Append(IDM_SAVESESSION, L"Save Session &Log...", L"Save everything done since the game started, to replay it");
+    fileMenu->AppendSeparator();
     fileMenu->Append(wxID_EXIT, "E&xit\tAlt-X", "Quit this program");
 
     // Append items to the view menu
     viewMenu->Append(IDM_CONTROLPOINTS, L"&Control Points", L"Toggle Control Points", wxITEM_CHECK);
+    viewMenu->AppendSeparator();
+    viewMenu->Append(IDM_SPEED1, L"Speed &1x\tCtrl-1", L"Play at normal speed", wxITEM_RADIO);
+    viewMenu->Append(IDM_SPEED2, L"Speed &2x\tCtrl-2", L"Play twice as fast", wxITEM_RADIO);
+    viewMenu->Append(IDM_SPEED8, L"Speed &8x\tCtrl-8", L"Play eight times as fast", wxITEM_RADIO);
+    viewMenu->Append(IDM_SPEEDMAX, L"Speed &Max\tCtrl-0", L"Play as fast as the computer can", wxITEM_RADIO);
 
     // Append items to the help menu
     helpMenu->Append(wxID_ABOUT, "&About\tF1", "Show about dialog");
@@ -62,6 +72,18 @@ void MainFrame::Initialize()
     gatesMenu->Append(IDM_NOTGATE, L"&NOT");
     gatesMenu->Append(IDM_SRFLIPFLOP, L"&SR Flip Flop");
     gatesMenu->Append(IDM_DFLIPFLOP, L"&D Flip Flop");
+    gatesMenu->AppendSeparator();
+    gatesMenu->Append(IDM_AND4GATE, L"AND (&4 Inputs)");
+    gatesMenu->Append(IDM_OR4GATE, L"OR (4 &Inputs)");
+    gatesMenu->Append(IDM_XORGATE, L"&XOR");
+    gatesMenu->Append(IDM_NANDGATE, L"N&AND");
+    gatesMenu->Append(IDM_NORGATE, L"NO&R");
+    gatesMenu->AppendSeparator();
+    gatesMenu->Append(IDM_BUSJOIN, L"Bus &Join (4 Bits)", L"Join four wires into a bus");
+    gatesMenu->Append(IDM_AND4BUS, L"AND (4-Bit &Bus)", L"AND two 4-bit buses bit by bit");
+    gatesMenu->Append(IDM_BUSSPLIT, L"Bus S&plit (4 Bits)", L"Split a bus into four wires");
+    gatesMenu->AppendSeparator();
+    gatesMenu->Append(IDM_VERIFYCIRCUIT, L"&Verify Circuit", L"Check the circuit against the level's products");
 
     // Add level menu items
     levelMenu->Append(IDM_LEVEL0, L"Level &0");
@@ -73,6 +95,10 @@ void MainFrame::Initialize()
     levelMenu->Append(IDM_LEVEL6, L"Level &6");
    levelMenu->Append(IDM_LEVEL7, L"Level &7");
  levelMenu->Append(IDM_LEVEL8, L"Level &8");
+    levelMenu->Append(IDM_LEVEL9, L"Level &9");
+    levelMenu->Append(IDM_LEVEL10, L"&Endless", L"Products stream in until another level is picked");
+    levelMenu->AppendSeparator();
+    levelMenu->Append(IDM_REWIND, L"&Rewind\tCtrl-Z", L"Go back a second; again to go further");
 
     // Append menus to the menu bar
     menuBar->Append(fileMenu, L"&File");
@@ -0,0 +1,350 @@
+/**
+ * @file MultiInputGate.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "MultiInputGate.h"
+#include <algorithm>
+#include <bitset>
+#include "Game.h"
+#include "InputPin.h"
+#include "OutputPin.h"
+
+/// Width of the gate body in pixels
+const int MultiInputGateWidth = 60;
+
+/// Smallest height of the gate body in pixels
+const int MultiInputGateMinHeight = 50;
+
+/// Vertical distance between input pins in pixels
+const int MultiInputPinSpacing = 25;
+
+/// Diameter of the inverting bubble on NAND and NOR gates
+const int MultiInputBubbleSize = 10;
+
+/// Size of the font for the gate symbol
+const int MultiInputLabelSize = 18;
+
+/// Function names as level files write them
+const std::pair<const wchar_t *, MultiInputGate::Function> FunctionNames[] = {
+    {L"and", MultiInputGate::Function::And}, {L"or", MultiInputGate::Function::Or},
+    {L"xor", MultiInputGate::Function::Xor}, {L"nand", MultiInputGate::Function::Nand},
+    {L"nor", MultiInputGate::Function::Nor}};
+
+/**
+ * Constructor
+ * @param game The game this gate is in
+ * @param function What the gate computes
+ * @param inputs Number of input pins, clamped to MinInputs to MaxInputs
+ * @param busWidth Number of bits each pin carries, clamped to 1 to MaxBusWidth
+ */
+MultiInputGate::MultiInputGate(Game *game, Function function, int inputs, int busWidth) :
+    Gates(game), mFunction(function), mBusWidth(std::clamp(busWidth, 1, MaxBusWidth))
+{
+    inputs = std::clamp(inputs, MinInputs, MaxInputs);
+
+    auto w = MultiInputGateWidth;
+    auto h = std::max(MultiInputGateMinHeight, inputs * MultiInputPinSpacing);
+
+    for (int i = 0; i < inputs; i++)
+    {
+        wxPoint point(-w / 2, -h / 2 + MultiInputPinSpacing / 2 + i * MultiInputPinSpacing);
+        auto pin = CreatePart<InputPin>(this, point);
+        Get(pin)->SetState(States::Unknown);
+        Get(pin)->SetBusWidth(mBusWidth);
+        mInputs.push_back(pin);
+    }
+
+    bool inverted = function == Function::Nand || function == Function::Nor;
+    mOutput = CreatePart<OutputPin>(this, wxPoint(w / 2 + (inverted ? MultiInputBubbleSize : 0), 0));
+    Get(mOutput)->SetState(States::Unknown);
+    Get(mOutput)->SetBusWidth(mBusWidth);
+}
+
+/**
+ * Look up a gate function by the name level files use
+ * @param name Function name: and, or, xor, nand or nor
+ * @param function Receives the function
+ * @return True if the name is known
+ */
+bool MultiInputGate::FunctionFromName(const std::wstring &name, Function &function)
+{
+    for (const auto &entry : FunctionNames)
+    {
+        if (name == entry.first)
+        {
+            function = entry.second;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Get the name level files use for a gate function
+ * @param function Gate function
+ * @return Function name: and, or, xor, nand or nor
+ */
+std::wstring MultiInputGate::FunctionName(Function function)
+{
+    for (const auto &entry : FunctionNames)
+    {
+        if (entry.second == function)
+        {
+            return entry.first;
+        }
+    }
+
+    return L"and";
+}
+
+/**
+ * Compute a gate's output from its packed inputs
+ * @param function What the gate computes
+ * @param inputs Input i in lane i
+ * @param count Number of inputs
+ * @return Output state, Unknown if any input is Unknown
+ */
+States MultiInputGate::Evaluate(Function function, LogicWord inputs, int count)
+{
+    uint64_t used = LogicWord::Mask(count);
+    if ((inputs.Known() & used) != used)
+    {
+        return States::Unknown;
+    }
+
+    uint64_t ones = inputs.mOne & used;
+    bool value;
+    switch (function)
+    {
+    case Function::And:
+        value = ones == used;
+        break;
+
+    case Function::Or:
+        value = ones != 0;
+        break;
+
+    case Function::Xor:
+        value = (std::bitset<64>(ones).count() & 1) != 0;
+        break;
+
+    case Function::Nand:
+        value = ones != used;
+        break;
+
+    default:
+        value = ones == 0;
+        break;
+    }
+
+    return value ? States::One : States::Zero;
+}
+
+/**
+ * Compute the output from the input pins
+ */
+void MultiInputGate::ComputeOutput()
+{
+    if (mBusWidth > 1)
+    {
+        // Each lane is one bit of the bus, so the gate rules apply lane by lane
+        auto bus = Get(mInputs[0])->GetBus();
+        for (size_t i = 1; i < mInputs.size(); i++)
+        {
+            auto input = Get(mInputs[i])->GetBus();
+            if (mFunction == Function::Or || mFunction == Function::Nor)
+            {
+                bus = GateLogic::Or(bus, input);
+            }
+            else if (mFunction == Function::Xor)
+            {
+                bus = GateLogic::Xor(bus, input);
+            }
+            else
+            {
+                bus = GateLogic::And(bus, input);
+            }
+        }
+
+        if (mFunction == Function::Nand || mFunction == Function::Nor)
+        {
+            bus = GateLogic::Not(bus);
+        }
+        Get(mOutput)->SetBus(bus);
+        return;
+    }
+
+    LogicWord inputs;
+    for (int i = 0; i < (int)mInputs.size(); i++)
+    {
+        inputs.SetLane(i, Get(mInputs[i])->GetState());
+    }
+
+    Get(mOutput)->SetState(Evaluate(mFunction, inputs, (int)mInputs.size()));
+}
+
+/**
+ * Draw the gate as a box labelled with its function
+ * @param graphics Graphics context to draw on
+ */
+void MultiInputGate::Draw(wxGraphicsContext *graphics)
+{
+    for (auto &pin : mInputs)
+    {
+        Get(pin)->Draw(graphics);
+    }
+    Get(mOutput)->Draw(graphics);
+
+    auto x = GetX();
+    auto y = GetY();
+    auto w = getWidth();
+    auto h = getHeight();
+
+    graphics->SetPen(*wxBLACK_PEN);
+    graphics->SetBrush(*wxWHITE_BRUSH);
+
+    auto path = graphics->CreatePath();
+    path.AddRectangle(x - w / 2, y - h / 2, w, h);
+    path.CloseSubpath();
+    graphics->DrawPath(path);
+
+    if (mFunction == Function::Nand || mFunction == Function::Nor)
+    {
+        auto bubble = graphics->CreatePath();
+        bubble.AddCircle(x + w / 2 + MultiInputBubbleSize / 2, y, MultiInputBubbleSize / 2);
+        graphics->DrawPath(bubble);
+    }
+
+    // The IEC symbols: & for AND, >=1 for OR, =1 for XOR
+    wxString label = L"&";
+    if (mFunction == Function::Or || mFunction == Function::Nor)
+    {
+        label = L"\u22651";
+    }
+    else if (mFunction == Function::Xor)
+    {
+        label = L"=1";
+    }
+
+    auto font = graphics->CreateFont(MultiInputLabelSize, L"Arial", wxFONTFLAG_BOLD, *wxBLACK);
+    graphics->SetFont(font);
+
+    double labelWidth, labelHeight;
+    graphics->GetTextExtent(label, &labelWidth, &labelHeight);
+    graphics->DrawText(label, x - labelWidth / 2, y - labelHeight / 2);
+
+    if (mBusWidth > 1)
+    {
+        // The bus width under the symbol, as a slash on a bus is labelled
+        wxString bits = wxString::Format(L"/%d", mBusWidth);
+        auto bitsFont = graphics->CreateFont(MultiInputLabelSize / 2, L"Arial", wxFONTFLAG_DEFAULT, *wxBLACK);
+        graphics->SetFont(bitsFont);
+        double bitsWidth, bitsHeight;
+        graphics->GetTextExtent(bits, &bitsWidth, &bitsHeight);
+        graphics->DrawText(bits, x - bitsWidth / 2, y + labelHeight / 2);
+    }
+}
+
+/**
+ * Handle updates for animation
+ * @param elapsed The time since the last update
+ */
+void MultiInputGate::Update(double elapsed)
+{
+    Get(mOutput)->Update();
+    ComputeOutput();
+}
+
+/**
+ * Handle a click on the item
+ * @param x X location clicked on
+ * @param y Y location clicked on
+ */
+void MultiInputGate::OnClick(double x, double y)
+{
+    ComputeOutput();
+}
+
+/**
+ * Get the Gate Width
+ * @return Width in pixels
+ */
+double MultiInputGate::getWidth()
+{
+    return MultiInputGateWidth;
+}
+
+/**
+ * Get the Gate Height, which grows with the number of inputs
+ * @return Height in pixels
+ */
+double MultiInputGate::getHeight()
+{
+    return std::max(MultiInputGateMinHeight, (int)mInputs.size() * MultiInputPinSpacing);
+}
+
+/**
+ * Test to see if we clicked on some draggable inside the item.
+ * @param x X location clicked on
+ * @param y Y location clicked on
+ * @return Whatever we clicked on or NULL if none
+ */
+IDraggable *MultiInputGate::HitDraggable(int x, int y)
+{
+    if (Get(mOutput)->HitTest(x, y))
+    {
+        return Get(mOutput);
+    }
+
+    return nullptr;
+}
+
+/**
+ * Tests if an output pin has an input pin to connect to
+ * @param pin The pin that is connected
+ * @param lineEnd The spot of the mouse
+ * @return True if there is a pin to be connected to
+ */
+bool MultiInputGate::Connect(OutputPin *pin, wxPoint lineEnd)
+{
+    for (auto &input : mInputs)
+    {
+        if (Get(input)->Catch(pin, lineEnd))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Save the gate's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void MultiInputGate::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Gates::SaveSnapshot(snapshot);
+    for (const auto &input : mInputs)
+    {
+        Get(input)->SaveSnapshot(snapshot);
+    }
+    Get(mOutput)->SaveSnapshot(snapshot);
+}
+
+/**
+ * Restore the gate's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void MultiInputGate::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Gates::RestoreSnapshot(snapshot);
+    for (auto &input : mInputs)
+    {
+        Get(input)->RestoreSnapshot(snapshot);
+    }
+    Get(mOutput)->RestoreSnapshot(snapshot);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file MultiInputGate.h
+ * @author matthew vazquez
+ *
+ * A gate with any number of inputs.
+ */
+
+#ifndef MULTIINPUTGATE_H
+#define MULTIINPUTGATE_H
+
+#include <string>
+#include <vector>
+#include "Gates.h"
+
+class InputPin;
+class OutputPin;
+
+/**
+ * A gate with any number of inputs.
+ *
+ * One MultiInputGate replaces a tree of two input gates: a single
+ * item updates, hit-tests and draws where the tree had one per gate.
+ * The input states are packed into the lanes of a LogicWord and
+ * reduced with a few word operations. Packing still reads every
+ * input, so an update costs time in proportion to the inputs.
+ *
+ * A gate with a bus width above 1 has bus pins and computes the
+ * function for every bit at once: bit i of the output comes from
+ * bit i of each input, with one word operation per input whatever
+ * the width. Like the other gates, any Unknown input makes the
+ * output Unknown.
+ */
+class MultiInputGate final : public Gates {
+public:
+ /// What the gate computes
+ enum class Function {And, Or, Xor, Nand, Nor};
+
+ /// Fewest inputs a gate can have
+ static const int MinInputs = 2;
+
+ /// Most inputs a gate can have, one per lane of a LogicWord
+ static const int MaxInputs = 64;
+
+ /// Most bits a bus can carry, one per lane of a LogicWord
+ static const int MaxBusWidth = 64;
+
+private:
+ /// What the gate computes
+ Function mFunction;
+
+ /// Number of bits each pin carries
+ int mBusWidth = 1;
+
+ /// Input pins, from the top
+ std::vector<ArenaHandle<InputPin>> mInputs;
+
+ /// Output pin
+ ArenaHandle<OutputPin> mOutput;
+
+public:
+ MultiInputGate(Game *game, Function function, int inputs, int busWidth = 1);
+
+ void ComputeOutput();
+ void Draw(wxGraphicsContext *graphics) override;
+ void OnClick(double x, double y) override;
+ double getWidth() override;
+ double getHeight() override;
+ IDraggable *HitDraggable(int x, int y) override;
+ bool Connect(OutputPin *pin, wxPoint lineEnd) override;
+ void Update(double elapsed) override;
+ void SaveSnapshot(GameSnapshot &snapshot) const override;
+ void RestoreSnapshot(GameSnapshot &snapshot) override;
+
+ /**
+  * Accept a visitor
+  * @param visitor The visitor we accept
+  */
+ void Accept(ItemVisitor* visitor) override { visitor->VisitMultiInputGate(this); }
+
+ /**
+  * Get what the gate computes
+  * @return Gate function
+  */
+ Function GetFunction() const { return mFunction; }
+
+ /**
+  * Get the number of inputs
+  * @return Number of input pins
+  */
+ int GetNumInputs() const { return (int)mInputs.size(); }
+
+ /**
+  * Get the number of bits each pin carries
+  * @return 1 for single wires, more for buses
+  */
+ int GetBusWidth() const { return mBusWidth; }
+
+ /**
+  * Get the output pin
+  * @return The pin
+  */
+ OutputPin *GetOutput() const { return Get(mOutput); }
+
+ /**
+  * Get an input pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr
+  */
+ InputPin *GetInputPin(int index) const override
+ {
+  return index >= 0 && index < (int)mInputs.size() ? Get(mInputs[index]) : nullptr;
+ }
+
+ /**
+  * Get an output pin by position
+  * @param index Pin index, from the top
+  * @return The pin, or nullptr
+  */
+ OutputPin *GetOutputPin(int index) const override { return index == 0 ? Get(mOutput) : nullptr; }
+
+ static bool FunctionFromName(const std::wstring &name, Function &function);
+ static std::wstring FunctionName(Function function);
+ static States Evaluate(Function function, LogicWord inputs, int count);
+};
+
+#endif //MULTIINPUTGATE_H
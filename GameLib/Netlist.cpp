@@ -0,0 +1,160 @@
+/**
+ * @file Netlist.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "Netlist.h"
+
+/**
+ * Add a circuit input such as a sensor property or the beam.
+ *
+ * Inputs must be added before any cells so they occupy the
+ * lowest net numbers.
+ *
+ * @param name Name of the input, e.g. L"red" or L"beam"
+ * @return Net driven by the input
+ */
+int Netlist::AddInput(const std::wstring &name)
+{
+    int existing = FindInput(name);
+    if (existing != Unconnected)
+    {
+        return existing;
+    }
+
+    mInputNames.push_back(name);
+    return mNumNets++;
+}
+
+/**
+ * Add a cell with all of its inputs unconnected.
+ * @param type Kind of gate
+ * @param inputs Number of inputs for AND, OR, XOR, NAND and NOR.
+ * NOT always has one and the flip flops two.
+ * @return Index of the new cell
+ */
+int Netlist::AddCell(CellType type, int inputs)
+{
+    if (type == CellType::Not)
+    {
+        inputs = 1;
+    }
+    else if (IsSequential(type))
+    {
+        inputs = 2;
+    }
+
+    Cell cell;
+    cell.mType = type;
+    cell.mInputs.assign(inputs, Unconnected);
+    cell.mOutput = mNumNets++;
+    if (IsSequential(type))
+    {
+        cell.mOutputNot = mNumNets++;
+    }
+
+    mCells.push_back(cell);
+    return (int)mCells.size() - 1;
+}
+
+/**
+ * Wire a cell input to a net
+ * @param cell Index of the cell
+ * @param input Which input pin on the cell
+ * @param net Net to wire it to, or Unconnected
+ */
+void Netlist::ConnectInput(int cell, int input, int net)
+{
+    mCells[cell].mInputs[input] = net;
+}
+
+/**
+ * Find an input by name
+ * @param name Name of the input
+ * @return Net driven by the input, or Unconnected if there is none
+ */
+int Netlist::FindInput(const std::wstring &name) const
+{
+    for (int i = 0; i < (int)mInputNames.size(); i++)
+    {
+        if (mInputNames[i] == name)
+        {
+            return i;
+        }
+    }
+
+    return Unconnected;
+}
+
+/**
+ * Does a cell type hold state between evaluations?
+ * @param type Kind of gate
+ * @return True for the flip flops
+ */
+bool Netlist::IsSequential(CellType type) const
+{
+    return type == CellType::SrFlipFlop || type == CellType::DFlipFlop;
+}
+
+/**
+ * Count the cells that hold state
+ * @return Number of flip flops in the circuit
+ */
+int Netlist::GetNumLatches() const
+{
+    int count = 0;
+    for (const auto &cell : mCells)
+    {
+        if (IsSequential(cell.mType))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Count the cells a net depends on, through any number of gates and
+ * flip flops
+ * @param net Net to start from, such as the kick net
+ * @return Number of cells whose outputs can reach the net
+ */
+int Netlist::GetNumCellsFeeding(int net) const
+{
+    // The cell driving each net
+    std::vector<int> driver(mNumNets, -1);
+    for (int i = 0; i < (int)mCells.size(); i++)
+    {
+        for (int output : {mCells[i].mOutput, mCells[i].mOutputNot})
+        {
+            if (output >= 0 && output < mNumNets)
+            {
+                driver[output] = i;
+            }
+        }
+    }
+
+    std::vector<bool> reached(mCells.size(), false);
+    std::vector<int> pending{net};
+    int count = 0;
+    while (!pending.empty())
+    {
+        int next = pending.back();
+        pending.pop_back();
+        if (next < 0 || next >= mNumNets || driver[next] < 0 || reached[driver[next]])
+        {
+            continue;
+        }
+
+        reached[driver[next]] = true;
+        count++;
+        for (int input : mCells[driver[next]].mInputs)
+        {
+            pending.push_back(input);
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file Netlist.h
+ * @author matthew vazquez
+ *
+ * A flat description of a wired circuit, independent of the items
+ * and pins it was built from.
+ */
+
+#ifndef NETLIST_H
+#define NETLIST_H
+
+#include <string>
+#include <vector>
+
+/**
+ * A flat description of a wired circuit.
+ *
+ * Nets are numbered signals. Inputs (sensor properties and the beam)
+ * drive nets directly, every cell drives one net per output, and
+ * cell inputs refer to the net they are wired to. The kick net is
+ * the signal wired into Sparty.
+ */
+class Netlist
+{
+public:
+    /// The kinds of cells a circuit can contain
+    enum class CellType {And, Or, Not, SrFlipFlop, DFlipFlop, Xor, Nand, Nor};
+
+    /// Net number used for a pin that is not wired to anything
+    static const int Unconnected = -1;
+
+    /**
+     * A single gate in the circuit.
+     */
+    struct Cell
+    {
+        /// What kind of gate this is
+        CellType mType;
+
+        /// Net wired to each input pin, or Unconnected
+        std::vector<int> mInputs;
+
+        /// Net driven by the first output (Q for flip flops)
+        int mOutput = Unconnected;
+
+        /// Net driven by Q' for flip flops, otherwise Unconnected
+        int mOutputNot = Unconnected;
+    };
+
+private:
+    /// Name of each circuit input, indexed by net
+    std::vector<std::wstring> mInputNames;
+
+    /// All of the cells in the circuit
+    std::vector<Cell> mCells;
+
+    /// Total number of nets
+    int mNumNets = 0;
+
+    /// Net wired into Sparty
+    int mKickNet = Unconnected;
+
+public:
+    int AddInput(const std::wstring &name);
+    int AddCell(CellType type, int inputs = 2);
+    void ConnectInput(int cell, int input, int net);
+    int FindInput(const std::wstring &name) const;
+    bool IsSequential(CellType type) const;
+    int GetNumLatches() const;
+    int GetNumCellsFeeding(int net) const;
+
+    /**
+     * Set the net that is wired into Sparty
+     * @param net Net number, or Unconnected
+     */
+    void SetKickNet(int net) { mKickNet = net; }
+
+    /**
+     * Get the net that is wired into Sparty
+     * @return Net number, or Unconnected
+     */
+    int GetKickNet() const { return mKickNet; }
+
+    /**
+     * Get the total number of nets
+     * @return Number of nets
+     */
+    int GetNumNets() const { return mNumNets; }
+
+    /**
+     * Get the number of circuit inputs. Inputs always
+     * occupy the lowest net numbers.
+     * @return Number of inputs
+     */
+    int GetNumInputs() const { return (int)mInputNames.size(); }
+
+    /**
+     * Get the name of an input
+     * @param net Net driven by the input
+     * @return Input name
+     */
+    const std::wstring &GetInputName(int net) const { return mInputNames[net]; }
+
+    /**
+     * Get all of the cells
+     * @return Cells in the order they were added
+     */
+    const std::vector<Cell> &GetCells() const { return mCells; }
+};
+
+#endif //NETLIST_H
@@ -0,0 +1,302 @@
+/**
+ * @file NetlistBuilder.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "NetlistBuilder.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include "AndGate.h"
+#include "Beam.h"
+#include "BusConnector.h"
+#include "DFlipFlopGate.h"
+#include "InputPin.h"
+#include "MultiInputGate.h"
+#include "NotGate.h"
+#include "OrGate.h"
+#include "OutputPin.h"
+#include "Product.h"
+#include "Sensor.h"
+#include "SensorPanel.h"
+#include "Sparty.h"
+#include "SrFlipFlopGate.h"
+
+using namespace std;
+
+/**
+ * Is an item of the production line this builder takes?
+ * @param item Sensor, beam, Sparty or product
+ * @return True if it is taken
+ */
+bool NetlistBuilder::Takes(Item* item) const
+{
+    return mLine == nullptr || item->GetLine() == mLine;
+}
+
+/**
+ * Visit a sensor to record its property panels
+ * @param sensor Sensor we are visiting
+ */
+void NetlistBuilder::VisitSensor(Sensor* sensor)
+{
+    if (Takes(sensor))
+    {
+        mSensors.push_back(sensor);
+    }
+}
+
+/**
+ * Visit a beam to record its output pin
+ * @param beam Beam we are visiting
+ */
+void NetlistBuilder::VisitBeam(Beam* beam)
+{
+    if (Takes(beam))
+    {
+        mBeams.push_back(beam);
+    }
+}
+
+/**
+ * Visit Sparty to record his input pin
+ * @param sparty Sparty we are visiting
+ */
+void NetlistBuilder::VisitSparty(Sparty* sparty)
+{
+    if (Takes(sparty))
+    {
+        mSparty = sparty;
+    }
+}
+
+/**
+ * Visit a product to record it for the product list
+ * @param product Product we are visiting
+ */
+void NetlistBuilder::VisitProduct(Product* product)
+{
+    if (Takes(product))
+    {
+        mProducts.push_back(product);
+    }
+}
+
+/**
+ * Visit an AND gate
+ * @param gate Gate we are visiting
+ */
+void NetlistBuilder::VisitAndGate(AndGate* gate)
+{
+    mGates.push_back({Netlist::CellType::And,
+                      {gate->GetInputA(), gate->GetInputB()},
+                      {gate->GetOutput()}});
+}
+
+/**
+ * Visit an OR gate
+ * @param gate Gate we are visiting
+ */
+void NetlistBuilder::VisitOrGate(OrGate* gate)
+{
+    mGates.push_back({Netlist::CellType::Or,
+                      {gate->GetInputA(), gate->GetInputB()},
+                      {gate->GetOutput()}});
+}
+
+/**
+ * Visit a NOT gate
+ * @param gate Gate we are visiting
+ */
+void NetlistBuilder::VisitNotGate(NotGate* gate)
+{
+    mGates.push_back({Netlist::CellType::Not,
+                      {gate->GetInput()},
+                      {gate->GetOutput()}});
+}
+
+/**
+ * Visit an SR flip flop
+ * @param gate Gate we are visiting
+ */
+void NetlistBuilder::VisitSrFlipFlopGate(SrFlipFlopGate* gate)
+{
+    mGates.push_back({Netlist::CellType::SrFlipFlop,
+                      {gate->GetInputA(), gate->GetInputB()},
+                      {gate->GetOutputA(), gate->GetOutputB()}});
+}
+
+/**
+ * Visit a D flip flop
+ * @param gate Gate we are visiting
+ */
+void NetlistBuilder::VisitDFlipFlopGate(DFlipFlopGate* gate)
+{
+    mGates.push_back({Netlist::CellType::DFlipFlop,
+                      {gate->GetInputA(), gate->GetInputB()},
+                      {gate->GetOutputA(), gate->GetOutputB()}});
+}
+
+/**
+ * Visit a gate with any number of inputs. A bus-width gate is
+ * recorded once for each bit it computes.
+ * @param gate Gate we are visiting
+ */
+void NetlistBuilder::VisitMultiInputGate(MultiInputGate* gate)
+{
+    static const map<MultiInputGate::Function, Netlist::CellType> types = {
+        {MultiInputGate::Function::And, Netlist::CellType::And},
+        {MultiInputGate::Function::Or, Netlist::CellType::Or},
+        {MultiInputGate::Function::Xor, Netlist::CellType::Xor},
+        {MultiInputGate::Function::Nand, Netlist::CellType::Nand},
+        {MultiInputGate::Function::Nor, Netlist::CellType::Nor}};
+
+    GateRecord record{types.at(gate->GetFunction()), {}, {gate->GetOutput()}};
+    for (int i = 0; i < gate->GetNumInputs(); i++)
+    {
+        record.mInputs.push_back(gate->GetInputPin(i));
+    }
+
+    for (int lane = 0; lane < gate->GetBusWidth(); lane++)
+    {
+        record.mLane = lane;
+        mGates.push_back(record);
+    }
+}
+
+/**
+ * Visit a bus connector to record the bits it passes along
+ * @param connector Connector we are visiting
+ */
+void NetlistBuilder::VisitBusConnector(BusConnector* connector)
+{
+    for (int lane = 0; lane < connector->GetBusWidth(); lane++)
+    {
+        if (connector->GetKind() == BusConnector::Kind::Join)
+        {
+            mPassed[{connector->GetOutputPin(0), lane}] = {connector->GetInputPin(lane), 0};
+        }
+        else
+        {
+            mPassed[{connector->GetOutputPin(lane), 0}] = {connector->GetInputPin(0), lane};
+        }
+    }
+}
+
+/**
+ * Build the netlist from everything visited
+ * @return The wired circuit
+ */
+Netlist NetlistBuilder::BuildNetlist() const
+{
+    Netlist netlist;
+    map<Bit<OutputPin>, int> nets;
+
+    // Sensor panels. A panel whose property the sensor does not
+    // understand never drives its pin, so it stays unconnected.
+    for (auto sensor : mSensors)
+    {
+        for (const auto& panel : sensor->GetSensorPanels())
+        {
+            auto property = Product::NamesToProperties.find(panel->GetProperty());
+            if (property != Product::NamesToProperties.end() && property->second != Product::Properties::None)
+            {
+                nets[{panel->GetOutputPin(), 0}] = netlist.AddInput(panel->GetProperty());
+            }
+        }
+    }
+
+    for (auto beam : mBeams)
+    {
+        nets[{beam->GetOutputPin(), 0}] = netlist.AddInput(CircuitVerifier::BeamInput);
+    }
+
+    // Create every cell first so wires can refer forward
+    vector<int> cells;
+    for (const auto& gate : mGates)
+    {
+        int cell = netlist.AddCell(gate.mType, (int)gate.mInputs.size());
+        cells.push_back(cell);
+
+        const auto& added = netlist.GetCells()[cell];
+        nets[{gate.mOutputs[0], gate.mLane}] = added.mOutput;
+        if (gate.mOutputs.size() > 1)
+        {
+            nets[{gate.mOutputs[1], gate.mLane}] = added.mOutputNot;
+        }
+    }
+
+    // A bit is followed back through bus connectors to the input or
+    // cell that drives it. Connectors wired only to each other drive
+    // nothing, so the walk gives up once it has passed them all.
+    function<int(InputPin*, int, size_t)> netFor = [&](InputPin* pin, int lane, size_t passed) -> int {
+        if (pin == nullptr || pin->GetLine() == nullptr)
+        {
+            return Netlist::Unconnected;
+        }
+
+        Bit<OutputPin> bit(pin->GetLine(), lane);
+        auto found = nets.find(bit);
+        if (found != nets.end())
+        {
+            return found->second;
+        }
+
+        auto through = mPassed.find(bit);
+        if (through == mPassed.end() || passed >= mPassed.size())
+        {
+            return Netlist::Unconnected;
+        }
+        return netFor(through->second.first, through->second.second, passed + 1);
+    };
+
+    for (size_t g = 0; g < mGates.size(); g++)
+    {
+        for (size_t i = 0; i < mGates[g].mInputs.size(); i++)
+        {
+            netlist.ConnectInput(cells[g], (int)i, netFor(mGates[g].mInputs[i], mGates[g].mLane, 0));
+        }
+    }
+
+    if (mSparty != nullptr)
+    {
+        netlist.SetKickNet(netFor(mSparty->GetInputPin(), 0, 0));
+    }
+
+    return netlist;
+}
+
+/**
+ * Build the product list in the order products reach the sensor
+ * @return Product specifications
+ */
+vector<CircuitVerifier::ProductSpec> NetlistBuilder::BuildProducts() const
+{
+    // The conveyor moves products down the screen, so the
+    // product placed lowest reaches the sensor first
+    auto ordered = mProducts;
+    stable_sort(ordered.begin(), ordered.end(), [](Product* a, Product* b) {
+        return a->GetInitialPlacementY() > b->GetInitialPlacementY();
+    });
+
+    vector<CircuitVerifier::ProductSpec> specs;
+    for (auto product : ordered)
+    {
+        CircuitVerifier::ProductSpec spec;
+        spec.mKick = product->GetKick();
+        for (auto property : product->GetProperties())
+        {
+            for (const auto& name : Product::NamesToProperties)
+            {
+                if (name.second == property && property != Product::Properties::None)
+                {
+                    spec.mProperties.push_back(name.first);
+                }
+            }
+        }
+        specs.push_back(spec);
+    }
+
+    return specs;
+}
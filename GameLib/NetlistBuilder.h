@@ -0,0 +1,109 @@
+/**
+ * @file NetlistBuilder.h
+ * @author matthew vazquez
+ *
+ * Visitor that extracts the wired circuit and product list from a game.
+ */
+
+#ifndef NETLISTBUILDER_H
+#define NETLISTBUILDER_H
+
+#include <map>
+#include <utility>
+#include <vector>
+#include "ItemVisitor.h"
+#include "Netlist.h"
+#include "CircuitVerifier.h"
+
+class InputPin;
+class Item;
+class OutputPin;
+class ProductionLine;
+
+/**
+ * Visitor that extracts the wired circuit and product list from a game.
+ *
+ * Accept this visitor on a Game, then call BuildNetlist and
+ * BuildProducts. Sensor panels and the beam become circuit inputs,
+ * gates become cells and the wire into Sparty becomes the kick net.
+ * A bus-width gate becomes one cell per bit, and bus connectors add
+ * no cells: each bit is followed through them to what drives it.
+ *
+ * A level with several production lines has a circuit per line. A
+ * builder given a line takes only that line's sensors, beam, Sparty
+ * and products, along with every gate, since gates belong to no line.
+ */
+class NetlistBuilder : public ItemVisitor
+{
+private:
+    /**
+     * A gate found while visiting
+     */
+    struct GateRecord
+    {
+        /// Kind of cell this gate becomes
+        Netlist::CellType mType;
+
+        /// Input pins in cell input order
+        std::vector<InputPin*> mInputs;
+
+        /// Output pins in cell output order
+        std::vector<OutputPin*> mOutputs;
+
+        /// Bit of the pins this cell computes, 0 unless they are buses
+        int mLane = 0;
+    };
+
+    /// A pin and one of the bits it carries, 0 for a single wire
+    template <class Pin>
+    using Bit = std::pair<Pin*, int>;
+
+    /// Sensors found
+    std::vector<Sensor*> mSensors;
+
+    /// Beams found
+    std::vector<Beam*> mBeams;
+
+    /// Sparty, if found
+    Sparty* mSparty = nullptr;
+
+    /// Products found
+    std::vector<Product*> mProducts;
+
+    /// Gates found
+    std::vector<GateRecord> mGates;
+
+    /// Production line whose items are taken, nullptr for every item
+    ProductionLine* mLine = nullptr;
+
+    /// Bits bus connectors pass along: the output bit and the input bit it copies
+    std::map<Bit<OutputPin>, Bit<InputPin>> mPassed;
+
+    bool Takes(Item* item) const;
+
+public:
+    NetlistBuilder() = default;
+
+    /**
+     * Constructor
+     * @param line Production line whose sensors, beam, Sparty and products are taken
+     */
+    explicit NetlistBuilder(ProductionLine* line) : mLine(line) {}
+
+    void VisitSensor(Sensor* sensor) override;
+    void VisitBeam(Beam* beam) override;
+    void VisitSparty(Sparty* sparty) override;
+    void VisitProduct(Product* product) override;
+    void VisitAndGate(AndGate* gate) override;
+    void VisitOrGate(OrGate* gate) override;
+    void VisitNotGate(NotGate* gate) override;
+    void VisitSrFlipFlopGate(SrFlipFlopGate* gate) override;
+    void VisitDFlipFlopGate(DFlipFlopGate* gate) override;
+    void VisitMultiInputGate(MultiInputGate* gate) override;
+    void VisitBusConnector(BusConnector* connector) override;
+
+    Netlist BuildNetlist() const;
+    std::vector<CircuitVerifier::ProductSpec> BuildProducts() const;
+};
+
+#endif //NETLISTBUILDER_H
@@ -27,27 +27,26 @@ NotGate::NotGate(Game *game) : Gates(game)
     auto x = GetX();
     auto y = GetY();
     auto w = NotGateSize.GetWidth();
-    auto h = NotGateSize.GetHeight();
 
     wxPoint pointA(x - w/2,y);
     wxPoint pointB(x + w/2,y);
 
-    mInput = std::make_shared<InputPin>(this, pointA);
-    mOutput = std::make_shared<OutputPin>(this, pointB);
+    mInput = CreatePart<InputPin>(this, pointA);
+    mOutput = CreatePart<OutputPin>(this, pointB);
 
 
-    mInput->SetState(States::Unknown);
-    mOutput->SetState(States::Unknown);
+    Get(mInput)->SetState(States::Unknown);
+    Get(mOutput)->SetState(States::Unknown);
 }
 
 /**
  * Computes the output using inputs and or gate logic
  */
 void NotGate::ComputeOutput() {
-    if (mInput->GetState() == States::Unknown) {
-        mOutput->SetState(States::Unknown);
+    if (Get(mInput)->GetState() == States::Unknown) {
+        Get(mOutput)->SetState(States::Unknown);
     } else {
-        mOutput->SetState((mInput->GetState() == States::One) ? States::Zero : States::One);
+        Get(mOutput)->SetState((Get(mInput)->GetState() == States::One) ? States::Zero : States::One);
     }
 }
 
@@ -55,12 +54,12 @@ void NotGate::ComputeOutput() {
  * Draws or gate
  * @param graphics Graphics context to draw on
  */
-void NotGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
+void NotGate::Draw(wxGraphicsContext *graphics) {
     // Create a path to draw the gate shape
 
 
-    mInput->Draw(graphics);
-    mOutput->Draw(graphics);
+    Get(mInput)->Draw(graphics);
+    Get(mOutput)->Draw(graphics);
 
     auto path = graphics->CreatePath();
 
@@ -97,7 +96,7 @@ void NotGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
  */
 void NotGate::Update(double elapsed)
 {
-    mOutput->Update();
+    Get(mOutput)->Update();
     ComputeOutput(); // Recompute the output on each update
 }
 
@@ -135,11 +134,11 @@ double NotGate::getHeight()
  * @param y Y location clicked on
  * @return Whatever we clicked on or NULL if none
  */
-std::shared_ptr<IDraggable> NotGate::HitDraggable(int x, int y)
+IDraggable *NotGate::HitDraggable(int x, int y)
 {
-    if(mOutput->HitTest(x, y))
+    if(Get(mOutput)->HitTest(x, y))
     {
-        return mOutput;
+        return Get(mOutput);
     }
 
     return nullptr;
@@ -154,5 +153,27 @@ std::shared_ptr<IDraggable> NotGate::HitDraggable(int x, int y)
  */
 bool NotGate::Connect(OutputPin *pin, wxPoint lineEnd)
 {
-    return mInput->Catch(pin, lineEnd);
-}
\ No newline at end of file
+    return Get(mInput)->Catch(pin, lineEnd);
+}
+
+/**
+ * Save the gate's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void NotGate::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Gates::SaveSnapshot(snapshot);
+    Get(mInput)->SaveSnapshot(snapshot);
+    Get(mOutput)->SaveSnapshot(snapshot);
+}
+
+/**
+ * Restore the gate's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void NotGate::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Gates::RestoreSnapshot(snapshot);
+    Get(mInput)->RestoreSnapshot(snapshot);
+    Get(mOutput)->RestoreSnapshot(snapshot);
+}
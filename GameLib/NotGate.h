@@ -17,12 +17,12 @@ class OutputPin;
 /**
  * Class for or gate
  */
-class NotGate : public Gates {
+class NotGate final : public Gates {
 private:
     /// InputPin
-    std::shared_ptr<InputPin> mInput;
+    ArenaHandle<InputPin> mInput;
     /// OutputPin
-    std::shared_ptr<OutputPin> mOutput;
+    ArenaHandle<OutputPin> mOutput;
 public:
     /**
      * Constructor for or gate
@@ -31,16 +31,50 @@ public:
     NotGate(Game *game);
 
     void ComputeOutput();
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Draw(wxGraphicsContext *graphics) override;
     void OnClick(double x, double y) override;
     void Update(double elapsed) override;
+    void SaveSnapshot(GameSnapshot &snapshot) const override;
+    void RestoreSnapshot(GameSnapshot &snapshot) override;
 
     double getWidth() override;
     double getHeight() override;
 
-    std::shared_ptr<IDraggable> HitDraggable(int x, int y) override;
+    IDraggable *HitDraggable(int x, int y) override;
 
     bool Connect(OutputPin *pin, wxPoint lineEnd) override;
+
+    /**
+     * Accept a visitor
+     * @param visitor The visitor we accept
+     */
+    void Accept(ItemVisitor* visitor) override { visitor->VisitNotGate(this); }
+
+    /**
+     * Get the input pin
+     * @return The pin
+     */
+    InputPin *GetInput() const { return Get(mInput); }
+
+    /**
+     * Get the output pin
+     * @return The pin
+     */
+    OutputPin *GetOutput() const { return Get(mOutput); }
+
+    /**
+     * Get an input pin by position
+     * @param index Pin index, from the top
+     * @return The pin, or nullptr
+     */
+    InputPin *GetInputPin(int index) const override { return index == 0 ? Get(mInput) : nullptr; }
+
+    /**
+     * Get an output pin by position
+     * @param index Pin index, from the top
+     * @return The pin, or nullptr
+     */
+    OutputPin *GetOutputPin(int index) const override { return index == 0 ? Get(mOutput) : nullptr; }
 };
 
 
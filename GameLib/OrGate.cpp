@@ -30,13 +30,13 @@ OrGate::OrGate(Game *game) : Gates(game)
     wxPoint pointB(x - w/3,y + h/4);
     wxPoint pointC(x + w/2,y);
 
-    mInputA = std::make_shared<InputPin>(this, pointA);
-    mInputB = std::make_shared<InputPin>(this, pointB);
-    mOutput = std::make_shared<OutputPin>(this, pointC);
+    mInputA = CreatePart<InputPin>(this, pointA);
+    mInputB = CreatePart<InputPin>(this, pointB);
+    mOutput = CreatePart<OutputPin>(this, pointC);
 
-    mInputA->SetState(States::Unknown);
-    mInputB->SetState(States::Unknown);
-    mOutput->SetState(States::Unknown);
+    Get(mInputA)->SetState(States::Unknown);
+    Get(mInputB)->SetState(States::Unknown);
+    Get(mOutput)->SetState(States::Unknown);
 
 
 
@@ -46,10 +46,10 @@ OrGate::OrGate(Game *game) : Gates(game)
  * Computes the output using inputs and or gate logic
  */
 void OrGate::ComputeOutput() {
-    if (mInputA->GetState() == States::Unknown || mInputB->GetState() == States::Unknown) {
-        mOutput->SetState(States::Unknown);
+    if (Get(mInputA)->GetState() == States::Unknown || Get(mInputB)->GetState() == States::Unknown) {
+        Get(mOutput)->SetState(States::Unknown);
     } else {
-        mOutput->SetState((mInputA->GetState() == States::One || mInputB->GetState() == States::One) ? States::One : States::Zero);
+        Get(mOutput)->SetState((Get(mInputA)->GetState() == States::One || Get(mInputB)->GetState() == States::One) ? States::One : States::Zero);
     }
 }
 
@@ -57,16 +57,16 @@ void OrGate::ComputeOutput() {
  * Draws or gate
  * @param graphics Graphics context to draw on
  */
-void OrGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
+void OrGate::Draw(wxGraphicsContext *graphics) {
     if (!graphics) return;
 
     // Create a path to draw the gate shape
     auto path = graphics->CreatePath();
 
 
-    mInputA->Draw(graphics);
-    mInputB->Draw(graphics);
-    mOutput->Draw(graphics);
+    Get(mInputA)->Draw(graphics);
+    Get(mInputB)->Draw(graphics);
+    Get(mOutput)->Draw(graphics);
 
     // The location and size
     auto x = GetX();
@@ -103,7 +103,7 @@ void OrGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
  */
 void OrGate::Update(double elapsed)
 {
-    mOutput->Update();
+    Get(mOutput)->Update();
     ComputeOutput(); // Recompute the output on each update
 }
 
@@ -141,11 +141,11 @@ double OrGate::getHeight()
  * @param y Y location clicked on
  * @return Whatever we clicked on or NULL if none
  */
-std::shared_ptr<IDraggable> OrGate::HitDraggable(int x, int y)
+IDraggable *OrGate::HitDraggable(int x, int y)
 {
-    if(mOutput->HitTest(x, y))
+    if(Get(mOutput)->HitTest(x, y))
     {
-        return mOutput;
+        return Get(mOutput);
     }
 
     return nullptr;
@@ -160,5 +160,29 @@ std::shared_ptr<IDraggable> OrGate::HitDraggable(int x, int y)
  */
 bool OrGate::Connect(OutputPin *pin, wxPoint lineEnd)
 {
-    return mInputA->Catch(pin, lineEnd) || mInputB->Catch(pin, lineEnd);
-}
\ No newline at end of file
+    return Get(mInputA)->Catch(pin, lineEnd) || Get(mInputB)->Catch(pin, lineEnd);
+}
+
+/**
+ * Save the gate's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void OrGate::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Gates::SaveSnapshot(snapshot);
+    Get(mInputA)->SaveSnapshot(snapshot);
+    Get(mInputB)->SaveSnapshot(snapshot);
+    Get(mOutput)->SaveSnapshot(snapshot);
+}
+
+/**
+ * Restore the gate's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void OrGate::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Gates::RestoreSnapshot(snapshot);
+    Get(mInputA)->RestoreSnapshot(snapshot);
+    Get(mInputB)->RestoreSnapshot(snapshot);
+    Get(mOutput)->RestoreSnapshot(snapshot);
+}
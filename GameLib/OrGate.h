@@ -13,15 +13,15 @@ class OutputPin;
 /**
  * Class for or gate
  */
-class OrGate : public Gates {
+class OrGate final : public Gates {
 private:
 
     /// InputPin A
-    std::shared_ptr<InputPin> mInputA;
+    ArenaHandle<InputPin> mInputA;
     /// InputPin B
-    std::shared_ptr<InputPin> mInputB;
+    ArenaHandle<InputPin> mInputB;
     /// OutputPin
-    std::shared_ptr<OutputPin> mOutput;
+    ArenaHandle<OutputPin> mOutput;
 public:
     /**
      * Constructor for or gate
@@ -30,17 +30,57 @@ public:
     OrGate(Game *game);
 
     void ComputeOutput();
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Draw(wxGraphicsContext *graphics) override;
     void OnClick(double x, double y) override;
     void Update(double elapsed) override;
+    void SaveSnapshot(GameSnapshot &snapshot) const override;
+    void RestoreSnapshot(GameSnapshot &snapshot) override;
 
 
     double getWidth() override;
     double getHeight() override;
 
-    std::shared_ptr<IDraggable> HitDraggable(int x, int y) override;
+    IDraggable *HitDraggable(int x, int y) override;
 
     bool Connect(OutputPin *pin, wxPoint lineEnd) override;
+
+    /**
+     * Accept a visitor
+     * @param visitor The visitor we accept
+     */
+    void Accept(ItemVisitor* visitor) override { visitor->VisitOrGate(this); }
+
+    /**
+     * Get input pin A
+     * @return The pin
+     */
+    InputPin *GetInputA() const { return Get(mInputA); }
+
+    /**
+     * Get input pin B
+     * @return The pin
+     */
+    InputPin *GetInputB() const { return Get(mInputB); }
+
+    /**
+     * Get the output pin
+     * @return The pin
+     */
+    OutputPin *GetOutput() const { return Get(mOutput); }
+
+    /**
+     * Get an input pin by position
+     * @param index Pin index, from the top
+     * @return The pin, or nullptr
+     */
+    InputPin *GetInputPin(int index) const override { return index == 0 ? Get(mInputA) : index == 1 ? Get(mInputB) : nullptr; }
+
+    /**
+     * Get an output pin by position
+     * @param index Pin index, from the top
+     * @return The pin, or nullptr
+     */
+    OutputPin *GetOutputPin(int index) const override { return index == 0 ? Get(mOutput) : nullptr; }
 };
 
 #endif // ORGATE_H
\ No newline at end of file
@@ -37,7 +37,7 @@ OutputPin::OutputPin(Item *owner, wxPoint location) : mOwner(owner), mLocation(l
  * Draws Output pin
  * @param graphics Graphics context to draw on
  */
-void OutputPin::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void OutputPin::Draw(wxGraphicsContext *graphics)
 {
  wxColour connectionColor; // Declare connectionColor here
 
@@ -64,7 +64,8 @@ void OutputPin::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  wxGraphicsPath path2 = graphics->CreatePath();
  path2.MoveToPoint(loc.x - DefaultLineLength - PinSize/2,loc.y);
  path2.AddLineToPoint(loc.x - PinSize/2,loc.y);
- graphics->SetPen(wxPen(connectionColor, LineWidth));
+ auto lineWidth = mBusWidth > 1 ? BusLineWidth : LineWidth;
+ graphics->SetPen(wxPen(connectionColor, lineWidth));
  path2.CloseSubpath();
 
  graphics->DrawPath(path2);
@@ -76,7 +77,7 @@ void OutputPin::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  path.CloseSubpath();
  graphics->DrawPath(path);
 
- graphics->SetPen(wxPen(connectionColor, LineWidth));
+ graphics->SetPen(wxPen(connectionColor, lineWidth));
  graphics->SetBrush(wxBrush());
  if (mDragging)
  {
@@ -190,19 +191,47 @@ void OutputPin::Release()
 }
 
 /**
- * Sets the InputPin connection to the list
+ * Sets the state of each bit of a bus pin. The pin's state becomes
+ * One if any bit is One and Zero if every bit is Zero, so the bus is
+ * drawn the way a wire is.
+ * @param bus Bit i in lane i; lanes past the bus width are ignored
+ */
+void OutputPin::SetBus(LogicWord bus)
+{
+ auto lanes = LogicWord::Mask(mBusWidth);
+ mBus.mOne = bus.mOne & lanes;
+ mBus.mZero = bus.mZero & lanes;
+
+ if (mBus.mOne != 0)
+ {
+  mState = States::One;
+ }
+ else if (mBus.mZero == lanes)
+ {
+  mState = States::Zero;
+ }
+ else
+ {
+  mState = States::Unknown;
+ }
+}
+
+/**
+ * Sets the InputPin connection to the list. A pin that carries a
+ * different number of bits is not connected.
  * @param connected InputPin that needs to be connected
  */
 void OutputPin::SetConnection(InputPin* connected)
 {
  // Add connected pin to the vector
- if (connected != nullptr)
+ if (connected != nullptr && connected->GetBusWidth() == mBusWidth)
  {
   // Avoid duplicates
   if (std::find(mConnected.begin(), mConnected.end(), connected) == mConnected.end())
   {
    mConnected.push_back(connected);
    connected->SetLine(this); // Assuming SetLine sets a reference back to this OutputPin
+   WiresChanged();
   }
  }
 }
@@ -221,14 +250,65 @@ void OutputPin::Release(InputPin* connected)
   {
    // Remove the pin from the vector
    mConnected.erase(it); // Erase it from the vector
+   WiresChanged();
   }
  }
 }
 
+/**
+ * Tell the game a wire from this pin was connected or removed
+ */
+void OutputPin::WiresChanged()
+{
+ if (mOwner != nullptr && mOwner->GetGame() != nullptr)
+ {
+  mOwner->GetGame()->InvalidateWires();
+ }
+}
+
 void OutputPin::Update()
 {
  for (InputPin* pin : mConnected)
  {
   pin->SetState(mState);
+  pin->SetBus(mBus);
+ }
+}
+
+/**
+ * Save the pin's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void OutputPin::SaveSnapshot(GameSnapshot &snapshot) const
+{
+ snapshot.Write(mLocation);
+ snapshot.Write(mState);
+ snapshot.Write(mBus);
+ snapshot.Write(mLineEnd);
+ snapshot.Write(mDragging);
+ snapshot.Write(mConnected.size());
+ for (auto pin : mConnected)
+ {
+  snapshot.Write(pin);
+ }
+}
+
+/**
+ * Restore the pin's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void OutputPin::RestoreSnapshot(GameSnapshot &snapshot)
+{
+ snapshot.Read(mLocation);
+ snapshot.Read(mState);
+ snapshot.Read(mBus);
+ snapshot.Read(mLineEnd);
+ snapshot.Read(mDragging);
+ size_t connected = 0;
+ snapshot.Read(connected);
+ mConnected.resize(connected);
+ for (auto &pin : mConnected)
+ {
+  snapshot.Read(pin);
  }
 }
@@ -8,10 +8,11 @@
 #ifndef OUTPUTPIN_H
 #define OUTPUTPIN_H
 #include "IDraggable.h"
+#include "GateLogic.h"
 
 class Item;
+class GameSnapshot;
 class InputPin;
-enum class States;
 
 /**
  * Class for Output pin
@@ -26,6 +27,12 @@ private:
  /// State of pin
  States mState;
 
+ /// Number of bits the pin carries, 1 for a single wire
+ int mBusWidth = 1;
+
+ /// State of each bit of a bus pin, bit i in lane i
+ LogicWord mBus;
+
  /// Location of the line end when dragging
  wxPoint mLineEnd;
 
@@ -41,13 +48,18 @@ private:
  /// Line with for drawing lines between pins
  static const int LineWidth = 3;
 
+ /// Line width for drawing bus lines
+ static const int BusLineWidth = 7;
+
  /// Default length of line from the pin
  int DefaultLineLength = 20;
 
+ void WiresChanged();
+
 public:
  OutputPin(Item *owner, wxPoint location);
  void SetLocation(double x, double y) override;
- void Draw(std::shared_ptr<wxGraphicsContext> graphics);
+ void Draw(wxGraphicsContext *graphics);
  wxPoint GetAbsoluteLocation();
 
  /**
@@ -62,8 +74,31 @@ public:
   */
  States GetState() {return mState;}
 
+ /**
+  * Make the pin carry a bus, or a single wire with width 1
+  * @param width Number of bits
+  */
+ void SetBusWidth(int width) {mBusWidth = width;}
+
+ /**
+  * Gets the number of bits the pin carries
+  * @return 1 for a single wire, more for a bus
+  */
+ int GetBusWidth() const {return mBusWidth;}
+
+ void SetBus(LogicWord bus);
+
+ /**
+  * Gets the state of each bit of a bus pin
+  * @return Bit i in lane i
+  */
+ LogicWord GetBus() const {return mBus;}
+
  bool HitTest(int x, int y);
 
+ void SaveSnapshot(GameSnapshot &snapshot) const;
+ void RestoreSnapshot(GameSnapshot &snapshot);
+
  /**
   * Sees if item was clicked
   * @param x X location of click
@@ -0,0 +1,138 @@
+/**
+ * @file PinFinder.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "PinFinder.h"
+#include "Beam.h"
+#include "Game.h"
+#include "Gates.h"
+#include "InputPin.h"
+#include "OutputPin.h"
+#include "ProductionLine.h"
+#include "Sensor.h"
+#include "SensorPanel.h"
+#include "Sparty.h"
+
+/**
+ * Constructor
+ * @param endpoint Endpoint as written in the level file
+ */
+PinFinder::PinFinder(const std::wstring& endpoint)
+{
+    auto dot = endpoint.find(L'.');
+    mItem = endpoint.substr(0, dot);
+    if (dot != std::wstring::npos)
+    {
+        mPin = endpoint.substr(dot + 1);
+    }
+
+    // line<n>. in front of a sensor, beam or Sparty endpoint
+    long line = 0;
+    if (mItem.compare(0, 4, L"line") == 0 && mItem.size() > 4 &&
+        mItem.find_first_not_of(L"0123456789", 4) == std::wstring::npos &&
+        wxString(mItem.substr(4)).ToLong(&line) && line >= 1)
+    {
+        PinFinder rest(mPin);
+        if (rest.mItem == L"sensor" || rest.mItem == L"beam" || rest.mItem == L"sparty")
+        {
+            mItem = rest.mItem;
+            mPin = rest.mPin;
+            mLine = (int)line - 1;
+        }
+    }
+}
+
+/**
+ * Look for the endpoint's pin in a game. Sensor, beam and Sparty
+ * endpoints are looked for among their production line's items only.
+ * @param game Game to look in
+ */
+void PinFinder::Find(Game* game)
+{
+    bool lineItem = mItem == L"sensor" || mItem == L"beam" || mItem == L"sparty";
+    if (!lineItem || game->GetNumLines() == 0)
+    {
+        game->Accept(this);
+    }
+    else if (mLine < game->GetNumLines())
+    {
+        game->GetLine(mLine)->AcceptAll(this);
+    }
+}
+
+/**
+ * Get the pin number part of a gate endpoint
+ * @return Pin number, 0 if none is given, -1 if it is not a number
+ */
+int PinFinder::PinIndex() const
+{
+    if (mPin.empty())
+    {
+        return 0;
+    }
+
+    long index = 0;
+    return wxString(mPin).ToLong(&index) ? (int)index : -1;
+}
+
+/**
+ * Visit a sensor to find one of its panels
+ * @param sensor Sensor we are visiting
+ */
+void PinFinder::VisitSensor(Sensor* sensor)
+{
+    if (mItem != L"sensor")
+    {
+        return;
+    }
+
+    for (const auto& panel : sensor->GetSensorPanels())
+    {
+        if (panel->GetProperty() == mPin)
+        {
+            mOutput = panel->GetOutputPin();
+        }
+    }
+}
+
+/**
+ * Visit the beam to find its output
+ * @param beam Beam we are visiting
+ */
+void PinFinder::VisitBeam(Beam* beam)
+{
+    if (mItem == L"beam")
+    {
+        mOutput = beam->GetOutputPin();
+    }
+}
+
+/**
+ * Visit Sparty to find his input
+ * @param sparty Sparty we are visiting
+ */
+void PinFinder::VisitSparty(Sparty* sparty)
+{
+    if (mItem == L"sparty")
+    {
+        mInput = sparty->GetInputPin();
+    }
+}
+
+/**
+ * Visit a gate to find one of its pins
+ * @param gate Gate we are visiting
+ */
+void PinFinder::VisitGates(Gates* gate)
+{
+    if (gate->GetId().empty() || gate->GetId() != mItem)
+    {
+        return;
+    }
+
+    int index = PinIndex();
+    mOutput = gate->GetOutputPin(index);
+    mInput = gate->GetInputPin(index);
+}
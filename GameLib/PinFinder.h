@@ -0,0 +1,71 @@
+/**
+ * @file PinFinder.h
+ * @author matthew vazquez
+ *
+ * Visitor that finds the pin a wire endpoint in a level file names.
+ */
+
+#ifndef PINFINDER_H
+#define PINFINDER_H
+
+#include <string>
+#include "ItemVisitor.h"
+
+class Game;
+class InputPin;
+class OutputPin;
+
+/**
+ * Visitor that finds the pin a wire endpoint in a level file names.
+ *
+ * Endpoints are written as sensor.<property> for a sensor panel,
+ * beam for the beam, sparty for Sparty's input, and <id> or
+ * <id>.<pin> for a gate, where pins are numbered from the top
+ * starting at 0. A sensor, beam or Sparty endpoint can name its
+ * production line as line<n>.beam, with lines counted from 1;
+ * without one it names the first line's.
+ */
+class PinFinder : public ItemVisitor
+{
+private:
+    /// Item part of the endpoint
+    std::wstring mItem;
+
+    /// Sensor property or pin number part of the endpoint
+    std::wstring mPin;
+
+    /// Production line of a sensor, beam or Sparty endpoint, from 0
+    int mLine = 0;
+
+    /// Output pin found
+    OutputPin* mOutput = nullptr;
+
+    /// Input pin found
+    InputPin* mInput = nullptr;
+
+    int PinIndex() const;
+
+public:
+    PinFinder(const std::wstring& endpoint);
+
+    void Find(Game* game);
+
+    void VisitSensor(Sensor* sensor) override;
+    void VisitBeam(Beam* beam) override;
+    void VisitSparty(Sparty* sparty) override;
+    void VisitGates(Gates* gate) override;
+
+    /**
+     * Get the output pin the endpoint names
+     * @return Pin, or nullptr if not found
+     */
+    OutputPin* GetOutputPin() const { return mOutput; }
+
+    /**
+     * Get the input pin the endpoint names
+     * @return Pin, or nullptr if not found
+     */
+    InputPin* GetInputPin() const { return mInput; }
+};
+
+#endif //PINFINDER_H
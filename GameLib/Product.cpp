@@ -8,6 +8,9 @@
 #include "Product.h"
 #include "Game.h"
 #include "Conveyor.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
+#include "XmlPullParser.h"
 
 using namespace std;
 
@@ -48,15 +51,6 @@ const std::map<Product::Properties, std::wstring> Product::PropertiesToContentIm
     {Product::Properties::Basketball, L"basketball.png"}
 };
 
-/// Default product size in pixels.
-std::wstring ProductDefaultSize = L"80";
-
-/// Default product size as double.
-const double ProductDefaultSizeDouble = 80.0;
-
-/// Size to draw content relative to the product size
-double ContentScale = 0.8;
-
 /**
  * @return Color to use for "red"
  */
@@ -102,9 +96,10 @@ Product::Product(Game* game, const std::wstring& filename) : Item(game, filename
  * Draw the product on the conveyor
  * @param graphics graphics contezt where to draw on
  */
-void Product::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Product::Draw(wxGraphicsContext *graphics)
 {
-    if (!graphics)
+    // Products outside the playfield would only be clipped
+    if (!graphics || mParked || !IsOnPlayfield())
         return;
 
 
@@ -112,7 +107,7 @@ void Product::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 
     graphics->Translate(GetX(), GetY());
 
-    double size = std::stod(ProductDefaultSize);
+    double size = GetSize();
     wxBrush brush;
     wxPen pen(*wxBLACK, 2);
     for (auto prop : mProperties)
@@ -175,15 +170,11 @@ void Product::Draw(std::shared_ptr<wxGraphicsContext> graphics)
     {
         if (PropertiesToTypes.at(prop) == Types::Content && prop != Properties::None)
         {
-            wxString filename = PropertiesToContentImages.at(prop);
-            wxImage img(L"images/" + filename, wxBITMAP_TYPE_ANY);
-            if (img.IsOk())
-            {
-                int dim = wxRound(size * ContentScale);
-                img.Rescale(dim, dim);
-                wxBitmap bmp(img);
-                graphics->DrawBitmap(bmp, wxDouble(-dim/2), wxDouble(-dim/2), wxDouble(dim), wxDouble(dim));
-            }
+            auto atlas = GetGame()->GetAtlas();
+            auto sprites = GetGame()->GetSprites();
+            int sprite = atlas->Find(PropertiesToContentImages.at(prop));
+            int dim = wxRound(size * GetGame()->GetConfig().mContentScale);
+            sprites->Draw(graphics, sprite, wxDouble(-dim/2), wxDouble(-dim/2), wxDouble(dim), wxDouble(dim));
             break;
         }
     }
@@ -201,7 +192,10 @@ void Product::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  */
 bool Product::HitTest(double x, double y)
 {
-    double size = ProductDefaultSizeDouble;  // Using the default size
+    if (mParked)
+        return false;
+
+    double size = GetSize();
     double halfSize = size / 2;
 
     // Calculate the relative position of the test point to the product's location
@@ -214,33 +208,63 @@ bool Product::HitTest(double x, double y)
 
 
 /**
- * Loads the product from xml into program
- * @param node xml node we are loading from
+ * Load the product from a level being read
+ * @param parser Parser on the product's start element
  */
-void Product::XmlLoad(wxXmlNode* node)
+void Product::XmlLoad(XmlPullParser &parser)
 {
-    mKick = (node->GetAttribute(L"kick", L"no") == L"yes");
-
-    wxString shape = node->GetAttribute(L"shape", L"");
-    wxString color = node->GetAttribute(L"color", L"");
-    wxString content = node->GetAttribute(L"content", L"");
-
-    if (!shape.empty() && NamesToProperties.find(shape.ToStdWstring()) != NamesToProperties.end())
-        mProperties.push_back(NamesToProperties.at(shape.ToStdWstring()));
-    if (!color.empty() && NamesToProperties.find(color.ToStdWstring()) != NamesToProperties.end())
-        mProperties.push_back(NamesToProperties.at(color.ToStdWstring()));
-    if (!content.empty() && NamesToProperties.find(content.ToStdWstring()) != NamesToProperties.end())
-        mProperties.push_back(NamesToProperties.at(content.ToStdWstring()));
+    mKick = parser.GetAttribute("kick", "no") == "yes";
+
+    auto properties = XmlProperties(parser);
+    mProperties.insert(mProperties.end(), properties.begin(), properties.end());
 }
 
+/**
+ * Read the shape, color and content of a product element being read
+ * @param parser Parser on the product's start element
+ * @return Properties named by the element, shape first
+ */
+std::vector<Product::Properties> Product::XmlProperties(XmlPullParser &parser)
+{
+    std::vector<Properties> properties;
+
+    Properties property;
+    for (auto attribute : {"shape", "color", "content"})
+    {
+        if (PropertyFromName(parser.GetAttribute(attribute), property))
+        {
+            properties.push_back(property);
+        }
+    }
+
+    return properties;
+}
 
 /**
- * Updating the currents tate of the product
- * @param elapsed how much time has passed since previous update
+ * Look up a property by the name level files use for it, without
+ * converting the name to a wide string
+ * @param name UTF-8 property name, such as red
+ * @param property Receives the property
+ * @return True if the name is a property
  */
-void Product::Update(double elapsed)
+bool Product::PropertyFromName(std::string_view name, Properties &property)
 {
-    SetLocation(GetX() - mKickSpeed * elapsed, GetY());
+    static const auto names = []() {
+        std::map<std::string, Properties, std::less<>> names;
+        for (const auto &entry : NamesToProperties)
+        {
+            names.emplace(wxString(entry.first).utf8_string(), entry.second);
+        }
+        return names;
+    }();
+
+    auto found = names.find(name);
+    if (name.empty() || found == names.end())
+    {
+        return false;
+    }
+    property = found->second;
+    return true;
 }
 
 
@@ -252,6 +276,7 @@ void Product::Reset()
     SetLocation(mInitialPlacementX, mInitialPlacementY);
     mWasKicked = false;
     mKickSpeed = 0;
+    SetRetired(false);
 }
 
 
@@ -270,11 +295,11 @@ void Product::OnClick(double x, double y)
 /**
  * You get the sizeo of the prodcut here
  *
- * @return It returns the deafult size of the product
+ * @return The product size set in the game's configuration
  */
 double Product::GetSize() const
 {
-    return ProductDefaultSizeDouble;
+    return GetGame()->GetConfig().mProductSize;
 }
 
 void Product::SetInitalPosition(double x, double y)
@@ -285,7 +310,7 @@ void Product::SetInitalPosition(double x, double y)
 
 void Product::MovePosition(double x, double y)
 {
-    if (mKickSpeed == 0)
+    if (mKickSpeed == 0 && !mParked)
     {
         SetLocation(GetX() + x, GetY() + y);
     }
@@ -305,12 +330,100 @@ void Product::Kick(double kick)
     // If the product was kicked but shouldn't have been, give bad score.
     if (!mKick)
     {
-        GetGame()->GetScore()->SetLevelScoreBad();
+        ScoreBad();
         mScoreUpdated = true; // Mark product score as updated so it doesn't happen more than once.
     }
     else
     {
-        GetGame()->GetScore()->SetLevelScoreGood();
+        ScoreGood();
         mScoreUpdated = true;
     }
 }
+
+/**
+ * Does any part of the product lie on the playfield?
+ * @return True if it does
+ */
+bool Product::IsOnPlayfield() const
+{
+    double half = GetSize() / 2;
+    return GetX() + half >= 0 && GetX() - half <= GetGame()->GetWidth() &&
+           GetY() + half >= 0 && GetY() - half <= GetGame()->GetHeight();
+}
+
+/**
+ * Take the product out of play, to wait in a generator's pool. A
+ * parked product is not drawn, hit or moved by its conveyor.
+ * @param x X location to leave it at
+ * @param y Y location to leave it at
+ */
+void Product::Park(double x, double y)
+{
+    mParked = true;
+    mPooled = true;
+    mKickSpeed = 0;
+    SetInitalPosition(x, y);
+    SetLocation(x, y);
+}
+
+/**
+ * Put a parked product back in play as a new product
+ * @param properties Properties of the new product
+ * @param kick True if the new product should be kicked
+ * @param x X location to place it at
+ * @param y Y location to place it at
+ */
+void Product::Spawn(const std::vector<Properties> &properties, bool kick, double x, double y)
+{
+    // Assigning keeps the vector's memory, so a pool spawns without allocating
+    mProperties.assign(properties.begin(), properties.end());
+    mKick = kick;
+    mWasKicked = false;
+    mKickSpeed = 0;
+    mScoreUpdated = false;
+    mParked = false;
+    SetLocation(x, y);
+}
+
+/**
+ * Save the product's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void Product::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Item::SaveSnapshot(snapshot);
+    snapshot.Write(mKick);
+    snapshot.Write(mWasKicked);
+    snapshot.Write(mKickSpeed);
+    snapshot.Write(mScoreUpdated);
+    snapshot.Write(mParked);
+
+    // Products of a generator change properties when they are spawned
+    snapshot.Write(mProperties.size());
+    for (auto property : mProperties)
+    {
+        snapshot.Write(property);
+    }
+}
+
+/**
+ * Restore the product's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Product::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Item::RestoreSnapshot(snapshot);
+    snapshot.Read(mKick);
+    snapshot.Read(mWasKicked);
+    snapshot.Read(mKickSpeed);
+    snapshot.Read(mScoreUpdated);
+    snapshot.Read(mParked);
+
+    size_t count = 0;
+    snapshot.Read(count);
+    mProperties.resize(count);
+    for (auto &property : mProperties)
+    {
+        snapshot.Read(property);
+    }
+}
@@ -15,6 +15,7 @@
 #include "Item.h"
 #include <map>
 #include <string>
+#include <string_view>
 #include <memory>
 
 
@@ -58,10 +59,20 @@ public:
  Product(Game* game);
  Product(Game* game, const std::wstring& filename);
 
- void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+ void Draw(wxGraphicsContext *graphics) final;
  bool HitTest(double x, double y) override;
- void XmlLoad(wxXmlNode* node) override;
- void Update(double elapsed) override;
+ void XmlLoad(XmlPullParser &parser) override;
+ /**
+  * Updating the current state of the product
+  *
+  * Defined here so loops over products can inline it.
+  *
+  * @param elapsed how much time has passed since previous update
+  */
+ void Update(double elapsed) final { SetLocation(GetX() - mKickSpeed * elapsed, GetY()); }
+
+ void SaveSnapshot(GameSnapshot &snapshot) const override;
+ void RestoreSnapshot(GameSnapshot &snapshot) override;
 
  /**
  * This makes it so taht whether kicking is enabled or not
@@ -96,7 +107,7 @@ public:
     *
     * @return It returns a vector regarding what kind of properties this product has
     */
-    std::vector<Properties> GetProperties() const { return mProperties; }
+    const std::vector<Properties> &GetProperties() const { return mProperties; }
 
 
    /**
@@ -122,6 +133,13 @@ public:
     */
     void MovePosition(double x, double y);
 
+   /**
+    * Gets the initial Y position of the product on the conveyor.
+    * Products with a larger initial Y reach the sensor first.
+    * @return Initial Y coordinate
+    */
+    double GetInitialPlacementY() const { return mInitialPlacementY; }
+
 
 
    /**
@@ -151,6 +169,27 @@ public:
      */
     bool GetWasKicked() const { return mWasKicked; }
 
+    static std::vector<Properties> XmlProperties(XmlPullParser &parser);
+    static bool PropertyFromName(std::string_view name, Properties &property);
+
+    void Park(double x, double y);
+    void Spawn(const std::vector<Properties> &properties, bool kick, double x, double y);
+
+    /**
+     * Is the product parked in a generator's pool, out of play?
+     * @return True if parked
+     */
+    bool IsParked() const { return mParked; }
+
+    /**
+     * Does the product belong to a generator's pool? Such products go
+     * back to the pool rather than retiring.
+     * @return True if pooled
+     */
+    bool IsPooled() const { return mPooled; }
+
+    bool IsOnPlayfield() const;
+
 private:
     double mInitialPlacementX = 0;///<The initial placement of the X
     double mInitialPlacementY = 0; ///< The current placement of product on conveyor belt
@@ -158,6 +197,8 @@ private:
     bool mWasKicked = false; ///< Keeps track of whether the product was kicked for scoring purposes.
     double mKickSpeed = 0; ///< Speed to move Product in X direction.
     bool mScoreUpdated = false; ///< Helps score be updated once per product
+    bool mParked = false; ///< True while the product waits in a generator's pool, out of play
+    bool mPooled = false; ///< True if the product belongs to a generator's pool
     std::vector<Properties> mProperties; ///< Vector for produts showing its various characteristics
 
 };
@@ -0,0 +1,257 @@
+/**
+ * @file ProductGenerator.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "ProductGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include "Conveyor.h"
+#include "Game.h"
+#include "ProductionLine.h"
+#include "XmlPullParser.h"
+
+/// Longest a kicked product takes to leave the playfield, in seconds
+const double KickedTime = 2;
+
+/**
+ * Constructor
+ * @param conveyor Conveyor the products are placed on
+ */
+ProductGenerator::ProductGenerator(Conveyor *conveyor) : mConveyor(conveyor)
+{
+}
+
+/**
+ * Load the generator from a level being read and create its pool of
+ * products. The conveyor's own attributes must already be loaded.
+ * @param parser Parser on the generator's start element
+ */
+void ProductGenerator::XmlLoad(XmlPullParser &parser)
+{
+    // The generator's attributes are gone once its children are read
+    mSeed = (uint64_t)parser.GetLong("seed", 1);
+    double rate = parser.GetDouble("rate", 1);
+    long pool = 0;
+    if (!XmlPullParser::ToLong(parser.GetAttribute("pool"), pool))
+    {
+        pool = 0;
+    }
+
+    int depth = parser.GetDepth();
+    while (parser.NextChild(depth))
+    {
+        if (parser.IsStartElement() && parser.GetName() == "product")
+        {
+            AddTemplate(Product::XmlProperties(parser), parser.GetAttribute("kick", "no") == "yes",
+                        parser.GetLong("weight", 1));
+        }
+    }
+
+    CreatePool(rate, pool);
+}
+
+/**
+ * Add a kind of product the generator makes
+ * @param properties Properties of the product, shape first
+ * @param kick True if the product should be kicked
+ * @param weight How often the product is made relative to the others
+ */
+void ProductGenerator::AddTemplate(const std::vector<Product::Properties> &properties, bool kick, long weight)
+{
+    Template product;
+    product.mProperties = properties;
+    product.mKick = kick;
+    product.mWeight = std::max((int)weight, 1);
+
+    mTotalWeight += product.mWeight;
+    mTemplates.push_back(product);
+}
+
+/**
+ * Create the pool of products once the templates are loaded
+ * @param rate Products placed per second
+ * @param pool Number of products in the pool, or 0 for as many as the belt needs
+ */
+void ProductGenerator::CreatePool(double rate, long pool)
+{
+    auto game = mConveyor->GetGame();
+    if (mTemplates.empty())
+    {
+        return;
+    }
+
+    // Products are placed no closer together than their size
+    double size = game->GetConfig().mProductSize;
+    double speed = mConveyor->GetSpeed();
+    mInterval = rate > 0 ? 1 / rate : 1;
+    if (speed > 0)
+    {
+        mInterval = std::max(mInterval, size / speed);
+    }
+
+    // Enough products for a belt full of them and those kicked off it
+    if (pool <= 0)
+    {
+        double onBelt = speed > 0 ? (mConveyor->GetHeight() + size) / speed : 0;
+        pool = (long)std::ceil((onBelt + KickedTime) / mInterval) + 1;
+    }
+
+    mParked.reserve(pool);
+    for (long i = 0; i < pool; i++)
+    {
+        auto product = game->Create<Product>(game);
+        game->Add(product);
+        if (mConveyor->GetLine() != nullptr)
+        {
+            mConveyor->GetLine()->Add(product.get());
+        }
+        mProducts.push_back(product.get());
+    }
+
+    Reset();
+}
+
+/**
+ * Park every product and start the random sequence over, as when the
+ * conveyor is started
+ */
+void ProductGenerator::Reset()
+{
+    mRandom = mSeed;
+    mUntilNext = 0;
+    mNumSpawned = 0;
+
+    mParked.clear();
+    for (int i = (int)mProducts.size() - 1; i >= 0; i--)
+    {
+        Park(i);
+    }
+}
+
+/**
+ * Park products that have left play and place new ones on the belt
+ * @param elapsed Time since the last update in seconds
+ */
+void ProductGenerator::Update(double elapsed)
+{
+    for (int i = 0; i < (int)mProducts.size(); i++)
+    {
+        auto product = mProducts[i];
+        if (!product->IsParked() && IsOutOfPlay(product))
+        {
+            Park(i);
+        }
+    }
+
+    mUntilNext -= elapsed;
+    while (mUntilNext <= 0)
+    {
+        // With every product in play the next one waits its turn
+        Spawn();
+        mUntilNext += mInterval;
+    }
+}
+
+/**
+ * Has a product run off the end of the belt or been kicked out of
+ * the playfield?
+ * @param product Product in play
+ * @return True if it is out of play
+ */
+bool ProductGenerator::IsOutOfPlay(Product *product) const
+{
+    double half = product->GetSize() / 2;
+    double beltEnd = mConveyor->GetY() + mConveyor->GetHeight() / 2;
+
+    return product->GetY() - half > beltEnd ||
+           product->GetX() + half < 0 ||
+           product->GetX() - half > mConveyor->GetGame()->GetWidth();
+}
+
+/**
+ * Park a product above the top of the belt
+ * @param index Index of the product in mProducts
+ */
+void ProductGenerator::Park(int index)
+{
+    double top = mConveyor->GetY() - mConveyor->GetHeight() / 2;
+    mProducts[index]->Park(mConveyor->GetX(), top - mProducts[index]->GetSize() * 2);
+    mParked.push_back(index);
+}
+
+/**
+ * Place a parked product at the top of the belt
+ */
+void ProductGenerator::Spawn()
+{
+    if (mParked.empty() || mTemplates.empty())
+    {
+        return;
+    }
+
+    int pick = (int)(NextRandom() % (uint64_t)mTotalWeight);
+    auto product = mTemplates.begin();
+    while (pick >= product->mWeight)
+    {
+        pick -= product->mWeight;
+        ++product;
+    }
+
+    auto index = mParked.back();
+    mParked.pop_back();
+
+    auto spawned = mProducts[index];
+    double top = mConveyor->GetY() - mConveyor->GetHeight() / 2;
+    spawned->Spawn(product->mProperties, product->mKick, mConveyor->GetX(), top - spawned->GetSize() / 2);
+    mNumSpawned++;
+}
+
+/**
+ * Get the next number in the random sequence (splitmix64)
+ * @return Random 64-bit number
+ */
+uint64_t ProductGenerator::NextRandom()
+{
+    uint64_t z = (mRandom += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Append the generator's state to a snapshot. The products save
+ * themselves as items of the game.
+ * @param snapshot Snapshot to append to
+ */
+void ProductGenerator::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    snapshot.Write(mRandom);
+    snapshot.Write(mUntilNext);
+    snapshot.Write(mNumSpawned);
+    snapshot.Write(mParked.size());
+    for (auto index : mParked)
+    {
+        snapshot.Write(index);
+    }
+}
+
+/**
+ * Restore the generator's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void ProductGenerator::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    snapshot.Read(mRandom);
+    snapshot.Read(mUntilNext);
+    snapshot.Read(mNumSpawned);
+
+    size_t count = 0;
+    snapshot.Read(count);
+    mParked.resize(count);
+    for (auto &index : mParked)
+    {
+        snapshot.Read(index);
+    }
+}
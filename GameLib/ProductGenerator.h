@@ -0,0 +1,124 @@
+/**
+ * @file ProductGenerator.h
+ * @author matthew vazquez
+ *
+ * Streams products onto a conveyor without end, reusing a fixed pool.
+ */
+
+#ifndef PRODUCTGENERATOR_H
+#define PRODUCTGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "GameSnapshot.h"
+#include "Product.h"
+
+class Conveyor;
+
+/**
+ * Streams products onto a conveyor without end, reusing a fixed pool.
+ *
+ * A conveyor with a generator node places products at the top of its
+ * belt at a steady rate, each one copied from a product node of the
+ * generator picked at random. The picks come from a seeded generator,
+ * so a level plays out the same way every time it is started.
+ *
+ * Every product the generator will ever place is created when the
+ * level loads and parked until it is needed. Once a product has run
+ * off the end of the belt or been kicked out of the playfield it is
+ * parked again, so the game holds the same items, and the same
+ * memory, however long the conveyor runs.
+ */
+class ProductGenerator
+{
+private:
+    /**
+     * A kind of product the generator places
+     */
+    struct Template
+    {
+        /// Properties of the product
+        std::vector<Product::Properties> mProperties;
+
+        /// True if the product should be kicked
+        bool mKick = false;
+
+        /// Chance of being picked, relative to the other templates
+        int mWeight = 1;
+    };
+
+    /// Conveyor the products are placed on
+    Conveyor *mConveyor;
+
+    /// Kinds of product to place
+    std::vector<Template> mTemplates;
+
+    /// Sum of the templates' weights
+    int mTotalWeight = 0;
+
+    /// Seed the random state starts from
+    uint64_t mSeed = 1;
+
+    /// State of the random number generator
+    uint64_t mRandom = 1;
+
+    /// Seconds between products
+    double mInterval = 1;
+
+    /// Seconds until the next product is placed
+    double mUntilNext = 0;
+
+    /// Every product of the pool
+    std::vector<Product *> mProducts;
+
+    /// Indices into mProducts of the parked products, next to place last
+    std::vector<int> mParked;
+
+    /// Number of products placed since the conveyor started
+    uint64_t mNumSpawned = 0;
+
+    uint64_t NextRandom();
+    bool IsOutOfPlay(Product *product) const;
+    void Park(int index);
+    void Spawn();
+    void AddTemplate(const std::vector<Product::Properties> &properties, bool kick, long weight);
+    void CreatePool(double rate, long pool);
+
+public:
+    explicit ProductGenerator(Conveyor *conveyor);
+
+    /// Default constructor (disabled)
+    ProductGenerator() = delete;
+
+    /// Copy constructor (disabled)
+    ProductGenerator(const ProductGenerator &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ProductGenerator &) = delete;
+
+    void XmlLoad(XmlPullParser &parser);
+    void Reset();
+    void Update(double elapsed);
+    void SaveSnapshot(GameSnapshot &snapshot) const;
+    void RestoreSnapshot(GameSnapshot &snapshot);
+
+    /**
+     * Get the number of products in the pool
+     * @return Number of products
+     */
+    int GetPoolSize() const { return (int)mProducts.size(); }
+
+    /**
+     * Get the number of products placed since the conveyor started
+     * @return Number of products
+     */
+    uint64_t GetNumSpawned() const { return mNumSpawned; }
+
+    /**
+     * Get the time between products
+     * @return Seconds
+     */
+    double GetInterval() const { return mInterval; }
+};
+
+#endif //PRODUCTGENERATOR_H
@@ -0,0 +1,192 @@
+/**
+ * @file ProductionLine.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "ProductionLine.h"
+#include "Item.h"
+#include "Score.h"
+
+/**
+ * Add an item to the line
+ * @param item Item to add, after those already added
+ */
+void ProductionLine::Add(Item *item)
+{
+    item->SetLine(this);
+    mItems.push_back(item);
+    mActive.push_back(item);
+}
+
+/**
+ * Accept a visitor for every item of the line still in play
+ * @param visitor Visitor to accept
+ */
+void ProductionLine::Accept(ItemVisitor *visitor)
+{
+    for (auto item : mActive)
+    {
+        item->Accept(visitor);
+    }
+}
+
+/**
+ * Accept a visitor for every item of the line, retired or not
+ * @param visitor Visitor to accept
+ */
+void ProductionLine::AcceptAll(ItemVisitor *visitor)
+{
+    for (auto item : mItems)
+    {
+        item->Accept(visitor);
+    }
+}
+
+/**
+ * Find the line's items still in play, after items retired or came back
+ */
+void ProductionLine::UpdateActive()
+{
+    mActive.clear();
+    for (auto item : mItems)
+    {
+        if (!item->IsRetired())
+        {
+            mActive.push_back(item);
+        }
+    }
+}
+
+/**
+ * Find the item of the line at a location, the way Game::HitTest
+ * finds the item of the game at a location
+ * @param x X location in virtual pixels
+ * @param y Y location in virtual pixels
+ * @return The last item added at the location, or null if none
+ */
+IDraggable *ProductionLine::HitTest(double x, double y)
+{
+    for (auto i = mActive.rbegin(); i != mActive.rend(); i++)
+    {
+        auto draggable = (*i)->HitDraggable(x, y);
+        if (draggable != nullptr)
+        {
+            return draggable;
+        }
+
+        if ((*i)->HitTest(x, y))
+        {
+            return *i;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Score a product sorted correctly
+ * @param score Score holding the points a correct sort is worth
+ */
+void ProductionLine::ScoreGood(const Score &score)
+{
+    mNumGood++;
+    mPendingSorted++;
+    mScore += score.GetGoodScore();
+    mPendingScore += score.GetGoodScore();
+}
+
+/**
+ * Score a product sorted wrongly
+ * @param score Score holding the points a wrong sort is worth
+ */
+void ProductionLine::ScoreBad(const Score &score)
+{
+    mNumBad++;
+    mPendingSorted++;
+    mScore += score.GetBadScore();
+    mPendingScore += score.GetBadScore();
+}
+
+/**
+ * Take back the points the line scored, as when its conveyor starts over
+ */
+void ProductionLine::ResetScore()
+{
+    mPendingScore -= mScore;
+    mScore = 0;
+    mNumGood = 0;
+    mNumBad = 0;
+    mFinished = false;
+}
+
+/**
+ * Get the points scored since the last call and not yet added to the
+ * level score
+ * @return Points to add to the level score
+ */
+int ProductionLine::TakePendingScore()
+{
+    int pending = mPendingScore;
+    mPendingScore = 0;
+    return pending;
+}
+
+/**
+ * Get the number of products sorted since the last call
+ * @return Products sorted correctly or wrongly
+ */
+int ProductionLine::TakeSorted()
+{
+    int sorted = mPendingSorted;
+    mPendingSorted = 0;
+    return sorted;
+}
+
+/**
+ * Note that every product has passed the line's beam
+ */
+void ProductionLine::Finish()
+{
+    mFinished = true;
+    mJustFinished = true;
+}
+
+/**
+ * Find out if the line finished since the last call
+ * @return True if it did
+ */
+bool ProductionLine::TakeJustFinished()
+{
+    bool finished = mJustFinished;
+    mJustFinished = false;
+    return finished;
+}
+
+/**
+ * Append the line's counters to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void ProductionLine::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    snapshot.Write(mNumGood);
+    snapshot.Write(mNumBad);
+    snapshot.Write(mScore);
+    snapshot.Write(mPendingScore);
+    snapshot.Write(mFinished);
+    snapshot.Write(mPendingSorted);
+}
+
+/**
+ * Restore the line's counters from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void ProductionLine::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    snapshot.Read(mNumGood);
+    snapshot.Read(mNumBad);
+    snapshot.Read(mScore);
+    snapshot.Read(mPendingScore);
+    snapshot.Read(mFinished);
+    snapshot.Read(mPendingSorted);
+}
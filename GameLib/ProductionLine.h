@@ -0,0 +1,162 @@
+/**
+ * @file ProductionLine.h
+ * @author matthew vazquez
+ *
+ * A conveyor and the sensor, beam and Sparty that sort its products.
+ */
+
+#ifndef PRODUCTIONLINE_H
+#define PRODUCTIONLINE_H
+
+#include <vector>
+#include "GameSnapshot.h"
+
+class Item;
+class ItemVisitor;
+class IDraggable;
+class Score;
+
+/**
+ * A conveyor and the sensor, beam and Sparty that sort its products.
+ *
+ * A level declares its lines with line nodes in its items node. Items
+ * a level places outside any line belong to one line of their own, so
+ * levels written for a single conveyor load as a single line.
+ *
+ * Items of a line only look at other items of the same line: the
+ * conveyor moves its own products, the sensor and beam look for them
+ * and Sparty kicks them, leaving out retired products. Lines share
+ * nothing but the circuit, so they can update in parallel. Points a
+ * line scores while it updates are held back until Game::Update adds
+ * them to the level score.
+ */
+class ProductionLine
+{
+private:
+    /// Position of the line in the level, from 0
+    int mIndex;
+
+    /// Items of the line, in the order the game holds them
+    std::vector<Item *> mItems;
+
+    /// Items of the line that are not retired
+    std::vector<Item *> mActive;
+
+    /// Number of products on the line's conveyors
+    int mNumProducts = 0;
+
+    /// Number of products sorted correctly since the line started
+    int mNumGood = 0;
+
+    /// Number of products sorted wrongly since the line started
+    int mNumBad = 0;
+
+    /// Points the line added to the level score
+    int mScore = 0;
+
+    /// Points not yet added to the level score
+    int mPendingScore = 0;
+
+    /// True once every product has passed the line's beam
+    bool mFinished = false;
+
+    /// True if the line finished during the update in progress
+    bool mJustFinished = false;
+
+    /// Products sorted and not yet counted by the game
+    int mPendingSorted = 0;
+
+    /// True if a conveyor of the line never runs out of products
+    bool mEndless = false;
+
+public:
+    /**
+     * Constructor
+     * @param index Position of the line in the level, from 0
+     */
+    explicit ProductionLine(int index) : mIndex(index) {}
+
+    /// Copy constructor (disabled)
+    ProductionLine(const ProductionLine &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ProductionLine &) = delete;
+
+    void Add(Item *item);
+    void Accept(ItemVisitor *visitor);
+    void AcceptAll(ItemVisitor *visitor);
+    void UpdateActive();
+    IDraggable *HitTest(double x, double y);
+
+    void ScoreGood(const Score &score);
+    void ScoreBad(const Score &score);
+    void ResetScore();
+    int TakePendingScore();
+    int TakeSorted();
+    void Finish();
+    bool TakeJustFinished();
+
+    void SaveSnapshot(GameSnapshot &snapshot) const;
+    void RestoreSnapshot(GameSnapshot &snapshot);
+
+    /**
+     * Forget the points the line scored, once the level score they
+     * were added to has been reset
+     */
+    void ClearScore() { mScore = 0; mPendingScore = 0; }
+
+    /**
+     * Note that a conveyor of the line streams products without end
+     */
+    void SetEndless() { mEndless = true; }
+
+    /**
+     * Does a conveyor of the line stream products without end?
+     * @return True if the line never finishes
+     */
+    bool IsEndless() const { return mEndless; }
+
+    /**
+     * Count products a conveyor of this line carries
+     * @param count Number of products
+     */
+    void AddProducts(int count) { mNumProducts += count; }
+
+    /**
+     * Get the position of the line in the level
+     * @return Index from 0
+     */
+    int GetIndex() const { return mIndex; }
+
+    /**
+     * Get the number of products on the line's conveyors
+     * @return Number of products
+     */
+    int GetNumProducts() const { return mNumProducts; }
+
+    /**
+     * Get the number of products sorted correctly
+     * @return Number of products
+     */
+    int GetNumGood() const { return mNumGood; }
+
+    /**
+     * Get the number of products sorted wrongly
+     * @return Number of products
+     */
+    int GetNumBad() const { return mNumBad; }
+
+    /**
+     * Get the points the line scored since it started
+     * @return Points
+     */
+    int GetScore() const { return mScore; }
+
+    /**
+     * Has every product passed the line's beam?
+     * @return True if the line is finished
+     */
+    bool IsFinished() const { return mFinished; }
+};
+
+#endif //PRODUCTIONLINE_H
@@ -0,0 +1,60 @@
+/**
+ * @file RewindBuffer.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "RewindBuffer.h"
+#include "Game.h"
+
+/**
+ * Set the number of snapshots kept, dropping any held
+ * @param capacity Number of snapshots
+ */
+void RewindBuffer::SetCapacity(int capacity)
+{
+    mSnapshots.resize(capacity);
+    mNext = 0;
+    mCount = 0;
+}
+
+/**
+ * Take a snapshot of a game, replacing the oldest one if full
+ * @param game Game to take a snapshot of
+ */
+void RewindBuffer::Push(Game *game)
+{
+    if (mSnapshots.empty())
+    {
+        return;
+    }
+
+    game->SaveSnapshot(mSnapshots[mNext]);
+    mNext = (mNext + 1) % (int)mSnapshots.size();
+    if (mCount < (int)mSnapshots.size())
+    {
+        mCount++;
+    }
+}
+
+/**
+ * Restore a game to its most recent snapshot and drop that snapshot,
+ * so rewinding again goes further back. Snapshots the game can no
+ * longer be restored to are dropped too.
+ * @param game Game to restore
+ * @return True if the game was restored
+ */
+bool RewindBuffer::Rewind(Game *game)
+{
+    while (mCount > 0)
+    {
+        mNext = (mNext + (int)mSnapshots.size() - 1) % (int)mSnapshots.size();
+        mCount--;
+        if (game->RestoreSnapshot(mSnapshots[mNext]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file RewindBuffer.h
+ * @author matthew vazquez
+ *
+ * The most recent snapshots of a game, for going back in time.
+ */
+
+#ifndef REWINDBUFFER_H
+#define REWINDBUFFER_H
+
+#include <vector>
+#include "GameSnapshot.h"
+
+class Game;
+
+/**
+ * The most recent snapshots of a game, for going back in time.
+ *
+ * A ring of snapshots: once it is full, each new snapshot replaces
+ * the oldest and reuses its memory.
+ */
+class RewindBuffer
+{
+private:
+    /// Snapshot slots
+    std::vector<GameSnapshot> mSnapshots;
+
+    /// Slot the next snapshot goes into
+    int mNext = 0;
+
+    /// Number of slots holding snapshots
+    int mCount = 0;
+
+public:
+    void SetCapacity(int capacity);
+    void Push(Game *game);
+    bool Rewind(Game *game);
+
+    /**
+     * Drop every snapshot
+     */
+    void Clear() { mCount = 0; }
+
+    /**
+     * Get the number of snapshots held
+     * @return Number of snapshots
+     */
+    int GetCount() const { return mCount; }
+};
+
+#endif //REWINDBUFFER_H
@@ -69,6 +69,18 @@ public:
      */
     void SetBadScore(int badScore) {mBadScore = badScore;}
 
+    /**
+     * Get the score for a correct kick.
+     * @return Points for a good kick.
+     */
+    int GetGoodScore() const {return mGoodScore;}
+
+    /**
+     * Get the score for a bad kick.
+     * @return Points for a bad kick.
+     */
+    int GetBadScore() const {return mBadScore;}
+
     /**
      * Resets the score of the level to zero.
      */
@@ -12,6 +12,7 @@
 #include <iomanip>
 #include <wx/dcbuffer.h>
 #include "Game.h"
+#include "XmlPullParser.h"
 
 using namespace std;
 
@@ -78,56 +79,40 @@ const wxColour HalfMinuteWarning(171, 25, 27);
  */
 Scoreboard::Scoreboard(Game* game) : Item(game)
 {
-    int good;
-    int bad;
-    int hours;
-    int minutes;
-    int seconds;
 }
 
 /**
- * Load attributes for item node.
- * Loads attributes for the scoreboard to use for drawing.
- * @param node Xml node we are loading item from.
+ * Load the scoreboard from a level being read.
+ * @param parser Parser on the scoreboard's start element.
  */
-void Scoreboard::XmlLoad(wxXmlNode* node)
+void Scoreboard::XmlLoad(XmlPullParser &parser)
 {
+ mX = (int)parser.GetLong("x", 700);
+ mY = (int)parser.GetLong("y", 40);
 
- node->GetAttribute(L"x", L"700").ToInt(&mX);
- node->GetAttribute(L"y", L"40").ToInt(&mY);
-
- //Load in the good attribute
- int good = 10; //Default 10
- node->GetAttribute(L"good", L"10").ToInt(&good);
- GetGame()->GetScore()->SetGoodScore(good);
-
- //Load in the bad attribute
- int bad = 0; //Default 0
- node->GetAttribute(L"bad", L"0").ToInt(&bad);
- GetGame()->GetScore()->SetBadScore(bad);
+ GetGame()->GetScore()->SetGoodScore((int)parser.GetLong("good", 10));
+ GetGame()->GetScore()->SetBadScore((int)parser.GetLong("bad", 0));
 
  //Load in the instruction text into a single string.
- auto child = node->GetChildren();
- for (; child; child = child->GetNext())
+ int depth = parser.GetDepth();
+ while (parser.NextChild(depth))
  {
-     if (child->GetType() == wxXML_TEXT_NODE)
+     if (parser.GetEvent() == XmlPullParser::Event::Text)
      {
-         std::wstring instructionLine = child->GetContent().ToStdWstring();
-         mGoalText += instructionLine;
+         mGoalText += XmlPullParser::Decode(parser.GetText());
      }
-     else if (child->GetName() == L"br") //Line break
+     else if (parser.GetName() == "br") //Line break
      {
          mGoalText += L"\n";
      }
  }
-
 }
 
 /**
  * Draws the scoreboard for the game.
  * @param graphics context to draw scoreboard on
  */
-void Scoreboard::Draw(shared_ptr<wxGraphicsContext> graphics)
+void Scoreboard::Draw(wxGraphicsContext *graphics)
 {
     //Draw Scoreboard box
     graphics->SetBrush(*wxWHITE_BRUSH); //Sets color of scoreboard
@@ -169,6 +154,7 @@ void Scoreboard::Draw(shared_ptr<wxGraphicsContext> graphics)
 
     // Draw time bonus
     auto bonusFont = graphics->CreateFont(ScoreFontSize, "Arial", wxFONTFLAG_BOLD, Default);
+    graphics->SetFont(bonusFont);
     graphics->DrawText(L"Time Bonus: " + to_string(GetGame()->GetTimeBonus()), mX + BonusX, mY + BonusY);
 
 
@@ -179,6 +165,31 @@ void Scoreboard::Draw(shared_ptr<wxGraphicsContext> graphics)
     auto instructionsFont = graphics->CreateFont(InstructionFontSize, "Arial", wxFONTFLAG_BOLD, *wxBLACK);
     graphics->SetFont(instructionsFont);
 
+    auto game = GetGame();
+
+    //Draw how fast products are sorted when they never run out
+    if (game->IsEndless())
+    {
+        wstringstream throughput;
+        throughput << L"Sorted: " << game->GetThroughput().GetTotal() << L" ("
+                   << fixed << setprecision(1) << game->GetThroughput().GetPerMinute() << L" per minute)";
+        graphics->DrawText(throughput.str(), mX + ScoreX, instruction_y);
+        instruction_y += SpacingInstructionLines;
+    }
+
+    //Draw each line's score when the level has more than one
+    if (game->GetNumLines() > 1)
+    {
+        for (int i = 0; i < game->GetNumLines(); i++)
+        {
+            auto line = game->GetLine(i);
+            graphics->DrawText(L"Line " + to_wstring(i + 1) + L": " + to_wstring(line->GetScore()) +
+                               L" (" + to_wstring(line->GetNumGood()) + L" good, " +
+                               to_wstring(line->GetNumBad()) + L" bad)", mX + ScoreX, instruction_y);
+            instruction_y += SpacingInstructionLines;
+        }
+    }
+
     wistringstream stream(mGoalText);
     wstring instructionLine;
     while (getline(stream, instructionLine))
@@ -212,3 +223,29 @@ void Scoreboard::Update(double elapsed)
 void Scoreboard::OnClick(double x, double y)
 {
 }
+
+/**
+ * Save the scoreboard's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void Scoreboard::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Item::SaveSnapshot(snapshot);
+    snapshot.Write(mLevelScore);
+    snapshot.Write(mHours);
+    snapshot.Write(mMinutes);
+    snapshot.Write(mSeconds);
+}
+
+/**
+ * Restore the scoreboard's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Scoreboard::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Item::RestoreSnapshot(snapshot);
+    snapshot.Read(mLevelScore);
+    snapshot.Read(mHours);
+    snapshot.Read(mMinutes);
+    snapshot.Read(mSeconds);
+}
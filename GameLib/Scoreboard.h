@@ -16,7 +16,7 @@
  * Displays the level score and game score.
  * Displays level instructions.
  */
-class Scoreboard : public Item
+class Scoreboard final : public Item
 {
 private:
     /// X-coordinate of the scoreboard (taken from XML)
@@ -59,10 +59,12 @@ private:
 
 public:
     Scoreboard(Game* game);
-    void XmlLoad(wxXmlNode* node) override;
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void XmlLoad(XmlPullParser &parser) override;
+    void Draw(wxGraphicsContext *graphics) override;
     void OnClick(double x, double y) override;
     void Update(double elapsed) override;
+    void SaveSnapshot(GameSnapshot &snapshot) const override;
+    void RestoreSnapshot(GameSnapshot &snapshot) override;
 
     /**
      * Accept a visitor
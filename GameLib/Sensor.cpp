@@ -9,6 +9,9 @@
 #include "Sensor.h"
 #include "Game.h"
 #include "Gates.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
+#include "XmlPullParser.h"
 
 using namespace std;
 
@@ -55,7 +58,7 @@ public:
 	 */
 	void VisitProduct(Product* product) override
 	{
-		if (mSensor->IsProductInRange(product))
+		if (!product->IsParked() && mSensor->IsProductInRange(product))
 		{
 			const auto& properties = product->GetProperties();
 			mDetectedProperties.insert(mDetectedProperties.end(), properties.begin(), properties.end());
@@ -75,34 +78,34 @@ public:
  */
 Sensor::Sensor(Game* game) : Item(game)
 {
-    // Load camera image
-	mSensorCameraImage = make_shared<wxImage>(SensorCameraImagePath, wxBITMAP_TYPE_PNG);
-	mSensorCameraBitmap = make_shared<wxBitmap>(*mSensorCameraImage);
-
-	mSensorCableImage = make_unique<wxImage>(SensorCableImagePath, wxBITMAP_TYPE_PNG);
-	mSensorCableBitmap = make_unique<wxBitmap>(*mSensorCableImage);
+    // Find camera images
+	mSensorCameraSprite = game->GetAtlas()->Find(SensorCameraImagePath);
+	mSensorCableSprite = game->GetAtlas()->Find(SensorCableImagePath);
 }
 
 /**
  * Draws sensor components and properties panel
  * @param graphics The graphics context to draw on
  */
-void Sensor::Draw(shared_ptr<wxGraphicsContext> graphics)
+void Sensor::Draw(wxGraphicsContext *graphics)
 {
+	auto atlas = GetGame()->GetAtlas();
+	auto sprites = GetGame()->GetSprites();
+
 	// Stuff for sensor camera
-	double cameraWidth = mSensorCameraBitmap->GetWidth();
-	double cameraHeight = mSensorCameraBitmap->GetHeight();
+	double cameraWidth = atlas->GetSize(mSensorCameraSprite).GetWidth();
+	double cameraHeight = atlas->GetSize(mSensorCameraSprite).GetHeight();
 
 	// Stuff for sensor cable
-	double cableWidth = mSensorCableBitmap->GetWidth();
-	double cableHeight = mSensorCableBitmap->GetHeight();
+	double cableWidth = atlas->GetSize(mSensorCableSprite).GetWidth();
+	double cableHeight = atlas->GetSize(mSensorCableSprite).GetHeight();
 
 	// Draw sensor cable
-	graphics->DrawBitmap(*mSensorCableBitmap, GetX() - cableWidth / 2, GetY() - cameraHeight / 2, cableWidth, cableHeight);
+	sprites->Draw(graphics, mSensorCableSprite, GetX() - cableWidth / 2, GetY() - cameraHeight / 2, cableWidth, cableHeight);
 
 	// Draw sensor camera
-	graphics->DrawBitmap(*mSensorCameraBitmap, GetX() - cameraWidth / 2, GetY() - cameraHeight / 2, cameraWidth,
-						cameraHeight);
+	sprites->Draw(graphics, mSensorCameraSprite, GetX() - cameraWidth / 2, GetY() - cameraHeight / 2, cameraWidth,
+				  cameraHeight);
 
 	// Draw properties panel
 	if (!mProperties.empty())
@@ -118,38 +121,50 @@ void Sensor::Draw(shared_ptr<wxGraphicsContext> graphics)
 		graphics->DrawRectangle(panelLeftX, panelTopY, PropertySize.GetWidth(), panelHeight);
 
 		// Draw each SensorPanel
-		for (auto& panel : mSensorPanels)
+		for (auto panel : mSensorPanels)
 		{
-			if (panel)
-			{
-				panel->Draw(graphics);
-			}
+			Get(panel)->Draw(graphics);
 		}
 	}
 }
 
 /**
- * Loads sensor properties from an XML node
- * @param node The XML node containing sensor data
+ * Load the sensor from a level being read. Each child element names
+ * a property the sensor has a panel for.
+ * @param parser Parser on the sensor's start element
  */
-void Sensor::XmlLoad(wxXmlNode* node)
+void Sensor::XmlLoad(XmlPullParser &parser)
 {
-	Item::XmlLoad(node);
+	Item::XmlLoad(parser);
 
-	// Load properties from XML
-	wxXmlNode* child = node->GetChildren();
-	while (child)
+	int depth = parser.GetDepth();
+	while (parser.NextChild(depth))
+	{
+		if (parser.IsStartElement())
+		{
+			mProperties.push_back(XmlPullParser::Decode(parser.GetName()));
+		}
+	}
+
+	CreatePanels();
+}
+
+/**
+ * Create a panel for each property, below the sensor
+ */
+void Sensor::CreatePanels()
+{
+	// Panels from an earlier load go back to the arena
+	for (auto panel : mSensorPanels)
 	{
-		auto name = child->GetName().ToStdWstring();
-		mProperties.push_back(name);
-		child = child->GetNext();
+		DestroyPart(panel);
 	}
 
 	// Initialize pins for each property
 	mSensorPanels.resize(mProperties.size());
 
 	// Set positions
-	double panelLeftX = GetX() + mSensorCableBitmap->GetWidth() / 2;
+	double panelLeftX = GetX() + GetGame()->GetAtlas()->GetSize(mSensorCableSprite).GetWidth() / 2;
 	double panelTopY = GetY() + PanelOffsetY;
 
 	for (size_t i = 0; i < mProperties.size(); ++i)
@@ -161,10 +176,27 @@ void Sensor::XmlLoad(wxXmlNode* node)
 		double panelY = panelTopY + i * PropertySize.GetHeight() + PropertySize.GetHeight() / 2;
 
 
-		mSensorPanels[i] = make_shared<SensorPanel>(GetGame(), mProperties[i], panelX, panelY);
+		mSensorPanels[i] = CreatePart<SensorPanel>(GetGame(), mProperties[i], panelX, panelY);
 	}
 }
 
+/**
+ * Get the property panels of this sensor
+ * @return Panels in the order they are listed in the level
+ */
+std::vector<SensorPanel *> Sensor::GetSensorPanels() const
+{
+	std::vector<SensorPanel *> panels;
+	for (auto panel : mSensorPanels)
+	{
+		if (auto found = Get(panel))
+		{
+			panels.push_back(found);
+		}
+	}
+	return panels;
+}
+
 /**
  * Handles mouse click events on sensor
  * @param x X-coordinate of click
@@ -177,12 +209,9 @@ void Sensor::OnClick(double x, double y)
 
 void Sensor::UpdatePins(const vector<Product::Properties>& detectedProperties)
 {
-	for (auto& panel : mSensorPanels)
+	for (auto panel : mSensorPanels)
 	{
-		if (panel)
-		{
-			panel->UpdateState(detectedProperties);
-		}
+		Get(panel)->UpdateState(detectedProperties);
 	}
 }
 
@@ -192,13 +221,14 @@ void Sensor::UpdatePins(const vector<Product::Properties>& detectedProperties)
  * @param y Y location clicked on
  * @return Whatever we clicked on or NULL if none
  */
-std::shared_ptr<IDraggable> Sensor::HitDraggable(int x, int y)
+IDraggable *Sensor::HitDraggable(int x, int y)
 {
-	for (auto& panel : mSensorPanels)
+	for (auto panel : mSensorPanels)
 	{
-		if (panel->GetOutputPin()->HitTest(x,y ))
+		auto pin = Get(panel)->GetOutputPin();
+		if (pin->HitTest(x,y ))
 		{
-			return panel->GetOutputPin();
+			return pin;
 		}
 	}
 	return nullptr;
@@ -212,15 +242,22 @@ std::shared_ptr<IDraggable> Sensor::HitDraggable(int x, int y)
 void Sensor::Update(double elapsed)
 {
 	SensorCollisionVisitor visitor(this);
-	GetGame()->Accept(&visitor);
+	AcceptLine(&visitor);
 	UpdatePins(visitor.GetDetectedProperties());
 }
 
-bool Sensor::IsProductInRange(Product* product)
+/**
+ * Get the area where the sensor views products
+ * @return Range in virtual pixels
+ */
+wxRect2DDouble Sensor::GetRange() const
 {
-	double sensorX = GetX();
-	double sensorY = GetY();
+	return wxRect2DDouble(GetX() + SensorRangeX[0], GetY() + SensorRange[0],
+			SensorRangeX[1] - SensorRangeX[0], SensorRange[1] - SensorRange[0]);
+}
 
+bool Sensor::IsProductInRange(Product* product)
+{
 	double productWidth = product->GetSize();
 	double productHeight = product->GetSize();
 
@@ -229,10 +266,11 @@ bool Sensor::IsProductInRange(Product* product)
 	double productXLeft = product->GetX() - productWidth / 2;
 	double productXRight = product->GetX() + productWidth / 2;
 
-	double rangeTop = sensorY + SensorRange[0];
-	double rangeBottom = sensorY + SensorRange[1];
-	double rangeLeft = sensorX + SensorRangeX[0];
-	double rangeRight = sensorX + SensorRangeX[1];
+	auto range = GetRange();
+	double rangeTop = range.GetTop();
+	double rangeBottom = range.GetBottom();
+	double rangeLeft = range.GetLeft();
+	double rangeRight = range.GetRight();
 
 	if (productYBottom >= rangeTop && productYTop <= rangeBottom && productXLeft >= rangeLeft && productXRight <= rangeRight)
 	{
@@ -240,4 +278,30 @@ bool Sensor::IsProductInRange(Product* product)
 	}
 
 	return false;
-}
\ No newline at end of file
+}
+
+/**
+ * Save the sensor's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void Sensor::SaveSnapshot(GameSnapshot &snapshot) const
+{
+	Item::SaveSnapshot(snapshot);
+	for (auto panel : mSensorPanels)
+	{
+		Get(panel)->GetOutputPin()->SaveSnapshot(snapshot);
+	}
+}
+
+/**
+ * Restore the sensor's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Sensor::RestoreSnapshot(GameSnapshot &snapshot)
+{
+	Item::RestoreSnapshot(snapshot);
+	for (auto panel : mSensorPanels)
+	{
+		Get(panel)->GetOutputPin()->RestoreSnapshot(snapshot);
+	}
+}
@@ -23,15 +23,11 @@
 class Sensor : public Item
 {
 private:
-    /// Image for the sensor camera
-    std::shared_ptr<wxImage> mSensorCameraImage;
-	/// Bitmap for the sensor camera
-	std::shared_ptr<wxBitmap> mSensorCameraBitmap;
+    /// Sprite for the sensor camera
+    int mSensorCameraSprite = -1;
 
-	/// Image for the sensor cable
-	std::shared_ptr<wxImage> mSensorCableImage;
-	/// Bitmap for the sensor cable
-	std::shared_ptr<wxBitmap> mSensorCableBitmap;
+	/// Sprite for the sensor cable
+	int mSensorCableSprite = -1;
 
 	/// List of properties that can be detected
 	std::vector<std::wstring> mProperties;
@@ -46,7 +42,7 @@ private:
 	static const wxColour PanelBackgroundColor;
 
 	/// Collection of SensorPanels for each property
-	std::vector<std::shared_ptr<SensorPanel>> mSensorPanels;
+	std::vector<ArenaHandle<SensorPanel>> mSensorPanels;
 
 	/// Range where a product is viewed
 	static const int SensorRange[2];
@@ -54,12 +50,14 @@ private:
 	/// Range x-axis where a product is viewed
 	static const int SensorRangeX[2];
 
+	void CreatePanels();
+
 public:
 	Sensor(Game* game);
 
-	void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
-	void XmlLoad(wxXmlNode* node) override;
-	//void DrawProperty(std::shared_ptr<wxGraphicsContext> graphics, const std::wstring& property, double x, double y);
+	void Draw(wxGraphicsContext *graphics) final;
+	void XmlLoad(XmlPullParser &parser) override;
+	//void DrawProperty(wxGraphicsContext *graphics, const std::wstring& property, double x, double y);
 	void OnClick(double x, double y) override;
 
     /**
@@ -74,8 +72,12 @@ public:
      */
     void Accept(ItemVisitor* visitor) override { visitor->VisitSensor(this); }
 
-	std::shared_ptr<IDraggable> HitDraggable(int x, int y) override;
-	void Update(double elapsed) override;
+	IDraggable *HitDraggable(int x, int y) override;
+	void Update(double elapsed) final;
+	void SaveSnapshot(GameSnapshot &snapshot) const override;
+	void RestoreSnapshot(GameSnapshot &snapshot) override;
+
+	std::vector<SensorPanel *> GetSensorPanels() const;
 
     /**
      * Determines if product is in range of sensor.
@@ -83,6 +85,8 @@ public:
      * @return True if product in range, false otherwise.
      */
     bool IsProductInRange(Product* product);
+
+	wxRect2DDouble GetRange() const;
 };
 
 
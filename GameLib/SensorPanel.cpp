@@ -8,6 +8,8 @@
 #include "Game.h"
 #include "Sensor.h"
 #include "Gates.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
 #include <algorithm>
 
 using namespace std;
@@ -29,14 +31,15 @@ SensorPanel::SensorPanel(Game* game, const wstring& property, double x, double y
  : Item(game), mProperty(property), mX(x), mY(y)
 {
     wxPoint pinLocation(x + PropertySize.GetWidth() / 2 + OutputPinOffset, y);
-	   mOutputPin = make_shared<OutputPin>(this, pinLocation);
+	   mOutputPin = CreatePart<OutputPin>(this, pinLocation);
+    mSprite = game->GetAtlas()->Find(property + L".png");
 }
 
 /**
  * Draws property panel and OutputPin
  * @param graphics Graphics context to draw on
  */
-void SensorPanel::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void SensorPanel::Draw(wxGraphicsContext *graphics)
 {
     // Draw the property box
     double rectX = mX - PropertySize.GetWidth() / 2;
@@ -97,13 +100,12 @@ void SensorPanel::Draw(std::shared_ptr<wxGraphicsContext> graphics)
     else
     {
         // Image properties
-        std::wstring imagePath = L"images/" + mProperty + L".png";
-        wxImage image;
-        if (image.LoadFile(imagePath, wxBITMAP_TYPE_PNG))
+        auto atlas = GetGame()->GetAtlas();
+        auto sprites = GetGame()->GetSprites();
+        if (mSprite >= 0)
         {
-            wxBitmap bitmap(image);
-            double imageWidth = bitmap.GetWidth();
-            double imageHeight = bitmap.GetHeight();
+            double imageWidth = atlas->GetSize(mSprite).GetWidth();
+            double imageHeight = atlas->GetSize(mSprite).GetHeight();
 
             double availableWidth = rectWidth - 2 * padding;
             double availableHeight = rectHeight - 2 * padding;
@@ -116,11 +118,7 @@ void SensorPanel::Draw(std::shared_ptr<wxGraphicsContext> graphics)
             double offsetX = rectX + padding + (availableWidth - imageDisplayWidth) / 2;
             double offsetY = rectY + padding + (availableHeight - imageDisplayHeight) / 2;
 
-            graphics->PushState();
-            graphics->Translate(offsetX, offsetY);
-            graphics->Scale(scale, scale);
-            graphics->DrawBitmap(bitmap, 0, 0, imageWidth, imageHeight);
-            graphics->PopState();
+            sprites->Draw(graphics, mSprite, offsetX, offsetY, imageDisplayWidth, imageDisplayHeight);
 
             graphics->SetPen(*wxBLACK_PEN);
             graphics->SetBrush(*wxTRANSPARENT_BRUSH);
@@ -131,7 +129,7 @@ void SensorPanel::Draw(std::shared_ptr<wxGraphicsContext> graphics)
     // Draw the OutputPin
     if (mOutputPin)
     {
-        mOutputPin->Draw(graphics);
+        Get(mOutputPin)->Draw(graphics);
     }
 }
 
@@ -164,10 +162,10 @@ void SensorPanel::UpdateState(const std::vector<Product::Properties>& detectedPr
 
         if (mOutputPin)
         {
-            mOutputPin->SetState(isActive ? States::One : States::Zero);
+            Get(mOutputPin)->SetState(isActive ? States::One : States::Zero);
         }
     }
-    mOutputPin->Update();
+    Get(mOutputPin)->Update();
 }
 
 /**
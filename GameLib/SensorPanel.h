@@ -17,14 +17,17 @@
 /**
  * Class representing a single property panel in Sensor
  */
-class SensorPanel : public Item
+class SensorPanel final : public Item
 {
 private:
     /// Name of the property
     std::wstring mProperty;
 
+    /// Sprite for a content property, -1 for the others
+    int mSprite = -1;
+
     /// OutputPin associated
-    std::shared_ptr<OutputPin> mOutputPin;
+    ArenaHandle<OutputPin> mOutputPin;
 
 	/// X-coordinate of panel
 	double mX;
@@ -38,15 +41,15 @@ private:
 public:
     SensorPanel(Game* game, const std::wstring& property, double x, double y);
 
-	void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+	void Draw(wxGraphicsContext *graphics) override;
 
 	void UpdateState(const std::vector<Product::Properties>& detectedProperties);
 
 	/**
 	 * Getter for the OutputPin
-	 * @return Shared pointer to OutputPin
+	 * @return The OutputPin
 	 */
-	std::shared_ptr<OutputPin> GetOutputPin() const { return mOutputPin; }
+	OutputPin *GetOutputPin() const { return Get(mOutputPin); }
 
 	/**
 	 * Getter for property name
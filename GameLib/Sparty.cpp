@@ -13,6 +13,10 @@
 #include "Game.h"
 #include "Gates.h"
 #include "InputPin.h"
+#include "ProductionLine.h"
+#include "SpriteAtlas.h"
+#include "SpriteView.h"
+#include "XmlPullParser.h"
 
 using namespace std;
 
@@ -27,7 +31,7 @@ const std::wstring SpartyFrontImage = L"images/sparty-front.png";
 
 /// Pivot point for the Sparty boot image as a fraction of
 /// the width and height.
-wxPoint2DDouble SpartyBootPivot = wxPoint2DDouble(0.5, 0.55);
+const wxPoint2DDouble SpartyBootPivot = wxPoint2DDouble(0.5, 0.55);
 
 /// The maximum rotation for Sparty's boot in radians
 const double SpartyBootMaxRotation = 0.8;
@@ -71,62 +75,78 @@ const int WireOffsetSparty = 70;
  */
 Sparty::Sparty(Game* game) : Item(game, SpartyBackImage)
 {
-    mSpartyBackImage = make_shared<wxImage>(SpartyBackImage, wxBITMAP_TYPE_PNG);
-    mSpartyBackBitmap = make_shared<wxBitmap>(*mSpartyBackImage);
-
-    mSpartyBootImage = make_shared<wxImage>(SpartyBootImage, wxBITMAP_TYPE_PNG);
-    mSpartyBootBitmap = make_shared<wxBitmap>(*mSpartyBootImage);
-
-    mSpartyFrontImage = make_shared<wxImage>(SpartyFrontImage, wxBITMAP_TYPE_PNG);
-    mSpartyFrontBitmap = make_shared<wxBitmap>(*mSpartyFrontImage);
+    auto atlas = game->GetAtlas();
+    mSpartyBackSprite = atlas->Find(SpartyBackImage);
+    mSpartyBootSprite = atlas->Find(SpartyBootImage);
+    mSpartyFrontSprite = atlas->Find(SpartyFrontImage);
 }
 
 /**
- * Loads the Sparty Game Object from the xml node
- * @param node the node that has the Sparty Information
+ * Loads the Sparty Game Object from a level being read
+ * @param parser Parser on Sparty's start element
  */
-void Sparty::XmlLoad(wxXmlNode* node)
+void Sparty::XmlLoad(XmlPullParser &parser)
 {
-    if (node == nullptr)
-    {
-        return;
-    }
-    Item::XmlLoad(node);
-
-    node->GetAttribute(L"height", L"100").ToDouble(&mHeight);
-    node->GetAttribute(L"kick-duration", L"10").ToDouble(&mKickDuration);
-    node->GetAttribute(L"kick-speed", L"1").ToDouble(&mKickSpeed);
+    Item::XmlLoad(parser);
 
-    mWidth = mHeight * (double)mSpartyBackImage->GetWidth() / (double)mSpartyBackImage->GetHeight();
+    mHeight = parser.GetDouble("height", 100);
+    mKickDuration = parser.GetDouble("kick-duration", 10);
+    mKickSpeed = parser.GetDouble("kick-speed", 1);
 
-    wxString pinCoordinates = node->GetAttribute(L"pin", L"0, 0");
     double pinX = 0, pinY = 0;
-    bool validPinParse = (wxSscanf(pinCoordinates, L"%lf, %lf", &pinX, &pinY) == 2);
-    mPinLocation = validPinParse ? wxPoint(pinX, pinY) : wxPoint(0, 0);
+    bool validPinParse = XmlPullParser::ToPair(parser.GetAttribute("pin", "0, 0"), pinX, pinY);
+    Place(validPinParse ? wxPoint(pinX, pinY) : wxPoint(0, 0));
+}
+
+/**
+ * Size Sparty and create its input pin once its attributes are loaded
+ * @param pinLocation Location of the input pin
+ */
+void Sparty::Place(wxPoint pinLocation)
+{
+    auto backSize = GetGame()->GetAtlas()->GetSize(mSpartyBackSprite);
+    mWidth = mHeight * (double)backSize.GetWidth() / (double)backSize.GetHeight();
+    mPinLocation = pinLocation;
 
     const double verticalOffset = mHeight/2;
     const double bootTipLocation = mHeight * SpartyBootPercentage;
     mYPositionOfKick = GetY() - verticalOffset + bootTipLocation;
 
-    mInput = std::make_shared<InputPin>(nullptr, mPinLocation);
-    mInput -> SetState(States::Unknown);
+    mInput = CreatePart<InputPin>(nullptr, mPinLocation);
+    Get(mInput)->SetState(States::Unknown);
+}
+
+/**
+ * Get the point Sparty's boot kicks products at
+ * @return Kick point in virtual pixels
+ */
+wxPoint2DDouble Sparty::GetKickPoint() const
+{
+    return wxPoint2DDouble(GetX() - ProductKickPointX, mYPositionOfKick);
 }
 
-std::shared_ptr<IDraggable> Sparty::GrabProductForKicking()
+/**
+ * Find the product at the point Sparty's boot kicks
+ * @return The product, or null if there is none
+ */
+IDraggable *Sparty::GrabProductForKicking()
 {
     if (GetGame() == nullptr)
     {
         return nullptr;
     }
 
-    double sensorDetectionX = GetX() - ProductKickPointX;
+    auto kickPoint = GetKickPoint();
 
-    if (sensorDetectionX < 0 || mYPositionOfKick < 0)
+    if (kickPoint.m_x < 0 || kickPoint.m_y < 0)
     {
         return nullptr;
     }
 
-    auto detectedProduct = GetGame()->HitTest(sensorDetectionX, mYPositionOfKick);
+    // Only products on Sparty's own line can be kicked
+    auto line = GetLine();
+    auto detectedProduct = line != nullptr ? line->HitTest(kickPoint.m_x, kickPoint.m_y) :
+                           GetGame()->HitTest(kickPoint.m_x, kickPoint.m_y);
 
     if (detectedProduct == nullptr)
     {
@@ -141,7 +161,7 @@ std::shared_ptr<IDraggable> Sparty::GrabProductForKicking()
  * Draws Sparty
  * @param graphics The graphics context that sparty's on
  */
-void Sparty::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Sparty::Draw(wxGraphicsContext *graphics)
 {
     if (!graphics) return;
 
@@ -149,21 +169,16 @@ void Sparty::Draw(std::shared_ptr<wxGraphicsContext> graphics)
     graphics->PushState();
     graphics->Translate(GetX(), GetY());
 
-    if (mSpartyBackBitmap->IsOk())
-        graphics->DrawBitmap(*mSpartyBackBitmap, -mWidth/2, -mHeight/2, mWidth, mHeight);
+    auto sprites = GetGame()->GetSprites();
+    sprites->Draw(graphics, mSpartyBackSprite, -mWidth/2, -mHeight/2, mWidth, mHeight);
+    sprites->Draw(graphics, mSpartyFrontSprite, -mWidth/2, -mHeight/2, mWidth, mHeight);
 
-    if (mSpartyFrontBitmap->IsOk())
-        graphics->DrawBitmap(*mSpartyFrontBitmap, -mWidth/2, -mHeight/2, mWidth, mHeight);
-
-    if (mSpartyBootBitmap->IsOk())
-    {
-        graphics->Rotate(mKickAngle);
-        graphics->DrawBitmap(*mSpartyBootBitmap, -mWidth/2, -mHeight/2, mWidth, mHeight);
-    }
+    graphics->Rotate(mKickAngle);
+    sprites->Draw(graphics, mSpartyBootSprite, -mWidth/2, -mHeight/2, mWidth, mHeight);
 
     graphics->PopState();
 
-    mInput->Draw(graphics);
+    Get(mInput)->Draw(graphics);
     //graphics->PopState();
 }
 
@@ -194,7 +209,7 @@ void Sparty::StartKickAnimation()
 void Sparty::Update(double elapsed)
 {
 
-    if (mInput->GetState() == States::One && mLastState != States::One)
+    if (Get(mInput)->GetState() == States::One && mLastState != States::One)
     {
         StartKickAnimation();
     }
@@ -203,7 +218,7 @@ void Sparty::Update(double elapsed)
     {
         UpdateKickAngle(elapsed);
     }
-    mLastState = mInput->GetState();
+    mLastState = Get(mInput)->GetState();
 }
 
 void Sparty::UpdateKickAngle(double elapsed)
@@ -246,10 +261,10 @@ void Sparty::EndKickAnimation()
  */
 bool Sparty::Connect(OutputPin *pin, wxPoint lineEnd)
 {
-    return mInput->Catch(pin, lineEnd);
+    return Get(mInput)->Catch(pin, lineEnd);
 }
 
-void Sparty::DrawWire(std::shared_ptr<wxGraphicsContext> graphics)
+void Sparty::DrawWire(wxGraphicsContext *graphics)
 {
     if (!mInput)
     {
@@ -257,11 +272,11 @@ void Sparty::DrawWire(std::shared_ptr<wxGraphicsContext> graphics)
     }
 
     wxColour connectionColor;
-    if (mInput->GetState() == States::Zero)
+    if (Get(mInput)->GetState() == States::Zero)
     {
         connectionColor = ConnectionColorZero;
     }
-    else if (mInput->GetState() == States::One)
+    else if (Get(mInput)->GetState() == States::One)
     {
         connectionColor = ConnectionColorOne;
     }
@@ -273,7 +288,7 @@ void Sparty::DrawWire(std::shared_ptr<wxGraphicsContext> graphics)
     wxPen wirePen(connectionColor, 3);  // Thickness 3 for better visibility
     graphics->SetPen(wirePen);
 
-    auto spartyPin = mInput->GetAbsoluteLocation();
+    auto spartyPin = Get(mInput)->GetAbsoluteLocation();
     int spartyX = GetX();
     int spartyY = GetY();
 
@@ -288,4 +303,38 @@ void Sparty::DrawWire(std::shared_ptr<wxGraphicsContext> graphics)
     graphics->StrokeLine(leftwardPoint.x, leftwardPoint.y, downwardPoint.x, downwardPoint.y);
     graphics->StrokeLine(downwardPoint.x, downwardPoint.y, leftwardPoint2.x, leftwardPoint2.y);
 
-}
\ No newline at end of file
+}
+
+/**
+ * Save the Sparty's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void Sparty::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Item::SaveSnapshot(snapshot);
+    snapshot.Write(mKickState);
+    snapshot.Write(mLastState);
+    snapshot.Write(mKickAngle);
+    snapshot.Write(mChangedDirection);
+    snapshot.Write(mBootRotation);
+    snapshot.Write(mPinStateFromEarlier);
+    snapshot.Write(mYPositionOfKick);
+    Get(mInput)->SaveSnapshot(snapshot);
+}
+
+/**
+ * Restore the Sparty's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Sparty::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Item::RestoreSnapshot(snapshot);
+    snapshot.Read(mKickState);
+    snapshot.Read(mLastState);
+    snapshot.Read(mKickAngle);
+    snapshot.Read(mChangedDirection);
+    snapshot.Read(mBootRotation);
+    snapshot.Read(mPinStateFromEarlier);
+    snapshot.Read(mYPositionOfKick);
+    Get(mInput)->RestoreSnapshot(snapshot);
+}
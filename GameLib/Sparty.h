@@ -9,12 +9,13 @@
 #define SPARTY_H
 
 #include "Item.h"
+#include "InputPin.h"
 
 /**
  * Objects of this class represent Sparty in the game.
  * Sparty class objects are responsible for kicking products on the conveyor belt.
  */
-class Sparty : public Item
+class Sparty final : public Item
 {
 private:
     /// the speed the products are kicked off the conveyor belt in pixels per second
@@ -22,12 +23,9 @@ private:
     /// how long it takes to complete a kick in seconds
     double mKickDuration;
 
-    std::shared_ptr<wxImage> mSpartyBackImage; ///< Image of Sparty backward.
-    std::shared_ptr<wxBitmap> mSpartyBackBitmap; ///< Bitmap for backward Sparty.
-    std::shared_ptr<wxImage> mSpartyBootImage; ///<  Image for Sparty's boot.
-    std::shared_ptr<wxBitmap> mSpartyBootBitmap; ///< Bitmap for Sparty's boot.
-    std::shared_ptr<wxImage> mSpartyFrontImage; ///< Image of Spary forward.
-    std::shared_ptr<wxBitmap> mSpartyFrontBitmap; ///< Bitmap for Sparty forward.
+    int mSpartyBackSprite = -1; ///< Sprite of Sparty backward.
+    int mSpartyBootSprite = -1; ///< Sprite for Sparty's boot.
+    int mSpartyFrontSprite = -1; ///< Sprite of Sparty forward.
 
     /// Height of Sparty.
     double mHeight;
@@ -59,20 +57,25 @@ private:
     double mYPositionOfKick;
 
     /// Pointer to Sparty's input pin.
-    std::shared_ptr<InputPin> mInput;
+    ArenaHandle<InputPin> mInput;
+
+    void Place(wxPoint pinLocation);
 
 public:
     Sparty(Game* game);
-    void XmlLoad(wxXmlNode* node) override;
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void XmlLoad(XmlPullParser &parser) override;
+    void Draw(wxGraphicsContext *graphics) override;
     void OnClick(double x, double y) override;
     void Update(double elapsed) override;
+    void SaveSnapshot(GameSnapshot &snapshot) const override;
+    void RestoreSnapshot(GameSnapshot &snapshot) override;
 
     /**
      * Grab product to kick.
-     * @return shared pointer of draggable object (product).
+     * @return Draggable object (product), or nullptr if none.
      */
-    std::shared_ptr<IDraggable> GrabProductForKicking();
+    IDraggable *GrabProductForKicking();
+    wxPoint2DDouble GetKickPoint() const;
 
     /**
      * Accept a visitor
@@ -82,11 +85,17 @@ public:
 
     bool Connect(OutputPin *pin, wxPoint lineEnd) override;
 
+    /**
+     * Get Sparty's input pin
+     * @return The pin, nullptr until loaded
+     */
+    InputPin *GetInputPin() const { return Get(mInput); }
+
     /**
      * Draws wire connected to Sparty.
      * @param graphics graphics context to draw on
      */
-    void DrawWire(std::shared_ptr<wxGraphicsContext> graphics);
+    void DrawWire(wxGraphicsContext *graphics);
 
     /**
      * Starts kick animation.
@@ -0,0 +1,438 @@
+/**
+ * @file SpriteAtlas.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "SpriteAtlas.h"
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+using namespace std;
+
+/// The eight bytes every PNG file starts with
+const char PngSignature[] = "\x89PNG\r\n\x1a\n";
+
+/**
+ * List the PNG files in a directory
+ * @param directory Directory holding the images
+ * @return Paths of the files, sorted
+ */
+static wxArrayString PngFiles(const wxString &directory)
+{
+    wxArrayString files;
+    if (wxDirExists(directory))
+    {
+        wxDir::GetAllFiles(directory, &files, L"*.png", wxDIR_FILES);
+    }
+    files.Sort();
+    return files;
+}
+
+/**
+ * Read the size of a PNG image from its header, without decoding it
+ * @param filename PNG file
+ * @param size Receives the width and height
+ * @return True if the file starts with a PNG header
+ */
+static bool ReadPngSize(const wxString &filename, wxSize &size)
+{
+    // Signature, then the IHDR chunk's length and type, then width and height
+    unsigned char header[24];
+    ifstream in(filename.fn_str(), ios::binary);
+    if (!in.read((char *)header, sizeof(header)) || memcmp(header, PngSignature, 8) != 0 ||
+        memcmp(header + 12, "IHDR", 4) != 0)
+    {
+        return false;
+    }
+
+    auto bigEndian = [&header](int at) {
+        return (int)((uint32_t)header[at] << 24 | (uint32_t)header[at + 1] << 16 | (uint32_t)header[at + 2] << 8 |
+                     header[at + 3]);
+    };
+    size = wxSize(bigEndian(16), bigEndian(20));
+    return size.GetWidth() > 0 && size.GetHeight() > 0;
+}
+
+/**
+ * Destructor. Waits for the images to finish decoding.
+ */
+SpriteAtlas::~SpriteAtlas()
+{
+    Wait();
+}
+
+/**
+ * Decode every PNG in a directory and pack them
+ * @param directory Directory holding the images, such as images
+ * @return True if any image was found
+ */
+bool SpriteAtlas::Build(const wxString &directory)
+{
+    auto images = Decode(directory);
+    Pack(images);
+    return !images.empty();
+}
+
+/**
+ * Lay out every PNG in a directory from the sizes in their headers,
+ * then decode and pack them on a worker thread. Sprites can be found
+ * and measured as soon as this returns; they are drawn once decoded.
+ * @param directory Directory holding the images, such as images
+ */
+void SpriteAtlas::Load(const wxString &directory)
+{
+    Wait();
+
+    vector<pair<wstring, wxSize>> sizes;
+    wxArrayString files;
+    for (const auto &file : PngFiles(directory))
+    {
+        wxSize size;
+        if (ReadPngSize(file, size))
+        {
+            sizes.emplace_back(wxFileName(file).GetFullName().ToStdWstring(), size);
+            files.Add(file);
+        }
+    }
+    Layout(sizes);
+
+    mDecoded.store(false, memory_order_release);
+    mDecoding = async(launch::async, [this, sizes, files] {
+        vector<pair<wstring, wxImage>> images;
+        for (size_t i = 0; i < sizes.size(); i++)
+        {
+            wxImage image;
+            image.LoadFile(files[i], wxBITMAP_TYPE_PNG);
+            images.emplace_back(sizes[i].first, image);
+        }
+        Fill(images);
+        mDecoded.store(true, memory_order_release);
+    });
+}
+
+/**
+ * Wait for the images Load started decoding. Returns at once if
+ * they are decoded, or if the atlas was built some other way.
+ */
+void SpriteAtlas::Wait() const
+{
+    if (mDecoding.valid())
+    {
+        mDecoding.wait();
+    }
+}
+
+/**
+ * Decode every PNG in a directory. Safe to call off the UI thread.
+ * @param directory Directory holding the images
+ * @return Images and their file names, sorted by name
+ */
+vector<pair<wstring, wxImage>> SpriteAtlas::Decode(const wxString &directory)
+{
+    vector<pair<wstring, wxImage>> images;
+    for (const auto &file : PngFiles(directory))
+    {
+        wxImage image;
+        if (image.LoadFile(file, wxBITMAP_TYPE_PNG))
+        {
+            images.emplace_back(wxFileName(file).GetFullName().ToStdWstring(), image);
+        }
+    }
+    return images;
+}
+
+/**
+ * Decode and pack a directory's images again, keeping every sprite of
+ * this atlas at its index. Reads only the decoded images, so it may
+ * run on another thread while the game draws.
+ * @param directory Directory holding the images
+ * @return New atlas, to Swap into this one
+ */
+unique_ptr<SpriteAtlas> SpriteAtlas::Rebuild(const wxString &directory) const
+{
+    vector<pair<wstring, wxImage>> images(mSprites.size());
+    for (const auto &name : mNames)
+    {
+        images[name.second].first = name.first;
+    }
+
+    for (auto &image : Decode(directory))
+    {
+        auto found = mNames.find(image.first);
+        if (found != mNames.end())
+        {
+            images[found->second].second = image.second;
+        }
+        else
+        {
+            images.push_back(image);
+        }
+    }
+
+    // A sprite whose file is gone is left transparent
+    for (auto &image : images)
+    {
+        if (!image.second.IsOk())
+        {
+            image.second = wxImage(1, 1);
+            image.second.InitAlpha();
+            image.second.SetAlpha(0, 0, 0);
+        }
+    }
+
+    auto atlas = make_unique<SpriteAtlas>();
+    atlas->Pack(images);
+    return atlas;
+}
+
+/**
+ * Exchange images with another atlas. Both change version, so views
+ * drawing either make their bitmaps again from the new pages.
+ * @param other Atlas to exchange with, usually one made by Rebuild
+ */
+void SpriteAtlas::Swap(SpriteAtlas &other)
+{
+    Wait();
+    other.Wait();
+
+    mPages.swap(other.mPages);
+    mPageSizes.swap(other.mPageSizes);
+    mSprites.swap(other.mSprites);
+    mNames.swap(other.mNames);
+
+    mVersion++;
+    other.mVersion++;
+}
+
+/**
+ * Pack images onto pages, replacing whatever the atlas held
+ * @param images Images and the file names they are found by
+ */
+void SpriteAtlas::Pack(const vector<pair<wstring, wxImage>> &images)
+{
+    Wait();
+
+    vector<pair<wstring, wxSize>> sizes;
+    for (const auto &image : images)
+    {
+        sizes.emplace_back(image.first, image.second.GetSize());
+    }
+    Layout(sizes);
+    Fill(images);
+}
+
+/**
+ * Decide where each sprite goes, replacing whatever the atlas held
+ * @param sizes Sizes of the images and the file names they are found by
+ */
+void SpriteAtlas::Layout(const vector<pair<wstring, wxSize>> &sizes)
+{
+    mPages.clear();
+    mPageSizes.clear();
+    mSprites.assign(sizes.size(), Sprite());
+    mNames.clear();
+    mVersion++;
+
+    // Tallest first, so each row wastes little height
+    vector<int> order(sizes.size());
+    for (size_t i = 0; i < sizes.size(); i++)
+    {
+        order[i] = (int)i;
+        mNames[sizes[i].first] = (int)i;
+    }
+    stable_sort(order.begin(), order.end(), [&sizes](int a, int b) {
+        return sizes[a].second.GetHeight() > sizes[b].second.GetHeight();
+    });
+
+    // Place each sprite in the current row, starting a row or a page when it does not fit
+    int x = 0;
+    int rowY = 0;
+    int rowHeight = 0;
+    for (auto i : order)
+    {
+        int width = sizes[i].second.GetWidth();
+        int height = sizes[i].second.GetHeight();
+
+        bool oversized = width + 2 * Gutter > PageSize || height + 2 * Gutter > PageSize;
+        if (!mPageSizes.empty() && !oversized && x + width + 2 * Gutter > PageSize)
+        {
+            rowY += rowHeight + Gutter;
+            x = 0;
+            rowHeight = 0;
+        }
+        if (mPageSizes.empty() || oversized || rowY + height + 2 * Gutter > PageSize)
+        {
+            // An image larger than a page gets a page of its own
+            mPageSizes.emplace_back(0, 0);
+            x = 0;
+            rowY = 0;
+            rowHeight = 0;
+        }
+
+        auto &sprite = mSprites[i];
+        sprite.mPage = (int)mPageSizes.size() - 1;
+        sprite.mRect = wxRect(x + Gutter, rowY + Gutter, width, height);
+
+        auto &pageSize = mPageSizes.back();
+        pageSize.SetWidth(max(pageSize.GetWidth(), sprite.mRect.GetRight() + 1 + Gutter));
+        pageSize.SetHeight(max(pageSize.GetHeight(), sprite.mRect.GetBottom() + 1 + Gutter));
+
+        x += width + Gutter;
+        rowHeight = max(rowHeight, height);
+        if (oversized)
+        {
+            // Nothing shares its page
+            x = PageSize;
+            rowY = PageSize;
+        }
+    }
+}
+
+/**
+ * Make the pages and copy the images onto them where Layout put them
+ * @param images Images in the order they were laid out. One that did
+ * not decode is left transparent, and one whose size changed since it
+ * was laid out is resized to fit.
+ */
+void SpriteAtlas::Fill(const vector<pair<wstring, wxImage>> &images)
+{
+    vector<wxImage> pages;
+    for (const auto &size : mPageSizes)
+    {
+        wxImage page(size.GetWidth(), size.GetHeight(), true);
+        page.SetAlpha();
+        memset(page.GetAlpha(), 0, (size_t)size.GetWidth() * size.GetHeight());
+        pages.push_back(page);
+    }
+
+    // Copy each image onto its page, with transparency as alpha
+    for (size_t i = 0; i < images.size() && i < mSprites.size(); i++)
+    {
+        const auto &rect = mSprites[i].mRect;
+        if (!images[i].second.IsOk())
+        {
+            continue;
+        }
+
+        wxImage image = images[i].second.GetSize() == rect.GetSize() ?
+                images[i].second.Copy() : images[i].second.Scale(rect.GetWidth(), rect.GetHeight());
+        if (!image.HasAlpha())
+        {
+            image.InitAlpha();
+        }
+
+        auto &page = pages[mSprites[i].mPage];
+        int pageWidth = page.GetWidth();
+        for (int row = 0; row < rect.GetHeight(); row++)
+        {
+            size_t to = (size_t)(rect.GetY() + row) * pageWidth + rect.GetX();
+            size_t from = (size_t)row * rect.GetWidth();
+            memcpy(page.GetData() + to * 3, image.GetData() + from * 3, (size_t)rect.GetWidth() * 3);
+            memcpy(page.GetAlpha() + to, image.GetAlpha() + from, (size_t)rect.GetWidth());
+        }
+    }
+
+    mPages.swap(pages);
+}
+
+/**
+ * Find a sprite by the file it was loaded from
+ * @param filename File name, with or without its directory
+ * @return Sprite index, or -1 if there is no such sprite
+ */
+int SpriteAtlas::Find(const wstring &filename) const
+{
+    auto found = mNames.find(wxFileName(filename).GetFullName().ToStdWstring());
+    return found != mNames.end() ? found->second : -1;
+}
+
+/**
+ * Get the size of a sprite
+ * @param sprite Sprite index
+ * @return Size of the image in pixels, or 0 by 0 if there is no such sprite
+ */
+wxSize SpriteAtlas::GetSize(int sprite) const
+{
+    if (sprite < 0 || sprite >= (int)mSprites.size())
+    {
+        return wxSize(0, 0);
+    }
+    return mSprites[sprite].mRect.GetSize();
+}
+
+/**
+ * Is a pixel of a sprite transparent?
+ * @param sprite Sprite index
+ * @param x X in the image, from its left
+ * @param y Y in the image, from its top
+ * @return True if the pixel is transparent or outside the sprite
+ */
+bool SpriteAtlas::IsTransparent(int sprite, int x, int y) const
+{
+    if (sprite < 0 || sprite >= (int)mSprites.size())
+    {
+        return true;
+    }
+
+    const auto &rect = mSprites[sprite].mRect;
+    if (x < 0 || y < 0 || x >= rect.GetWidth() || y >= rect.GetHeight())
+    {
+        return true;
+    }
+
+    Wait();
+    return mPages[mSprites[sprite].mPage].IsTransparent(rect.GetX() + x, rect.GetY() + y);
+}
+
+/**
+ * Resample a sprite to a size
+ * @param sprite Sprite index
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @return Resampled image, with alpha
+ */
+wxImage SpriteAtlas::ScaleSprite(int sprite, int width, int height) const
+{
+    Wait();
+    const auto &where = mSprites[sprite];
+    return mPages[where.mPage].GetSubImage(where.mRect).Scale(width, height, wxIMAGE_QUALITY_HIGH);
+}
+
+/**
+ * Get a page of the atlas, waiting for it to be decoded
+ * @param page Page index
+ * @return Decoded page
+ */
+const wxImage &SpriteAtlas::GetPage(int page) const
+{
+    Wait();
+    return mPages[page];
+}
+
+/**
+ * Get the atlas of a directory's images, loading it if no game holds it.
+ * The images are decoded on a worker thread; see Load.
+ * @param directory Directory holding the images
+ * @return The atlas, shared with every other game using the directory
+ */
+shared_ptr<SpriteAtlas> SpriteAtlas::Shared(const wxString &directory)
+{
+    static mutex atlasesMutex;
+    static map<wstring, weak_ptr<SpriteAtlas>> atlases;
+
+    lock_guard<mutex> lock(atlasesMutex);
+    auto &held = atlases[directory.ToStdWstring()];
+    auto atlas = held.lock();
+    if (atlas == nullptr)
+    {
+        atlas = make_shared<SpriteAtlas>();
+        atlas->Load(directory);
+        held = atlas;
+    }
+    return atlas;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file SpriteAtlas.h
+ * @author matthew vazquez
+ *
+ * Every sprite image packed into a few large pages.
+ */
+
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/graphics.h>
+
+/**
+ * Every sprite image packed into a few large pages.
+ *
+ * Build decodes every PNG in a directory and packs them onto pages of
+ * at most PageSize pixels square, tallest first in rows, with a
+ * transparent gutter so filtering at a sprite's edge never picks up
+ * its neighbor. The game's images fit on one page.
+ *
+ * Load lays the sprites out from the sizes in the PNG headers and
+ * decodes the images on a worker thread, so a game can start and draw
+ * before its images are ready; until they are, sprites are not drawn.
+ * Anything that reads pixels waits for them.
+ *
+ * Items look sprites up by file name once, then draw them by index
+ * through their game's SpriteView, which holds the bitmaps, scale and
+ * resampled copies drawing makes. The atlas holds only the decoded
+ * images, which drawing never changes.
+ *
+ * Games share the atlas for a directory through Shared; it is freed
+ * once no game holds it. When the images change, Rebuild decodes and
+ * packs them into a new atlas, off the UI thread if need be, with
+ * every sprite at the index it has in this one, and Swap puts the new
+ * images in place so items draw them without finding their sprites
+ * again. Swap changes the version, so every view makes its bitmaps
+ * again; call it on the UI thread, while no game draws elsewhere.
+ */
+class SpriteAtlas
+{
+public:
+    /// Largest page width and height in pixels
+    static const int PageSize = 2048;
+
+    /// Transparent pixels between sprites on a page
+    static const int Gutter = 2;
+
+private:
+    /**
+     * Where a sprite is in the atlas
+     */
+    struct Sprite
+    {
+        /// Page the sprite is on
+        int mPage = 0;
+
+        /// Area of the page the sprite covers
+        wxRect mRect;
+    };
+
+    /// Decoded pages
+    std::vector<wxImage> mPages;
+
+    /// Size of each page, known before it is decoded
+    std::vector<wxSize> mPageSizes;
+
+    /// Sprites, in the order of their names
+    std::vector<Sprite> mSprites;
+
+    /// Sprite index by file name, such as beam-red.png
+    std::map<std::wstring, int> mNames;
+
+    /// Changes whenever the images are laid out or swapped
+    int mVersion = 0;
+
+    /// Decoding started by Load, invalid if the atlas was packed directly
+    std::future<void> mDecoding;
+
+    /// True once the pages are decoded, so Draw can check without waiting
+    std::atomic<bool> mDecoded{true};
+
+    void Layout(const std::vector<std::pair<std::wstring, wxSize>> &sizes);
+    void Fill(const std::vector<std::pair<std::wstring, wxImage>> &images);
+
+public:
+    SpriteAtlas() = default;
+    ~SpriteAtlas();
+
+    /// Copy constructor (disabled)
+    SpriteAtlas(const SpriteAtlas &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SpriteAtlas &) = delete;
+
+    bool Build(const wxString &directory);
+    void Load(const wxString &directory);
+    void Wait() const;
+    void Pack(const std::vector<std::pair<std::wstring, wxImage>> &images);
+    std::unique_ptr<SpriteAtlas> Rebuild(const wxString &directory) const;
+    void Swap(SpriteAtlas &other);
+
+    static std::vector<std::pair<std::wstring, wxImage>> Decode(const wxString &directory);
+
+    int Find(const std::wstring &filename) const;
+    wxSize GetSize(int sprite) const;
+    bool IsTransparent(int sprite, int x, int y) const;
+    wxImage ScaleSprite(int sprite, int width, int height) const;
+
+    /**
+     * Get the page a sprite is on
+     * @param sprite Sprite index
+     * @return Page index
+     */
+    int GetPageOf(int sprite) const { return mSprites[sprite].mPage; }
+
+    /**
+     * Get the area of its page a sprite covers
+     * @param sprite Sprite index
+     * @return Area in page pixels
+     */
+    const wxRect &GetRect(int sprite) const { return mSprites[sprite].mRect; }
+
+    /**
+     * Get the version of the images, so bitmaps made from them can be
+     * made again when they change
+     * @return Version, changed by Load, Pack and Swap
+     */
+    int GetVersion() const { return mVersion; }
+
+    static std::shared_ptr<SpriteAtlas> Shared(const wxString &directory);
+
+    /**
+     * Get the number of pages
+     * @return Pages the sprites are packed onto
+     */
+    int GetNumPages() const { return (int)mPageSizes.size(); }
+
+    /**
+     * Get the number of sprites
+     * @return Sprites in the atlas
+     */
+    int GetNumSprites() const { return (int)mSprites.size(); }
+
+    /**
+     * Are the images decoded?
+     * @return True once sprites can be drawn
+     */
+    bool IsDecoded() const { return mDecoded.load(std::memory_order_acquire); }
+
+    const wxImage &GetPage(int page) const;
+};
+
+#endif //SPRITEATLAS_H
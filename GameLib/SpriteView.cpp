@@ -0,0 +1,99 @@
+/**
+ * @file SpriteView.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "SpriteView.h"
+#include "SpriteAtlas.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param atlas Images to draw, usually shared with other games
+ */
+SpriteView::SpriteView(shared_ptr<SpriteAtlas> atlas) : mAtlas(move(atlas))
+{
+}
+
+/**
+ * Set the view scale sprites are drawn under, so Draw can resample them
+ * once for it rather than on every frame
+ * @param scale Scale from sizes passed to Draw to device pixels
+ */
+void SpriteView::SetScale(double scale)
+{
+    if (scale != mScale)
+    {
+        mScale = scale;
+        mScaledSprites.clear();
+    }
+}
+
+/**
+ * Draw a sprite, like wxGraphicsContext::DrawBitmap. Nothing is drawn
+ * until the atlas's images are decoded.
+ *
+ * The sprite covers width by height scaled by the view scale on screen.
+ * If that is not its own size, a copy resampled to it is drawn.
+ * @param graphics Graphics context to draw on
+ * @param sprite Sprite index; nothing is drawn if there is no such sprite
+ * @param x Left of the sprite
+ * @param y Top of the sprite
+ * @param width Width to draw the sprite
+ * @param height Height to draw the sprite
+ */
+void SpriteView::Draw(wxGraphicsContext *graphics, int sprite, wxDouble x, wxDouble y, wxDouble width,
+                      wxDouble height)
+{
+    if (sprite < 0 || sprite >= mAtlas->GetNumSprites())
+    {
+        return;
+    }
+
+    // Sprites are not drawn until Load has decoded them
+    if (!mAtlas->IsDecoded())
+    {
+        return;
+    }
+
+    // Bitmaps belong to the renderer that created them and the images they were made from
+    if (graphics->GetRenderer() != mRenderer || mAtlas->GetVersion() != mVersion)
+    {
+        mRenderer = graphics->GetRenderer();
+        mVersion = mAtlas->GetVersion();
+        mGraphicsPages.assign(mAtlas->GetNumPages(), wxGraphicsBitmap());
+        mGraphicsSprites.assign(mAtlas->GetNumSprites(), wxGraphicsBitmap());
+        mScaledSprites.clear();
+    }
+
+    auto rect = mAtlas->GetRect(sprite);
+    int deviceWidth = wxRound(width * mScale);
+    int deviceHeight = wxRound(height * mScale);
+    if (deviceWidth > 0 && deviceHeight > 0 &&
+        (deviceWidth != rect.GetWidth() || deviceHeight != rect.GetHeight()))
+    {
+        auto &scaled = mScaledSprites[make_tuple(sprite, deviceWidth, deviceHeight)];
+        if (scaled.IsNull())
+        {
+            scaled = graphics->CreateBitmapFromImage(mAtlas->ScaleSprite(sprite, deviceWidth, deviceHeight));
+        }
+        graphics->DrawBitmap(scaled, x, y, width, height);
+        return;
+    }
+
+    auto &bitmap = mGraphicsSprites[sprite];
+    if (bitmap.IsNull())
+    {
+        int pageIndex = mAtlas->GetPageOf(sprite);
+        auto &page = mGraphicsPages[pageIndex];
+        if (page.IsNull())
+        {
+            page = graphics->CreateBitmapFromImage(mAtlas->GetPage(pageIndex));
+        }
+        bitmap = graphics->CreateSubBitmap(page, rect.GetX(), rect.GetY(), rect.GetWidth(), rect.GetHeight());
+    }
+
+    graphics->DrawBitmap(bitmap, x, y, width, height);
+}
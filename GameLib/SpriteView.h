@@ -0,0 +1,96 @@
+/**
+ * @file SpriteView.h
+ * @author matthew vazquez
+ *
+ * One game's view of the sprite atlas, holding what it draws with.
+ */
+
+#ifndef SPRITEVIEW_H
+#define SPRITEVIEW_H
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <wx/graphics.h>
+
+class SpriteAtlas;
+
+/**
+ * One game's view of the sprite atlas, holding what it draws with.
+ *
+ * Games share the decoded images of a SpriteAtlas, which drawing never
+ * changes. Everything drawing makes is kept here, one view per game,
+ * so games can draw at once on different threads:
+ *
+ * Draw uploads each page to the graphics renderer the first time it
+ * is drawn with and makes each sprite a sub-bitmap of its page, so
+ * the backend holds a few large bitmaps rather than one per image and
+ * per item. Those are kept until a different renderer draws or the
+ * atlas's images are swapped, so draw a view from one thread only.
+ *
+ * The game draws under its view scale, so a sprite drawn from the page
+ * is resampled by the backend on every frame. SetScale tells the view
+ * that scale; Draw then keeps a copy of each sprite resampled once to
+ * the size it covers on screen and blits it 1:1. The copies are thrown
+ * away when the scale changes, which happens when the window is resized.
+ */
+class SpriteView
+{
+private:
+    /// Images this view draws
+    std::shared_ptr<SpriteAtlas> mAtlas;
+
+    /// Version of the atlas's images the bitmaps were made from
+    int mVersion = -1;
+
+    /// Renderer the graphics bitmaps were created for
+    wxGraphicsRenderer *mRenderer = nullptr;
+
+    /// Pages uploaded to mRenderer, null until drawn
+    std::vector<wxGraphicsBitmap> mGraphicsPages;
+
+    /// Sprites as sub-bitmaps of their uploaded page, null until drawn
+    std::vector<wxGraphicsBitmap> mGraphicsSprites;
+
+    /// View scale sprites are drawn under
+    double mScale = 1;
+
+    /// Sprites resampled for mScale and mRenderer, by sprite and size in device pixels
+    std::map<std::tuple<int, int, int>, wxGraphicsBitmap> mScaledSprites;
+
+public:
+    explicit SpriteView(std::shared_ptr<SpriteAtlas> atlas);
+
+    /// Default constructor (disabled)
+    SpriteView() = delete;
+
+    /// Copy constructor (disabled)
+    SpriteView(const SpriteView &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SpriteView &) = delete;
+
+    void Draw(wxGraphicsContext *graphics, int sprite, wxDouble x, wxDouble y, wxDouble width, wxDouble height);
+    void SetScale(double scale);
+
+    /**
+     * Get the images this view draws
+     * @return Shared atlas
+     */
+    SpriteAtlas *GetAtlas() const { return mAtlas.get(); }
+
+    /**
+     * Get the view scale sprites are drawn under
+     * @return Scale set by SetScale
+     */
+    double GetScale() const { return mScale; }
+
+    /**
+     * Get the number of sprites resampled for the view scale
+     * @return Resampled copies kept
+     */
+    int GetNumScaled() const { return (int)mScaledSprites.size(); }
+};
+
+#endif //SPRITEVIEW_H
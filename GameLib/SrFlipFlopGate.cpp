@@ -36,15 +36,15 @@ SrFlipFlopGate::SrFlipFlopGate(Game *game) : Gates(game)
     wxPoint pointC(x + w/2,y - h/4);
     wxPoint pointD(x + w/2,y + h/4);
 
-    mInputA = std::make_shared<InputPin>(this, pointA);
-    mInputB = std::make_shared<InputPin>(this,pointB);
-    mOutputA = std::make_shared<OutputPin>(this, pointC);
-    mOutputB = std::make_shared<OutputPin>(this, pointD);
-
-    mInputA -> SetState(States::Unknown);
-    mInputB -> SetState(States::Unknown);
-    mOutputA -> SetState(States::Zero);
-    mOutputB -> SetState(States::One);
+    mInputA = CreatePart<InputPin>(this, pointA);
+    mInputB = CreatePart<InputPin>(this,pointB);
+    mOutputA = CreatePart<OutputPin>(this, pointC);
+    mOutputB = CreatePart<OutputPin>(this, pointD);
+
+    Get(mInputA)->SetState(States::Unknown);
+    Get(mInputB)->SetState(States::Unknown);
+    Get(mOutputA)->SetState(States::Zero);
+    Get(mOutputB)->SetState(States::One);
 }
 
 /**
@@ -54,23 +54,23 @@ SrFlipFlopGate::SrFlipFlopGate(Game *game) : Gates(game)
  * If both are true, input is invalid, set to unknown.
  */
 void SrFlipFlopGate::ComputeOutput() {
-    States S = mInputA->GetState();
-    States R = mInputB->GetState();
+    States S = Get(mInputA)->GetState();
+    States R = Get(mInputB)->GetState();
 
     if (S == States::One && R == States::One) // Invalid inputs.
     {
-        mOutputA->SetState(States::Unknown);
-        mOutputB->SetState(States::Unknown);
+        Get(mOutputA)->SetState(States::Unknown);
+        Get(mOutputB)->SetState(States::Unknown);
     }
     else if (S == States::One) // Sets output to true.
     {
-        mOutputA->SetState(States::One);
-        mOutputB->SetState(States::Zero);
+        Get(mOutputA)->SetState(States::One);
+        Get(mOutputB)->SetState(States::Zero);
     }
     else if (R == States::One) // Resetting the output.
     {
-        mOutputA->SetState(States::Zero);
-        mOutputB->SetState(States::One);
+        Get(mOutputA)->SetState(States::Zero);
+        Get(mOutputB)->SetState(States::One);
     }
     //If both are zero, no change.
 }
@@ -79,14 +79,14 @@ void SrFlipFlopGate::ComputeOutput() {
  * Draws or gate
  * @param graphics Graphics context to draw on
  */
-void SrFlipFlopGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
+void SrFlipFlopGate::Draw(wxGraphicsContext *graphics) {
     // Create a path to draw the gate shape
     auto path = graphics->CreatePath();
 
-    mInputA->Draw(graphics);
-    mInputB->Draw(graphics);
-    mOutputA->Draw(graphics);
-    mOutputB->Draw(graphics);
+    Get(mInputA)->Draw(graphics);
+    Get(mInputB)->Draw(graphics);
+    Get(mOutputA)->Draw(graphics);
+    Get(mOutputB)->Draw(graphics);
 
     // Get the location and size
     auto x = GetX();
@@ -116,8 +116,8 @@ void SrFlipFlopGate::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
  */
 void SrFlipFlopGate::Update(double elapsed)
 {
-    mOutputA->Update();
-    mOutputB->Update();
+    Get(mOutputA)->Update();
+    Get(mOutputB)->Update();
     ComputeOutput(); // Recompute the output on each update
 }
 
@@ -157,15 +157,15 @@ double SrFlipFlopGate::getHeight()
  * @param y Y location clicked on
  * @return Whatever we clicked on or NULL if none
  */
-std::shared_ptr<IDraggable> SrFlipFlopGate::HitDraggable(int x, int y)
+IDraggable *SrFlipFlopGate::HitDraggable(int x, int y)
 {
-    if(mOutputA->HitTest(x, y))
+    if(Get(mOutputA)->HitTest(x, y))
     {
-        return mOutputA;
+        return Get(mOutputA);
     }
-    if (mOutputB->HitTest(x, y))
+    if (Get(mOutputB)->HitTest(x, y))
     {
-        return mOutputB;
+        return Get(mOutputB);
     }
 
     return nullptr;
@@ -180,5 +180,33 @@ std::shared_ptr<IDraggable> SrFlipFlopGate::HitDraggable(int x, int y)
  */
 bool SrFlipFlopGate::Connect(OutputPin *pin, wxPoint lineEnd)
 {
-    return mInputA->Catch(pin, lineEnd) || mInputB->Catch(pin, lineEnd);
-}
\ No newline at end of file
+    return Get(mInputA)->Catch(pin, lineEnd) || Get(mInputB)->Catch(pin, lineEnd);
+}
+
+/**
+ * Save the flip flop's state to a snapshot
+ * @param snapshot Snapshot to append to
+ */
+void SrFlipFlopGate::SaveSnapshot(GameSnapshot &snapshot) const
+{
+    Gates::SaveSnapshot(snapshot);
+    snapshot.Write(mNotOutput);
+    Get(mInputA)->SaveSnapshot(snapshot);
+    Get(mInputB)->SaveSnapshot(snapshot);
+    Get(mOutputA)->SaveSnapshot(snapshot);
+    Get(mOutputB)->SaveSnapshot(snapshot);
+}
+
+/**
+ * Restore the flip flop's state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void SrFlipFlopGate::RestoreSnapshot(GameSnapshot &snapshot)
+{
+    Gates::RestoreSnapshot(snapshot);
+    snapshot.Read(mNotOutput);
+    Get(mInputA)->RestoreSnapshot(snapshot);
+    Get(mInputB)->RestoreSnapshot(snapshot);
+    Get(mOutputA)->RestoreSnapshot(snapshot);
+    Get(mOutputB)->RestoreSnapshot(snapshot);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file TaskGraph.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "TaskGraph.h"
+#include <algorithm>
+#include "WorkStealingPool.h"
+
+/**
+ * Add a task with no dependencies
+ * @param task Work to do each time the graph runs
+ * @return Index of the task, for adding dependencies
+ */
+int TaskGraph::Add(std::function<void()> task)
+{
+    auto added = std::make_unique<Task>();
+    added->mRun = std::move(task);
+    mTasks.push_back(std::move(added));
+    return (int)mTasks.size() - 1;
+}
+
+/**
+ * Make a task wait for another to finish
+ * @param task Index of the task that waits
+ * @param dependency Index of an earlier task it waits for
+ */
+void TaskGraph::AddDependency(int task, int dependency)
+{
+    auto &successors = mTasks[dependency]->mSuccessors;
+    if (std::find(successors.begin(), successors.end(), task) == successors.end())
+    {
+        successors.push_back(task);
+        mTasks[task]->mNumDependencies++;
+    }
+}
+
+/**
+ * Does a task wait for another, directly or through other tasks?
+ * @param task Index of the task that may wait
+ * @param dependency Index of the task it may wait for
+ * @return True if the task never starts before the other finishes
+ */
+bool TaskGraph::Waits(int task, int dependency) const
+{
+    // Successors always come later, so only tasks up to task are searched
+    std::vector<bool> reached(mTasks.size(), false);
+    std::vector<int> pending{dependency};
+    while (!pending.empty())
+    {
+        int next = pending.back();
+        pending.pop_back();
+        for (int successor : mTasks[next]->mSuccessors)
+        {
+            if (successor == task)
+            {
+                return true;
+            }
+            if (successor < task && !reached[successor])
+            {
+                reached[successor] = true;
+                pending.push_back(successor);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Run every task once, waiting for them all to finish
+ * @param pool Pool to run the tasks on, or null to run them in the
+ * order added on this thread. Must not be called from a task
+ * running on the pool.
+ */
+void TaskGraph::Run(WorkStealingPool *pool)
+{
+    if (pool == nullptr || mTasks.size() < 2)
+    {
+        for (auto &task : mTasks)
+        {
+            task->mRun();
+        }
+        return;
+    }
+
+    for (auto &task : mTasks)
+    {
+        task->mRemaining = task->mNumDependencies;
+    }
+
+    for (int i = 0; i < (int)mTasks.size(); i++)
+    {
+        if (mTasks[i]->mNumDependencies == 0)
+        {
+            Start(*pool, i);
+        }
+    }
+
+    pool->Wait();
+}
+
+/**
+ * Submit a task whose dependencies have all finished
+ * @param pool Pool to run the task on
+ * @param task Index of the task
+ */
+void TaskGraph::Start(WorkStealingPool &pool, int task)
+{
+    pool.Submit([this, &pool, task] {
+        mTasks[task]->mRun();
+
+        // The last dependency to finish starts each successor
+        for (int successor : mTasks[task]->mSuccessors)
+        {
+            if (--mTasks[successor]->mRemaining == 0)
+            {
+                Start(pool, successor);
+            }
+        }
+    });
+}
@@ -0,0 +1,73 @@
+/**
+ * @file TaskGraph.h
+ * @author matthew vazquez
+ *
+ * Tasks with dependencies between them, run again and again on a
+ * WorkStealingPool.
+ */
+
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class WorkStealingPool;
+
+/**
+ * Tasks with dependencies between them, run again and again on a
+ * WorkStealingPool.
+ *
+ * A task may only depend on tasks added before it, so the order the
+ * tasks were added in is always an order they can run in. The graph
+ * is built once and run as many times as needed. Each run starts the
+ * tasks with no dependencies, and each task that finishes starts the
+ * tasks waiting only on it.
+ */
+class TaskGraph
+{
+private:
+    /**
+     * One task and the tasks waiting on it
+     */
+    struct Task
+    {
+        /// The work to do
+        std::function<void()> mRun;
+
+        /// Tasks that depend on this one
+        std::vector<int> mSuccessors;
+
+        /// Number of tasks this one depends on
+        int mNumDependencies = 0;
+
+        /// Dependencies not yet finished in the current run
+        std::atomic<int> mRemaining{0};
+    };
+
+    /// Tasks in the order added
+    std::vector<std::unique_ptr<Task>> mTasks;
+
+    void Start(WorkStealingPool &pool, int task);
+
+public:
+    int Add(std::function<void()> task);
+    void AddDependency(int task, int dependency);
+    void Run(WorkStealingPool *pool);
+    bool Waits(int task, int dependency) const;
+
+    /**
+     * Remove every task
+     */
+    void Clear() { mTasks.clear(); }
+
+    /**
+     * Get the number of tasks
+     * @return Number of tasks
+     */
+    int GetNumTasks() const { return (int)mTasks.size(); }
+};
+
+#endif //TASKGRAPH_H
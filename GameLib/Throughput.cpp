@@ -0,0 +1,79 @@
+/**
+ * @file Throughput.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "Throughput.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Forget everything measured
+ */
+void Throughput::Clear()
+{
+    mBuckets.fill(0);
+    mBucket = 0;
+    mBucketTime = 0;
+    mTime = 0;
+    mTotal = 0;
+}
+
+/**
+ * Count products sorted during the second in progress
+ * @param count Number of products
+ */
+void Throughput::Add(int count)
+{
+    mBuckets[mBucket] += count;
+    mTotal += count;
+}
+
+/**
+ * Move the window on
+ * @param elapsed Time since the last update in seconds
+ */
+void Throughput::Update(double elapsed)
+{
+    mTime += elapsed;
+    mBucketTime += elapsed;
+
+    // A gap of a whole window or more leaves every bucket empty
+    if (mBucketTime >= WindowSeconds)
+    {
+        mBuckets.fill(0);
+        mBucketTime = std::fmod(mBucketTime, 1.0);
+        return;
+    }
+
+    while (mBucketTime >= 1)
+    {
+        mBucketTime -= 1;
+        mBucket = (mBucket + 1) % WindowSeconds;
+        mBuckets[mBucket] = 0;
+    }
+}
+
+/**
+ * Get the rate products were sorted at over the last minute, or
+ * since the last Clear if that was less than a minute ago
+ * @return Products sorted per minute
+ */
+double Throughput::GetPerMinute() const
+{
+    // The window is every full second before this one and the part
+    // of this second played so far
+    double window = std::min(mTime, (WindowSeconds - 1) + mBucketTime);
+    if (window <= 0)
+    {
+        return 0;
+    }
+
+    int sorted = 0;
+    for (auto count : mBuckets)
+    {
+        sorted += count;
+    }
+    return sorted * 60.0 / window;
+}
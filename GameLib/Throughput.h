@@ -0,0 +1,55 @@
+/**
+ * @file Throughput.h
+ * @author matthew vazquez
+ *
+ * Products sorted per minute, over the last minute played.
+ */
+
+#ifndef THROUGHPUT_H
+#define THROUGHPUT_H
+
+#include <array>
+
+/**
+ * Products sorted per minute, over the last minute played.
+ *
+ * Counts are kept in one-second buckets that are reused as the minute
+ * moves on, so measuring a shift of any length takes the same memory.
+ * Holds only plain values, so a game snapshot copies it whole.
+ */
+class Throughput
+{
+public:
+    /// Seconds of play the rate is measured over
+    static const int WindowSeconds = 60;
+
+private:
+    /// Products sorted in each second of the window
+    std::array<int, WindowSeconds> mBuckets{};
+
+    /// Bucket of the second in progress
+    int mBucket = 0;
+
+    /// Time into the second in progress
+    double mBucketTime = 0;
+
+    /// Time measured since the last Clear
+    double mTime = 0;
+
+    /// Products sorted since the last Clear
+    long long mTotal = 0;
+
+public:
+    void Clear();
+    void Add(int count);
+    void Update(double elapsed);
+    double GetPerMinute() const;
+
+    /**
+     * Get the number of products sorted since the last Clear
+     * @return Number of products
+     */
+    long long GetTotal() const { return mTotal; }
+};
+
+#endif //THROUGHPUT_H
@@ -21,7 +21,7 @@ private:
     double mRemainingTime;
     /// Tracks the time passed by elapsed so that updates are made every second.
     /// Needed because the elapsed from game is not exactly a second.
-    double mElapsedTime;
+    double mElapsedTime = 0;
 
 public:
     /**
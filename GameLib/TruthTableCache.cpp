@@ -0,0 +1,133 @@
+/**
+ * @file TruthTableCache.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "TruthTableCache.h"
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+/// Identifies a saved cache file
+const uint32_t CacheMagic = 0x54544253;   // "SBTT"
+
+/// Format version of saved cache files
+const uint32_t CacheVersion = 1;
+
+/**
+ * Look up an entry
+ * @param key Canonical hash of what was computed
+ * @param table Set to the cached result if found
+ * @return True if found
+ */
+bool TruthTableCache::Find(uint64_t key, LogicWord &table) const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    auto found = mTables.find(key);
+    if (found == mTables.end())
+    {
+        mMisses++;
+        return false;
+    }
+
+    mHits++;
+    table = found->second;
+    return true;
+}
+
+/**
+ * Add or replace an entry
+ * @param key Canonical hash of what was computed
+ * @param table The result
+ */
+void TruthTableCache::Insert(uint64_t key, const LogicWord &table)
+{
+    std::unique_lock<std::shared_mutex> lock(mMutex);
+    mTables[key] = table;
+}
+
+/**
+ * Remove every entry
+ */
+void TruthTableCache::Clear()
+{
+    std::unique_lock<std::shared_mutex> lock(mMutex);
+    mTables.clear();
+}
+
+/**
+ * Get the number of entries
+ * @return Number of cached results
+ */
+size_t TruthTableCache::GetSize() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mTables.size();
+}
+
+/**
+ * Add the entries saved in a file to the cache
+ * @param filename File written by Save
+ * @return True if the file was read; false if it is missing or not a cache
+ */
+bool TruthTableCache::Load(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0;
+    uint64_t count = 0;
+    file.read((char *)&magic, sizeof(magic));
+    file.read((char *)&version, sizeof(version));
+    file.read((char *)&count, sizeof(count));
+    if (!file || magic != CacheMagic || version != CacheVersion)
+    {
+        return false;
+    }
+
+    std::vector<uint64_t> record(3);
+    std::unique_lock<std::shared_mutex> lock(mMutex);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        file.read((char *)record.data(), record.size() * sizeof(uint64_t));
+        if (!file)
+        {
+            return false;
+        }
+
+        mTables[record[0]] = {record[1], record[2]};
+    }
+
+    return true;
+}
+
+/**
+ * Write every entry to a file
+ * @param filename File to write
+ * @return True if the file was written
+ */
+bool TruthTableCache::Save(const std::string &filename) const
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    uint64_t count = mTables.size();
+    file.write((const char *)&CacheMagic, sizeof(CacheMagic));
+    file.write((const char *)&CacheVersion, sizeof(CacheVersion));
+    file.write((const char *)&count, sizeof(count));
+    for (const auto &entry : mTables)
+    {
+        uint64_t record[3] = {entry.first, entry.second.mOne, entry.second.mZero};
+        file.write((const char *)record, sizeof(record));
+    }
+
+    return (bool)file;
+}
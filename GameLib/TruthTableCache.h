@@ -0,0 +1,73 @@
+/**
+ * @file TruthTableCache.h
+ * @author matthew vazquez
+ *
+ * Memo of simulation results keyed by canonical circuit hashes.
+ */
+
+#ifndef TRUTHTABLECACHE_H
+#define TRUTHTABLECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "GateLogic.h"
+
+/**
+ * Memo of simulation results keyed by canonical circuit hashes.
+ *
+ * Every entry is a single LogicWord: the truth table of a small
+ * combinational sub-circuit, or a packed verification result. Keys
+ * come from CircuitHash, so identical sub-circuits in different
+ * players' circuits share entries. The cache can be used from many
+ * threads at once and saved to disk to carry results across runs.
+ */
+class TruthTableCache
+{
+private:
+    /// Protects mTables
+    mutable std::shared_mutex mMutex;
+
+    /// Cached results
+    std::unordered_map<uint64_t, LogicWord> mTables;
+
+    /// Number of successful lookups
+    mutable std::atomic<uint64_t> mHits{0};
+
+    /// Number of failed lookups
+    mutable std::atomic<uint64_t> mMisses{0};
+
+public:
+    TruthTableCache() {}
+
+    /// Copy constructor (disabled)
+    TruthTableCache(const TruthTableCache &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const TruthTableCache &) = delete;
+
+    bool Find(uint64_t key, LogicWord &table) const;
+    void Insert(uint64_t key, const LogicWord &table);
+    void Clear();
+
+    bool Load(const std::string &filename);
+    bool Save(const std::string &filename) const;
+
+    size_t GetSize() const;
+
+    /**
+     * Get the number of lookups that found an entry
+     * @return Number of hits
+     */
+    uint64_t GetHits() const { return mHits; }
+
+    /**
+     * Get the number of lookups that found nothing
+     * @return Number of misses
+     */
+    uint64_t GetMisses() const { return mMisses; }
+};
+
+#endif //TRUTHTABLECACHE_H
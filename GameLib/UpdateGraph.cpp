@@ -0,0 +1,417 @@
+/**
+ * @file UpdateGraph.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "UpdateGraph.h"
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include "Beam.h"
+#include "Gates.h"
+#include "InputPin.h"
+#include "Item.h"
+#include "ItemVisitor.h"
+#include "OutputPin.h"
+#include "ProductionLine.h"
+#include "Sensor.h"
+#include "SensorPanel.h"
+#include "Sparty.h"
+
+/// Bit for every resource
+static const int AllResources = (1 << UpdateGraph::NumResources) - 1;
+
+/**
+ * Visitor that finds the shared state an item's Update touches
+ */
+class UpdateAccess : public ItemVisitor
+{
+public:
+    /// Resources touched, as bits, or -1 if the item's type is unknown
+    int mResources = -1;
+
+    /// True if the item only moves itself
+    bool mMotion = false;
+
+    /// Phase of the update the item belongs to
+    UpdateGraph::Phase mPhase = UpdateGraph::Phase::Other;
+
+    /// Pins the item reads
+    std::vector<InputPin *> mInputs;
+
+    /// Pins the item sets
+    std::vector<OutputPin *> mOutputs;
+
+    /**
+     * Visit a beam, which looks for its line's products, sets its pin and scores
+     * @param beam Beam we are visiting
+     */
+    void VisitBeam(Beam *beam) override
+    {
+        mResources = 1 << UpdateGraph::Products | 1 << UpdateGraph::Circuit | 1 << UpdateGraph::Score;
+        mPhase = UpdateGraph::Phase::Beam;
+        mOutputs.push_back(beam->GetOutputPin());
+    }
+
+    /**
+     * Visit a conveyor, which moves every product
+     * @param conveyor Conveyor we are visiting
+     */
+    void VisitConveyor(Conveyor *conveyor) override
+    {
+        mResources = 1 << UpdateGraph::Products;
+        mPhase = UpdateGraph::Phase::Motion;
+    }
+
+    /**
+     * Visit a scoreboard, which only reads the timer
+     * @param scoreboard Scoreboard we are visiting
+     */
+    void VisitScoreboard(Scoreboard *scoreboard) override { mResources = 0; }
+
+    /**
+     * Visit a sensor, which looks for products and sets its panels' pins
+     * @param sensor Sensor we are visiting
+     */
+    void VisitSensor(Sensor *sensor) override
+    {
+        mResources = 1 << UpdateGraph::Products | 1 << UpdateGraph::Circuit;
+        mPhase = UpdateGraph::Phase::Sense;
+        for (auto panel : sensor->GetSensorPanels())
+        {
+            mOutputs.push_back(panel->GetOutputPin());
+        }
+    }
+
+    /**
+     * Visit Sparty, who reads its pin and kicks products, scoring wrong kicks
+     * @param sparty Sparty we are visiting
+     */
+    void VisitSparty(Sparty *sparty) override
+    {
+        mResources = 1 << UpdateGraph::Products | 1 << UpdateGraph::Circuit | 1 << UpdateGraph::Score;
+        mPhase = UpdateGraph::Phase::Kick;
+        mInputs.push_back(sparty->GetInputPin());
+    }
+
+    /**
+     * Visit a product, which moves itself once kicked
+     * @param product Product we are visiting
+     */
+    void VisitProduct(Product *product) override
+    {
+        mResources = 1 << UpdateGraph::Products;
+        mMotion = true;
+        mPhase = UpdateGraph::Phase::Motion;
+    }
+
+    /**
+     * Visit a gate, which reads and sets pins
+     * @param gates Gate we are visiting
+     */
+    void VisitGates(Gates *gates) override
+    {
+        mResources = 1 << UpdateGraph::Circuit;
+        mPhase = UpdateGraph::Phase::Gates;
+        for (int i = 0; gates->GetInputPin(i) != nullptr; i++)
+        {
+            mInputs.push_back(gates->GetInputPin(i));
+        }
+        for (int i = 0; gates->GetOutputPin(i) != nullptr; i++)
+        {
+            mOutputs.push_back(gates->GetOutputPin(i));
+        }
+    }
+};
+
+/**
+ * Get the line an item belongs to
+ * @param item Item to look at
+ * @param numLines Number of lines in the game
+ * @return Index of the item's line, or -1 if it has none
+ */
+static int LineOf(Item *item, int numLines)
+{
+    auto line = item->GetLine();
+    return line != nullptr && line->GetIndex() < numLines ? line->GetIndex() : -1;
+}
+
+/**
+ * Split the items that touch the circuit into groups joined by wires.
+ * Items of different groups never read a pin the other sets.
+ * @param accesses What each item's Update touches
+ * @param components Receives each item's group, or -1 if it touches no pins
+ * @return Number of groups
+ */
+static int CircuitComponents(const std::vector<UpdateAccess> &accesses, std::vector<int> &components)
+{
+    std::vector<int> parent(accesses.size());
+    for (size_t i = 0; i < parent.size(); i++)
+    {
+        parent[i] = (int)i;
+    }
+
+    auto find = [&parent](int i) {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    std::unordered_map<const OutputPin *, int> drivers;
+    for (size_t i = 0; i < accesses.size(); i++)
+    {
+        for (auto pin : accesses[i].mOutputs)
+        {
+            drivers[pin] = (int)i;
+        }
+    }
+
+    for (size_t i = 0; i < accesses.size(); i++)
+    {
+        for (auto pin : accesses[i].mInputs)
+        {
+            auto driver = pin != nullptr ? drivers.find(pin->GetLine()) : drivers.end();
+            if (driver != drivers.end())
+            {
+                parent[find((int)i)] = find(driver->second);
+            }
+        }
+    }
+
+    // Number the groups in the order of their first item
+    int numComponents = 0;
+    std::vector<int> number(accesses.size(), -1);
+    components.assign(accesses.size(), -1);
+    for (size_t i = 0; i < accesses.size(); i++)
+    {
+        if (accesses[i].mResources > 0 && (accesses[i].mResources & (1 << UpdateGraph::Circuit)))
+        {
+            int root = find((int)i);
+            if (number[root] < 0)
+            {
+                number[root] = numComponents++;
+            }
+            components[i] = number[root];
+        }
+    }
+    return numComponents;
+}
+
+/**
+ * Number the resources an item touches. Line lineIndex's resource r
+ * is lineIndex * NumResources + r, and circuit group c is
+ * numLines * NumResources + c.
+ * @param item Item to look at
+ * @param access What the item's Update touches
+ * @param component The item's circuit group, -1 for none
+ * @param numLines Number of lines in the game
+ * @param numComponents Number of circuit groups
+ * @return Resource numbers
+ */
+static std::vector<int> Resources(Item *item, const UpdateAccess &access, int component, int numLines,
+                                  int numComponents)
+{
+    int kinds = access.mResources < 0 ? AllResources : access.mResources;
+
+    // Items of no line, or of a type we know nothing about, touch every line
+    int first = 0;
+    int last = numLines - 1;
+    int line = LineOf(item, numLines);
+    if (line >= 0 && access.mResources >= 0)
+    {
+        first = last = line;
+    }
+
+    std::vector<int> resources;
+    if (kinds & (1 << UpdateGraph::Circuit))
+    {
+        // An item we know nothing about may set any pin
+        int circuit = numLines * UpdateGraph::NumResources;
+        if (component >= 0)
+        {
+            resources.push_back(circuit + component);
+        }
+        else
+        {
+            for (int c = 0; c < numComponents; c++)
+            {
+                resources.push_back(circuit + c);
+            }
+        }
+    }
+
+    for (int l = first; l <= last; l++)
+    {
+        for (int r : {UpdateGraph::Products, UpdateGraph::Score})
+        {
+            if (kinds & (1 << r))
+            {
+                resources.push_back(l * UpdateGraph::NumResources + r);
+            }
+        }
+    }
+    return resources;
+}
+
+/**
+ * Split items into stages and find the dependencies between them
+ * @param items Items in the order they update
+ * @param numLines Number of production lines the items belong to
+ */
+void UpdateGraph::Build(const std::vector<std::shared_ptr<Item>> &items, int numLines)
+{
+    mStages.clear();
+    mTasks.Clear();
+    mStageOf.clear();
+    numLines = std::max(numLines, 1);
+
+    std::vector<UpdateAccess> accesses(items.size());
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        items[i]->Accept(&accesses[i]);
+    }
+    std::vector<int> components;
+    int numComponents = CircuitComponents(accesses, components);
+
+    // For each resource, the last stage to change it and the stages
+    // of products sharing it since
+    int numResources = numLines * NumResources + numComponents;
+    std::vector<int> lastWriter(numResources, -1);
+    std::vector<std::vector<int>> sharers(numResources);
+
+    // The newest stage of each phase, by line or circuit group
+    std::map<std::pair<Phase, int>, int> phaseStages;
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        auto item = items[i].get();
+        const auto &access = accesses[i];
+        auto resources = Resources(item, access, components[i], numLines, numComponents);
+        int line = LineOf(item, numLines);
+
+        if (access.mMotion)
+        {
+            int stage = (int)mStages.size() - 1;
+            if (stage < 0 || !mStages[stage]->mMotion || mStages[stage]->mLine != line ||
+                (int)mStages[stage]->mItems.GetNumItems() >= ChunkSize)
+            {
+                stage = AddStage(Phase::Motion, true, line);
+                for (int r : resources)
+                {
+                    if (lastWriter[r] >= 0)
+                    {
+                        mTasks.AddDependency(stage, lastWriter[r]);
+                    }
+                    sharers[r].push_back(stage);
+                }
+            }
+            mStages[stage]->mItems.Add(item);
+            mStageOf[item] = stage;
+            continue;
+        }
+
+        // Gates are grouped by the wires between them, everything else by line
+        std::pair<Phase, int> key(access.mPhase, access.mPhase == Phase::Gates ? components[i] : line);
+
+        // The item joins its phase's newest stage if nothing since has
+        // touched what it touches, so it still updates in game order
+        // with every item it shares state with
+        int stage = -1;
+        auto found = phaseStages.find(key);
+        if (found != phaseStages.end())
+        {
+            stage = found->second;
+            for (int r : resources)
+            {
+                if ((lastWriter[r] >= 0 && lastWriter[r] != stage) || !sharers[r].empty())
+                {
+                    stage = -1;
+                    break;
+                }
+            }
+        }
+
+        if (stage < 0)
+        {
+            stage = AddStage(access.mPhase, false, line);
+            phaseStages[key] = stage;
+            for (int r : resources)
+            {
+                if (lastWriter[r] >= 0)
+                {
+                    mTasks.AddDependency(stage, lastWriter[r]);
+                }
+                for (int sharer : sharers[r])
+                {
+                    mTasks.AddDependency(stage, sharer);
+                }
+            }
+        }
+
+        for (int r : resources)
+        {
+            lastWriter[r] = stage;
+            sharers[r].clear();
+        }
+
+        mStages[stage]->mItems.Add(item);
+        mStageOf[item] = stage;
+    }
+}
+
+/**
+ * Add an empty stage and the task that updates it
+ * @param phase Phase of the update the stage's items belong to
+ * @param motion True if the stage will hold only products
+ * @param line Line of the stage's items, -1 if none
+ * @return Index of the stage
+ */
+int UpdateGraph::AddStage(Phase phase, bool motion, int line)
+{
+    auto stage = std::make_unique<Stage>();
+    stage->mPhase = phase;
+    stage->mMotion = motion;
+    stage->mLine = line;
+    auto items = &stage->mItems;
+    mStages.push_back(std::move(stage));
+
+    return mTasks.Add([this, items] { items->Update(mElapsed); });
+}
+
+/**
+ * Update every item
+ * @param elapsed Time since the last update in seconds
+ * @param pool Pool to update stages on, or null to update every item
+ * in order on this thread
+ */
+void UpdateGraph::Update(double elapsed, WorkStealingPool *pool)
+{
+    mElapsed = elapsed;
+    mTasks.Run(pool);
+}
+
+/**
+ * Get the stage an item updates in
+ * @param item Item to look for
+ * @return Index of its stage, or -1 if the item is not in the graph
+ */
+int UpdateGraph::GetStageOf(const Item *item) const
+{
+    auto found = mStageOf.find(item);
+    return found != mStageOf.end() ? found->second : -1;
+}
+
+/**
+ * Can two stages update at the same time?
+ * @param stage1 Index of one stage
+ * @param stage2 Index of the other stage
+ * @return True if neither waits for the other, directly or through other stages
+ */
+bool UpdateGraph::IsConcurrent(int stage1, int stage2) const
+{
+    return stage1 != stage2 && !mTasks.Waits(stage1, stage2) && !mTasks.Waits(stage2, stage1);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file UpdateGraph.h
+ * @author matthew vazquez
+ *
+ * The items of a game split into stages that can update in parallel.
+ */
+
+#ifndef UPDATEGRAPH_H
+#define UPDATEGRAPH_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "ItemRuns.h"
+#include "TaskGraph.h"
+
+class Item;
+class WorkStealingPool;
+
+/**
+ * The items of a game split into stages that can update in parallel.
+ *
+ * Each item's Update touches some of the game's shared state: the
+ * products (the conveyor moves them, the sensor and beam look for
+ * them, Sparty kicks them), the circuit (sensors, the beam and gates
+ * set pins Sparty and gates read) and the score and level state the
+ * beam and Sparty's kicks change. Products only move themselves, so
+ * any number of them can update at once.
+ *
+ * Each production line has products and a score of its own, so the
+ * items of one line never wait for the products of another. The
+ * circuit is split into the groups of items joined by wires: a group
+ * only touches its own pins, so lines whose sensors, beams, gates and
+ * Sparty share no wires update on different threads. Items that
+ * belong to no line touch the state of every line.
+ *
+ * Each stage holds items of one phase of the update: motion (the
+ * conveyors and products), sensing, the beam, the gates and Sparty's
+ * kick. Items are placed in stages in the order the game holds them.
+ * Products join the last stage if it holds only products of their line
+ * and has room. Any other item joins the newest stage of its phase on
+ * its line, or of its circuit group for a gate, if no stage since has
+ * touched the same state, and otherwise starts a new stage. A stage
+ * depends on the earlier stages that touch the same state, with stages
+ * of products sharing the products between them. Running the stages
+ * as a TaskGraph therefore gives the same result as updating every
+ * item in order, and stages that share nothing, such as the
+ * scoreboard, separate chunks of products or the phases of lines
+ * that are not wired together, update on different threads.
+ *
+ * The circuit groups come from the wires, so the game builds the
+ * graph again when a wire is connected or removed.
+ */
+class UpdateGraph
+{
+public:
+    /// Most products updated by one stage
+    static constexpr int ChunkSize = 256;
+
+    /// Shared state an item's Update may touch
+    enum Resource {Products, Circuit, Score, NumResources};
+
+    /// Phases of an update, in the order a line's items update
+    enum class Phase {Motion, Sense, Beam, Gates, Kick, Other};
+
+private:
+    /**
+     * Items updated one after another on one thread
+     */
+    struct Stage
+    {
+        /// The items, in the order the game holds them
+        ItemRuns mItems;
+
+        /// Phase of the update the items belong to
+        Phase mPhase = Phase::Other;
+
+        /// True if the stage holds only products moving themselves
+        bool mMotion = false;
+
+        /// Line of the stage's items, -1 if they have none
+        int mLine = -1;
+    };
+
+    /// Stages, in the order of their first item
+    std::vector<std::unique_ptr<Stage>> mStages;
+
+    /// Stage each item updates in
+    std::unordered_map<const Item *, int> mStageOf;
+
+    /// Dependencies between the stages, one task per stage
+    TaskGraph mTasks;
+
+    /// Time step of the update in progress
+    double mElapsed = 0;
+
+    int AddStage(Phase phase, bool motion, int line);
+
+public:
+    UpdateGraph() = default;
+
+    /// Copy constructor (disabled)
+    UpdateGraph(const UpdateGraph &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const UpdateGraph &) = delete;
+
+    void Build(const std::vector<std::shared_ptr<Item>> &items, int numLines = 1);
+    void Update(double elapsed, WorkStealingPool *pool);
+
+    /**
+     * Get the number of stages
+     * @return Number of stages
+     */
+    int GetNumStages() const { return (int)mStages.size(); }
+
+    /**
+     * Get the phase of the update a stage's items belong to
+     * @param stage Index of the stage
+     * @return Phase
+     */
+    Phase GetPhase(int stage) const { return mStages[stage]->mPhase; }
+
+    int GetStageOf(const Item *item) const;
+    bool IsConcurrent(int stage1, int stage2) const;
+};
+
+#endif //UPDATEGRAPH_H
@@ -0,0 +1,161 @@
+/**
+ * @file WorkStealingPool.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+/// The pool the current thread works for, if any
+static thread_local WorkStealingPool *tPool = nullptr;
+
+/// Index of the current thread's queue in tPool
+static thread_local int tWorker = -1;
+
+/**
+ * Constructor
+ * @param numThreads Number of workers, or 0 for one per core
+ */
+WorkStealingPool::WorkStealingPool(int numThreads)
+{
+    if (numThreads <= 0)
+    {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    for (int i = 0; i < numThreads; i++)
+    {
+        mQueues.push_back(std::make_unique<Queue>());
+    }
+
+    for (int i = 0; i < numThreads; i++)
+    {
+        mThreads.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+}
+
+/**
+ * Destructor. Waits for submitted tasks, then stops the workers.
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+
+    for (auto &thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Add a task to the pool
+ * @param task Task to run on some worker
+ */
+void WorkStealingPool::Submit(std::function<void()> task)
+{
+    int index = tPool == this ? tWorker : (int)(mNextQueue++ % mQueues.size());
+
+    mPending++;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueued++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mQueues[index]->mMutex);
+        mQueues[index]->mTasks.push_back(std::move(task));
+    }
+    mWorkAvailable.notify_one();
+}
+
+/**
+ * Wait until every submitted task has finished.
+ *
+ * Must not be called from a task running on this pool.
+ */
+void WorkStealingPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mAllDone.wait(lock, [this] { return mPending == 0; });
+}
+
+/**
+ * Run one task, preferring this worker's own queue
+ * @param index Index of the worker looking for work
+ * @return True if a task was run
+ */
+bool WorkStealingPool::TryRun(int index)
+{
+    std::function<void()> task;
+    int count = (int)mQueues.size();
+
+    for (int i = 0; i < count && !task; i++)
+    {
+        auto &queue = *mQueues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        if (queue.mTasks.empty())
+        {
+            continue;
+        }
+
+        // Own work is newest first, stolen work oldest first
+        if (i == 0)
+        {
+            task = std::move(queue.mTasks.back());
+            queue.mTasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.mTasks.front());
+            queue.mTasks.pop_front();
+        }
+    }
+
+    if (!task)
+    {
+        return false;
+    }
+
+    mQueued--;
+    task();
+
+    if (--mPending == 0)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mAllDone.notify_all();
+    }
+
+    return true;
+}
+
+/**
+ * Body of each worker thread
+ * @param index Index of this worker's queue
+ */
+void WorkStealingPool::WorkerLoop(int index)
+{
+    tPool = this;
+    tWorker = index;
+
+    while (true)
+    {
+        if (TryRun(index))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkAvailable.wait(lock, [this] { return mStopping || mQueued > 0; });
+        if (mStopping && mQueued == 0)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file WorkStealingPool.h
+ * @author matthew vazquez
+ *
+ * A fixed set of worker threads that share tasks by stealing.
+ */
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads that share tasks by stealing.
+ *
+ * Every worker owns a queue. A worker takes new work from the back
+ * of its own queue and, when that is empty, steals from the front of
+ * another worker's queue. Tasks submitted from a worker go on that
+ * worker's queue, tasks submitted from outside are spread round robin.
+ */
+class WorkStealingPool
+{
+private:
+    /**
+     * One worker's queue of tasks
+     */
+    struct Queue
+    {
+        /// Protects mTasks
+        std::mutex mMutex;
+
+        /// Tasks waiting to run
+        std::deque<std::function<void()>> mTasks;
+    };
+
+    /// One queue per worker
+    std::vector<std::unique_ptr<Queue>> mQueues;
+
+    /// The worker threads
+    std::vector<std::thread> mThreads;
+
+    /// Protects the sleeping and waiting state below
+    std::mutex mMutex;
+
+    /// Signalled when work is submitted or the pool stops
+    std::condition_variable mWorkAvailable;
+
+    /// Signalled when the last outstanding task finishes
+    std::condition_variable mAllDone;
+
+    /// Tasks submitted but not yet finished
+    std::atomic<int> mPending{0};
+
+    /// Tasks sitting in a queue
+    std::atomic<int> mQueued{0};
+
+    /// Next queue an outside submission goes to
+    std::atomic<unsigned> mNextQueue{0};
+
+    /// Set when the pool is being destroyed
+    bool mStopping = false;
+
+    void WorkerLoop(int index);
+    bool TryRun(int index);
+
+public:
+    WorkStealingPool(int numThreads = 0);
+    ~WorkStealingPool();
+
+    /// Copy constructor (disabled)
+    WorkStealingPool(const WorkStealingPool &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const WorkStealingPool &) = delete;
+
+    void Submit(std::function<void()> task);
+    void Wait();
+
+    /**
+     * Get the number of worker threads
+     * @return Number of workers
+     */
+    int GetNumThreads() const { return (int)mThreads.size(); }
+};
+
+#endif //WORKSTEALINGPOOL_H
@@ -0,0 +1,705 @@
+/**
+ * @file XmlPullParser.cpp
+ * @author matthew vazquez
+ */
+
+#include "pch.h"
+#include "XmlPullParser.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// Longest number ToDouble and ToLong read, in characters
+const size_t MaxNumberLength = 63;
+
+/**
+ * Is a character XML white space?
+ * @param c Character to test
+ * @return True if it is a space, tab or line end
+ */
+static bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Remove white space from both ends of a view
+ * @param text Text to trim
+ * @return Text without leading or trailing white space
+ */
+static string_view Trim(string_view text)
+{
+    while (!text.empty() && IsSpace(text.front()))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && IsSpace(text.back()))
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/**
+ * Destructor
+ */
+XmlPullParser::~XmlPullParser()
+{
+    Close();
+}
+
+/**
+ * Open a file for reading. The file is mapped into memory, or read
+ * into it where files cannot be mapped.
+ * @param filename File to open
+ * @return True if the file could be opened
+ */
+bool XmlPullParser::Open(const wxString &filename)
+{
+    Close();
+
+#ifdef _WIN32
+    return Read(filename);
+#else
+    int fd = open(filename.fn_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // An empty file cannot be mapped, and is not a document either
+    size_t size = (size_t)status.st_size;
+    void *mapping = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    SetText(string_view((const char *)mapping, mapping != nullptr ? size : 0));
+    mMapping = mapping;
+    mMappingSize = size;
+    return true;
+#endif
+}
+
+/**
+ * Read a file into memory rather than mapping it, for files that may
+ * be rewritten while they are parsed, such as a level being edited
+ * @param filename File to read
+ * @return True if the file could be read
+ */
+bool XmlPullParser::Read(const wxString &filename)
+{
+    Close();
+
+    ifstream in(filename.fn_str(), ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+    mBuffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    SetText(mBuffer);
+    return true;
+}
+
+/**
+ * Read text already in memory. The text must outlive the parser's use of it.
+ * @param text XML text
+ */
+void XmlPullParser::SetText(string_view text)
+{
+    // Skip a UTF-8 byte order mark
+    if (text.substr(0, 3) == "\xEF\xBB\xBF")
+    {
+        text.remove_prefix(3);
+    }
+
+    mBegin = text.data();
+    mEnd = text.data() + text.size();
+    Rewind();
+}
+
+/**
+ * Release the file being read. Views into it are no longer valid.
+ */
+void XmlPullParser::Close()
+{
+#ifndef _WIN32
+    if (mMapping != nullptr)
+    {
+        munmap(mMapping, mMappingSize);
+    }
+#endif
+    mMapping = nullptr;
+    mMappingSize = 0;
+    mBuffer.clear();
+    mBegin = mEnd = nullptr;
+    Rewind();
+}
+
+/**
+ * Go back to the start of the text
+ */
+void XmlPullParser::Rewind()
+{
+    mPos = mBegin;
+    mEventStart = mBegin;
+    mLineCounted = mBegin;
+    mLine = 1;
+    mEvent = Event::End;
+    mName = {};
+    mText = {};
+    mAttributes.clear();
+    mOpen.clear();
+    mPendingEnd = false;
+}
+
+/**
+ * Read the whole text to see if it is a document, then go back to
+ * the start. Loading can then replace what it loads into knowing the
+ * document will not stop halfway.
+ * @return True if the text holds one root element, properly nested
+ */
+bool XmlPullParser::IsWellFormed()
+{
+    Rewind();
+
+    bool root = false;
+    Event event;
+    while ((event = Next()) != Event::End && event != Event::Error)
+    {
+        root = root || event == Event::StartElement;
+    }
+
+    Rewind();
+    return root && event == Event::End;
+}
+
+/**
+ * Stop reading after a mistake in the text
+ * @return Event::Error
+ */
+XmlPullParser::Event XmlPullParser::Fail()
+{
+    mPos = mEnd;
+    mPendingEnd = false;
+    mEvent = Event::Error;
+    return mEvent;
+}
+
+/**
+ * Skip past the next occurrence of some text
+ * @param terminator Text to skip past
+ * @return True if it was found
+ */
+bool XmlPullParser::Skip(string_view terminator)
+{
+    auto found = string_view(mPos, mEnd - mPos).find(terminator);
+    if (found == string_view::npos)
+    {
+        return false;
+    }
+    mPos += found + terminator.size();
+    return true;
+}
+
+/**
+ * Skip white space
+ */
+void XmlPullParser::SkipSpace()
+{
+    while (mPos < mEnd && IsSpace(*mPos))
+    {
+        mPos++;
+    }
+}
+
+/**
+ * Read an element or attribute name
+ * @param name Receives the name
+ * @return True if there was a name to read
+ */
+bool XmlPullParser::ReadName(string_view &name)
+{
+    auto start = mPos;
+    while (mPos < mEnd && !IsSpace(*mPos) && strchr("/>=<\"'", *mPos) == nullptr)
+    {
+        mPos++;
+    }
+    name = string_view(start, mPos - start);
+    return !name.empty();
+}
+
+/**
+ * Read the next element start, element end or text. Comments,
+ * processing instructions, the document type and text that is only
+ * white space are skipped.
+ * @return What was read
+ */
+XmlPullParser::Event XmlPullParser::Next()
+{
+    if (mEvent == Event::Error)
+    {
+        return mEvent;
+    }
+
+    if (mPendingEnd)
+    {
+        mPendingEnd = false;
+        mName = mOpen.back();
+        mOpen.pop_back();
+        mEvent = Event::EndElement;
+        return mEvent;
+    }
+
+    while (true)
+    {
+        mEventStart = mPos;
+        if (mPos >= mEnd)
+        {
+            mEvent = Event::End;
+            return mOpen.empty() ? mEvent : Fail();
+        }
+
+        if (*mPos != '<')
+        {
+            auto start = mPos;
+            auto next = (const char *)memchr(mPos, '<', mEnd - mPos);
+            mPos = next != nullptr ? next : mEnd;
+
+            string_view text(start, mPos - start);
+            if (Trim(text).empty())
+            {
+                continue;
+            }
+            if (mOpen.empty())
+            {
+                return Fail();
+            }
+
+            mText = text;
+            mEvent = Event::Text;
+            return mEvent;
+        }
+
+        string_view rest(mPos, mEnd - mPos);
+        if (rest.substr(0, 4) == "<!--")
+        {
+            mPos += 4;
+            if (!Skip("-->"))
+            {
+                return Fail();
+            }
+            continue;
+        }
+
+        if (rest.substr(0, 2) == "<?")
+        {
+            mPos += 2;
+            if (!Skip("?>"))
+            {
+                return Fail();
+            }
+            continue;
+        }
+
+        if (rest.substr(0, 9) == "<![CDATA[")
+        {
+            mPos += 9;
+            auto start = mPos;
+            if (!Skip("]]>") || mOpen.empty())
+            {
+                return Fail();
+            }
+
+            mText = string_view(start, mPos - 3 - start);
+            mEvent = Event::Text;
+            return mEvent;
+        }
+
+        if (rest.substr(0, 2) == "<!")
+        {
+            mPos += 2;
+            if (!Skip(">"))
+            {
+                return Fail();
+            }
+            continue;
+        }
+
+        if (rest.substr(0, 2) == "</")
+        {
+            mPos += 2;
+            string_view name;
+            if (!ReadName(name))
+            {
+                return Fail();
+            }
+            SkipSpace();
+            if (mPos >= mEnd || *mPos != '>' || mOpen.empty() || mOpen.back() != name)
+            {
+                return Fail();
+            }
+            mPos++;
+
+            mOpen.pop_back();
+            mName = name;
+            mEvent = Event::EndElement;
+            return mEvent;
+        }
+
+        // An element start
+        mPos++;
+        if (!ReadName(mName))
+        {
+            return Fail();
+        }
+
+        mAttributes.clear();
+        while (true)
+        {
+            SkipSpace();
+            if (mPos >= mEnd)
+            {
+                return Fail();
+            }
+
+            if (*mPos == '>')
+            {
+                mPos++;
+                break;
+            }
+
+            if (*mPos == '/')
+            {
+                if (mPos + 1 >= mEnd || mPos[1] != '>')
+                {
+                    return Fail();
+                }
+                mPos += 2;
+                mPendingEnd = true;
+                break;
+            }
+
+            Attribute attribute;
+            if (!ReadName(attribute.mName))
+            {
+                return Fail();
+            }
+            SkipSpace();
+            if (mPos >= mEnd || *mPos != '=')
+            {
+                return Fail();
+            }
+            mPos++;
+            SkipSpace();
+            if (mPos >= mEnd || (*mPos != '"' && *mPos != '\''))
+            {
+                return Fail();
+            }
+
+            char quote = *mPos++;
+            auto close = (const char *)memchr(mPos, quote, mEnd - mPos);
+            if (close == nullptr)
+            {
+                return Fail();
+            }
+            attribute.mValue = string_view(mPos, close - mPos);
+            mPos = close + 1;
+            mAttributes.push_back(attribute);
+        }
+
+        mOpen.push_back(mName);
+        mText = {};
+        mEvent = Event::StartElement;
+        return mEvent;
+    }
+}
+
+/**
+ * Step to the next child of an element: an element start or text
+ * directly inside it. Anything deeper, such as the children of a
+ * child that was not stepped into, is skipped.
+ * @param depth Depth of the element, from GetDepth on its start
+ * @return True if there is a child, false once the element ends
+ */
+bool XmlPullParser::NextChild(int depth)
+{
+    while (true)
+    {
+        auto event = Next();
+        if (event == Event::End || event == Event::Error)
+        {
+            return false;
+        }
+        if (event == Event::EndElement && GetDepth() < depth)
+        {
+            return false;
+        }
+        if ((event == Event::StartElement && GetDepth() == depth + 1) ||
+            (event == Event::Text && GetDepth() == depth))
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * Does the element started have an attribute?
+ * @param name Attribute name
+ * @return True if it does
+ */
+bool XmlPullParser::HasAttribute(string_view name) const
+{
+    for (const auto &attribute : mAttributes)
+    {
+        if (attribute.mName == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Get an attribute of the element started
+ * @param name Attribute name
+ * @param defaultValue Value if the element does not have the attribute
+ * @return Raw attribute value, a view into the file
+ */
+string_view XmlPullParser::GetAttribute(string_view name, string_view defaultValue) const
+{
+    for (const auto &attribute : mAttributes)
+    {
+        if (attribute.mName == name)
+        {
+            return attribute.mValue;
+        }
+    }
+    return defaultValue;
+}
+
+/**
+ * Get an attribute of the element started as a number. Like
+ * wxString::ToDouble, a value that is not a number reads as far
+ * as it is one, or as 0.
+ * @param name Attribute name
+ * @param defaultValue Value if the element does not have the attribute
+ * @return Attribute value
+ */
+double XmlPullParser::GetDouble(string_view name, double defaultValue) const
+{
+    if (!HasAttribute(name))
+    {
+        return defaultValue;
+    }
+
+    double value = 0;
+    ToDouble(GetAttribute(name), value);
+    return value;
+}
+
+/**
+ * Get an attribute of the element started as an integer
+ * @param name Attribute name
+ * @param defaultValue Value if the element does not have the attribute
+ * @return Attribute value
+ */
+long XmlPullParser::GetLong(string_view name, long defaultValue) const
+{
+    if (!HasAttribute(name))
+    {
+        return defaultValue;
+    }
+
+    long value = 0;
+    ToLong(GetAttribute(name), value);
+    return value;
+}
+
+/**
+ * Get the line of the file the last event was read from. Lines are
+ * counted when asked for, so reading does not pay for them.
+ * @return Line number, starting at 1
+ */
+int XmlPullParser::GetLineNumber() const
+{
+    if (mEventStart < mLineCounted)
+    {
+        mLineCounted = mBegin;
+        mLine = 1;
+    }
+
+    mLine += (int)count(mLineCounted, mEventStart, '\n');
+    mLineCounted = mEventStart;
+    return mLine;
+}
+
+/**
+ * Read a number
+ * @param text Text of the number
+ * @param value Receives the number, or as much of it as was read
+ * @return True if the whole text is a number
+ */
+bool XmlPullParser::ToDouble(string_view text, double &value)
+{
+    char number[MaxNumberLength + 1];
+    if (text.size() > MaxNumberLength)
+    {
+        value = 0;
+        return false;
+    }
+    memcpy(number, text.data(), text.size());
+    number[text.size()] = 0;
+
+    char *end;
+    value = strtod(number, &end);
+    return end != number && *end == 0;
+}
+
+/**
+ * Read an integer
+ * @param text Text of the integer
+ * @param value Receives the integer, or as much of it as was read
+ * @return True if the whole text is an integer
+ */
+bool XmlPullParser::ToLong(string_view text, long &value)
+{
+    char number[MaxNumberLength + 1];
+    if (text.size() > MaxNumberLength)
+    {
+        value = 0;
+        return false;
+    }
+    memcpy(number, text.data(), text.size());
+    number[text.size()] = 0;
+
+    char *end;
+    value = strtol(number, &end, 10);
+    return end != number && *end == 0;
+}
+
+/**
+ * Read two numbers separated by a comma, such as "1100, 400"
+ * @param text Text of the pair
+ * @param x Receives the first number
+ * @param y Receives the second number
+ * @return True if both are numbers
+ */
+bool XmlPullParser::ToPair(string_view text, double &x, double &y)
+{
+    auto comma = text.find(',');
+    if (comma == string_view::npos)
+    {
+        return false;
+    }
+
+    bool first = ToDouble(Trim(text.substr(0, comma)), x);
+    bool second = ToDouble(Trim(text.substr(comma + 1)), y);
+    return first && second;
+}
+
+/**
+ * Turn raw text into a wide string, replacing entity and character references
+ * @param text Raw UTF-8 text from the file
+ * @return Decoded text
+ */
+wstring XmlPullParser::Decode(string_view text)
+{
+    string decoded;
+    decoded.reserve(text.size());
+
+    static const pair<string_view, char> entities[] = {
+            {"&lt;", '<'}, {"&gt;", '>'}, {"&amp;", '&'}, {"&quot;", '"'}, {"&apos;", '\''}};
+
+    while (!text.empty())
+    {
+        auto amp = text.find('&');
+        decoded.append(text.substr(0, amp));
+        if (amp == string_view::npos)
+        {
+            break;
+        }
+        text.remove_prefix(amp);
+
+        auto semicolon = text.find(';');
+        auto reference = text.substr(0, semicolon == string_view::npos ? 1 : semicolon + 1);
+
+        bool replaced = false;
+        for (const auto &entity : entities)
+        {
+            if (reference == entity.first)
+            {
+                decoded += entity.second;
+                replaced = true;
+            }
+        }
+
+        if (!replaced && reference.size() > 3 && reference[1] == '#')
+        {
+            // A character reference, written as UTF-8
+            auto digits = string(reference.substr(2, reference.size() - 3));
+            bool hex = digits[0] == 'x' || digits[0] == 'X';
+            char *end;
+            unsigned long code = strtoul(digits.c_str() + (hex ? 1 : 0), &end, hex ? 16 : 10);
+            if (*end == 0 && code > 0 && code <= 0x10FFFF)
+            {
+                if (code < 0x80)
+                {
+                    decoded += (char)code;
+                }
+                else if (code < 0x800)
+                {
+                    decoded += (char)(0xC0 | (code >> 6));
+                    decoded += (char)(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    decoded += (char)(0xE0 | (code >> 12));
+                    decoded += (char)(0x80 | ((code >> 6) & 0x3F));
+                    decoded += (char)(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    decoded += (char)(0xF0 | (code >> 18));
+                    decoded += (char)(0x80 | ((code >> 12) & 0x3F));
+                    decoded += (char)(0x80 | ((code >> 6) & 0x3F));
+                    decoded += (char)(0x80 | (code & 0x3F));
+                }
+                replaced = true;
+            }
+        }
+
+        if (replaced)
+        {
+            text.remove_prefix(reference.size());
+        }
+        else
+        {
+            // Not a reference, so the ampersand is kept as it is
+            decoded += '&';
+            text.remove_prefix(1);
+        }
+    }
+
+    return wxString::FromUTF8(decoded.data(), decoded.size()).ToStdWstring();
+}
@@ -0,0 +1,166 @@
+/**
+ * @file XmlPullParser.h
+ * @author matthew vazquez
+ *
+ * Reads an XML file one element at a time, without building a document.
+ */
+
+#ifndef XMLPULLPARSER_H
+#define XMLPULLPARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Reads an XML file one element at a time, without building a document.
+ *
+ * The file is mapped into memory and the parser walks it in place:
+ * names, attribute values and text are views into the mapping, so
+ * reading a level allocates nothing per element once the attribute
+ * and open element arrays have grown to the largest element. Views
+ * stay valid until the parser is closed or destroyed.
+ *
+ * Loaders are handed the parser positioned on their start element and
+ * read its attributes, then step through its children with NextChild.
+ * Children a loader does not step into are skipped for it.
+ *
+ * Attribute values and text are raw: entity references are left as
+ * they are in the file. Decode turns a view into a wide string with
+ * them replaced, for the few values, such as instruction text and
+ * wire endpoints, that are kept as strings. Levels use only the
+ * subset of XML wxXmlDocument writes: no DTD and no namespaces.
+ */
+class XmlPullParser
+{
+public:
+    /// What the parser read last
+    enum class Event {StartElement, EndElement, Text, End, Error};
+
+private:
+    /**
+     * An attribute of the current element
+     */
+    struct Attribute
+    {
+        /// Attribute name
+        std::string_view mName;
+
+        /// Attribute value, without the quotes
+        std::string_view mValue;
+    };
+
+    /// Mapped file, or nullptr if the text is not mapped
+    void *mMapping = nullptr;
+
+    /// Size of the mapping in bytes
+    size_t mMappingSize = 0;
+
+    /// Text read into memory where files cannot be mapped
+    std::string mBuffer;
+
+    /// Start of the text
+    const char *mBegin = nullptr;
+
+    /// End of the text
+    const char *mEnd = nullptr;
+
+    /// Next character to read
+    const char *mPos = nullptr;
+
+    /// Start of what was read last, for line numbers
+    const char *mEventStart = nullptr;
+
+    /// Position line numbers have been counted up to
+    mutable const char *mLineCounted = nullptr;
+
+    /// Line of mLineCounted
+    mutable int mLine = 1;
+
+    /// What was read last
+    Event mEvent = Event::End;
+
+    /// Name of the element started or ended
+    std::string_view mName;
+
+    /// Text read
+    std::string_view mText;
+
+    /// Attributes of the element started
+    std::vector<Attribute> mAttributes;
+
+    /// Names of the open elements, outermost first
+    std::vector<std::string_view> mOpen;
+
+    /// True if the element started was empty, as in <br/>, so its end comes next
+    bool mPendingEnd = false;
+
+    Event Fail();
+    bool Skip(std::string_view terminator);
+    bool ReadName(std::string_view &name);
+    void SkipSpace();
+
+public:
+    XmlPullParser() = default;
+    ~XmlPullParser();
+
+    /// Copy constructor (disabled)
+    XmlPullParser(const XmlPullParser &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const XmlPullParser &) = delete;
+
+    bool Open(const wxString &filename);
+    bool Read(const wxString &filename);
+    void SetText(std::string_view text);
+    void Close();
+    void Rewind();
+    bool IsWellFormed();
+
+    Event Next();
+    bool NextChild(int depth);
+
+    bool HasAttribute(std::string_view name) const;
+    std::string_view GetAttribute(std::string_view name, std::string_view defaultValue = {}) const;
+    double GetDouble(std::string_view name, double defaultValue) const;
+    long GetLong(std::string_view name, long defaultValue) const;
+    int GetLineNumber() const;
+
+    static bool ToDouble(std::string_view text, double &value);
+    static bool ToLong(std::string_view text, long &value);
+    static bool ToPair(std::string_view text, double &x, double &y);
+    static std::wstring Decode(std::string_view text);
+
+    /**
+     * Get what the parser read last
+     * @return Event read by the last call to Next
+     */
+    Event GetEvent() const { return mEvent; }
+
+    /**
+     * Is the parser on the start of an element?
+     * @return True if the last event started an element
+     */
+    bool IsStartElement() const { return mEvent == Event::StartElement; }
+
+    /**
+     * Get the number of open elements. On a start element this counts
+     * the element itself, and on an end element it no longer does.
+     * @return Depth of the parser in the document
+     */
+    int GetDepth() const { return (int)mOpen.size(); }
+
+    /**
+     * Get the name of the element started or ended
+     * @return Element name, a view into the file
+     */
+    std::string_view GetName() const { return mName; }
+
+    /**
+     * Get the text read
+     * @return Raw text, a view into the file
+     */
+    std::string_view GetText() const { return mText; }
+};
+
+#endif //XMLPULLPARSER_H
@@ -18,8 +18,13 @@
  * Each ID is associated with a specific action or menu item.
  */
 enum IDs {
+ // File menu
+ IDM_SAVECIRCUIT = wxID_HIGHEST + 1,
+ IDM_LOADCIRCUIT,
+ IDM_SAVESESSION,
+
  // View menu
- IDM_CONTROLPOINTS = wxID_HIGHEST + 1,
+ IDM_CONTROLPOINTS,
 
  // Levels menu
  IDM_LEVEL0,
@@ -31,6 +36,9 @@ enum IDs {
  IDM_LEVEL6,
  IDM_LEVEL7,
  IDM_LEVEL8,
+ IDM_LEVEL9,
+ IDM_LEVEL10,
+ IDM_REWIND,
 
  // Gates menu
  IDM_ANDGATE,
@@ -38,6 +46,23 @@ enum IDs {
  IDM_NOTGATE,
  IDM_SRFLIPFLOP,
  IDM_DFLIPFLOP,
+ IDM_AND4GATE,
+ IDM_OR4GATE,
+ IDM_XORGATE,
+ IDM_NANDGATE,
+ IDM_NORGATE,
+ IDM_VERIFYCIRCUIT,
+
+ // Speed menu options
+ IDM_SPEED1,
+ IDM_SPEED2,
+ IDM_SPEED8,
+ IDM_SPEEDMAX,
+
+ // Bus items in the Gates menu, after the ids session logs already hold
+ IDM_AND4BUS,
+ IDM_BUSJOIN,
+ IDM_BUSSPLIT,
 
  // Timers
  IDM_GAME_TIMER
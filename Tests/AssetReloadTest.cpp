@@ -0,0 +1,121 @@
+/**
+ * @file AssetReloadTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <CircuitSerializer.h>
+#include <Game.h>
+#include <ItemVisitor.h>
+#include <SpriteAtlas.h>
+#include <XmlPullParser.h>
+#include <ids.h>
+
+using namespace std;
+
+/**
+ * Visitor that counts products
+ */
+class ProductCounter : public ItemVisitor
+{
+public:
+    /// Products visited
+    int mProducts = 0;
+
+    /**
+     * Count a product
+     * @param product Product we are visiting
+     */
+    void VisitProduct(Product *product) override { mProducts++; }
+};
+
+/**
+ * Save an opaque image of one size
+ * @param filename File to save to
+ * @param size Width and height
+ */
+static void SaveImage(const wxString &filename, int size)
+{
+    wxImage image(size, size);
+    image.SetRGB(wxRect(0, 0, size, size), 200, 0, 0);
+    ASSERT_TRUE(image.SaveFile(filename, wxBITMAP_TYPE_PNG));
+}
+
+TEST(AssetReloadTest, Images)
+{
+    auto directory = wxFileName::CreateTempFileName(L"images");
+    wxRemoveFile(directory);
+    ASSERT_TRUE(wxMkdir(directory));
+    SaveImage(directory + L"/a.png", 10);
+    SaveImage(directory + L"/b.png", 20);
+
+    SpriteAtlas atlas;
+    ASSERT_TRUE(atlas.Build(directory));
+    int a = atlas.Find(L"a.png");
+    int b = atlas.Find(L"b.png");
+
+    // Edit one image, remove one and add one
+    SaveImage(directory + L"/b.png", 30);
+    wxRemoveFile(directory + L"/a.png");
+    SaveImage(directory + L"/c.png", 5);
+
+    auto version = atlas.GetVersion();
+    auto rebuilt = atlas.Rebuild(directory);
+    atlas.Swap(*rebuilt);
+
+    // Views make their bitmaps again from the new images
+    ASSERT_NE(version, atlas.GetVersion());
+
+    // Sprites keep their index, so items need not find them again
+    ASSERT_EQ(a, atlas.Find(L"a.png"));
+    ASSERT_EQ(b, atlas.Find(L"b.png"));
+    ASSERT_EQ(wxSize(30, 30), atlas.GetSize(b));
+    ASSERT_FALSE(atlas.IsTransparent(b, 29, 29));
+    ASSERT_TRUE(atlas.IsTransparent(a, 0, 0));
+    ASSERT_EQ(2, atlas.Find(L"c.png"));
+    ASSERT_EQ(wxSize(5, 5), atlas.GetSize(atlas.Find(L"c.png")));
+
+    // The old images went to the other atlas
+    ASSERT_EQ(wxSize(20, 20), rebuilt->GetSize(b));
+
+    wxFileName::Rmdir(directory, wxPATH_RMDIR_RECURSIVE);
+}
+
+TEST(AssetReloadTest, Level)
+{
+    Game game;
+    game.SelectLevel(1);
+    ASSERT_EQ(L"levels/level1.xml", game.GetLevelFile());
+    ASSERT_TRUE(game.OnCommand(IDM_ANDGATE));
+
+    ProductCounter before;
+    game.Accept(&before);
+
+    // The level file as a designer edited it, with one more product
+    ifstream in("levels/level1.xml", ios::binary);
+    string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    auto conveyor = text.find("</conveyor>");
+    ASSERT_NE(string::npos, conveyor);
+    text.insert(conveyor, "<product placement=\"700\" shape=\"circle\" color=\"red\" kick=\"no\"/>\n");
+
+    XmlPullParser parser;
+    parser.SetText(text);
+    ASSERT_TRUE(parser.IsWellFormed());
+    game.ReloadLevel(parser);
+
+    ProductCounter after;
+    game.Accept(&after);
+    ASSERT_EQ(before.mProducts + 1, after.mProducts);
+
+    // The player's circuit is kept
+    CircuitSerializer circuit;
+    circuit.Capture(&game);
+    ASSERT_EQ(1u, circuit.GetGates().size());
+    ASSERT_EQ(L"levels/level1.xml", game.GetLevelFile());
+}
@@ -0,0 +1,108 @@
+/**
+ * @file BatchGraderTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <BatchGrader.h>
+#include <WorkStealingPool.h>
+
+using namespace std;
+
+/// Level whose circuit is a single wire from the beam to Sparty
+const wstring GradedLevel = L"levels/level1.xml";
+
+/**
+ * Write a circuit file that wires the beam straight to Sparty
+ * @return Name of the file, to be removed by the caller
+ */
+static wstring WriteBeamCircuit()
+{
+    auto filename = wxFileName::CreateTempFileName(L"circuit");
+    ofstream out(filename.ToStdString());
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<circuit><wire from=\"beam\" to=\"sparty\"/></circuit>\n";
+    return filename.ToStdWstring();
+}
+
+TEST(BatchGraderTest, PlaysLevel)
+{
+    auto circuit = WriteBeamCircuit();
+
+    BatchGrader grader;
+    ASSERT_TRUE(grader.AddJob(GradedLevel, circuit));
+    ASSERT_TRUE(grader.AddJob(GradedLevel, L""));
+
+    WorkStealingPool pool(2);
+    grader.Run(pool);
+    wxRemoveFile(circuit);
+
+    // Every product in the level should be kicked
+    const auto &wired = grader.GetResult(0);
+    ASSERT_TRUE(wired.mFinished);
+    ASSERT_EQ(wired.mProducts, 4);
+    ASSERT_EQ(wired.mKicked, 4);
+    ASSERT_EQ(wired.mCorrect, 4);
+
+    const auto &unwired = grader.GetResult(1);
+    ASSERT_TRUE(unwired.mFinished);
+    ASSERT_EQ(unwired.mKicked, 0);
+    ASSERT_EQ(unwired.mCorrect, 0);
+    ASSERT_GT(wired.mScore, unwired.mScore);
+}
+
+TEST(BatchGraderTest, ParallelMatchesSerial)
+{
+    auto circuit = WriteBeamCircuit();
+
+    BatchGrader serial;
+    BatchGrader parallel;
+    for (int level = 0; level <= 8; level++)
+    {
+        auto name = L"levels/level" + to_wstring(level) + L".xml";
+        serial.AddJob(name, circuit);
+        parallel.AddJob(name, circuit);
+    }
+
+    WorkStealingPool one(1);
+    WorkStealingPool many(4);
+    serial.Run(one);
+    parallel.Run(many);
+    wxRemoveFile(circuit);
+
+    ASSERT_EQ(serial.GetNumJobs(), parallel.GetNumJobs());
+    for (int job = 0; job < serial.GetNumJobs(); job++)
+    {
+        const auto &a = serial.GetResult(job);
+        const auto &b = parallel.GetResult(job);
+        ASSERT_EQ(a.mFinished, b.mFinished);
+        ASSERT_EQ(a.mScore, b.mScore);
+        ASSERT_EQ(a.mKicked, b.mKicked);
+        ASSERT_EQ(a.mCorrect, b.mCorrect);
+        ASSERT_EQ(a.mSimulatedTime, b.mSimulatedTime);
+    }
+}
+
+TEST(BatchGraderTest, Csv)
+{
+    BatchGrader grader;
+    ASSERT_FALSE(grader.AddJob(L"levels/missing.xml", L"a,b.xml"));
+
+    WorkStealingPool pool(1);
+    grader.Run(pool);
+    ASSERT_FALSE(grader.GetResult(0).mLoaded);
+
+    stringstream csv;
+    grader.WriteCsv(csv);
+
+    string header, row;
+    getline(csv, header);
+    getline(csv, row);
+    ASSERT_EQ(header, "level,circuit,loaded,finished,score,products,kicked,correct,simulated_s,load_ms,run_ms");
+    ASSERT_EQ(row.substr(0, 40), "levels/missing.xml,\"a,b.xml\",0,0,0,0,0,");
+}
@@ -0,0 +1,143 @@
+/**
+ * @file CircuitHashTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <CircuitHash.h>
+#include <CircuitSimulator.h>
+#include <CircuitVerifier.h>
+#include <Netlist.h>
+#include <TruthTableCache.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+/**
+ * Build (NOT green) AND beam into Sparty
+ * @param netlist Empty netlist to build in
+ * @param notFirst Add the NOT gate before the AND gate
+ * @param swap Wire the AND gate's operands the other way round
+ */
+static void BuildKickAllButGreen(Netlist &netlist, bool notFirst, bool swap)
+{
+    int green = netlist.AddInput(L"green");
+    int beam = netlist.AddInput(CircuitVerifier::BeamInput);
+
+    int notGate = notFirst ? netlist.AddCell(Netlist::CellType::Not) : -1;
+    int andGate = netlist.AddCell(Netlist::CellType::And);
+    if (!notFirst)
+    {
+        notGate = netlist.AddCell(Netlist::CellType::Not);
+    }
+
+    netlist.ConnectInput(notGate, 0, green);
+    netlist.ConnectInput(andGate, swap ? 1 : 0, netlist.GetCells()[notGate].mOutput);
+    netlist.ConnectInput(andGate, swap ? 0 : 1, beam);
+    netlist.SetKickNet(netlist.GetCells()[andGate].mOutput);
+}
+
+/// Products for the kick-all-but-green circuit
+static const vector<CircuitVerifier::ProductSpec> Products = {
+    MakeProduct({L"red", L"square"}, true),
+    MakeProduct({L"green", L"circle"}, false),
+    MakeProduct({L"blue"}, true)};
+
+TEST(CircuitHashTest, IgnoresOrder)
+{
+    Netlist a, b, c;
+    BuildKickAllButGreen(a, true, false);
+    BuildKickAllButGreen(b, false, false);
+    BuildKickAllButGreen(c, true, true);
+
+    ASSERT_EQ(CircuitHash(a).GetKickHash(), CircuitHash(b).GetKickHash());
+    ASSERT_EQ(CircuitHash(a).GetKickHash(), CircuitHash(c).GetKickHash());
+}
+
+TEST(CircuitHashTest, Distinguishes)
+{
+    Netlist a, b;
+    BuildKickAllButGreen(a, true, false);
+
+    // The same shape with OR in place of AND
+    int green = b.AddInput(L"green");
+    int beam = b.AddInput(CircuitVerifier::BeamInput);
+    int notGate = b.AddCell(Netlist::CellType::Not);
+    int orGate = b.AddCell(Netlist::CellType::Or);
+    b.ConnectInput(notGate, 0, green);
+    b.ConnectInput(orGate, 0, b.GetCells()[notGate].mOutput);
+    b.ConnectInput(orGate, 1, beam);
+    b.SetKickNet(b.GetCells()[orGate].mOutput);
+
+    ASSERT_NE(CircuitHash(a).GetKickHash(), CircuitHash(b).GetKickHash());
+
+    // Different products must not share verification results
+    ASSERT_NE(CircuitHash::HashProducts(Products), CircuitHash::HashProducts({Products[0], Products[1]}));
+}
+
+TEST(CircuitHashTest, Feedback)
+{
+    // Two NOT gates in a ring, built in either order
+    Netlist a, b;
+    for (auto netlist : {&a, &b})
+    {
+        int first = netlist->AddCell(Netlist::CellType::Not);
+        int second = netlist->AddCell(Netlist::CellType::Not);
+        netlist->ConnectInput(first, 0, netlist->GetCells()[second].mOutput);
+        netlist->ConnectInput(second, 0, netlist->GetCells()[first].mOutput);
+        netlist->SetKickNet(netlist->GetCells()[netlist == &a ? first : second].mOutput);
+    }
+
+    ASSERT_EQ(CircuitHash(a).GetKickHash(), CircuitHash(b).GetKickHash());
+}
+
+TEST(CircuitHashTest, TablesMatchSimulation)
+{
+    Netlist netlist;
+    BuildKickAllButGreen(netlist, true, false);
+
+    TruthTableCache cache;
+    CircuitSimulator simulator(netlist, &cache);
+    ASSERT_EQ(simulator.GetNumTables(), 1);
+
+    auto plain = CircuitVerifier(netlist).Verify(Products);
+    auto first = CircuitVerifier(netlist, &cache).Verify(Products);
+    uint64_t hits = cache.GetHits();
+    auto second = CircuitVerifier(netlist, &cache).Verify(Products);
+
+    ASSERT_GT(cache.GetHits(), hits);
+    for (size_t i = 0; i < Products.size(); i++)
+    {
+        ASSERT_EQ(plain[i].mKicked, first[i].mKicked);
+        ASSERT_EQ(plain[i].mKicked, second[i].mKicked);
+        ASSERT_EQ(plain[i].mStateDependent, second[i].mStateDependent);
+    }
+    ASSERT_EQ(CircuitVerifier::CountMisKicks(second), 0);
+}
+
+TEST(CircuitHashTest, SaveLoad)
+{
+    TruthTableCache cache;
+    cache.Insert(1, LogicWord::Splat(States::One));
+    cache.Insert(0xFFFFFFFFFFFFFFFFull, LogicWord{0x1234, 0x5678});
+
+    auto filename = wxFileName::CreateTempFileName(L"cache").ToStdString();
+    ASSERT_TRUE(cache.Save(filename));
+
+    TruthTableCache loaded;
+    ASSERT_TRUE(loaded.Load(filename));
+    wxRemoveFile(filename);
+
+    ASSERT_EQ(loaded.GetSize(), 2u);
+
+    LogicWord table;
+    ASSERT_TRUE(loaded.Find(1, table));
+    ASSERT_TRUE(table == LogicWord::Splat(States::One));
+    ASSERT_TRUE(loaded.Find(0xFFFFFFFFFFFFFFFFull, table));
+    ASSERT_EQ(table.mOne, 0x1234u);
+    ASSERT_EQ(table.mZero, 0x5678u);
+    ASSERT_FALSE(loaded.Find(2, table));
+}
@@ -0,0 +1,152 @@
+/**
+ * @file CircuitOptimizerTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <random>
+#include <Aig.h>
+#include <CircuitOptimizer.h>
+#include <CircuitSimulator.h>
+#include <CircuitVerifier.h>
+#include <Netlist.h>
+
+using namespace std;
+
+/**
+ * Add a two input gate
+ * @param netlist Netlist to add to
+ * @param type Kind of gate
+ * @param a Net wired to the first input
+ * @param b Net wired to the second input
+ * @return Net the gate drives
+ */
+static int AddGate(Netlist &netlist, Netlist::CellType type, int a, int b = Netlist::Unconnected)
+{
+    int cell = netlist.AddCell(type);
+    netlist.ConnectInput(cell, 0, a);
+    if (type != Netlist::CellType::Not)
+    {
+        netlist.ConnectInput(cell, 1, b);
+    }
+    return netlist.GetCells()[cell].mOutput;
+}
+
+TEST(CircuitOptimizerTest, AigRules)
+{
+    Aig aig;
+    int a = aig.AddInput(true);
+    int b = aig.AddInput(true);
+    int q = aig.AddInput(false);
+
+    ASSERT_EQ(aig.And(a, b), aig.And(b, a));
+    ASSERT_EQ(aig.And(a, a), a);
+    ASSERT_EQ(aig.And(a, Aig::True), a);
+    ASSERT_EQ(aig.And(a, Aig::False), Aig::False);
+    ASSERT_EQ(aig.And(a, Aig::Not(a)), Aig::False);
+    ASSERT_EQ(aig.And(a, Aig::Unknown), Aig::Unknown);
+    ASSERT_EQ(aig.And(a, aig.And(a, b)), aig.And(a, b));
+    ASSERT_EQ(Aig::Not(Aig::Not(b)), b);
+
+    // A flip flop output may be Unknown, which Zero would hide
+    ASSERT_NE(aig.And(q, Aig::Not(q)), Aig::False);
+    ASSERT_NE(aig.And(q, Aig::False), Aig::False);
+    ASSERT_EQ(aig.And(q, Aig::True), q);
+}
+
+TEST(CircuitOptimizerTest, RemovesRedundantGates)
+{
+    Netlist netlist;
+    int red = netlist.AddInput(L"red");
+    int beam = netlist.AddInput(CircuitVerifier::BeamInput);
+
+    // NOT NOT red, two identical ANDs ORed together, and an unused gate
+    int notNot = AddGate(netlist, Netlist::CellType::Not, AddGate(netlist, Netlist::CellType::Not, red));
+    int first = AddGate(netlist, Netlist::CellType::And, notNot, beam);
+    int second = AddGate(netlist, Netlist::CellType::And, beam, red);
+    AddGate(netlist, Netlist::CellType::Or, red, beam);
+    netlist.SetKickNet(AddGate(netlist, Netlist::CellType::Or, first, second));
+
+    CircuitOptimizer optimizer(netlist);
+    ASSERT_EQ(optimizer.GetOriginalGates(), 6);
+    ASSERT_EQ(optimizer.GetOptimizedGates(), 1);
+    ASSERT_EQ(optimizer.GetNumAnds(), 1);
+
+    // Sparty depends on every gate but the unused one
+    ASSERT_EQ(netlist.GetNumCellsFeeding(netlist.GetKickNet()), 5);
+    ASSERT_EQ(netlist.GetNumCellsFeeding(notNot), 2);
+    ASSERT_EQ(netlist.GetNumCellsFeeding(red), 0);
+}
+
+TEST(CircuitOptimizerTest, UnknownPropagates)
+{
+    Netlist netlist;
+    int red = netlist.AddInput(L"red");
+    int gate = AddGate(netlist, Netlist::CellType::And, red, Netlist::Unconnected);
+    netlist.SetKickNet(AddGate(netlist, Netlist::CellType::Not, gate));
+
+    CircuitOptimizer optimizer(netlist);
+    ASSERT_EQ(optimizer.GetOptimizedGates(), 0);
+    ASSERT_TRUE(optimizer.GetOptimized().GetKickNet() == Netlist::Unconnected);
+}
+
+TEST(CircuitOptimizerTest, MatchesOriginal)
+{
+    mt19937 engine(2024);
+    for (int trial = 0; trial < 500; trial++)
+    {
+        Netlist netlist;
+        vector<int> nets;
+        int inputs = 1 + engine() % 3;
+        for (int i = 0; i < inputs; i++)
+        {
+            nets.push_back(netlist.AddInput(wstring(1, L'a' + i)));
+        }
+
+        int cells = 1 + engine() % 8;
+        for (int c = 0; c < cells; c++)
+        {
+            int cell = netlist.AddCell((Netlist::CellType)(engine() % 8), 2 + engine() % 3);
+            nets.push_back(netlist.GetCells()[cell].mOutput);
+            if (netlist.GetCells()[cell].mOutputNot != Netlist::Unconnected)
+            {
+                nets.push_back(netlist.GetCells()[cell].mOutputNot);
+            }
+        }
+
+        for (int c = 0; c < cells; c++)
+        {
+            for (int pin = 0; pin < (int)netlist.GetCells()[c].mInputs.size(); pin++)
+            {
+                if (engine() % 8 != 0)
+                {
+                    netlist.ConnectInput(c, pin, nets[engine() % nets.size()]);
+                }
+            }
+        }
+        netlist.SetKickNet(nets[engine() % nets.size()]);
+
+        CircuitOptimizer optimizer(netlist);
+        const auto &optimized = optimizer.GetOptimized();
+        ASSERT_LE(optimizer.GetOptimizedGates(), optimizer.GetOriginalGates());
+
+        CircuitSimulator original(netlist);
+        CircuitSimulator simulator(optimized);
+        original.Reset();
+        simulator.Reset();
+        for (int step = 0; step < 8; step++)
+        {
+            for (int i = 0; i < inputs; i++)
+            {
+                auto value = LogicWord::Splat(engine() % 2 ? States::One : States::Zero);
+                original.SetInput(i, value);
+                simulator.SetInput(i, value);
+            }
+
+            original.Settle();
+            simulator.Settle();
+            ASSERT_TRUE(original.GetNet(netlist.GetKickNet()) == simulator.GetNet(optimized.GetKickNet()));
+        }
+    }
+}
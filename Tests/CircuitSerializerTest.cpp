@@ -0,0 +1,204 @@
+/**
+ * @file CircuitSerializerTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <memory>
+#include <sstream>
+#include <AndGate.h>
+#include <CircuitSerializer.h>
+#include <Game.h>
+#include <LevelLoader.h>
+#include <NotGate.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+/**
+ * Add a wire to a game
+ * @param game Game to wire
+ * @param from Output endpoint
+ * @param to Input endpoint
+ */
+static void AddWire(Game &game, const wstring &from, const wstring &to)
+{
+    game.XmlWire(from, to);
+}
+
+/**
+ * Build NOT red AND beam into Sparty on level 2, with gates as a
+ * player adds them, without ids
+ * @param game Game to build in
+ */
+static void BuildCircuit(Game &game)
+{
+    LevelLoader loader;
+    loader.LoadLevel(L"levels/level2.xml", &game);
+
+    auto notGate = make_shared<NotGate>(&game);
+    auto andGate = make_shared<AndGate>(&game);
+    game.Add(notGate, 400, 300);
+    game.Add(andGate, 500, 350);
+
+    CircuitSerializer ids;
+    ids.Capture(&game);
+    AddWire(game, L"sensor.red", notGate->GetId());
+    AddWire(game, notGate->GetId(), andGate->GetId());
+    AddWire(game, L"beam", andGate->GetId() + L".1");
+    AddWire(game, andGate->GetId(), L"sparty");
+}
+
+/**
+ * Check that two circuits hold the same gates and wires
+ * @param a First circuit
+ * @param b Second circuit
+ */
+static void ExpectSame(const CircuitSerializer &a, const CircuitSerializer &b)
+{
+    ASSERT_EQ(a.GetGates().size(), b.GetGates().size());
+    for (size_t g = 0; g < a.GetGates().size(); g++)
+    {
+        const auto &x = a.GetGates()[g];
+        const auto &y = b.GetGates()[g];
+        ASSERT_EQ(x.mType, y.mType);
+        ASSERT_EQ(x.mId, y.mId);
+        ASSERT_EQ(x.mX, y.mX);
+        ASSERT_EQ(x.mY, y.mY);
+        ASSERT_EQ(x.mFunction, y.mFunction);
+        ASSERT_EQ(x.mInputs, y.mInputs);
+        ASSERT_EQ(x.mWidth, y.mWidth);
+    }
+
+    ASSERT_EQ(a.GetWires().size(), b.GetWires().size());
+    for (size_t w = 0; w < a.GetWires().size(); w++)
+    {
+        ASSERT_EQ(a.GetWires()[w].mFrom, b.GetWires()[w].mFrom);
+        ASSERT_EQ(a.GetWires()[w].mTo, b.GetWires()[w].mTo);
+    }
+}
+
+TEST(CircuitSerializerTest, Capture)
+{
+    Game game;
+    BuildCircuit(game);
+
+    CircuitSerializer circuit;
+    circuit.Capture(&game);
+    ASSERT_EQ(circuit.GetGates().size(), 2u);
+    ASSERT_EQ(circuit.GetGates()[0].mType, L"notgate");
+    ASSERT_EQ(circuit.GetGates()[0].mId, L"g1");
+    ASSERT_EQ(circuit.GetGates()[1].mX, 500);
+    ASSERT_EQ(circuit.GetWires().size(), 4u);
+    ASSERT_EQ(circuit.GetWires()[0].mFrom, L"g2");
+    ASSERT_EQ(circuit.GetWires()[0].mTo, L"sparty");
+    ASSERT_EQ(circuit.GetWires()[3].mFrom, L"beam");
+    ASSERT_EQ(circuit.GetWires()[3].mTo, L"g2.1");
+
+    // Ids stay put from one capture to the next
+    CircuitSerializer again;
+    again.Capture(&game);
+    ExpectSame(circuit, again);
+}
+
+TEST(CircuitSerializerTest, RoundTrip)
+{
+    Game game;
+    BuildCircuit(game);
+
+    CircuitSerializer circuit;
+    circuit.Capture(&game);
+
+    stringstream binary;
+    circuit.Write(binary);
+    CircuitSerializer fromBinary;
+    ASSERT_TRUE(fromBinary.Read(binary));
+    ExpectSame(circuit, fromBinary);
+
+    wxXmlNode root(wxXML_ELEMENT_NODE, L"circuit");
+    circuit.XmlSave(&root);
+    CircuitSerializer fromXml;
+    fromXml.XmlLoad(&root);
+    ExpectSame(circuit, fromXml);
+
+    stringstream truncated(binary.str().substr(0, binary.str().size() / 2));
+    ASSERT_FALSE(fromBinary.Read(truncated));
+}
+
+TEST(CircuitSerializerTest, Apply)
+{
+    Game built;
+    BuildCircuit(built);
+    CircuitSerializer circuit;
+    circuit.Capture(&built);
+
+    // Applying replaces whatever circuit the game had
+    Game other;
+    BuildCircuit(other);
+    other.Add(make_shared<AndGate>(&other));
+    circuit.Apply(&other);
+
+    CircuitSerializer applied;
+    applied.Capture(&other);
+    ExpectSame(circuit, applied);
+}
+
+TEST(CircuitSerializerTest, KeptPerLevel)
+{
+    Game game;
+    BuildCircuit(game);
+    CircuitSerializer circuit;
+    circuit.Capture(&game);
+
+    LevelLoader loader;
+    loader.LoadLevel(L"levels/level1.xml", &game);
+    CircuitSerializer level1;
+    level1.Capture(&game);
+    ASSERT_TRUE(level1.GetGates().empty());
+
+    loader.LoadLevel(L"levels/level2.xml", &game);
+    CircuitSerializer level2;
+    level2.Capture(&game);
+    ExpectSame(circuit, level2);
+}
+
+TEST(CircuitSerializerTest, Buses)
+{
+    Game game;
+    LevelLoader loader;
+    loader.LoadLevel(L"levels/level2.xml", &game);
+
+    // The beam through bit 2 of a bus and back out into Sparty
+    LoadItem(game, R"(<busjoin id="j" width="3"/>)");
+    LoadItem(game, R"(<bussplit id="s" width="3"/>)");
+    AddWire(game, L"beam", L"j.2");
+    AddWire(game, L"j", L"s");
+    AddWire(game, L"s.2", L"sparty");
+
+    CircuitSerializer circuit;
+    circuit.Capture(&game);
+    ASSERT_EQ(circuit.GetGates().size(), 2u);
+    ASSERT_EQ(circuit.GetGates()[0].mType, L"busjoin");
+    ASSERT_EQ(circuit.GetGates()[1].mWidth, 3);
+    ASSERT_EQ(circuit.GetWires().size(), 3u);
+
+    stringstream binary;
+    circuit.Write(binary);
+    CircuitSerializer fromBinary;
+    ASSERT_TRUE(fromBinary.Read(binary));
+    ExpectSame(circuit, fromBinary);
+
+    wxXmlNode root(wxXML_ELEMENT_NODE, L"circuit");
+    circuit.XmlSave(&root);
+    CircuitSerializer fromXml;
+    fromXml.XmlLoad(&root);
+    ExpectSame(circuit, fromXml);
+
+    Game other;
+    loader.LoadLevel(L"levels/level2.xml", &other);
+    circuit.Apply(&other);
+    CircuitSerializer applied;
+    applied.Capture(&other);
+    ExpectSame(circuit, applied);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file CircuitSynthesizerTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <CircuitSynthesizer.h>
+#include <CircuitVerifier.h>
+#include <WorkStealingPool.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+/**
+ * Check a synthesized circuit with the verifier
+ * @param netlist Circuit to check
+ * @param products Products the circuit must handle
+ * @return Number of mis-kicked products
+ */
+static int MisKicks(const Netlist &netlist, const vector<CircuitVerifier::ProductSpec> &products)
+{
+    CircuitVerifier verifier(netlist);
+    return CircuitVerifier::CountMisKicks(verifier.Verify(products));
+}
+
+TEST(CircuitSynthesizerTest, KickEverything)
+{
+    vector<wstring> inputs = {L"red", L"green", CircuitVerifier::BeamInput};
+    vector<CircuitVerifier::ProductSpec> products = {MakeProduct({L"red"}, true),
+                                                     MakeProduct({L"green"}, true)};
+
+    WorkStealingPool pool(2);
+    CircuitSynthesizer synthesizer(inputs, products);
+    ASSERT_TRUE(synthesizer.Synthesize(pool));
+
+    // Wiring the beam straight to Sparty needs no gates
+    ASSERT_EQ(synthesizer.GetSolutionGates(), 0);
+    ASSERT_EQ(MisKicks(synthesizer.GetSolution(), products), 0);
+}
+
+TEST(CircuitSynthesizerTest, KickAllButGreen)
+{
+    // Level 3
+    vector<wstring> inputs = {L"red", L"green", L"blue", CircuitVerifier::BeamInput};
+    vector<CircuitVerifier::ProductSpec> products = {MakeProduct({L"square", L"green", L"izzo"}, false),
+                                                     MakeProduct({L"square", L"red"}, true),
+                                                     MakeProduct({L"diamond", L"blue"}, true),
+                                                     MakeProduct({L"circle", L"green", L"smith"}, false),
+                                                     MakeProduct({L"diamond", L"blue", L"basketball"}, true),
+                                                     MakeProduct({L"square", L"red", L"football"}, true)};
+
+    WorkStealingPool pool(4);
+    CircuitSynthesizer synthesizer(inputs, products);
+    ASSERT_TRUE(synthesizer.Synthesize(pool));
+
+    ASSERT_GE(synthesizer.GetSolutionGates(), 1);
+    ASSERT_LE(synthesizer.GetSolutionGates(), 2);
+    ASSERT_EQ(MisKicks(synthesizer.GetSolution(), products), 0);
+}
+
+TEST(CircuitSynthesizerTest, RemembersPreviousProduct)
+{
+    // Kick a product only when the one before it was red,
+    // which no combinational circuit can do
+    vector<wstring> inputs = {L"red", L"green", L"blue", CircuitVerifier::BeamInput};
+    vector<CircuitVerifier::ProductSpec> products = {MakeProduct({L"red"}, false),
+                                                     MakeProduct({L"blue"}, true),
+                                                     MakeProduct({L"green"}, false),
+                                                     MakeProduct({L"red"}, false),
+                                                     MakeProduct({L"red"}, true),
+                                                     MakeProduct({L"green"}, true),
+                                                     MakeProduct({L"blue"}, false)};
+
+    WorkStealingPool pool;
+    CircuitSynthesizer synthesizer(inputs, products);
+    ASSERT_TRUE(synthesizer.Synthesize(pool));
+
+    ASSERT_GT(synthesizer.GetSolution().GetNumLatches(), 0);
+    ASSERT_EQ(MisKicks(synthesizer.GetSolution(), products), 0);
+}
+
+TEST(CircuitSynthesizerTest, GivesUpAtGateLimit)
+{
+    vector<wstring> inputs = {L"red", L"green", L"blue", CircuitVerifier::BeamInput};
+    vector<CircuitVerifier::ProductSpec> products = {MakeProduct({L"red"}, false),
+                                                     MakeProduct({L"blue"}, true),
+                                                     MakeProduct({L"green"}, false),
+                                                     MakeProduct({L"red"}, false),
+                                                     MakeProduct({L"red"}, true)};
+
+    WorkStealingPool pool(2);
+    CircuitSynthesizer synthesizer(inputs, products);
+    synthesizer.SetMaxGates(1);
+    ASSERT_FALSE(synthesizer.Synthesize(pool));
+    ASSERT_EQ(synthesizer.GetSolutionGates(), -1);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file CircuitVerifierTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <CircuitVerifier.h>
+#include <Netlist.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(CircuitVerifierTest, Unwired)
+{
+    Netlist netlist;
+    netlist.AddInput(CircuitVerifier::BeamInput);
+
+    CircuitVerifier verifier(netlist);
+    auto results = verifier.Verify({MakeProduct({L"red"}, true), MakeProduct({L"green"}, false)});
+
+    ASSERT_EQ(results.size(), 2u);
+    ASSERT_FALSE(results[0].mKicked);
+    ASSERT_FALSE(results[1].mKicked);
+    ASSERT_EQ(CircuitVerifier::CountMisKicks(results), 1);
+}
+
+TEST(CircuitVerifierTest, BeamKicksEverything)
+{
+    Netlist netlist;
+    netlist.SetKickNet(netlist.AddInput(CircuitVerifier::BeamInput));
+
+    CircuitVerifier verifier(netlist);
+    auto results = verifier.Verify({MakeProduct({L"red"}, true),
+                                    MakeProduct({L"green"}, true),
+                                    MakeProduct({}, true)});
+
+    for (const auto &result : results)
+    {
+        ASSERT_TRUE(result.mKicked);
+        ASSERT_FALSE(result.mStateDependent);
+    }
+    ASSERT_EQ(CircuitVerifier::CountMisKicks(results), 0);
+}
+
+TEST(CircuitVerifierTest, KickAllButGreen)
+{
+    Netlist netlist;
+    int green = netlist.AddInput(L"green");
+    int beam = netlist.AddInput(CircuitVerifier::BeamInput);
+
+    int notGate = netlist.AddCell(Netlist::CellType::Not);
+    netlist.ConnectInput(notGate, 0, green);
+
+    int andGate = netlist.AddCell(Netlist::CellType::And);
+    netlist.ConnectInput(andGate, 0, netlist.GetCells()[notGate].mOutput);
+    netlist.ConnectInput(andGate, 1, beam);
+    netlist.SetKickNet(netlist.GetCells()[andGate].mOutput);
+
+    CircuitVerifier verifier(netlist);
+    auto results = verifier.Verify({MakeProduct({L"red", L"square"}, true),
+                                    MakeProduct({L"green", L"circle"}, false),
+                                    MakeProduct({L"green"}, true),
+                                    MakeProduct({L"blue"}, true)});
+
+    ASSERT_TRUE(results[0].mKicked);
+    ASSERT_FALSE(results[1].mKicked);
+    ASSERT_FALSE(results[2].mKicked);
+    ASSERT_TRUE(results[3].mKicked);
+
+    ASSERT_FALSE(results[2].mExpectedKick == results[2].mKicked);
+    ASSERT_EQ(CircuitVerifier::CountMisKicks(results), 1);
+}
+
+TEST(CircuitVerifierTest, FlipFlopStateDependence)
+{
+    // Green sets the flip flop, red resets it, and
+    // Sparty kicks whenever it is set as the beam breaks
+    Netlist netlist;
+    int green = netlist.AddInput(L"green");
+    int red = netlist.AddInput(L"red");
+    int beam = netlist.AddInput(CircuitVerifier::BeamInput);
+
+    int flipFlop = netlist.AddCell(Netlist::CellType::SrFlipFlop);
+    netlist.ConnectInput(flipFlop, 0, green);
+    netlist.ConnectInput(flipFlop, 1, red);
+
+    int andGate = netlist.AddCell(Netlist::CellType::And);
+    netlist.ConnectInput(andGate, 0, netlist.GetCells()[flipFlop].mOutput);
+    netlist.ConnectInput(andGate, 1, beam);
+    netlist.SetKickNet(netlist.GetCells()[andGate].mOutput);
+
+    ASSERT_EQ(netlist.GetNumLatches(), 1);
+
+    CircuitVerifier verifier(netlist);
+    auto results = verifier.Verify({MakeProduct({L"blue"}, false),
+                                    MakeProduct({L"green"}, true),
+                                    MakeProduct({L"blue"}, true),
+                                    MakeProduct({L"red"}, false)});
+
+    // The first product depends on how the flip flop starts,
+    // after that green and red decide everything
+    ASSERT_FALSE(results[0].mKicked);
+    ASSERT_TRUE(results[0].mStateDependent);
+
+    ASSERT_TRUE(results[1].mKicked);
+    ASSERT_FALSE(results[1].mStateDependent);
+
+    ASSERT_TRUE(results[2].mKicked);
+    ASSERT_FALSE(results[2].mStateDependent);
+
+    ASSERT_FALSE(results[3].mKicked);
+    ASSERT_FALSE(results[3].mStateDependent);
+
+    ASSERT_EQ(CircuitVerifier::CountMisKicks(results), 0);
+}
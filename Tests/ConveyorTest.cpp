@@ -45,4 +45,12 @@ TEST(ConveyorTest, OnClick) {
     ASSERT_TRUE(conveyor.IsRunning());
     conveyor.OnClick(250, 500);
     ASSERT_FALSE(conveyor.IsRunning());
-}
\ No newline at end of file
+}
+
+TEST(ConveyorTest, PlacedY) {
+    // Placements are up the belt from its center, or from the
+    // product before when they start with a +
+    ASSERT_DOUBLE_EQ(Conveyor::PlacedY("125", 400, 0), 275);
+    ASSERT_DOUBLE_EQ(Conveyor::PlacedY("+10", 400, 275), 265);
+    ASSERT_DOUBLE_EQ(Conveyor::PlacedY("", 400, 275), 400);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file FrameRendererTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <FrameRenderer.h>
+#include <Game.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+/// Size of the frames compared with the golden images
+const int FrameWidth = 575;
+
+/// Height of the frames compared with the golden images
+const int FrameHeight = 400;
+
+/// How far a color channel may be off, for the platform's antialiasing
+const int ChannelTolerance = 16;
+
+/// Fraction of the pixels that may differ, for the platform's fonts
+const double PixelTolerance = 0.005;
+
+/// Seconds each update covers
+const double TimeStep = 0.03;
+
+/**
+ * Compare a frame with its golden image. With RECORD_GOLDEN set in
+ * the environment the frame is saved as the golden image instead.
+ * A frame without a golden image fails, so a missing golden image
+ * cannot pass unnoticed.
+ * @param frame The frame drawn
+ * @param name Name of the golden image, without the directory
+ */
+static void CompareGolden(const wxImage &frame, const wxString &name)
+{
+    wxFileName golden(GOLDEN_DIRECTORY, name);
+    if (getenv("RECORD_GOLDEN") != nullptr)
+    {
+        if (!wxDirExists(GOLDEN_DIRECTORY))
+        {
+            wxMkdir(GOLDEN_DIRECTORY);
+        }
+        ASSERT_TRUE(frame.SaveFile(golden.GetFullPath(), wxBITMAP_TYPE_PNG));
+        return;
+    }
+
+    if (!golden.FileExists())
+    {
+        FAIL() << name << " has no golden image in " << GOLDEN_DIRECTORY << "; run with RECORD_GOLDEN=1 to record it";
+    }
+
+    wxImage expected(golden.GetFullPath(), wxBITMAP_TYPE_PNG);
+    double difference = FrameRenderer::Difference(frame, expected, ChannelTolerance);
+    if (difference > PixelTolerance)
+    {
+        // Keep the frame beside the golden image to look at
+        wxFileName actual(GOLDEN_DIRECTORY, name.BeforeLast(L'.') + L"-actual.png");
+        frame.SaveFile(actual.GetFullPath(), wxBITMAP_TYPE_PNG);
+    }
+    ASSERT_LE(difference, PixelTolerance) << name << " differs from its golden image";
+}
+
+TEST(FrameRendererTest, Difference)
+{
+    wxImage image1(10, 10);
+    image1.SetRGB(wxRect(0, 0, 10, 10), 100, 100, 100);
+    wxImage image2 = image1.Copy();
+    ASSERT_EQ(0, FrameRenderer::Difference(image1, image2, 0));
+
+    // A little off everywhere, and far off in one pixel
+    image2.SetRGB(wxRect(0, 0, 10, 10), 104, 100, 96);
+    image2.SetRGB(3, 4, 200, 100, 100);
+    ASSERT_EQ(1, FrameRenderer::Difference(image1, image2, 3));
+    ASSERT_DOUBLE_EQ(0.01, FrameRenderer::Difference(image1, image2, 4));
+
+    ASSERT_EQ(1, FrameRenderer::Difference(image1, wxImage(10, 11), 255));
+}
+
+TEST(FrameRendererTest, Render)
+{
+    FrameRenderer renderer(40, 30);
+    auto frame = renderer.Render([](wxGraphicsContext *graphics) {
+        graphics->SetBrush(*wxRED_BRUSH);
+        graphics->SetPen(*wxTRANSPARENT_PEN);
+        graphics->DrawRectangle(10, 10, 20, 10);
+    });
+
+    ASSERT_EQ(wxSize(40, 30), frame.GetSize());
+    ASSERT_EQ(0, frame.GetRed(5, 5));
+    ASSERT_EQ(255, frame.GetRed(20, 15));
+    ASSERT_EQ(0, frame.GetGreen(20, 15));
+}
+
+TEST(FrameRendererTest, Levels)
+{
+    FrameRenderer renderer(FrameWidth, FrameHeight);
+    for (int level = 0; wxFileExists(Game::LevelFile(level)); level++)
+    {
+        Game game;
+        game.SelectLevel(level);
+
+        // As the level begins, then with its products moving
+        CompareGolden(renderer.Render(&game), wxString::Format(L"level%d-0.png", level));
+
+        game.StartConveyors();
+        Play(game, 100, TimeStep);
+        CompareGolden(renderer.Render(&game), wxString::Format(L"level%d-3.png", level));
+    }
+}
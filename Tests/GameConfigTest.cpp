@@ -0,0 +1,101 @@
+/**
+ * @file GameConfigTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <memory>
+#include <thread>
+#include <vector>
+#include <Game.h>
+#include <GameConfig.h>
+#include <Product.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+/// Steps long enough for every product to pass the beam, but not
+/// so long that the next level is loaded
+const int PlaySteps = 700;
+
+/**
+ * Get where the products of a game are
+ * @param game Game to look in
+ * @return Product locations, x then y
+ */
+static vector<double> ProductLocations(Game &game)
+{
+    LevelItems items;
+    game.Accept(&items);
+
+    vector<double> locations;
+    for (auto product : items.mProducts)
+    {
+        locations.push_back(product->GetX());
+        locations.push_back(product->GetY());
+    }
+    return locations;
+}
+
+TEST(GameConfigTest, PerGame)
+{
+    GameConfig large;
+    large.mProductSize = 120;
+
+    Game standard;
+    Game enlarged(large);
+    Product small(&standard);
+    Product big(&enlarged);
+
+    ASSERT_EQ(small.GetSize(), 80);
+    ASSERT_EQ(big.GetSize(), 120);
+
+    // A product is hit anywhere inside its own game's size
+    ASSERT_FALSE(small.HitTest(50, 0));
+    ASSERT_TRUE(big.HitTest(50, 0));
+}
+
+/// Games updated on their own threads end up where a game updated alone does.
+/// Build with SANITIZE_THREAD to check that they share no state.
+TEST(GameConfigTest, ConcurrentGames)
+{
+    const int NumGames = 8;
+
+    GameConfig config;
+    Game reference(config);
+    StartWiredLevel(reference);
+    Play(reference, PlaySteps);
+
+    LevelItems expected;
+    reference.Accept(&expected);
+    ASSERT_EQ(expected.GetNumKicked(), 4);
+
+    // Loading creates bitmaps, so it stays on this thread
+    vector<unique_ptr<Game>> games;
+    for (int i = 0; i < NumGames; i++)
+    {
+        games.push_back(make_unique<Game>(config));
+        StartWiredLevel(*games.back());
+    }
+
+    vector<thread> threads;
+    for (auto &game : games)
+    {
+        threads.emplace_back([&game] { Play(*game, PlaySteps); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto &game : games)
+    {
+        LevelItems actual;
+        game->Accept(&actual);
+        ASSERT_EQ(ProductLocations(*game), ProductLocations(reference));
+        ASSERT_EQ(actual.GetNumKicked(), expected.GetNumKicked());
+        ASSERT_EQ(game->GetScore()->GetGameScore(), reference.GetScore()->GetGameScore());
+        ASSERT_EQ(game->GetScore()->GetLevelScore(), reference.GetScore()->GetLevelScore());
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file GameSnapshotTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <memory>
+#include <AndGate.h>
+#include <Game.h>
+#include <GameSnapshot.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(GameSnapshotTest, Branch)
+{
+    Game game;
+    StartWiredLevel(game);
+    Play(game, 200);
+
+    GameSnapshot snapshot;
+    game.SaveSnapshot(snapshot);
+    auto atSnapshot = game.StateHash();
+    auto remaining = game.GetTimer().GetRemainingTime();
+
+    Play(game, 500);
+    auto afterwards = game.StateHash();
+    LevelItems items;
+    game.Accept(&items);
+    ASSERT_EQ(items.GetNumKicked(), 4);
+
+    // Restoring goes back, and playing on from there ends the same way
+    ASSERT_TRUE(game.RestoreSnapshot(snapshot));
+    ASSERT_EQ(game.StateHash(), atSnapshot);
+    ASSERT_EQ(game.GetTimer().GetRemainingTime(), remaining);
+
+    Play(game, 500);
+    ASSERT_EQ(game.StateHash(), afterwards);
+
+    // A snapshot can be restored again
+    ASSERT_TRUE(game.RestoreSnapshot(snapshot));
+    ASSERT_EQ(game.StateHash(), atSnapshot);
+}
+
+TEST(GameSnapshotTest, OnlySameItems)
+{
+    Game game;
+    StartWiredLevel(game);
+    GameSnapshot snapshot;
+    game.SaveSnapshot(snapshot);
+
+    Game other;
+    StartWiredLevel(other);
+    ASSERT_FALSE(other.RestoreSnapshot(snapshot));
+
+    game.Add(make_shared<AndGate>(&game));
+    ASSERT_FALSE(game.RestoreSnapshot(snapshot));
+
+    GameSnapshot empty;
+    ASSERT_FALSE(game.RestoreSnapshot(empty));
+}
+
+TEST(GameSnapshotTest, Rewind)
+{
+    GameConfig config;
+    config.mRewindSnapshots = 3;
+    config.mRewindInterval = 2;
+    Game game(config);
+    StartWiredLevel(game);
+    ASSERT_FALSE(game.Rewind());
+
+    // Snapshots at 2, 4 and 6 seconds, on a timer counting down whole seconds
+    Play(game, 750);
+    auto remaining = game.GetTimer().GetRemainingTime();
+
+    ASSERT_TRUE(game.Rewind());
+    auto back1 = game.GetTimer().GetRemainingTime();
+    ASSERT_GT(back1, remaining);
+
+    ASSERT_TRUE(game.Rewind());
+    ASSERT_GT(game.GetTimer().GetRemainingTime(), back1);
+    ASSERT_TRUE(game.Rewind());
+    ASSERT_FALSE(game.Rewind());
+}
+
+TEST(GameSnapshotTest, RewindClearedByLevelChange)
+{
+    GameConfig config;
+    config.mRewindInterval = 1;
+    Game game(config);
+    StartWiredLevel(game);
+    Play(game, 350);
+    ASSERT_GT(game.GetNumRewinds(), 0);
+
+    // Snapshots of level 1 do not carry over into level 2
+    StartWiredLevel(game, L"levels/level2.xml");
+    ASSERT_EQ(game.GetNumRewinds(), 0);
+    ASSERT_FALSE(game.Rewind());
+}
@@ -0,0 +1,75 @@
+/**
+ * @file GameSpeedTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <sstream>
+#include <Game.h>
+#include <InputRecorder.h>
+#include <InputReplayer.h>
+#include <ids.h>
+
+using namespace std;
+
+TEST(GameSpeedTest, Substeps)
+{
+    Game advanced, updated;
+    advanced.SelectLevel(1);
+    advanced.StartConveyors();
+    updated.SelectLevel(1);
+    updated.StartConveyors();
+    double step = advanced.GetConfig().mMaxTimeStep;
+
+    // A frame at eight times speed is split into steps no longer than the longest
+    ASSERT_EQ(1, advanced.Advance(step));
+    ASSERT_EQ(8, advanced.Advance(step * 8));
+    ASSERT_EQ(9, advanced.Advance(step * 8.5));
+    for (int i = 0; i < 1 + 8 + 9; i++)
+    {
+        updated.Update(i < 9 ? step : step * 8.5 / 9);
+    }
+    ASSERT_EQ(updated.StateHash(), advanced.StateHash());
+}
+
+TEST(GameSpeedTest, Replay)
+{
+    // A level played through at eight times speed, then as fast as
+    // frames allow, the way the game view logs it
+    Game game;
+    InputRecorder recorder;
+    recorder.Command(IDM_LEVEL1);
+    game.OnCommand(IDM_LEVEL1);
+
+    long simulated = 0;
+    for (int frame = 0; frame < 300; frame++)
+    {
+        long milliseconds = 8 * (28 + frame % 5);
+        recorder.Tick(milliseconds);
+        game.Advance((double)milliseconds * 0.001);
+        recorder.Checkpoint(&game);
+        simulated += milliseconds;
+    }
+    for (int frame = 0; simulated < 130000; frame++)
+    {
+        long milliseconds = 50 * (40 + frame % 7);
+        recorder.Tick(milliseconds);
+        game.Advance((double)milliseconds * 0.001);
+        recorder.Checkpoint(&game);
+        simulated += milliseconds;
+    }
+    recorder.Checksum(&game);
+
+    // The level's two minutes passed in a few hundred frames
+    ASSERT_GT(game.GetCurrentLevel(), 1);
+
+    stringstream log;
+    recorder.Write(log);
+    InputReplayer replayer;
+    ASSERT_TRUE(replayer.Read(log));
+    Game replayed;
+    ASSERT_TRUE(replayer.Replay(&replayed));
+    ASSERT_EQ(replayer.GetMismatchTick(), -1);
+    ASSERT_EQ(replayed.StateHash(), game.StateHash());
+}
@@ -0,0 +1,223 @@
+/**
+ * @file InputReplayTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <sstream>
+#include <AndGate.h>
+#include <CircuitSerializer.h>
+#include <Game.h>
+#include <InputRecorder.h>
+#include <InputReplayer.h>
+#include <ItemVisitor.h>
+#include <ids.h>
+
+using namespace std;
+
+/**
+ * Visitor that finds where the AND gates are
+ */
+class AndGateFinder : public ItemVisitor
+{
+public:
+    /// Locations of the AND gates, x then y
+    vector<double> mLocations;
+
+    /**
+     * Record an AND gate
+     * @param gate Gate we are visiting
+     */
+    void VisitAndGate(AndGate *gate) override
+    {
+        mLocations.push_back(gate->GetX());
+        mLocations.push_back(gate->GetY());
+    }
+};
+
+/**
+ * A game played the way the game view plays it, with every input logged
+ */
+class RecordedSession
+{
+public:
+    /// The game being played
+    Game mGame;
+
+    /// Log of the session
+    InputRecorder mRecorder;
+
+    /**
+     * Run a frame
+     * @param milliseconds Time since the last frame
+     */
+    void Tick(long milliseconds)
+    {
+        mRecorder.Tick(milliseconds);
+        mGame.Advance((double)milliseconds * 0.001);
+        mRecorder.Checkpoint(&mGame);
+        mRecorder.ViewSize(600, 400);
+        mGame.SetViewSize(600, 400);
+    }
+
+    /**
+     * Run a menu command
+     * @param id Menu id
+     */
+    void Command(int id)
+    {
+        mRecorder.Command(id);
+        mGame.OnCommand(id);
+    }
+
+    /**
+     * Drag with the mouse, a frame per move
+     * @param x Starting x in window coordinates
+     * @param y Starting y in window coordinates
+     * @param dx Distance to move each frame
+     * @param moves Number of moves
+     */
+    void Drag(int x, int y, int dx, int moves)
+    {
+        mRecorder.LeftDown(x, y);
+        mGame.OnLeftDown(x, y);
+        for (int m = 1; m <= moves; m++)
+        {
+            mRecorder.MouseMove(x + dx * m, y, true);
+            mGame.OnMouseMove(x + dx * m, y, true);
+            Tick(30);
+        }
+        mRecorder.LeftUp(x + dx * moves, y);
+        mGame.OnLeftUp(x + dx * moves, y);
+    }
+
+    /**
+     * Click the mouse
+     * @param x X in window coordinates
+     * @param y Y in window coordinates
+     */
+    void Click(int x, int y)
+    {
+        mRecorder.LeftDown(x, y);
+        mGame.OnLeftDown(x, y);
+        mRecorder.LeftUp(x, y);
+        mGame.OnLeftUp(x, y);
+    }
+
+    /**
+     * Build a session: level 1 with an AND gate dragged across the
+     * window, a circuit loaded that wires the beam to Sparty, the
+     * conveyor started, and enough frames of irregular length for
+     * the level to end
+     */
+    void Play()
+    {
+        Command(IDM_LEVEL1);
+        Tick(0);
+        Command(IDM_ANDGATE);
+        Tick(31);
+
+        // The window is half size, so window coordinates are half virtual ones
+        AndGateFinder finder;
+        mGame.Accept(&finder);
+        Drag(int(finder.mLocations[0] / 2), int(finder.mLocations[1] / 2), 3, 20);
+
+        wxXmlNode root(wxXML_ELEMENT_NODE, L"circuit");
+        auto wire = new wxXmlNode(&root, wxXML_ELEMENT_NODE, L"wire");
+        wire->AddAttribute(L"from", L"beam");
+        wire->AddAttribute(L"to", L"sparty");
+        CircuitSerializer circuit;
+        circuit.XmlLoad(&root);
+        mRecorder.Circuit(circuit);
+        mGame.ApplyCircuit(circuit);
+
+        // Start button on level 1's conveyor panel
+        Click(135, 27);
+
+        for (int frame = 0; frame < 1500; frame++)
+        {
+            Tick(28 + frame % 5);
+        }
+        mRecorder.Checksum(&mGame);
+    }
+};
+
+TEST(InputReplayTest, Replay)
+{
+    RecordedSession session;
+    session.Play();
+
+    stringstream log;
+    session.mRecorder.Write(log);
+
+    InputReplayer replayer;
+    ASSERT_TRUE(replayer.Read(log));
+
+    Game replayed;
+    ASSERT_TRUE(replayer.Replay(&replayed));
+    ASSERT_EQ(replayer.GetNumTicks(), session.mRecorder.GetNumTicks());
+    ASSERT_EQ(replayer.GetMismatchTick(), -1);
+    ASSERT_EQ(replayer.GetNumChecksums(), session.mRecorder.GetNumTicks() / InputRecorder::ChecksumInterval + 1);
+    ASSERT_EQ(replayed.StateHash(), session.mGame.StateHash());
+
+    // The drag was replayed, and the session got far enough to score
+    AndGateFinder recorded, played;
+    session.mGame.Accept(&recorded);
+    replayed.Accept(&played);
+    ASSERT_EQ(played.mLocations, recorded.mLocations);
+    ASSERT_EQ(replayed.GetScore()->GetGameScore(), session.mGame.GetScore()->GetGameScore());
+    ASSERT_GT(replayed.GetCurrentLevel(), 1);
+}
+
+TEST(InputReplayTest, Mismatch)
+{
+    RecordedSession session;
+    session.Command(IDM_LEVEL1);
+    for (int frame = 0; frame < 400; frame++)
+    {
+        session.Tick(30);
+    }
+
+    // A gate added without going through the recorder
+    session.mGame.OnCommand(IDM_ORGATE);
+    for (int frame = 0; frame < 400; frame++)
+    {
+        session.Tick(30);
+    }
+
+    stringstream log;
+    session.mRecorder.Write(log);
+
+    InputReplayer replayer;
+    ASSERT_TRUE(replayer.Read(log));
+    Game replayed;
+    ASSERT_FALSE(replayer.Replay(&replayed));
+    ASSERT_EQ(replayer.GetMismatchTick(), 2 * InputRecorder::ChecksumInterval);
+}
+
+TEST(InputReplayTest, BadLog)
+{
+    stringstream notLog("not a session log");
+    InputReplayer replayer;
+    ASSERT_FALSE(replayer.Read(notLog));
+
+    RecordedSession session;
+    session.Command(IDM_LEVEL1);
+    session.Tick(30);
+    stringstream log;
+    session.mRecorder.Write(log);
+
+    stringstream truncated(log.str().substr(0, log.str().size() - 1));
+    ASSERT_TRUE(replayer.Read(truncated));
+    Game replayed;
+    ASSERT_FALSE(replayer.Replay(&replayed));
+
+    // A log from before the last format change is refused
+    auto older = log.str();
+    older[sizeof(InputRecorder::Magic)] = char(InputRecorder::Version - 1);
+    stringstream oldLog(older);
+    ASSERT_FALSE(replayer.Read(oldLog));
+    stringstream current(log.str());
+    ASSERT_TRUE(replayer.Read(current));
+}
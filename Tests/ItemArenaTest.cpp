@@ -0,0 +1,145 @@
+/**
+ * @file ItemArenaTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <memory>
+#include <AndGate.h>
+#include <Game.h>
+#include <InputPin.h>
+#include <ItemArena.h>
+#include <LevelLoader.h>
+#include <OutputPin.h>
+
+using namespace std;
+
+TEST(ItemArenaTest, Allocate)
+{
+    ItemArena arena;
+    auto a = (char *)arena.Allocate(3, 1);
+    auto b = (char *)arena.Allocate(8, 8);
+    auto c = (char *)arena.Allocate(1, 1);
+    ASSERT_EQ(arena.GetNumBlocks(), 1);
+    ASSERT_EQ(arena.GetNumAllocations(), 3);
+    ASSERT_EQ(arena.GetBytesUsed(), 12u);
+
+    // One after another, aligned as asked
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0u);
+    ASSERT_GT(b, a);
+    ASSERT_LE(b, a + 3 + 7);
+    ASSERT_EQ(c, b + 8);
+
+    // Larger than a block gets a block of its own
+    arena.Allocate(ItemArena::BlockSize * 2, 16);
+    ASSERT_EQ(arena.GetNumBlocks(), 2);
+
+    // Returned memory goes to the next allocation of its size
+    arena.Deallocate(b, 8);
+    ASSERT_EQ(arena.GetNumAllocations(), 3);
+    ASSERT_EQ(arena.Allocate(8, 8), (void *)b);
+    ASSERT_EQ(arena.GetNumAllocations(), 4);
+}
+
+TEST(ItemArenaTest, Handles)
+{
+    ItemArena arena;
+    auto a = arena.Create<OutputPin>(nullptr, wxPoint(1, 2));
+    auto b = arena.Create<OutputPin>(nullptr, wxPoint(3, 4));
+    ASSERT_NE(arena.Get(a), nullptr);
+    ASSERT_EQ(arena.Get(b)->GetAbsoluteLocation(), wxPoint(3, 4));
+    ASSERT_EQ(arena.GetNumParts<OutputPin>(), 2);
+
+    // Parts of a type sit side by side in one chunk
+    ASSERT_EQ(b.GetIndex(), a.GetIndex() + 1);
+    ASSERT_EQ(arena.GetNumAllocations(), 1);
+
+    // A destroyed part's slot is used again, and its old handle finds nothing
+    arena.Destroy(a);
+    ASSERT_EQ(arena.Get(a), nullptr);
+    auto c = arena.Create<OutputPin>(nullptr, wxPoint(5, 6));
+    ASSERT_EQ(c.GetIndex(), a.GetIndex());
+    ASSERT_NE(c, a);
+    ASSERT_EQ(arena.Get(a), nullptr);
+    ASSERT_EQ(arena.Get(c)->GetAbsoluteLocation(), wxPoint(5, 6));
+    ASSERT_EQ(arena.GetNumParts<OutputPin>(), 2);
+
+    // Destroying twice, or a handle never set, does nothing
+    arena.Destroy(a);
+    ASSERT_EQ(arena.GetNumParts<OutputPin>(), 2);
+    ASSERT_EQ(arena.Get(ArenaHandle<OutputPin>()), nullptr);
+
+    // Each type has its own array, and a handle from another arena finds nothing
+    auto input = arena.Create<InputPin>(nullptr, wxPoint(0, 0));
+    ASSERT_EQ(input.GetIndex(), 0u);
+    ItemArena other;
+    auto there = other.Create<OutputPin>(nullptr, wxPoint(0, 0));
+    ASSERT_EQ(arena.Get(there), nullptr);
+    ASSERT_EQ(other.Get(b), nullptr);
+
+    // Past one chunk the array grows by another
+    for (uint32_t i = 0; i < ItemArena::ChunkSize; i++)
+    {
+        arena.Create<OutputPin>(nullptr, wxPoint(0, 0));
+    }
+    ASSERT_EQ(arena.GetNumParts<OutputPin>(), 2 + (int)ItemArena::ChunkSize);
+    ASSERT_NE(arena.Get(b), nullptr);
+}
+
+TEST(ItemArenaTest, LevelArena)
+{
+    Game game;
+    LevelLoader loader;
+    loader.LoadLevel(L"levels/level3.xml", &game);
+
+    // Every item and pin of the level is in a few blocks
+    weak_ptr<ItemArena> level3 = game.GetArena();
+    ASSERT_GT(game.GetArena()->GetNumAllocations(), 10);
+    ASSERT_LE(game.GetArena()->GetNumBlocks(), 2);
+
+    auto gate = game.Create<AndGate>(&game);
+    game.Add(gate);
+    ASSERT_EQ(game.GetArena(), level3.lock());
+    ASSERT_NE(gate->GetInputA(), nullptr);
+
+    // A gate removed from the game takes its pins with it
+    auto pins = game.GetArena()->GetNumParts<InputPin>();
+    auto bytes = game.GetArena()->GetBytesUsed();
+    auto removed = game.Create<AndGate>(&game);
+    ASSERT_EQ(game.GetArena()->GetNumParts<InputPin>(), pins + 2);
+    removed = nullptr;
+    ASSERT_EQ(game.GetArena()->GetNumParts<InputPin>(), pins);
+    ASSERT_EQ(game.GetArena()->GetBytesUsed(), bytes);
+
+    // and its memory goes to the next gate, so adding and removing
+    // gates all level long takes no more memory
+    auto blocks = game.GetArena()->GetNumBlocks();
+    for (int i = 0; i < 1000; i++)
+    {
+        game.Create<AndGate>(&game);
+    }
+    ASSERT_EQ(game.GetArena()->GetNumBlocks(), blocks);
+
+    // A gate still held keeps its level's arena, and its pins in it
+    auto held = game.Create<AndGate>(&game);
+    loader.LoadLevel(L"levels/level1.xml", &game);
+    ASSERT_NE(game.GetArena(), level3.lock());
+    ASSERT_FALSE(level3.expired());
+    ASSERT_EQ(held->GetArena(), level3.lock().get());
+    ASSERT_NE(held->GetInputA(), nullptr);
+
+    // Destroyed after the level changed, it frees its pins in the
+    // arena it came from, not in the new level's. The level's own
+    // items went with the level, so only the two gates' pins are left.
+    auto newPins = game.GetArena()->GetNumParts<InputPin>();
+    ASSERT_EQ(level3.lock()->GetNumParts<InputPin>(), 4);
+    held = nullptr;
+    ASSERT_EQ(level3.lock()->GetNumParts<InputPin>(), 2);
+    ASSERT_EQ(game.GetArena()->GetNumParts<InputPin>(), newPins);
+
+    // Once nothing from the level is left, the whole arena goes
+    gate = nullptr;
+    ASSERT_TRUE(level3.expired());
+}
@@ -0,0 +1,109 @@
+/**
+ * @file ItemRunsTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+#include <AndGate.h>
+#include <Game.h>
+#include <ItemRuns.h>
+#include <Product.h>
+
+using namespace std;
+
+/**
+ * Item that records when it is updated
+ */
+class OrderedItem : public Item
+{
+private:
+    /// Where updates are recorded
+    vector<int> *mOrder;
+
+    /// Number recorded when updated
+    int mNumber;
+
+public:
+    /**
+     * Constructor
+     * @param game Game the item is in
+     * @param order Where updates are recorded
+     * @param number Number recorded when updated
+     */
+    OrderedItem(Game *game, vector<int> *order, int number) : Item(game), mOrder(order), mNumber(number) {}
+
+    /**
+     * Record the update
+     * @param elapsed Time since the last update
+     */
+    void Update(double elapsed) override { mOrder->push_back(mNumber); }
+
+    /**
+     * Accept a visitor
+     * @param visitor Visitor to accept
+     */
+    void Accept(ItemVisitor *visitor) override {}
+};
+
+TEST(ItemRunsTest, Runs)
+{
+    Game game;
+    Product first(&game);
+    Product second(&game);
+    Product third(&game);
+    AndGate gate(&game);
+    vector<int> order;
+    OrderedItem a(&game, &order, 1);
+    OrderedItem b(&game, &order, 2);
+
+    ItemRuns runs;
+    runs.Add(&first);
+    runs.Add(&second);
+    runs.Add(&a);
+    runs.Add(&b);
+    runs.Add(&gate);
+    runs.Add(&third);
+    ASSERT_EQ(runs.GetNumItems(), 6u);
+    ASSERT_EQ(runs.GetNumRuns(), 4u);
+
+    // Items of other types are still updated, in the order added
+    runs.Update(0.1);
+    ASSERT_EQ(order, vector<int>({1, 2}));
+
+    runs.Clear();
+    ASSERT_EQ(runs.GetNumItems(), 0u);
+    ASSERT_EQ(runs.GetNumRuns(), 0u);
+    runs.Update(0.1);
+    ASSERT_EQ(order.size(), 2u);
+}
+
+TEST(ItemRunsTest, DerivedTypes)
+{
+    /// A product of a class derived from Product
+    class LargeProduct : public Product
+    {
+    public:
+        /// Constructor
+        /// @param game Game the product is in
+        explicit LargeProduct(Game *game) : Product(game) {}
+
+        /// Get the size of the product
+        /// @return Size in virtual pixels
+        double GetSize() const override { return 200; }
+    };
+
+    Game game;
+    Product first(&game);
+    LargeProduct large(&game);
+    Product second(&game);
+
+    // A derived product is not a Product for dispatch, so it breaks the run
+    ItemRuns runs;
+    runs.Add(&first);
+    runs.Add(&large);
+    runs.Add(&second);
+    ASSERT_EQ(runs.GetNumRuns(), 3u);
+}
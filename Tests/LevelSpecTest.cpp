@@ -0,0 +1,79 @@
+/**
+ * @file LevelSpecTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <LevelSpec.h>
+#include <LevelLoader.h>
+#include <CircuitSynthesizer.h>
+#include <WorkStealingPool.h>
+#include <Game.h>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+
+using namespace std;
+
+TEST(LevelSpecTest, Level3)
+{
+    wxXmlDocument xmlDoc;
+    ASSERT_TRUE(xmlDoc.Load(L"levels/level3.xml"));
+
+    LevelSpec spec;
+    ASSERT_TRUE(spec.XmlLoad(xmlDoc.GetRoot()));
+
+    vector<wstring> inputs = {L"red", L"green", L"blue", CircuitVerifier::BeamInput};
+    ASSERT_EQ(spec.GetInputs(), inputs);
+
+    const auto &products = spec.GetProducts();
+    ASSERT_EQ(products.size(), 6u);
+
+    // First product placed is the first to reach the sensor
+    vector<wstring> first = {L"square", L"green", L"izzo"};
+    ASSERT_EQ(products[0].mProperties, first);
+    ASSERT_FALSE(products[0].mKick);
+    ASSERT_TRUE(products[1].mKick);
+    ASSERT_FALSE(products[3].mKick);
+}
+
+TEST(LevelSpecTest, Unsupported)
+{
+    // Several production lines, then generated products
+    for (auto level : {L"levels/level9.xml", L"levels/level10.xml"})
+    {
+        wxXmlDocument xmlDoc;
+        ASSERT_TRUE(xmlDoc.Load(level));
+
+        LevelSpec spec;
+        ASSERT_FALSE(spec.XmlLoad(xmlDoc.GetRoot()));
+        ASSERT_FALSE(spec.GetError().empty());
+    }
+}
+
+TEST(LevelSpecTest, SolvedLevelLoads)
+{
+    wxXmlDocument xmlDoc;
+    ASSERT_TRUE(xmlDoc.Load(L"levels/level3.xml"));
+
+    LevelSpec spec;
+    ASSERT_TRUE(spec.XmlLoad(xmlDoc.GetRoot()));
+
+    WorkStealingPool pool(2);
+    CircuitSynthesizer synthesizer(spec.GetInputs(), spec.GetProducts());
+    ASSERT_TRUE(synthesizer.Synthesize(pool));
+    synthesizer.XmlSave(xmlDoc.GetRoot()->GetChildren());
+
+    auto solved = wxFileName::CreateTempFileName(L"level3-solved");
+    ASSERT_TRUE(xmlDoc.Save(solved));
+
+    // The solved level's wiring must pass the verifier once loaded
+    Game game;
+    LevelLoader loader;
+    loader.LoadLevel(solved, &game);
+    wxRemoveFile(solved);
+
+    auto results = game.VerifyCircuit();
+    ASSERT_EQ(results.size(), 6u);
+    ASSERT_EQ(CircuitVerifier::CountMisKicks(results), 0);
+}
@@ -0,0 +1,143 @@
+/**
+ * @file LevelValidatorTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <fstream>
+#include <string>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <Game.h>
+#include <LevelLoader.h>
+#include <LevelValidator.h>
+
+using namespace std;
+
+/**
+ * Check a level file the way the validate tool does
+ * @param filename Level file
+ * @return Validator holding the mistakes found
+ */
+static LevelValidator Validate(const wxString &filename)
+{
+    LevelValidator validator;
+    wxXmlDocument xmlDoc;
+    EXPECT_TRUE(xmlDoc.Load(filename));
+    validator.CheckXml(xmlDoc.GetRoot());
+    if (validator.IsValid())
+    {
+        Game game;
+        LevelLoader loader;
+        loader.LoadLevel(filename, &game);
+        validator.CheckGame(&game);
+    }
+    return validator;
+}
+
+/**
+ * Is there a mistake on a line of the level whose message holds some text?
+ * @param validator Validator that checked the level
+ * @param line Line of the level file, or 0 for mistakes with no one place
+ * @param text Text the message holds
+ * @return True if there is
+ */
+static bool HasProblem(const LevelValidator &validator, int line, const wstring &text)
+{
+    for (const auto &problem : validator.GetProblems())
+    {
+        if (problem.mLine == line && problem.mMessage.find(text) != wstring::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST(LevelValidatorTest, ShippedLevels)
+{
+    for (int level = 0; level <= 10; level++)
+    {
+        auto filename = wxString::Format(L"levels/level%d.xml", level);
+        auto validator = Validate(filename);
+        for (const auto &problem : validator.GetProblems())
+        {
+            ADD_FAILURE() << filename << ":" << problem.mLine << ": " << wxString(problem.mMessage);
+        }
+    }
+}
+
+TEST(LevelValidatorTest, Schema)
+{
+    auto filename = wxFileName::CreateTempFileName(L"level-broken");
+    {
+        ofstream out(filename.ToStdString());
+        out << "<?xml version='1.0' encoding='UTF-8'?>\n"
+               "<level size=\"1150,800\">\n"
+               "<items>\n"
+               "<conveyor x=\"150\" y=\"400\" speed=\"100\" height=\"800\">\n"
+               "<product placement=\"+-50\" shape=\"square\" color=\"square\"/>\n"
+               "<product placement=\"+100\" color=\"red\" kick=\"maybe\"/>\n"
+               "</conveyor>\n"
+               "<sensor x=\"155\" y=\"430\"><purple/><red/></sensor>\n"
+               "<beam x=\"242\" sender=\"-185\"/>\n"
+               "<multigate function=\"xnor\" inputs=\"1\" width=\"65\"/>\n"
+               "<busjoin width=\"1\"/>\n"
+               "<crate x=\"0\" y=\"0\"/>\n"
+               "</items>\n"
+               "</level>\n";
+    }
+
+    auto validator = Validate(filename);
+    wxRemoveFile(filename);
+
+    ASSERT_FALSE(validator.IsValid());
+    ASSERT_TRUE(HasProblem(validator, 4, L"panel"));
+    ASSERT_TRUE(HasProblem(validator, 5, L"+-50"));
+    ASSERT_TRUE(HasProblem(validator, 5, L"unknown color \"square\""));
+    ASSERT_TRUE(HasProblem(validator, 6, L"no shape"));
+    ASSERT_TRUE(HasProblem(validator, 6, L"maybe"));
+    ASSERT_TRUE(HasProblem(validator, 8, L"<purple>"));
+    ASSERT_FALSE(HasProblem(validator, 8, L"<red>"));
+    ASSERT_TRUE(HasProblem(validator, 9, L"no y"));
+    ASSERT_TRUE(HasProblem(validator, 10, L"xnor"));
+    ASSERT_TRUE(HasProblem(validator, 10, L"inputs"));
+    ASSERT_TRUE(HasProblem(validator, 10, L"bits wide"));
+    ASSERT_TRUE(HasProblem(validator, 11, L"bits wide"));
+    ASSERT_TRUE(HasProblem(validator, 12, L"<crate>"));
+}
+
+TEST(LevelValidatorTest, Geometry)
+{
+    auto filename = wxFileName::CreateTempFileName(L"level-misplaced");
+    {
+        ofstream out(filename.ToStdString());
+        out << "<?xml version='1.0' encoding='UTF-8'?>\n"
+               "<level size=\"1150,800\">\n"
+               "<items>\n"
+               "<conveyor x=\"150\" y=\"400\" speed=\"100\" height=\"800\" panel=\"60,-390\">\n"
+               "<product placement=\"100\" shape=\"square\" color=\"red\" kick=\"yes\"/>\n"
+               "</conveyor>\n"
+               "<sensor x=\"600\" y=\"430\"><red/></sensor>\n"
+               "<beam x=\"900\" y=\"437\" sender=\"-185\"/>\n"
+               "<sparty x=\"290\" y=\"340\" height=\"300\" pin=\"1100, 400\" kick-duration=\"0.25\" kick-speed=\"1000\"/>\n"
+               "<wire from=\"beam\" to=\"sparty\"/>\n"
+               "<wire from=\"sensor.blue\" to=\"sparty\"/>\n"
+               "<busjoin id=\"j\" width=\"4\"/>\n"
+               "<wire from=\"j\" to=\"sparty\"/>\n"
+               "</items>\n"
+               "</level>\n";
+    }
+
+    auto validator = Validate(filename);
+    wxRemoveFile(filename);
+
+    ASSERT_TRUE(HasProblem(validator, 0, L"the beam at (900, 437)"));
+    ASSERT_TRUE(HasProblem(validator, 0, L"the sensor at (600, 430)"));
+    ASSERT_FALSE(HasProblem(validator, 0, L"Sparty"));
+    ASSERT_FALSE(HasProblem(validator, 10, L"wire"));
+    ASSERT_TRUE(HasProblem(validator, 11, L"sensor.blue"));
+    ASSERT_TRUE(HasProblem(validator, 13, L"carries 4 bits"));
+    ASSERT_EQ(validator.GetProblems().size(), 4u);
+}
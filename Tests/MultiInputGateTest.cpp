@@ -0,0 +1,177 @@
+/**
+ * @file MultiInputGateTest.cpp
+ * @author matthew vazquez
+ *
+ * Unit tests for the MultiInputGate class
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <MultiInputGate.h>
+#include <BusConnector.h>
+#include <Game.h>
+#include <InputPin.h>
+#include <OutputPin.h>
+#include <CircuitSimulator.h>
+#include <Netlist.h>
+#include <NetlistBuilder.h>
+#include "TestHelpers.h"
+
+/**
+ * Pack pin states into a word, one lane per input
+ * @param states Input states, from the top
+ * @return Packed inputs
+ */
+static LogicWord Pack(std::initializer_list<States> states)
+{
+    LogicWord word;
+    int lane = 0;
+    for (auto state : states)
+    {
+        word.SetLane(lane++, state);
+    }
+    return word;
+}
+
+/// Test that MultiInputGate can be constructed and clamps its inputs
+TEST(MultiInputGateTest, Construct)
+{
+    Game game;
+    MultiInputGate gate(&game, MultiInputGate::Function::And, 4);
+    ASSERT_EQ(gate.GetNumInputs(), 4);
+    ASSERT_NE(gate.GetInputPin(3), nullptr);
+    ASSERT_EQ(gate.GetInputPin(4), nullptr);
+
+    MultiInputGate narrow(&game, MultiInputGate::Function::Or, 1);
+    ASSERT_EQ(narrow.GetNumInputs(), MultiInputGate::MinInputs);
+
+    // Taller with more inputs
+    ASSERT_GT(gate.getHeight(), narrow.getHeight());
+}
+
+/// Test the gate functions on packed inputs
+TEST(MultiInputGateTest, Evaluate)
+{
+    auto one = States::One;
+    auto zero = States::Zero;
+    auto both = Pack({one, one, one, zero});
+    auto ones = Pack({one, one, one, one});
+    auto zeros = Pack({zero, zero, zero, zero});
+
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::And, ones, 4), one);
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::And, both, 4), zero);
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::Or, both, 4), one);
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::Or, zeros, 4), zero);
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::Xor, both, 4), one);
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::Xor, ones, 4), zero);
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::Nand, both, 4), one);
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::Nor, zeros, 4), one);
+
+    // Only the first count lanes are inputs
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::And, both, 3), one);
+
+    auto unknown = Pack({one, States::Unknown, one});
+    ASSERT_EQ(MultiInputGate::Evaluate(MultiInputGate::Function::Or, unknown, 3), States::Unknown);
+}
+
+/// Test that the simulator agrees with the gate
+TEST(MultiInputGateTest, Simulate)
+{
+    Netlist netlist;
+    int a = netlist.AddInput(L"a");
+    int b = netlist.AddInput(L"b");
+    int c = netlist.AddInput(L"c");
+
+    int xorGate = netlist.AddCell(Netlist::CellType::Xor, 3);
+    netlist.ConnectInput(xorGate, 0, a);
+    netlist.ConnectInput(xorGate, 1, b);
+    netlist.ConnectInput(xorGate, 2, c);
+    netlist.SetKickNet(netlist.GetCells()[xorGate].mOutput);
+
+    CircuitSimulator simulator(netlist);
+    for (int inputs = 0; inputs < 8; inputs++)
+    {
+        LogicWord packed;
+        for (int i = 0; i < 3; i++)
+        {
+            auto state = (inputs >> i) & 1 ? States::One : States::Zero;
+            packed.SetLane(i, state);
+            simulator.SetInput(i, LogicWord::Splat(state));
+        }
+
+        simulator.Settle();
+        ASSERT_EQ(simulator.GetNet(netlist.GetKickNet()).Lane(0),
+                  MultiInputGate::Evaluate(MultiInputGate::Function::Xor, packed, 3));
+    }
+}
+
+/// Test that a bus-width gate computes every bit at once
+TEST(MultiInputGateTest, Bus)
+{
+    Game game;
+    MultiInputGate gate(&game, MultiInputGate::Function::Nand, 2, 4);
+    ASSERT_EQ(gate.GetBusWidth(), 4);
+    ASSERT_EQ(gate.GetInputPin(1)->GetBusWidth(), 4);
+    ASSERT_EQ(gate.GetOutput()->GetBusWidth(), 4);
+
+    auto one = States::One;
+    auto zero = States::Zero;
+    gate.GetInputPin(0)->SetBus(Pack({one, one, zero, States::Unknown}));
+    gate.GetInputPin(1)->SetBus(Pack({one, zero, zero, one}));
+    gate.ComputeOutput();
+
+    auto bus = gate.GetOutput()->GetBus();
+    ASSERT_EQ(bus.Lane(0), zero);
+    ASSERT_EQ(bus.Lane(1), one);
+    ASSERT_EQ(bus.Lane(2), one);
+    ASSERT_EQ(bus.Lane(3), States::Unknown);
+
+    // Lanes past the width carry nothing, and a bus is drawn One if any bit is
+    ASSERT_EQ(bus.Lane(4), States::Unknown);
+    ASSERT_EQ(gate.GetOutput()->GetState(), one);
+}
+
+/// Test joining wires into a bus and splitting it in a game
+TEST(MultiInputGateTest, BusConnectors)
+{
+    Game game;
+    game.SelectLevel(2);
+
+    // Bit 0 is red XOR beam and bit 1 is beam XOR beam
+    LoadItem(game, R"(<busjoin id="j" width="2"/>)");
+    LoadItem(game, R"(<busjoin id="k" width="2"/>)");
+    LoadItem(game, R"(<multigate id="x" function="xor" width="2"/>)");
+    LoadItem(game, R"(<bussplit id="s" width="2"/>)");
+    game.XmlWire(L"sensor.red", L"j");
+    game.XmlWire(L"beam", L"j.1");
+    game.XmlWire(L"beam", L"k");
+    game.XmlWire(L"beam", L"k.1");
+    game.XmlWire(L"j", L"x");
+    game.XmlWire(L"k", L"x.1");
+    game.XmlWire(L"x", L"s");
+    game.XmlWire(L"s", L"sparty");
+
+    // Pins that carry different numbers of bits are not wired
+    LoadItem(game, R"(<multigate id="y" width="3"/>)");
+    game.XmlWire(L"j", L"y");
+    game.XmlWire(L"beam", L"y.1");
+
+    NetlistBuilder builder;
+    game.Accept(&builder);
+    auto netlist = builder.BuildNetlist();
+
+    int red = netlist.FindInput(L"red");
+    int beam = netlist.FindInput(L"beam");
+    const auto &cells = netlist.GetCells();
+
+    // One cell per bit of each bus-width gate; the connectors add none
+    ASSERT_EQ(cells.size(), 5u);
+    ASSERT_EQ(cells[0].mType, Netlist::CellType::Xor);
+    ASSERT_EQ(cells[0].mInputs, std::vector<int>({red, beam}));
+    ASSERT_EQ(cells[1].mInputs, std::vector<int>({beam, beam}));
+    ASSERT_EQ(netlist.GetKickNet(), cells[0].mOutput);
+    for (size_t c = 2; c < cells.size(); c++)
+    {
+        ASSERT_EQ(cells[c].mInputs, std::vector<int>({Netlist::Unconnected, Netlist::Unconnected}));
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file ProductGeneratorTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Conveyor.h>
+#include <Game.h>
+#include <ProductGenerator.h>
+#include <Throughput.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(ProductGeneratorTest, Throughput)
+{
+    Throughput throughput;
+    ASSERT_EQ(throughput.GetPerMinute(), 0);
+
+    // Ten products in the first half minute is twenty a minute
+    for (int second = 0; second < 30; second++)
+    {
+        throughput.Add(second % 3 == 0 ? 1 : 0);
+        throughput.Update(1);
+    }
+    ASSERT_NEAR(throughput.GetPerMinute(), 20, 0.0001);
+    ASSERT_EQ(throughput.GetTotal(), 10);
+
+    // A minute without any forgets them, but not the total
+    throughput.Update(61);
+    ASSERT_EQ(throughput.GetPerMinute(), 0);
+    ASSERT_EQ(throughput.GetTotal(), 10);
+}
+
+TEST(ProductGeneratorTest, Endless)
+{
+    Game game;
+    StartWiredLevel(game, L"levels/level10.xml");
+    LevelItems items;
+    game.Accept(&items);
+    ASSERT_EQ(items.mConveyors.size(), 1u);
+
+    auto generator = items.mConveyors[0]->GetGenerator();
+    ASSERT_NE(generator, nullptr);
+    ASSERT_GT(generator->GetPoolSize(), 0);
+    ASSERT_TRUE(game.IsEndless());
+    ASSERT_EQ(game.GetNumProducts(), 0);
+
+    // Ten minutes is long past the timer and many times the pool
+    for (int step = 0; step < 60000; step++)
+    {
+        game.Update(0.01);
+        ASSERT_NE(game.GetState(), Game::State::Ending);
+    }
+
+    ASSERT_GT(generator->GetNumSpawned(), (uint64_t)generator->GetPoolSize() * 10);
+    ASSERT_GT(game.GetThroughput().GetTotal(), 0);
+    ASSERT_GT(game.GetThroughput().GetPerMinute(), 0);
+}
+
+TEST(ProductGeneratorTest, Seeded)
+{
+    Game first;
+    Game second;
+    StartWiredLevel(first, L"levels/level10.xml");
+    StartWiredLevel(second, L"levels/level10.xml");
+
+    for (int step = 0; step < 3000; step++)
+    {
+        first.Update(0.01);
+        second.Update(0.01);
+        ASSERT_EQ(first.StateHash(), second.StateHash());
+    }
+}
+
+TEST(ProductGeneratorTest, Rewind)
+{
+    Game game;
+    StartWiredLevel(game, L"levels/level10.xml");
+    Play(game, 1000);
+
+    GameSnapshot snapshot;
+    game.SaveSnapshot(snapshot);
+    Play(game, 1000);
+    auto expected = game.StateHash();
+
+    // Playing on from the snapshot spawns the same products again
+    ASSERT_TRUE(game.RestoreSnapshot(snapshot));
+    Play(game, 1000);
+    ASSERT_EQ(game.StateHash(), expected);
+}
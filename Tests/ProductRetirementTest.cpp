@@ -0,0 +1,50 @@
+/**
+ * @file ProductRetirementTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Conveyor.h>
+#include <Game.h>
+#include <Product.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(ProductRetirementTest, KickedProductsRetire)
+{
+    Game game;
+    StartWiredLevel(game);
+
+    LevelItems items;
+    game.Accept(&items);
+    ASSERT_EQ(items.mConveyors.size(), 1u);
+    ASSERT_EQ(items.mProducts.size(), 4u);
+
+    game.Update(0.01);
+    int allItems = game.GetNumActiveItems();
+    Play(game, 700);
+
+    // Every product was kicked off the playfield and stopped there
+    for (auto product : items.mProducts)
+    {
+        ASSERT_TRUE(product->GetWasKicked());
+        ASSERT_TRUE(product->IsRetired());
+        ASSERT_FALSE(product->IsOnPlayfield());
+    }
+    ASSERT_EQ(game.GetNumActiveItems(), allItems - 4);
+
+    double x = items.mProducts[0]->GetX();
+    game.Update(0.01);
+    ASSERT_EQ(items.mProducts[0]->GetX(), x);
+
+    // Starting the conveyor again brings them all back
+    game.StartConveyors();
+    game.Update(0.01);
+    ASSERT_EQ(game.GetNumActiveItems(), allItems);
+    for (auto product : items.mProducts)
+    {
+        ASSERT_FALSE(product->IsRetired());
+    }
+}
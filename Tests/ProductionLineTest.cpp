@@ -0,0 +1,108 @@
+/**
+ * @file ProductionLineTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <CircuitSerializer.h>
+#include <Game.h>
+#include <LevelLoader.h>
+#include <ProductionLine.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(ProductionLineTest, Load)
+{
+    Game game;
+    LevelLoader loader;
+
+    // Levels without line nodes are a single line
+    loader.LoadLevel(L"levels/level1.xml", &game);
+    ASSERT_EQ(game.GetNumLines(), 1);
+    ASSERT_EQ(game.GetLine(0)->GetNumProducts(), 4);
+    ASSERT_EQ(game.GetNumProducts(), 4);
+
+    loader.LoadLevel(L"levels/level9.xml", &game);
+    ASSERT_EQ(game.GetNumLines(), 2);
+    ASSERT_EQ(game.GetLine(0)->GetIndex(), 0);
+    ASSERT_EQ(game.GetLine(0)->GetNumProducts(), 5);
+    ASSERT_EQ(game.GetLine(1)->GetNumProducts(), 6);
+    ASSERT_EQ(game.GetNumProducts(), 11);
+}
+
+TEST(ProductionLineTest, LinesFinish)
+{
+    Game game;
+    StartWiredLevel(game, L"levels/level9.xml");
+
+    for (int step = 0; step < 2000 && game.GetState() != Game::State::Ending; step++)
+    {
+        game.Update(0.01);
+    }
+
+    // The level ends once both lines are done, with each line's
+    // points in the level score
+    ASSERT_EQ(game.GetState(), Game::State::Ending);
+    ASSERT_TRUE(game.GetLine(0)->IsFinished());
+    ASSERT_TRUE(game.GetLine(1)->IsFinished());
+    ASSERT_GT(game.GetLine(0)->GetNumGood() + game.GetLine(0)->GetNumBad(), 0);
+    ASSERT_GT(game.GetLine(1)->GetNumGood() + game.GetLine(1)->GetNumBad(), 0);
+    ASSERT_EQ(game.GetScore()->GetLevelScore(), game.GetLine(0)->GetScore() + game.GetLine(1)->GetScore());
+}
+
+TEST(ProductionLineTest, ParallelMatchesSerial)
+{
+    GameConfig parallel;
+    parallel.mUpdateThreads = 4;
+
+    Game serialGame;
+    Game parallelGame(parallel);
+    StartWiredLevel(serialGame, L"levels/level9.xml");
+    StartWiredLevel(parallelGame, L"levels/level9.xml");
+
+    for (int step = 0; step < 1000; step++)
+    {
+        serialGame.Update(0.01);
+        parallelGame.Update(0.01);
+        ASSERT_EQ(serialGame.StateHash(), parallelGame.StateHash());
+    }
+}
+
+TEST(ProductionLineTest, Circuit)
+{
+    Game game;
+    StartWiredLevel(game, L"levels/level9.xml");
+
+    // Each line's wire names its own beam and Sparty
+    CircuitSerializer circuit;
+    circuit.Capture(&game);
+    auto &wires = circuit.GetWires();
+    ASSERT_EQ(wires.size(), 2u);
+    ASSERT_EQ(wires[0].mFrom, L"line1.beam");
+    ASSERT_EQ(wires[0].mTo, L"line1.sparty");
+    ASSERT_EQ(wires[1].mFrom, L"line2.beam");
+    ASSERT_EQ(wires[1].mTo, L"line2.sparty");
+
+    // Applied to a fresh copy of the level, it wires both lines again
+    Game other;
+    LevelLoader loader;
+    loader.LoadLevel(L"levels/level9.xml", &other);
+    circuit.Apply(&other);
+    CircuitSerializer applied;
+    applied.Capture(&other);
+    ASSERT_EQ(applied.GetWires().size(), 2u);
+    ASSERT_EQ(applied.GetWires()[1].mTo, L"line2.sparty");
+
+    // Every product is verified against its own line's wiring
+    auto results = game.VerifyCircuit();
+    ASSERT_EQ(results.size(), 11u);
+    int second = 0;
+    for (const auto &result : results)
+    {
+        second += result.mLine == 1 ? 1 : 0;
+        ASSERT_TRUE(result.mKicked);
+    }
+    ASSERT_EQ(second, 6);
+}
@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 #include <Scoreboard.h>
 #include <Game.h>
+#include <XmlPullParser.h>
 #include <regex>
 
 using namespace std;
@@ -22,10 +23,10 @@ TEST(ScoreboardTest, xml)
 {
  Game game;
  Scoreboard scoreboard(&game);
- wxXmlNode node = wxXmlNode(wxXML_ELEMENT_NODE, "scoreboard");
- node.AddAttribute("x", "242");
- node.AddAttribute("y", "437");
- scoreboard.XmlLoad(&node);
+ XmlPullParser parser;
+ parser.SetText(R"(<scoreboard x="242" y="437"/>)");
+ parser.Next();
+ scoreboard.XmlLoad(parser);
  ASSERT_TRUE(scoreboard.GetmX() == 242);
  ASSERT_TRUE(scoreboard.GetmY() == 437);
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+/**
+ * @file SpriteAtlasTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+#include <SpriteAtlas.h>
+
+using namespace std;
+
+/**
+ * Make an image of one color
+ * @param width Image width
+ * @param height Image height
+ * @param red Red level of every pixel
+ * @return Opaque image
+ */
+static wxImage SolidImage(int width, int height, unsigned char red)
+{
+    wxImage image(width, height);
+    image.SetRGB(wxRect(0, 0, width, height), red, 10, 20);
+    return image;
+}
+
+TEST(SpriteAtlasTest, Pack)
+{
+    vector<pair<wstring, wxImage>> images;
+    images.emplace_back(L"wide.png", SolidImage(300, 40, 1));
+    images.emplace_back(L"tall.png", SolidImage(50, 500, 2));
+    images.emplace_back(L"small.png", SolidImage(16, 16, 3));
+
+    // Half transparent image, with alpha
+    wxImage half = SolidImage(20, 10, 4);
+    half.InitAlpha();
+    for (int x = 0; x < 10; x++)
+    {
+        for (int y = 0; y < 10; y++)
+        {
+            half.SetAlpha(x, y, 0);
+        }
+    }
+    images.emplace_back(L"half.png", half);
+
+    SpriteAtlas atlas;
+    atlas.Pack(images);
+    ASSERT_EQ(1, atlas.GetNumPages());
+    ASSERT_EQ(4, atlas.GetNumSprites());
+
+    // Found by file name, with or without a directory
+    ASSERT_EQ(atlas.Find(L"wide.png"), atlas.Find(L"images/wide.png"));
+    ASSERT_EQ(-1, atlas.Find(L"missing.png"));
+    ASSERT_EQ(wxSize(0, 0), atlas.GetSize(-1));
+
+    // The page is no larger than it needs to be
+    const auto &page = atlas.GetPage(0);
+    ASSERT_LE(page.GetWidth(), SpriteAtlas::PageSize);
+    ASSERT_LE(page.GetHeight(), SpriteAtlas::PageSize);
+    ASSERT_LT(page.GetWidth() * page.GetHeight(), 400 * 600);
+
+    // Each sprite keeps its size, pixels and alpha
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        int sprite = atlas.Find(images[i].first);
+        ASSERT_NE(-1, sprite);
+        ASSERT_EQ(images[i].second.GetSize(), atlas.GetSize(sprite));
+    }
+
+    int halfSprite = atlas.Find(L"half.png");
+    ASSERT_TRUE(atlas.IsTransparent(halfSprite, 5, 5));
+    ASSERT_FALSE(atlas.IsTransparent(halfSprite, 15, 5));
+    ASSERT_TRUE(atlas.IsTransparent(halfSprite, 25, 5));
+    ASSERT_FALSE(atlas.IsTransparent(atlas.Find(L"tall.png"), 0, 499));
+    ASSERT_TRUE(atlas.IsTransparent(atlas.Find(L"tall.png"), 0, 500));
+
+    // Every pixel outside the sprites is a transparent gutter
+    int opaque = 0;
+    for (int y = 0; y < page.GetHeight(); y++)
+    {
+        for (int x = 0; x < page.GetWidth(); x++)
+        {
+            if (!page.IsTransparent(x, y))
+            {
+                opaque++;
+            }
+        }
+    }
+    ASSERT_EQ(300 * 40 + 50 * 500 + 16 * 16 + 10 * 10, opaque);
+    ASSERT_TRUE(page.IsTransparent(0, 0));
+    ASSERT_EQ(1, page.GetRed(SpriteAtlas::Gutter + 50 + SpriteAtlas::Gutter, SpriteAtlas::Gutter));
+}
+
+TEST(SpriteAtlasTest, Pages)
+{
+    // Four images that each fill most of a page
+    vector<pair<wstring, wxImage>> images;
+    for (int i = 0; i < 4; i++)
+    {
+        images.emplace_back(wxString::Format(L"big%d.png", i).ToStdWstring(), SolidImage(1500, 1500, 5));
+    }
+    images.emplace_back(L"huge.png", SolidImage(SpriteAtlas::PageSize + 1, 10, 6));
+
+    SpriteAtlas atlas;
+    atlas.Pack(images);
+    ASSERT_EQ(5, atlas.GetNumPages());
+
+    // An image larger than a page gets one of its own
+    for (int page = 0; page < atlas.GetNumPages(); page++)
+    {
+        if (atlas.GetPage(page).GetWidth() > SpriteAtlas::PageSize)
+        {
+            ASSERT_EQ(10 + 2 * SpriteAtlas::Gutter, atlas.GetPage(page).GetHeight());
+        }
+    }
+    ASSERT_FALSE(atlas.IsTransparent(atlas.Find(L"huge.png"), SpriteAtlas::PageSize, 9));
+}
+
+TEST(SpriteAtlasTest, Images)
+{
+    // The game's images fit on one page
+    auto atlas = SpriteAtlas::Shared(L"images");
+    ASSERT_EQ(1, atlas->GetNumPages());
+
+    wxImage beam(L"images/beam-red.png", wxBITMAP_TYPE_PNG);
+    int sprite = atlas->Find(L"images/beam-red.png");
+    ASSERT_NE(-1, sprite);
+    ASSERT_EQ(beam.GetSize(), atlas->GetSize(sprite));
+    for (int y = 0; y < beam.GetHeight(); y++)
+    {
+        for (int x = 0; x < beam.GetWidth(); x++)
+        {
+            ASSERT_EQ(beam.IsTransparent(x, y), atlas->IsTransparent(sprite, x, y));
+        }
+    }
+
+    ASSERT_NE(-1, atlas->Find(L"sparty-back.png"));
+    ASSERT_NE(-1, atlas->Find(L"izzo.png"));
+    ASSERT_EQ(-1, atlas->Find(L"screenshot.png"));
+
+    // Games share the atlas while any holds it
+    ASSERT_EQ(atlas, SpriteAtlas::Shared(L"images"));
+}
+
+TEST(SpriteAtlasTest, Load)
+{
+    SpriteAtlas built;
+    ASSERT_TRUE(built.Build(L"images"));
+
+    // Laid out from the file headers before any image is decoded
+    SpriteAtlas loaded;
+    loaded.Load(L"images");
+    ASSERT_EQ(built.GetNumSprites(), loaded.GetNumSprites());
+    ASSERT_EQ(built.GetNumPages(), loaded.GetNumPages());
+    for (int sprite = 0; sprite < built.GetNumSprites(); sprite++)
+    {
+        ASSERT_EQ(built.GetSize(sprite), loaded.GetSize(sprite));
+    }
+    int sparty = loaded.Find(L"sparty-front.png");
+    ASSERT_EQ(built.Find(L"sparty-front.png"), sparty);
+
+    // Once decoded it matches an atlas decoded up front
+    loaded.Wait();
+    ASSERT_TRUE(loaded.IsDecoded());
+    const auto &builtPage = built.GetPage(0);
+    const auto &loadedPage = loaded.GetPage(0);
+    ASSERT_EQ(builtPage.GetSize(), loadedPage.GetSize());
+    for (int y = 0; y < builtPage.GetHeight(); y++)
+    {
+        for (int x = 0; x < builtPage.GetWidth(); x++)
+        {
+            ASSERT_EQ(builtPage.IsTransparent(x, y), loadedPage.IsTransparent(x, y));
+            ASSERT_EQ(builtPage.GetRed(x, y), loadedPage.GetRed(x, y));
+        }
+    }
+}
+
+TEST(SpriteAtlasTest, Scale)
+{
+    // Left half transparent, right half opaque
+    wxImage half = SolidImage(40, 20, 7);
+    half.InitAlpha();
+    for (int x = 0; x < 20; x++)
+    {
+        for (int y = 0; y < 20; y++)
+        {
+            half.SetAlpha(x, y, 0);
+        }
+    }
+
+    vector<pair<wstring, wxImage>> images;
+    images.emplace_back(L"neighbor.png", SolidImage(40, 20, 200));
+    images.emplace_back(L"half.png", half);
+
+    SpriteAtlas atlas;
+    atlas.Pack(images);
+
+    // Resampled from the sprite alone, never its neighbors on the page
+    auto scaled = atlas.ScaleSprite(atlas.Find(L"half.png"), 20, 10);
+    ASSERT_EQ(wxSize(20, 10), scaled.GetSize());
+    ASSERT_TRUE(scaled.HasAlpha());
+    ASSERT_TRUE(scaled.IsTransparent(2, 5));
+    ASSERT_FALSE(scaled.IsTransparent(17, 5));
+    ASSERT_EQ(7, scaled.GetRed(19, 9));
+}
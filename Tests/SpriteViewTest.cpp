@@ -0,0 +1,57 @@
+/**
+ * @file SpriteViewTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <Game.h>
+#include <SpriteAtlas.h>
+#include <SpriteView.h>
+
+using namespace std;
+
+TEST(SpriteViewTest, Scale)
+{
+    vector<pair<wstring, wxImage>> images;
+    images.emplace_back(L"square.png", wxImage(40, 40));
+    auto atlas = make_shared<SpriteAtlas>();
+    atlas->Pack(images);
+
+    SpriteView view(atlas);
+    ASSERT_EQ(atlas.get(), view.GetAtlas());
+    ASSERT_EQ(1.0, view.GetScale());
+
+    // Drawn under half scale, the sprite is resampled once
+    wxImage frame(100, 100);
+    {
+        unique_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(frame));
+        view.SetScale(0.5);
+        view.Draw(graphics.get(), atlas->Find(L"square.png"), 0, 0, 40, 40);
+        view.Draw(graphics.get(), atlas->Find(L"square.png"), 50, 50, 40, 40);
+    }
+    ASSERT_EQ(1, view.GetNumScaled());
+
+    view.SetScale(0.5);
+    ASSERT_EQ(1, view.GetNumScaled());
+    view.SetScale(2);
+    ASSERT_EQ(2.0, view.GetScale());
+    ASSERT_EQ(0, view.GetNumScaled());
+}
+
+TEST(SpriteViewTest, PerGame)
+{
+    // Games share the decoded images, but not what drawing makes of them
+    Game a;
+    Game b;
+    ASSERT_EQ(a.GetAtlas(), b.GetAtlas());
+    ASSERT_NE(a.GetSprites(), b.GetSprites());
+    ASSERT_EQ(a.GetAtlas(), a.GetSprites()->GetAtlas());
+
+    a.GetSprites()->SetScale(0.5);
+    ASSERT_EQ(0.5, a.GetSprites()->GetScale());
+    ASSERT_EQ(1.0, b.GetSprites()->GetScale());
+}
@@ -0,0 +1,72 @@
+/**
+ * @file TaskGraphTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <atomic>
+#include <utility>
+#include <vector>
+#include <TaskGraph.h>
+#include <WorkStealingPool.h>
+
+using namespace std;
+
+TEST(TaskGraphTest, InOrderWithoutPool)
+{
+    TaskGraph graph;
+    vector<int> order;
+    for (int i = 0; i < 5; i++)
+    {
+        graph.Add([&order, i] { order.push_back(i); });
+    }
+    graph.AddDependency(4, 1);
+    ASSERT_EQ(graph.GetNumTasks(), 5);
+
+    graph.Run(nullptr);
+    ASSERT_EQ(order, vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(TaskGraphTest, Dependencies)
+{
+    const int NumTasks = 200;
+
+    TaskGraph graph;
+    atomic<int> clock{0};
+    vector<int> finished(NumTasks);
+    for (int i = 0; i < NumTasks; i++)
+    {
+        graph.Add([&clock, &finished, i] { finished[i] = ++clock; });
+    }
+
+    // Chains and diamonds, with tasks waiting on several others
+    vector<pair<int, int>> edges;
+    for (int i = 1; i < NumTasks; i++)
+    {
+        if (i % 3 != 0)
+        {
+            edges.emplace_back(i, i / 2);
+        }
+        if (i % 7 == 0)
+        {
+            edges.emplace_back(i, i - 5);
+        }
+    }
+    for (auto &edge : edges)
+    {
+        graph.AddDependency(edge.first, edge.second);
+    }
+
+    WorkStealingPool pool(4);
+    for (int run = 0; run < 50; run++)
+    {
+        clock = 0;
+        graph.Run(&pool);
+        ASSERT_EQ(clock, NumTasks);
+        for (auto &edge : edges)
+        {
+            ASSERT_LT(finished[edge.second], finished[edge.first]);
+        }
+    }
+}
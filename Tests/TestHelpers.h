@@ -0,0 +1,128 @@
+/**
+ * @file TestHelpers.h
+ * @author matthew vazquez
+ *
+ * Helpers shared by the tests.
+ */
+
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+#include <string>
+#include <vector>
+#include <CircuitVerifier.h>
+#include <Conveyor.h>
+#include <Game.h>
+#include <ItemVisitor.h>
+#include <LevelLoader.h>
+#include <Product.h>
+#include <XmlPullParser.h>
+
+/**
+ * Make a product specification
+ * @param properties Property names the sensor sees
+ * @param kick Should Sparty kick it
+ * @return The specification
+ */
+inline CircuitVerifier::ProductSpec MakeProduct(std::vector<std::wstring> properties, bool kick)
+{
+    CircuitVerifier::ProductSpec spec;
+    spec.mProperties = properties;
+    spec.mKick = kick;
+    return spec;
+}
+
+/**
+ * Load an item into a game the way a level file loads it
+ * @param game Game to load into
+ * @param element The item's element, such as <andgate id="g1"/>
+ */
+inline void LoadItem(Game &game, const std::string &element)
+{
+    XmlPullParser parser;
+    parser.SetText(element);
+    parser.Next();
+    game.XmlItem(parser);
+}
+
+/**
+ * Visitor that collects the conveyors and products of a level
+ */
+class LevelItems : public ItemVisitor
+{
+public:
+    /// Conveyors in the order visited
+    std::vector<Conveyor *> mConveyors;
+
+    /// Products in the order visited
+    std::vector<Product *> mProducts;
+
+    /// Sparty of each line, in the order visited
+    std::vector<Sparty *> mSparties;
+
+    /**
+     * Collect a conveyor
+     * @param conveyor Conveyor we are visiting
+     */
+    void VisitConveyor(Conveyor *conveyor) override { mConveyors.push_back(conveyor); }
+
+    /**
+     * Collect a product
+     * @param product Product we are visiting
+     */
+    void VisitProduct(Product *product) override { mProducts.push_back(product); }
+
+    /**
+     * Collect Sparty
+     * @param sparty Sparty we are visiting
+     */
+    void VisitSparty(Sparty *sparty) override { mSparties.push_back(sparty); }
+
+    /**
+     * Count the products that were kicked
+     * @return Number of kicked products
+     */
+    int GetNumKicked() const
+    {
+        int kicked = 0;
+        for (auto product : mProducts)
+        {
+            kicked += product->GetWasKicked() ? 1 : 0;
+        }
+        return kicked;
+    }
+};
+
+/**
+ * Load a level with each line's beam wired straight to its Sparty,
+ * so every product is kicked, and start its conveyors
+ * @param game Game to load into
+ * @param level Level file
+ */
+inline void StartWiredLevel(Game &game, const wxString &level = L"levels/level1.xml")
+{
+    LevelLoader loader;
+    loader.LoadLevel(level, &game);
+    for (int i = 0; i < game.GetNumLines(); i++)
+    {
+        auto line = L"line" + std::to_wstring(i + 1);
+        game.XmlWire(line + L".beam", line + L".sparty");
+    }
+    game.StartConveyors();
+}
+
+/**
+ * Update a game in equal steps
+ * @param game Game to update
+ * @param steps Number of steps
+ * @param step Seconds each step covers
+ */
+inline void Play(Game &game, int steps, double step = 0.01)
+{
+    for (int i = 0; i < steps; i++)
+    {
+        game.Update(step);
+    }
+}
+
+#endif //TESTHELPERS_H
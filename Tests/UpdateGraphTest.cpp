@@ -0,0 +1,119 @@
+/**
+ * @file UpdateGraphTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+#include <AndGate.h>
+#include <Conveyor.h>
+#include <Game.h>
+#include <OrGate.h>
+#include <Product.h>
+#include <Scoreboard.h>
+#include <Sparty.h>
+#include <UpdateGraph.h>
+#include <WorkStealingPool.h>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(UpdateGraphTest, Stages)
+{
+    Game game;
+    vector<shared_ptr<Item>> items;
+    vector<shared_ptr<Product>> products;
+    items.push_back(make_shared<Conveyor>(&game));
+    for (int i = 0; i < 600; i++)
+    {
+        products.push_back(make_shared<Product>(&game));
+        products.back()->Kick(100);
+        items.push_back(products.back());
+    }
+    items.push_back(make_shared<Scoreboard>(&game));
+    items.push_back(make_shared<AndGate>(&game));
+    items.push_back(make_shared<OrGate>(&game));
+
+    // The conveyor, three chunks of products, the scoreboard, and a
+    // stage for each gate, as no wire joins them
+    UpdateGraph graph;
+    graph.Build(items);
+    ASSERT_EQ(graph.GetNumStages(), 7);
+    ASSERT_EQ(graph.GetPhase(graph.GetStageOf(products[0].get())), UpdateGraph::Phase::Motion);
+    auto andStage = graph.GetStageOf(items[602].get());
+    auto orStage = graph.GetStageOf(items[603].get());
+    ASSERT_EQ(graph.GetPhase(andStage), UpdateGraph::Phase::Gates);
+    ASSERT_TRUE(graph.IsConcurrent(andStage, orStage));
+
+    // Wired together, the gates update in one stage
+    auto andGate = static_pointer_cast<AndGate>(items[602]);
+    auto orGate = static_pointer_cast<OrGate>(items[603]);
+    andGate->GetOutputPin(0)->SetConnection(orGate->GetInputPin(0));
+    graph.Build(items);
+    ASSERT_EQ(graph.GetNumStages(), 6);
+    ASSERT_EQ(graph.GetStageOf(andGate.get()), graph.GetStageOf(orGate.get()));
+
+    graph.Update(0.5, nullptr);
+    for (auto &product : products)
+    {
+        ASSERT_NEAR(product->GetX(), -50, 0.0001);
+    }
+
+    WorkStealingPool pool(4);
+    graph.Update(0.5, &pool);
+    for (auto &product : products)
+    {
+        ASSERT_NEAR(product->GetX(), -100, 0.0001);
+    }
+}
+
+TEST(UpdateGraphTest, ParallelMatchesSerial)
+{
+    GameConfig parallel;
+    parallel.mUpdateThreads = 4;
+
+    Game serialGame;
+    Game parallelGame(parallel);
+    StartWiredLevel(serialGame, L"levels/level8.xml");
+    StartWiredLevel(parallelGame, L"levels/level8.xml");
+
+    for (int step = 0; step < 700; step++)
+    {
+        serialGame.Update(0.01);
+        parallelGame.Update(0.01);
+        ASSERT_EQ(serialGame.StateHash(), parallelGame.StateHash());
+    }
+
+    LevelItems items;
+    parallelGame.Accept(&items);
+    ASSERT_GT(items.GetNumKicked(), 0);
+}
+
+TEST(UpdateGraphTest, LinesConcurrent)
+{
+    Game game;
+    StartWiredLevel(game, L"levels/level9.xml");
+    game.Update(0.01);
+
+    // Each line's beam only drives its own Sparty, so the lines' kicks
+    // do not wait for each other
+    LevelItems items;
+    game.Accept(&items);
+    ASSERT_EQ(items.mSparties.size(), 2u);
+    auto &graph = game.GetUpdateGraph();
+    auto kick1 = graph.GetStageOf(items.mSparties[0]);
+    auto kick2 = graph.GetStageOf(items.mSparties[1]);
+    ASSERT_EQ(graph.GetPhase(kick1), UpdateGraph::Phase::Kick);
+    ASSERT_EQ(graph.GetPhase(kick2), UpdateGraph::Phase::Kick);
+    ASSERT_TRUE(graph.IsConcurrent(kick1, kick2));
+
+    // A wire between the lines joins their circuits, and the game
+    // finds the stages again
+    game.XmlWire(L"line1.beam", L"line2.sparty");
+    game.Update(0.01);
+    kick1 = graph.GetStageOf(items.mSparties[0]);
+    kick2 = graph.GetStageOf(items.mSparties[1]);
+    ASSERT_FALSE(graph.IsConcurrent(kick1, kick2));
+}
@@ -0,0 +1,57 @@
+/**
+ * @file WorkStealingPoolTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <WorkStealingPool.h>
+#include <atomic>
+
+TEST(WorkStealingPoolTest, RunsEveryTask)
+{
+    WorkStealingPool pool(4);
+    ASSERT_EQ(pool.GetNumThreads(), 4);
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 1000; i++)
+    {
+        pool.Submit([&count] { count++; });
+    }
+    pool.Wait();
+
+    ASSERT_EQ(count, 1000);
+}
+
+TEST(WorkStealingPoolTest, TasksSubmitTasks)
+{
+    WorkStealingPool pool(3);
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 10; i++)
+    {
+        pool.Submit([&pool, &count] {
+            for (int j = 0; j < 100; j++)
+            {
+                pool.Submit([&count] { count++; });
+            }
+        });
+    }
+    pool.Wait();
+
+    ASSERT_EQ(count, 1000);
+}
+
+TEST(WorkStealingPoolTest, Reusable)
+{
+    WorkStealingPool pool;
+    ASSERT_GE(pool.GetNumThreads(), 1);
+
+    std::atomic<int> count{0};
+    for (int round = 0; round < 5; round++)
+    {
+        pool.Submit([&count] { count++; });
+        pool.Wait();
+        ASSERT_EQ(count, round + 1);
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ * @file XmlPullParserTest.cpp
+ * @author matthew vazquez
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+#include <Game.h>
+#include <Beam.h>
+#include <Conveyor.h>
+#include <Gates.h>
+#include <ItemVisitor.h>
+#include <LevelLoader.h>
+#include <Product.h>
+#include <Sensor.h>
+#include <Sparty.h>
+#include <XmlPullParser.h>
+
+using namespace std;
+
+/**
+ * Visitor that describes every item, to compare two loads of a level
+ */
+class LoadedItemsVisitor : public ItemVisitor
+{
+public:
+    /// Item types and locations, and what else was loaded, in the order visited
+    vector<wstring> mItems;
+
+    /**
+     * Describe an item
+     * @param type Type of the item
+     * @param item Item we are visiting
+     * @param detail What else was loaded for the item
+     */
+    void Describe(const wstring &type, Item *item, const wstring &detail = L"")
+    {
+        mItems.push_back(wxString::Format(L"%ls %g,%g %ls", type, item->GetX(), item->GetY(), detail).ToStdWstring());
+    }
+
+    /**
+     * Describe a product
+     * @param product Product we are visiting
+     */
+    void VisitProduct(Product *product) override
+    {
+        wstring properties;
+        for (auto property : product->GetProperties())
+        {
+            properties += to_wstring((int)property) + L" ";
+        }
+        Describe(L"product", product, properties);
+    }
+
+    /**
+     * Describe a sensor
+     * @param sensor Sensor we are visiting
+     */
+    void VisitSensor(Sensor *sensor) override
+    {
+        Describe(L"sensor", sensor, to_wstring(sensor->GetSensorPanels().size()));
+    }
+
+    /**
+     * Describe Sparty
+     * @param sparty Sparty we are visiting
+     */
+    void VisitSparty(Sparty *sparty) override
+    {
+        auto kick = sparty->GetKickPoint();
+        Describe(L"sparty", sparty, to_wstring(kick.m_x) + L"," + to_wstring(kick.m_y));
+    }
+
+    /**
+     * Describe a gate
+     * @param gates Gate we are visiting
+     */
+    void VisitGates(Gates *gates) override { Describe(L"gate", gates, gates->GetId()); }
+
+    /**
+     * Describe a conveyor
+     * @param conveyor Conveyor we are visiting
+     */
+    void VisitConveyor(Conveyor *conveyor) override { Describe(L"conveyor", conveyor); }
+
+    /**
+     * Describe a beam
+     * @param beam Beam we are visiting
+     */
+    void VisitBeam(Beam *beam) override { Describe(L"beam", beam); }
+};
+
+TEST(XmlPullParserTest, Events)
+{
+    string text = "<?xml version='1.0'?>\n"
+                  "<!-- a comment -->\n"
+                  "<level size=\"1150,800\">\n"
+                  "  <items>\n"
+                  "    <beam x='242' y=\"437\" sender=\"-185\"/>\n"
+                  "    <scoreboard>Kick &amp; score<br/>again</scoreboard>\n"
+                  "  </items>\n"
+                  "</level>\n";
+
+    XmlPullParser parser;
+    parser.SetText(text);
+    ASSERT_TRUE(parser.IsWellFormed());
+
+    ASSERT_EQ(parser.Next(), XmlPullParser::Event::StartElement);
+    ASSERT_EQ(parser.GetName(), "level");
+    ASSERT_EQ(parser.GetLineNumber(), 3);
+    double width = 0;
+    double height = 0;
+    ASSERT_TRUE(XmlPullParser::ToPair(parser.GetAttribute("size"), width, height));
+    ASSERT_EQ(width, 1150);
+    ASSERT_EQ(height, 800);
+
+    int level = parser.GetDepth();
+    ASSERT_TRUE(parser.NextChild(level));
+    ASSERT_EQ(parser.GetName(), "items");
+
+    int items = parser.GetDepth();
+    ASSERT_TRUE(parser.NextChild(items));
+    ASSERT_EQ(parser.GetName(), "beam");
+    ASSERT_EQ(parser.GetLineNumber(), 5);
+    ASSERT_EQ(parser.GetDouble("x", 0), 242);
+    ASSERT_EQ(parser.GetDouble("sender", 0), -185);
+    ASSERT_EQ(parser.GetDouble("missing", 7), 7);
+    ASSERT_FALSE(parser.HasAttribute("missing"));
+
+    // Children not stepped into are skipped
+    ASSERT_TRUE(parser.NextChild(items));
+    ASSERT_EQ(parser.GetName(), "scoreboard");
+    ASSERT_FALSE(parser.NextChild(items));
+    ASSERT_FALSE(parser.NextChild(level));
+    ASSERT_EQ(parser.Next(), XmlPullParser::Event::End);
+
+    // Text is raw until decoded
+    parser.Rewind();
+    while (parser.Next() != XmlPullParser::Event::Text)
+    {
+    }
+    ASSERT_EQ(parser.GetText(), "Kick &amp; score");
+    ASSERT_EQ(XmlPullParser::Decode(parser.GetText()), L"Kick & score");
+}
+
+TEST(XmlPullParserTest, Malformed)
+{
+    XmlPullParser parser;
+    for (string text : {"", "<level>", "<level></items>", "<level x=1/>", "<level x='1/>", "text", "<a/>text"})
+    {
+        parser.SetText(text);
+        ASSERT_FALSE(parser.IsWellFormed()) << text;
+    }
+
+    ASSERT_FALSE(parser.Open(L"levels/no-such-level.xml"));
+}
+
+TEST(XmlPullParserTest, MappedMatchesRead)
+{
+    for (int level = 0; level <= 10; level++)
+    {
+        auto filename = wxString::Format(L"levels/level%d.xml", level);
+
+        // A mapped level and one read into memory load the same items
+        Game pulled;
+        LevelLoader loader;
+        loader.LoadLevel(filename, &pulled);
+
+        Game built;
+        XmlPullParser parser;
+        ASSERT_TRUE(parser.Read(filename));
+        loader.XmlLoad(parser, &built);
+
+        ASSERT_EQ(pulled.GetWidth(), built.GetWidth());
+        ASSERT_EQ(pulled.GetHeight(), built.GetHeight());
+        ASSERT_EQ(pulled.GetNumLines(), built.GetNumLines());
+        ASSERT_EQ(pulled.GetNumProducts(), built.GetNumProducts());
+        ASSERT_EQ(pulled.StateHash(), built.StateHash());
+
+        LoadedItemsVisitor pulledItems;
+        LoadedItemsVisitor builtItems;
+        pulled.Accept(&pulledItems);
+        built.Accept(&builtItems);
+        ASSERT_FALSE(pulledItems.mItems.empty());
+        ASSERT_EQ(pulledItems.mItems, builtItems.mItems);
+    }
+}
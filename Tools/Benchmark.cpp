@@ -0,0 +1,487 @@
+/**
+ * @file Benchmark.cpp
+ * @author matthew vazquez
+ *
+ * Command line tool that times the game's hot paths.
+ *
+ * Usage: benchmark [--frames N] [--items N] [--load-products N] [level.xml]
+ *
+ * Plays a level headless with the beam wired to Sparty and the
+ * conveyors running, and reports nanoseconds per operation for each
+ * case, including drawing its frames offscreen and each item type's
+ * share of that. Then generates a level with the given number of products and
+ * gates and times updating its items through virtual calls and
+ * through ItemRuns, and a whole frame on one thread and on every
+ * core. Last, writes a level with --load-products products and times
+ * parsing it into a wxXmlDocument and with XmlPullParser, and loading
+ * it into a game, per product. Run from the directory holding images/ and levels/.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/mstream.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Beam.h>
+#include <Conveyor.h>
+#include <FrameRenderer.h>
+#include <Game.h>
+#include <GameSnapshot.h>
+#include <Gates.h>
+#include <ItemRuns.h>
+#include <ItemVisitor.h>
+#include <LevelLoader.h>
+#include <Product.h>
+#include <Scoreboard.h>
+#include <Sensor.h>
+#include <SensorPanel.h>
+#include <Sparty.h>
+#include <SpriteAtlas.h>
+#include <XmlPullParser.h>
+
+/// Simulation time step in seconds, small so the level lasts
+const double TimeStep = 0.001;
+
+/// Frames between going back to the start of the level
+const int FramesPerRun = 2000;
+
+/**
+ * Visitor that collects every item in the order visited
+ */
+class ItemCollector : public ItemVisitor
+{
+public:
+    /// Items in the order visited
+    std::vector<Item *> mItems;
+
+    /// @param beam Beam we are visiting
+    void VisitBeam(Beam *beam) override { mItems.push_back(beam); }
+
+    /// @param conveyor Conveyor we are visiting
+    void VisitConveyor(Conveyor *conveyor) override { mItems.push_back(conveyor); }
+
+    /// @param scoreboard Scoreboard we are visiting
+    void VisitScoreboard(Scoreboard *scoreboard) override { mItems.push_back(scoreboard); }
+
+    /// @param sensor Sensor we are visiting
+    void VisitSensor(Sensor *sensor) override { mItems.push_back(sensor); }
+
+    /// @param sparty Sparty we are visiting
+    void VisitSparty(Sparty *sparty) override { mItems.push_back(sparty); }
+
+    /// @param product Product we are visiting
+    void VisitProduct(Product *product) override { mItems.push_back(product); }
+
+    /// @param gates Gate we are visiting
+    void VisitGates(Gates *gates) override { mItems.push_back(gates); }
+};
+
+/**
+ * Visitor that collects the items of each type
+ */
+class ItemTypeCollector : public ItemVisitor
+{
+public:
+    /// Items of each type, by type name
+    std::map<std::string, std::vector<Item *>> mTypes;
+
+    /// @param beam Beam we are visiting
+    void VisitBeam(Beam *beam) override { mTypes["beam"].push_back(beam); }
+
+    /// @param conveyor Conveyor we are visiting
+    void VisitConveyor(Conveyor *conveyor) override { mTypes["conveyor"].push_back(conveyor); }
+
+    /// @param scoreboard Scoreboard we are visiting
+    void VisitScoreboard(Scoreboard *scoreboard) override { mTypes["scoreboard"].push_back(scoreboard); }
+
+    /// @param sensor Sensor we are visiting
+    void VisitSensor(Sensor *sensor) override { mTypes["sensor"].push_back(sensor); }
+
+    /// @param sensorPanel Sensor panel we are visiting
+    void VisitSensorPanel(SensorPanel *sensorPanel) override { mTypes["sensor-panel"].push_back(sensorPanel); }
+
+    /// @param sparty Sparty we are visiting
+    void VisitSparty(Sparty *sparty) override { mTypes["sparty"].push_back(sparty); }
+
+    /// @param product Product we are visiting
+    void VisitProduct(Product *product) override { mTypes["product"].push_back(product); }
+
+    /// @param gates Gate we are visiting
+    void VisitGates(Gates *gates) override { mTypes["gate"].push_back(gates); }
+};
+
+/**
+ * Wire the beam to Sparty and start the conveyors
+ * @param game Game to start
+ */
+static void Start(Game &game)
+{
+    game.XmlWire(L"beam", L"sparty");
+    game.StartConveyors();
+}
+
+/**
+ * Generate a level with many products on one conveyor and many gates
+ * @param numItems Number of products
+ * @param numGates Number of gates
+ * @return Text of the level file
+ */
+static std::string GenerateLevel(int numItems, int numGates)
+{
+    wxXmlDocument xmlDoc;
+    auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"level");
+    xmlDoc.SetRoot(root);
+    root->AddAttribute(L"size", L"1150,800");
+    auto items = new wxXmlNode(root, wxXML_ELEMENT_NODE, L"items");
+
+    auto sensor = new wxXmlNode(items, wxXML_ELEMENT_NODE, L"sensor");
+    sensor->AddAttribute(L"x", L"155");
+    sensor->AddAttribute(L"y", L"430");
+    sensor->AddChild(new wxXmlNode(wxXML_ELEMENT_NODE, L"red"));
+    sensor->AddChild(new wxXmlNode(wxXML_ELEMENT_NODE, L"circle"));
+
+    auto conveyor = new wxXmlNode(wxXML_ELEMENT_NODE, L"conveyor");
+    items->AddChild(conveyor);
+    conveyor->AddAttribute(L"x", L"205");
+    conveyor->AddAttribute(L"y", L"400");
+    conveyor->AddAttribute(L"speed", L"100");
+    conveyor->AddAttribute(L"height", L"800");
+    conveyor->AddAttribute(L"panel", L"60,-390");
+    const wchar_t *colors[] = {L"red", L"green", L"blue", L"white"};
+    for (int i = 0; i < numItems; i++)
+    {
+        auto product = new wxXmlNode(wxXML_ELEMENT_NODE, L"product");
+        product->AddAttribute(L"placement", i == 0 ? L"125" : L"+10");
+        product->AddAttribute(L"shape", i % 2 ? L"circle" : L"square");
+        product->AddAttribute(L"color", colors[i % 4]);
+        conveyor->AddChild(product);
+    }
+
+    auto beam = new wxXmlNode(wxXML_ELEMENT_NODE, L"beam");
+    items->AddChild(beam);
+    beam->AddAttribute(L"x", L"297");
+    beam->AddAttribute(L"y", L"437");
+    beam->AddAttribute(L"sender", L"-185");
+
+    auto sparty = new wxXmlNode(wxXML_ELEMENT_NODE, L"sparty");
+    items->AddChild(sparty);
+    sparty->AddAttribute(L"x", L"345");
+    sparty->AddAttribute(L"y", L"340");
+    sparty->AddAttribute(L"height", L"300");
+    sparty->AddAttribute(L"pin", L"1100, 400");
+
+    const wchar_t *gateTypes[] = {L"andgate", L"orgate", L"notgate", L"srflipflop", L"dflipflop"};
+    for (int i = 0; i < numGates; i++)
+    {
+        auto gate = new wxXmlNode(wxXML_ELEMENT_NODE, gateTypes[i % 5]);
+        gate->AddAttribute(L"x", wxString::Format(L"%d", 500 + i % 20 * 30));
+        gate->AddAttribute(L"y", wxString::Format(L"%d", 100 + i / 20 % 20 * 30));
+        items->AddChild(gate);
+    }
+
+    wxMemoryOutputStream stream;
+    xmlDoc.Save(stream);
+    std::string text(stream.GetLength(), '\0');
+    stream.CopyTo(text.data(), text.size());
+    return text;
+}
+
+/**
+ * Time a case and print its cost per operation
+ * @param name Name of the case
+ * @param operations Number of operations the case does
+ * @param run Function that does them
+ */
+template <class Function>
+static void Time(const char *name, long operations, Function run)
+{
+    auto start = std::chrono::steady_clock::now();
+    run();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("%-24s %12ld ops %10.1f ns/op\n", name, operations, ns / operations);
+}
+
+/**
+ * Main entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if the level was found
+ */
+int main(int argc, char *argv[])
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    long frames = 100000;
+    int numItems = 2000;
+    int loadProducts = 100000;
+    wxString level = L"levels/level8.xml";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--items") == 0 && i + 1 < argc)
+        {
+            numItems = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--load-products") == 0 && i + 1 < argc)
+        {
+            loadProducts = atoi(argv[++i]);
+        }
+        else
+        {
+            level = wxString::FromUTF8(argv[i]);
+        }
+    }
+
+    if (!wxFileExists(level))
+    {
+        fprintf(stderr, "%s: not found\n", level.ToStdString().c_str());
+        return 1;
+    }
+
+    Game game;
+    LevelLoader loader;
+    loader.LoadLevel(level, &game);
+    Start(game);
+
+    // Each run starts from the same state, so every frame does similar work
+    GameSnapshot start;
+    game.SaveSnapshot(start);
+
+    Time("update", frames, [&]() {
+        for (long frame = 0; frame < frames; frame++)
+        {
+            if (frame % FramesPerRun == 0)
+            {
+                game.RestoreSnapshot(start);
+            }
+            game.Update(TimeStep);
+        }
+    });
+
+    Time("hit-test", frames, [&]() {
+        int hits = 0;
+        for (long i = 0; i < frames; i++)
+        {
+            hits += game.HitTest(int(i * 37 % game.GetWidth()), int(i * 53 % game.GetHeight())) != nullptr;
+        }
+        if (hits < 0)
+        {
+            printf("%d\n", hits);
+        }
+    });
+
+    // Drawing, offscreen at the level's own size, as a whole frame and
+    // per item type; the last frame drawn set the sprites' scale
+    FrameRenderer renderer(game.GetWidth(), game.GetHeight());
+    game.GetAtlas()->Wait();
+    long drawFrames = std::max(frames / 100, 1L);
+    Time("draw-frame", drawFrames, [&]() {
+        renderer.Render([&](wxGraphicsContext *graphics) {
+            for (long frame = 0; frame < drawFrames; frame++)
+            {
+                game.OnDraw(graphics, renderer.GetWidth(), renderer.GetHeight());
+            }
+        });
+    });
+
+    ItemTypeCollector types;
+    game.Accept(&types);
+    for (const auto &type : types.mTypes)
+    {
+        long draws = drawFrames * (long)type.second.size();
+        Time(("draw-" + type.first).c_str(), draws, [&]() {
+            renderer.Render([&](wxGraphicsContext *graphics) {
+                for (long frame = 0; frame < drawFrames; frame++)
+                {
+                    for (auto item : type.second)
+                    {
+                        item->Draw(graphics);
+                    }
+                }
+            });
+        });
+    }
+
+    // What passing shared_ptr by value costs: a refcount increment and
+    // decrement per item per frame, which the update loop used to do
+    std::vector<std::shared_ptr<Item>> items;
+    for (int i = 0; i < 64; i++)
+    {
+        items.push_back(game.Create<Product>(&game));
+    }
+
+    long visits = frames * (long)items.size();
+    double sum = 0;
+    Time("items-by-value", visits, [&]() {
+        for (long frame = 0; frame < frames; frame++)
+        {
+            for (auto item : items)
+            {
+                sum += item->GetX();
+            }
+        }
+    });
+
+    Time("items-by-reference", visits, [&]() {
+        for (long frame = 0; frame < frames; frame++)
+        {
+            for (const auto &item : items)
+            {
+                sum += item->GetX();
+            }
+        }
+    });
+
+    // A generated level, to compare calling each item's Update
+    // virtually with calling it on runs of one concrete type
+    Game generated;
+    auto generatedLevel = GenerateLevel(numItems, numItems);
+    XmlPullParser generatedParser;
+    generatedParser.SetText(generatedLevel);
+    loader.XmlLoad(generatedParser, &generated);
+    Start(generated);
+
+    ItemCollector collector;
+    generated.Accept(&collector);
+    ItemRuns runs;
+    for (auto item : collector.mItems)
+    {
+        runs.Add(item);
+    }
+    printf("generated level: %zu items in %zu runs\n", runs.GetNumItems(), runs.GetNumRuns());
+
+    GameSnapshot generatedStart;
+    generated.SaveSnapshot(generatedStart);
+    long generatedFrames = frames / 10;
+    long itemUpdates = generatedFrames * (long)runs.GetNumItems();
+
+    Time("items-virtual-update", itemUpdates, [&]() {
+        for (long frame = 0; frame < generatedFrames; frame++)
+        {
+            if (frame % FramesPerRun == 0)
+            {
+                generated.RestoreSnapshot(generatedStart);
+            }
+            for (auto item : collector.mItems)
+            {
+                item->Update(TimeStep);
+            }
+        }
+    });
+
+    Time("items-typed-update", itemUpdates, [&]() {
+        for (long frame = 0; frame < generatedFrames; frame++)
+        {
+            if (frame % FramesPerRun == 0)
+            {
+                generated.RestoreSnapshot(generatedStart);
+            }
+            runs.Update(TimeStep);
+        }
+    });
+
+    Time("generated-frame", generatedFrames, [&]() {
+        for (long frame = 0; frame < generatedFrames; frame++)
+        {
+            if (frame % FramesPerRun == 0)
+            {
+                generated.RestoreSnapshot(generatedStart);
+            }
+            generated.Update(TimeStep);
+        }
+    });
+
+    // The same level with its update stages run on every core
+    GameConfig threaded;
+    threaded.mUpdateThreads = 0;
+    Game parallel(threaded);
+    generatedParser.Rewind();
+    loader.XmlLoad(generatedParser, &parallel);
+    Start(parallel);
+
+    GameSnapshot parallelStart;
+    parallel.SaveSnapshot(parallelStart);
+
+    Time("generated-frame-threads", generatedFrames, [&]() {
+        for (long frame = 0; frame < generatedFrames; frame++)
+        {
+            if (frame % FramesPerRun == 0)
+            {
+                parallel.RestoreSnapshot(parallelStart);
+            }
+            parallel.Update(TimeStep);
+        }
+    });
+
+    // Loading a large level: parsing it into a document and with the
+    // pull parser, then loading it into a game
+    auto loadFile = wxFileName::CreateTempFileName(L"benchmark-level");
+    auto loadText = GenerateLevel(loadProducts, 0);
+    std::ofstream loadStream(loadFile.fn_str(), std::ios::binary | std::ios::trunc);
+    loadStream.write(loadText.data(), loadText.size());
+    loadStream.close();
+    if (!loadStream)
+    {
+        fprintf(stderr, "%s: unable to save\n", loadFile.ToStdString().c_str());
+        return 1;
+    }
+
+    Time("load-parse-document", loadProducts, [&]() {
+        wxXmlDocument xmlDoc;
+        xmlDoc.Load(loadFile);
+    });
+
+    Time("load-parse-pull", loadProducts, [&]() {
+        XmlPullParser parser;
+        parser.Open(loadFile);
+        long elements = 0;
+        XmlPullParser::Event event;
+        while ((event = parser.Next()) != XmlPullParser::Event::End && event != XmlPullParser::Event::Error)
+        {
+            elements += parser.IsStartElement() && parser.HasAttribute("placement");
+        }
+        sum += elements;
+    });
+
+    Time("load-level-pull", loadProducts, [&]() {
+        Game loaded;
+        loader.LoadLevel(loadFile, &loaded);
+    });
+
+    wxRemoveFile(loadFile);
+
+    // Startup: the images laid out from their headers, then decoded on a
+    // worker, against decoding them all before the first frame
+    if (wxDirExists(L"images"))
+    {
+        SpriteAtlas startupAtlas;
+        Time("startup-atlas-layout", 1, [&]() { startupAtlas.Load(L"images"); });
+        Time("startup-atlas-decode", 1, [&]() { startupAtlas.Wait(); });
+        Time("startup-atlas-sync", 1, [&]() {
+            SpriteAtlas atlas;
+            atlas.Build(L"images");
+        });
+        sum += startupAtlas.GetNumSprites();
+    }
+
+    return sum < 0 ? 1 : 0;
+}
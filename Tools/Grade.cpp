@@ -0,0 +1,132 @@
+/**
+ * @file Grade.cpp
+ * @author matthew vazquez
+ *
+ * Command line tool that plays every saved circuit in every level and reports the scores.
+ *
+ * Usage: grade [--threads N] [--out FILE] [--time-limit S] circuits-dir level.xml...
+ *
+ * Every .xml file in circuits-dir is wired into every level and the
+ * level is played headless until it ends. One CSV row per pair is
+ * written to FILE, or to standard output. Run from the directory
+ * holding images/, since levels load their images from there.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <wx/dir.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <BatchGrader.h>
+#include <WorkStealingPool.h>
+
+/**
+ * Main entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if every level and circuit loaded
+ */
+int main(int argc, char *argv[])
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    int threads = 0;
+    double timeLimit = BatchGrader::DefaultTimeLimit;
+    std::string outFile;
+    wxString circuitDir;
+    std::vector<wxString> levels;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+        {
+            outFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc)
+        {
+            timeLimit = atof(argv[++i]);
+        }
+        else if (circuitDir.empty())
+        {
+            circuitDir = wxString::FromUTF8(argv[i]);
+        }
+        else
+        {
+            levels.push_back(wxString::FromUTF8(argv[i]));
+        }
+    }
+
+    if (levels.empty())
+    {
+        fprintf(stderr, "usage: grade [--threads N] [--out FILE] [--time-limit S] circuits-dir level.xml...\n");
+        return 1;
+    }
+
+    wxArrayString circuits;
+    wxDir::GetAllFiles(circuitDir, &circuits, L"*.xml", wxDIR_FILES);
+    circuits.Sort();
+    if (circuits.IsEmpty())
+    {
+        fprintf(stderr, "%s: no circuits found\n", circuitDir.ToStdString().c_str());
+        return 1;
+    }
+
+    BatchGrader grader;
+    grader.SetTimeLimit(timeLimit);
+
+    int failures = 0;
+    for (const auto &level : levels)
+    {
+        for (const auto &circuit : circuits)
+        {
+            if (!grader.AddJob(level.ToStdWstring(), circuit.ToStdWstring()))
+            {
+                fprintf(stderr, "%s, %s: unable to load\n",
+                        level.ToStdString().c_str(), circuit.ToStdString().c_str());
+                failures++;
+            }
+        }
+    }
+
+    WorkStealingPool pool(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    grader.Run(pool);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (outFile.empty())
+    {
+        grader.WriteCsv(std::cout);
+    }
+    else
+    {
+        std::ofstream out(outFile);
+        grader.WriteCsv(out);
+        if (!out)
+        {
+            fprintf(stderr, "%s: unable to save\n", outFile.c_str());
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "%d jobs on %d threads in %.1f ms (%.1f jobs/s)\n", grader.GetNumJobs(),
+            pool.GetNumThreads(), ms, grader.GetNumJobs() * 1000.0 / std::max(ms, 1.0));
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file Render.cpp
+ * @author matthew vazquez
+ *
+ * Command line tool that draws a frame of the game to a PNG file without a window.
+ *
+ * Usage: render [--size WxH] [--time S] [--circuit FILE] level.xml|session.session out.png
+ *
+ * A level is loaded the way the game loads it, the circuit in FILE
+ * is wired in, and with --time the conveyors are started and the
+ * level is played headless for S seconds. A session log is replayed
+ * instead, to the state it was saved in. The frame is drawn at the
+ * given size, 1150x800 by default. Run from the directory holding
+ * images/ and levels/, as the game is.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <CircuitSerializer.h>
+#include <FrameRenderer.h>
+#include <Game.h>
+#include <InputReplayer.h>
+#include <LevelLoader.h>
+
+/// Seconds each update covers, as the view's frames do
+const double TimeStep = 0.03;
+
+/**
+ * Main entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if the frame was saved
+ */
+int main(int argc, char *argv[])
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    int width = 1150;
+    int height = 800;
+    double time = 0;
+    wxString circuitFile;
+    wxString input;
+    wxString output;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+            {
+                fprintf(stderr, "%s: not a size\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+        {
+            time = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--circuit") == 0 && i + 1 < argc)
+        {
+            circuitFile = wxString::FromUTF8(argv[++i]);
+        }
+        else if (input.empty())
+        {
+            input = wxString::FromUTF8(argv[i]);
+        }
+        else
+        {
+            output = wxString::FromUTF8(argv[i]);
+        }
+    }
+
+    if (output.empty())
+    {
+        fprintf(stderr, "usage: render [--size WxH] [--time S] [--circuit FILE] level.xml|session.session out.png\n");
+        return 1;
+    }
+
+    Game game;
+    if (input.EndsWith(L".session"))
+    {
+        InputReplayer replayer;
+        if (!replayer.Load(input))
+        {
+            fprintf(stderr, "%s: not a session log\n", input.ToStdString().c_str());
+            return 1;
+        }
+        replayer.Replay(&game);
+    }
+    else
+    {
+        if (!wxFileExists(input))
+        {
+            fprintf(stderr, "%s: not found\n", input.ToStdString().c_str());
+            return 1;
+        }
+        LevelLoader loader;
+        loader.LoadLevel(input, &game);
+
+        if (!circuitFile.empty())
+        {
+            CircuitSerializer circuit;
+            if (!circuit.Load(circuitFile))
+            {
+                fprintf(stderr, "%s: not a circuit\n", circuitFile.ToStdString().c_str());
+                return 1;
+            }
+            circuit.Apply(&game);
+        }
+
+        if (time > 0)
+        {
+            game.StartConveyors();
+            for (double t = 0; t < time; t += TimeStep)
+            {
+                game.Update(TimeStep);
+            }
+        }
+    }
+
+    FrameRenderer renderer(width, height);
+    if (!renderer.Render(&game).SaveFile(output, wxBITMAP_TYPE_PNG))
+    {
+        fprintf(stderr, "%s: unable to save\n", output.ToStdString().c_str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file Replay.cpp
+ * @author matthew vazquez
+ *
+ * Command line tool that replays a saved session log headless.
+ *
+ * Usage: replay session.session...
+ *
+ * Each log is played into a new game as fast as it can be updated,
+ * and the game is checked against the checksums in the log. Run from
+ * the directory holding images/ and levels/, as the game is.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <chrono>
+#include <cstdio>
+#include <Game.h>
+#include <InputReplayer.h>
+
+/**
+ * Main entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if every log replayed the way it was recorded
+ */
+int main(int argc, char *argv[])
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: replay session.session...\n");
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        InputReplayer replayer;
+        if (!replayer.Load(wxString::FromUTF8(argv[i])))
+        {
+            fprintf(stderr, "%s: not a session log\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        Game game;
+        auto start = std::chrono::steady_clock::now();
+        bool matched = replayer.Replay(&game);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%s: %d ticks, %.1f s simulated in %.1f ms (%.0fx), level %d, score %d\n", argv[i],
+               replayer.GetNumTicks(), replayer.GetSimulatedTime(), ms,
+               replayer.GetSimulatedTime() * 1000.0 / (ms > 0 ? ms : 1), game.GetCurrentLevel(),
+               game.GetScore()->GetGameScore());
+
+        if (replayer.GetMismatchTick() >= 0)
+        {
+            printf("%s: diverged from the recording by tick %d\n", argv[i], replayer.GetMismatchTick());
+            failures++;
+        }
+        else if (!matched)
+        {
+            printf("%s: log is cut short\n", argv[i]);
+            failures++;
+        }
+        else
+        {
+            printf("%s: %d checksums match\n", argv[i], replayer.GetNumChecksums());
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file Synthesize.cpp
+ * @author matthew vazquez
+ *
+ * Command line tool that finds the smallest circuit solving each level.
+ *
+ * Usage: synthesize [--max-gates N] [--threads N] [--out DIR] [--cache FILE] level.xml...
+ *
+ * Each solved level is written as <name>-solved.xml, with the gates
+ * and wires of the solution added, next to the level or in DIR.
+ * With --cache, verification results are loaded from FILE before
+ * the search and saved back to it afterwards.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <wx/filename.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <CircuitSynthesizer.h>
+#include <LevelSpec.h>
+#include <TruthTableCache.h>
+#include <WorkStealingPool.h>
+
+/**
+ * Synthesize a solution for one level
+ * @param filename Level file to solve
+ * @param outDir Directory to write the solved level to, empty for the level's own
+ * @param maxGates Largest circuit to search for
+ * @param pool Pool to run the search on
+ * @param cache Cache of verification results
+ * @return True if a solution was found and saved
+ */
+static bool SolveLevel(const wxString &filename, const wxString &outDir, int maxGates, WorkStealingPool &pool,
+                       TruthTableCache &cache)
+{
+    wxXmlDocument xmlDoc;
+    if (!xmlDoc.Load(filename))
+    {
+        fprintf(stderr, "%s: unable to load level\n", filename.ToStdString().c_str());
+        return false;
+    }
+
+    auto root = xmlDoc.GetRoot();
+    LevelSpec spec;
+    if (!spec.XmlLoad(root))
+    {
+        fprintf(stderr, "%s: %s\n", filename.ToStdString().c_str(), wxString(spec.GetError()).ToStdString().c_str());
+        return false;
+    }
+
+    CircuitSynthesizer synthesizer(spec.GetInputs(), spec.GetProducts());
+    synthesizer.SetMaxGates(maxGates);
+    synthesizer.SetCache(&cache);
+
+    auto start = std::chrono::steady_clock::now();
+    bool solved = synthesizer.Synthesize(pool);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!solved)
+    {
+        printf("%s: no circuit of %d gates or fewer (%zu candidates, %.1f ms)\n",
+               filename.ToStdString().c_str(), maxGates, synthesizer.GetNumCandidates(), ms);
+        return false;
+    }
+
+    printf("%s: %d gates (%zu candidates, %.1f ms)\n",
+           filename.ToStdString().c_str(), synthesizer.GetSolutionGates(), synthesizer.GetNumCandidates(), ms);
+
+    for (auto items = root->GetChildren(); items; items = items->GetNext())
+    {
+        if (items->GetName() == L"items")
+        {
+            synthesizer.XmlSave(items);
+            break;
+        }
+    }
+
+    wxFileName level(filename);
+    wxString dir = outDir.empty() ? level.GetPath() : outDir;
+    wxFileName solvedName(dir, level.GetName() + L"-solved.xml");
+    if (!xmlDoc.Save(solvedName.GetFullPath()))
+    {
+        fprintf(stderr, "%s: unable to save\n", solvedName.GetFullPath().ToStdString().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Main entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if every level was solved
+ */
+int main(int argc, char *argv[])
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    int maxGates = CircuitSynthesizer::DefaultMaxGates;
+    int threads = 0;
+    wxString outDir;
+    std::string cacheFile;
+    std::vector<wxString> levels;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--max-gates") == 0 && i + 1 < argc)
+        {
+            maxGates = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+        {
+            outDir = wxString::FromUTF8(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            cacheFile = argv[++i];
+        }
+        else
+        {
+            levels.push_back(wxString::FromUTF8(argv[i]));
+        }
+    }
+
+    if (levels.empty())
+    {
+        fprintf(stderr, "usage: synthesize [--max-gates N] [--threads N] [--out DIR] [--cache FILE] level.xml...\n");
+        return 1;
+    }
+
+    WorkStealingPool pool(threads);
+
+    // A missing cache file just means nothing has been cached yet
+    TruthTableCache cache;
+    if (!cacheFile.empty())
+    {
+        cache.Load(cacheFile);
+    }
+
+    int failures = 0;
+    for (const auto &level : levels)
+    {
+        if (!SolveLevel(level, outDir, maxGates, pool, cache))
+        {
+            failures++;
+        }
+    }
+
+    if (!cacheFile.empty())
+    {
+        if (!cache.Save(cacheFile))
+        {
+            fprintf(stderr, "%s: unable to save cache\n", cacheFile.c_str());
+        }
+        printf("cache: %zu entries, %llu hits, %llu misses\n", cache.GetSize(),
+               (unsigned long long)cache.GetHits(), (unsigned long long)cache.GetMisses());
+    }
+
+    return failures == 0 ? 0 : 1;
+}
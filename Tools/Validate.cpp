@@ -0,0 +1,176 @@
+/**
+ * @file Validate.cpp
+ * @author matthew vazquez
+ *
+ * Command line tool that checks level files for mistakes the game would load silently.
+ *
+ * Usage: validate [--threads N] level.xml|dir...
+ *
+ * Every level named, and every .xml file in every directory named, is
+ * checked with LevelValidator. Mistakes are written to standard error
+ * as file:line: error: message, the way compilers write them, and the
+ * tool fails if there are any. Run from the directory holding images/,
+ * since levels load their images from there.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/log.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <Game.h>
+#include <LevelLoader.h>
+#include <XmlPullParser.h>
+#include <LevelValidator.h>
+#include <WorkStealingPool.h>
+
+/**
+ * A level file being checked
+ */
+struct LevelFile
+{
+    /// File name
+    wxString mFilename;
+
+    /// Parsed document
+    std::unique_ptr<wxXmlDocument> mDocument;
+
+    /// Game the level is loaded into, once the document passes
+    std::unique_ptr<Game> mGame;
+
+    /// Mistakes found
+    LevelValidator mValidator;
+};
+
+/**
+ * Main entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if every level is free of mistakes
+ */
+int main(int argc, char *argv[])
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    int threads = 0;
+    std::vector<LevelFile> levels;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+            continue;
+        }
+
+        auto name = wxString::FromUTF8(argv[i]);
+        wxArrayString files;
+        if (wxDirExists(name))
+        {
+            wxDir::GetAllFiles(name, &files, L"*.xml", wxDIR_FILES);
+            files.Sort();
+        }
+        else
+        {
+            files.Add(name);
+        }
+
+        for (const auto &file : files)
+        {
+            levels.emplace_back();
+            levels.back().mFilename = file;
+        }
+    }
+
+    if (levels.empty())
+    {
+        fprintf(stderr, "usage: validate [--threads N] level.xml|dir...\n");
+        return 1;
+    }
+
+    WorkStealingPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+
+    // Parsing and checking the documents create nothing, so every file
+    // is done at once
+    for (auto &level : levels)
+    {
+        LevelFile *checking = &level;
+        pool.Submit([checking]() {
+            wxLogNull quiet;
+            checking->mDocument = std::make_unique<wxXmlDocument>();
+            if (!checking->mDocument->Load(checking->mFilename))
+            {
+                checking->mDocument.reset();
+                return;
+            }
+            checking->mValidator.CheckXml(checking->mDocument->GetRoot());
+        });
+    }
+    pool.Wait();
+
+    // Loading creates bitmaps, so it stays on this thread. Games are not
+    // shared, so their items are checked at once again.
+    for (auto &level : levels)
+    {
+        if (level.mDocument != nullptr && level.mValidator.IsValid())
+        {
+            level.mGame = std::make_unique<Game>();
+            XmlPullParser parser;
+            if (parser.Open(level.mFilename))
+            {
+                LevelLoader loader;
+                loader.XmlLoad(parser, level.mGame.get());
+            }
+
+            LevelFile *checking = &level;
+            pool.Submit([checking]() { checking->mValidator.CheckGame(checking->mGame.get()); });
+        }
+    }
+    pool.Wait();
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    int errors = 0;
+    for (const auto &level : levels)
+    {
+        auto filename = level.mFilename.ToStdString();
+        if (level.mDocument == nullptr)
+        {
+            fprintf(stderr, "%s: error: not a readable XML file\n", filename.c_str());
+            errors++;
+            continue;
+        }
+
+        for (const auto &problem : level.mValidator.GetProblems())
+        {
+            auto message = wxString(problem.mMessage).ToStdString();
+            if (problem.mLine > 0)
+            {
+                fprintf(stderr, "%s:%d: error: %s\n", filename.c_str(), problem.mLine, message.c_str());
+            }
+            else
+            {
+                fprintf(stderr, "%s: error: %s\n", filename.c_str(), message.c_str());
+            }
+            errors++;
+        }
+    }
+
+    printf("%zu levels checked on %d threads in %.1f ms, %d errors\n", levels.size(), pool.GetNumThreads(), ms,
+           errors);
+
+    return errors == 0 ? 0 : 1;
+}